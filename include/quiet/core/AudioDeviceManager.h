@@ -6,6 +6,7 @@
 #include <functional>
 #include "AudioBuffer.h"
 #include "EventDispatcher.h"
+#include "InputLevelMeter.h"
 
 namespace quiet {
 namespace core {
@@ -62,7 +63,7 @@ public:
     void stopAudio();
     bool isAudioActive() const;
     
-    // Audio levels
+    // Audio levels; only updated while AudioLevelChanged has subscribers
     float getInputLevel() const;
     bool isInputMuted() const;
     void setInputMuted(bool muted);
@@ -99,8 +100,9 @@ private:
     
     // Audio processing
     std::unique_ptr<AudioBuffer> m_inputBuffer;
-    std::atomic<float> m_inputLevel{0.0f};
+    InputLevelMeter m_levelMeter;
     std::atomic<bool> m_inputMuted{false};
+    std::atomic<bool> m_audioThreadPrepared{false};  // Reset on each device start
     
     // Configuration
     double m_currentSampleRate{48000.0};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "ConfigurationManager.h"
+
+namespace quiet {
+namespace core {
+
+/**
+ * @brief Result of parsing a configuration file
+ */
+struct ConfigJsonResult {
+    bool ok = true;
+    size_t offset = 0;       // Where parsing stopped, on error
+    std::string error;
+};
+
+/**
+ * @brief Parses a JSON configuration document in one pass
+ *
+ * Nested objects become dotted keys, so {"audio": {"buffer_size": 256}}
+ * and {"audio.buffer_size": 256} load the same value. Below the top-level
+ * sections, arrays load as ConfigArray and objects inside them as
+ * ConfigObject, e.g. a list of per-device profiles.
+ *
+ * Value types: true/false -> bool, integers -> int (int64_t when they do
+ * not fit), numbers with a fraction or exponent -> double, strings ->
+ * std::string, null -> an empty ConfigValue. Text is only copied into the
+ * values it ends up in.
+ */
+ConfigJsonResult parseConfigJson(std::string_view text, std::unordered_map<std::string, ConfigValue>& values);
+
+/**
+ * @brief Writes configuration values as a JSON document
+ *
+ * Dotted keys are written as nested sections, sorted by key, so the same
+ * values always produce the same bytes. Doubles are written with the
+ * shortest representation that reads back exactly, and always with a
+ * fraction or exponent so they load as doubles again. Values of types JSON
+ * cannot hold are written as null.
+ */
+std::string writeConfigJson(const std::unordered_map<std::string, ConfigValue>& values);
+
+// Appends one value in compact form; used for array elements and tests
+void appendConfigJsonValue(std::string& out, const ConfigValue& value);
+
+} // namespace core
+} // namespace quiet
@@ -5,7 +5,14 @@
 #include <mutex>
 #include <memory>
 #include <any>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <map>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include "EventDispatcher.h"
 
 namespace quiet {
@@ -23,16 +30,19 @@ public:
     
     template<typename T>
     T get(const T& defaultValue = T{}) const {
-        try {
-            return std::any_cast<T>(m_value);
-        } catch (const std::bad_any_cast&) {
-            return defaultValue;
-        }
+        const T* value = std::any_cast<T>(&m_value);
+        return value ? *value : defaultValue;
     }
     
+    // The stored value if it has exactly type T, otherwise nullptr
     template<typename T>
-    void set(const T& value) {
-        m_value = value;
+    const T* getIf() const {
+        return std::any_cast<T>(&m_value);
+    }
+    
+    template<typename T>
+    void set(T&& value) {
+        m_value = std::forward<T>(value);
     }
     
     bool empty() const {
@@ -47,6 +57,125 @@ private:
     std::any m_value;
 };
 
+// Values of JSON arrays, and of objects inside them (e.g. per-device profiles)
+using ConfigArray = std::vector<ConfigValue>;
+using ConfigObject = std::map<std::string, ConfigValue>;
+
+/**
+ * @brief Immutable set of configuration values at one point in time
+ *
+ * Published snapshots are never modified: writers build a new one and swap
+ * it in, so a reader holding a snapshot sees a consistent configuration for
+ * as long as it keeps it, without locking.
+ */
+class ConfigSnapshot {
+public:
+    template<typename T>
+    T get(const std::string& key, const T& defaultValue = T{}) const {
+        auto it = m_values.find(key);
+        if (it != m_values.end()) {
+            return it->second.get<T>(defaultValue);
+        }
+        return defaultValue;
+    }
+
+    bool has(const std::string& key) const {
+        return m_values.find(key) != m_values.end();
+    }
+
+    const std::unordered_map<std::string, ConfigValue>& values() const {
+        return m_values;
+    }
+
+    // Increases with every published change
+    uint64_t version() const {
+        return m_version;
+    }
+
+private:
+    friend class ConfigurationManager;
+
+    std::unordered_map<std::string, ConfigValue> m_values;
+    uint64_t m_version = 0;
+};
+
+/**
+ * @brief One change, as delivered to batch change callbacks
+ */
+struct ConfigChange {
+    std::string key;
+    ConfigValue oldValue;
+    ConfigValue newValue;
+};
+
+namespace detail {
+
+// Storage behind a ConfigHandle; the manager rewrites it whenever its key changes
+class ConfigHandleSlotBase {
+public:
+    virtual ~ConfigHandleSlotBase() = default;
+    virtual void update(const ConfigValue* value) = 0;
+};
+
+template<typename T>
+class ConfigHandleSlot : public ConfigHandleSlotBase {
+public:
+    explicit ConfigHandleSlot(const T& defaultValue)
+        : m_defaultValue(defaultValue)
+        , m_value(defaultValue) {
+    }
+
+    void update(const ConfigValue* value) override {
+        m_value.store(value ? value->get<T>(m_defaultValue) : m_defaultValue, std::memory_order_relaxed);
+    }
+
+    // The value is self-contained, so there is nothing to order against
+    T load() const noexcept {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    const T m_defaultValue;
+    std::atomic<T> m_value;
+};
+
+} // namespace detail
+
+/**
+ * @brief Typed configuration value bound once to a key
+ *
+ * get() is a single atomic load: the key is looked up and the type checked
+ * when the value changes, not when it is read, so handles are the way to
+ * read settings from hot paths and real-time threads. A missing value or one
+ * of another type reads as the default given to bind(). Strings and other
+ * non-trivial types are read from a ConfigSnapshot instead.
+ */
+template<typename T>
+class ConfigHandle {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ConfigHandle values are stored in a std::atomic; read other types from a snapshot");
+
+public:
+    ConfigHandle() = default;
+
+    T get() const noexcept {
+        return m_slot ? m_slot->load() : T{};
+    }
+
+    bool isBound() const noexcept {
+        return m_slot != nullptr;
+    }
+
+private:
+    friend class ConfigurationManager;
+
+    explicit ConfigHandle(std::shared_ptr<detail::ConfigHandleSlot<T>> slot)
+        : m_slot(std::move(slot)) {
+    }
+
+    std::shared_ptr<detail::ConfigHandleSlot<T>> m_slot;
+};
+
 /**
  * @brief Thread-safe configuration management system
  * 
@@ -55,11 +184,17 @@ private:
  * - Type-safe value access
  * - Change notifications
  * - Default value handling
- * - Automatic saving
+ * - Automatic saving: changes are written behind, coalesced, by a
+ *   persistence thread that replaces the file atomically
+ *
+ * Reads never take the lock: writers serialize on it, build a new
+ * ConfigSnapshot and publish it atomically, and readers use whichever
+ * snapshot is current.
  */
 class ConfigurationManager {
 public:
     using ChangeCallback = std::function<void(const std::string& key, const ConfigValue& oldValue, const ConfigValue& newValue)>;
+    using BatchChangeCallback = std::function<void(const std::vector<ConfigChange>& changes)>;
     using CallbackHandle = uint64_t;
 
     explicit ConfigurationManager(EventDispatcher& eventDispatcher);
@@ -73,12 +208,7 @@ public:
     // Value access
     template<typename T>
     T getValue(const std::string& key, const T& defaultValue = T{}) const {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto it = m_values.find(key);
-        if (it != m_values.end()) {
-            return it->second.get<T>(defaultValue);
-        }
-        return defaultValue;
+        return currentSnapshot().get<T>(key, defaultValue);
     }
     
     template<typename T>
@@ -91,14 +221,15 @@ public:
                 oldValue = it->second;
             }
             m_values[key].set(value);
-            m_isDirty = true;
+            markDirtyLocked();
+            publishSnapshotLocked();
         }
         
         // Notify listeners
         notifyChange(key, oldValue, ConfigValue(value));
         
         if (saveImmediately) {
-            saveConfiguration();
+            requestSave();
         }
     }
     
@@ -106,14 +237,36 @@ public:
     void removeValue(const std::string& key);
     void clear();
 
+    // Lock-free reads
+    std::shared_ptr<const ConfigSnapshot> getSnapshot() const;
+
+    template<typename T>
+    ConfigHandle<T> bind(const std::string& key, const T& defaultValue = T{}) {
+        auto slot = std::make_shared<detail::ConfigHandleSlot<T>>(defaultValue);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_values.find(key);
+        slot->update(it != m_values.end() ? &it->second : nullptr);
+        m_handleSlots[key].push_back(slot);
+        return ConfigHandle<T>(std::move(slot));
+    }
+
     // Configuration persistence
     bool loadConfiguration();
     bool saveConfiguration();
+    void requestSave();
     void setAutoSave(bool enabled, int intervalSeconds = 30);
+    void setSaveDelay(std::chrono::milliseconds delay);
 
-    // Change notifications
+    // Change notifications. Patterns: an exact key, "section.*" for every
+    // key below a section, "*" for everything, or any other glob where '*'
+    // matches any run of characters. The first three are indexed, so a change
+    // only costs as much as the callbacks it matches; other globs are tested
+    // one by one. Batch callbacks get all the changes of one operation
+    // (clear(), restoreDefaults(), ...) that match, in a single call.
     CallbackHandle addChangeCallback(const std::string& keyPattern, ChangeCallback callback);
     CallbackHandle addGlobalChangeCallback(ChangeCallback callback);
+    CallbackHandle addBatchChangeCallback(const std::string& keyPattern, BatchChangeCallback callback);
     bool removeChangeCallback(CallbackHandle handle);
 
     // Utility methods
@@ -136,6 +289,13 @@ public:
         uint64_t loadCount = 0;
         uint64_t saveCount = 0;
         uint64_t changeNotifications = 0;
+        uint64_t skippedSaves = 0;       // Saves with nothing new to write
+        uint64_t failedSaves = 0;
+        uint64_t coalescedChanges = 0;   // Changes handled by those saves
+        double coalescingRatio = 0.0;    // coalescedChanges per file write
+        double lastSaveMs = 0.0;
+        double maxSaveMs = 0.0;
+        double averageSaveMs = 0.0;
         std::string lastError;
     };
     
@@ -145,14 +305,20 @@ private:
     // Internal methods
     void initializeDefaults();
     void notifyChange(const std::string& key, const ConfigValue& oldValue, const ConfigValue& newValue);
-    void autoSaveWorker();
+    void notifyChanges(const std::vector<ConfigChange>& changes);
+    void persistenceWorker();
+    void startPersistenceLocked();
+    void stopPersistence();
+    void markDirtyLocked();
     bool matchesPattern(const std::string& key, const std::string& pattern) const;
+    CallbackHandle addCallbackLocked(const std::string& keyPattern, std::shared_ptr<const ChangeCallback> callback,
+                                     std::shared_ptr<const BatchChangeCallback> batchCallback);
+    void collectCallbacksLocked(const std::string& key, std::vector<CallbackHandle>& handles) const;
+    const ConfigSnapshot& currentSnapshot() const;
+    void publishSnapshotLocked();
     
-    // JSON serialization
-    bool loadFromJson(const std::string& filePath);
-    bool saveToJson(const std::string& filePath);
-    ConfigValue parseJsonValue(const std::string& jsonStr);
-    std::string serializeValue(const ConfigValue& value);
+    // JSON serialization, see ConfigJson.h
+    std::string serializeSnapshot(const ConfigSnapshot& snapshot);
     
     // Member variables
     EventDispatcher& m_eventDispatcher;
@@ -161,14 +327,33 @@ private:
     std::unordered_map<std::string, ConfigValue> m_values;
     std::unordered_map<std::string, ConfigValue> m_defaults;
     
-    // Change callbacks
+    // Published copy of m_values for lock-free readers
+    const uint64_t m_instanceId;
+    std::shared_ptr<const ConfigSnapshot> m_snapshot;
+    std::atomic<uint64_t> m_snapshotVersion{0};
+    std::unordered_map<std::string, std::vector<std::weak_ptr<detail::ConfigHandleSlotBase>>> m_handleSlots;
+    
+    // Change callbacks. Exactly one of callback and batchCallback is set;
+    // both are shared so dispatch can take them out of the lock cheaply
     struct CallbackInfo {
         std::string pattern;
-        ChangeCallback callback;
+        std::shared_ptr<const ChangeCallback> callback;
+        std::shared_ptr<const BatchChangeCallback> batchCallback;
         bool isGlobal;
     };
     
+    // Index over dot-separated key segments: a node's exact list holds the
+    // callbacks for that key, its subtree list those for every key below it.
+    // The root's subtree list holds the global callbacks.
+    struct CallbackTrieNode {
+        std::map<std::string, std::unique_ptr<CallbackTrieNode>, std::less<>> children;
+        std::vector<CallbackHandle> exact;
+        std::vector<CallbackHandle> subtree;
+    };
+    
     std::unordered_map<CallbackHandle, CallbackInfo> m_callbacks;
+    CallbackTrieNode m_callbackIndex;
+    std::vector<CallbackHandle> m_wildcardCallbacks;  // Globs the index cannot hold
     CallbackHandle m_nextCallbackHandle{1};
     
     // File management
@@ -176,11 +361,24 @@ private:
     bool m_isDirty{false};
     bool m_isInitialized{false};
     
-    // Auto-save
+    // Write-behind persistence: a save waits until changes have been quiet
+    // for m_saveDelay, but never longer than m_autoSaveInterval. After a
+    // failed save the retry delay doubles up to m_autoSaveInterval, unless a
+    // new change or requestSave() comes first.
     bool m_autoSaveEnabled{true};
     int m_autoSaveInterval{30};  // seconds
-    std::unique_ptr<std::thread> m_autoSaveThread;
-    std::atomic<bool> m_shouldStopAutoSave{false};
+    std::chrono::milliseconds m_saveDelay{500};
+    std::thread m_persistenceThread;
+    std::condition_variable m_persistenceCondition;
+    bool m_persistenceRunning{false};
+    bool m_stopPersistence{false};
+    bool m_saveRequested{false};
+    uint64_t m_changeCount{0};
+    uint64_t m_unsavedChanges{0};
+    uint64_t m_savedVersion{0};
+    std::mutex m_saveMutex;  // One writer of the file at a time
+    std::string m_lastSavedContent;
+    double m_totalSaveMs{0.0};
     
     // Statistics
     mutable Stats m_stats;
@@ -5,10 +5,20 @@
 #include <vector>
 #include <unordered_map>
 #include <mutex>
-#include <queue>
+#include <condition_variable>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <string>
+#include <array>
 #include <any>
+#include <variant>
+#include <optional>
+#include <type_traits>
+#include "quiet/core/EventTrace.h"
+#include "quiet/utils/FixedString.h"
+#include "quiet/utils/MpscRingBuffer.h"
+#include "quiet/utils/RingQueue.h"
 
 namespace quiet {
 namespace core {
@@ -40,8 +50,82 @@ enum class EventType {
     ErrorOccurred
 };
 
+constexpr size_t kEventTypeCount = static_cast<size_t>(EventType::ErrorOccurred) + 1;
+
+/**
+ * @brief Typed event payloads
+ * 
+ * Plain structs carried inline in Event, so publishing one of the common
+ * events never touches the heap. All payloads are trivially copyable, which
+ * also lets them travel through the real-time ring unchanged.
+ */
+struct AudioLevelPayload {
+    float level = 0.0f;
+    bool isInput = true;
+};
+
+struct ProcessingStatsPayload {
+    float cpuUsage = 0.0f;
+    float latency = 0.0f;
+    float reductionLevel = 0.0f;
+};
+
+struct NoiseReductionPayload {
+    bool enabled = false;
+    int level = 0;
+    float threshold = 0.0f;
+    bool adaptive = false;
+};
+
+struct AudioProcessingPayload {
+    double sampleRate = 0.0;
+};
+
+struct DeviceChangedPayload {
+    utils::FixedString<64> deviceId;
+    utils::FixedString<64> deviceName;
+};
+
+struct ErrorPayload {
+    utils::FixedString<128> message;
+    int errorCode = 0;
+};
+
+// One per configuration operation; key is set when exactly one key changed
+struct SettingsChangedPayload {
+    utils::FixedString<64> key;
+    uint32_t changeCount = 0;
+    uint64_t version = 0;  // ConfigSnapshot version after the change
+};
+
+using EventPayload = std::variant<
+    std::monostate,
+    AudioLevelPayload,
+    ProcessingStatsPayload,
+    NoiseReductionPayload,
+    AudioProcessingPayload,
+    DeviceChangedPayload,
+    ErrorPayload,
+    SettingsChangedPayload
+>;
+
+static_assert(std::is_trivially_copyable<EventPayload>::value,
+              "Event payloads must stay trivially copyable for the real-time ring");
+
+/**
+ * @brief Looks up a payload field by its legacy string key
+ * 
+ * Keys match the ones the old map-based factories used ("level",
+ * "cpu_usage", "device_id", ...). Returns an empty std::any if the payload
+ * has no such field. Slow path only; prefer Event::get<T>().
+ */
+std::any getPayloadField(const EventPayload& payload, const std::string& key);
+
 /**
  * @brief Base class for event data
+ * 
+ * Untyped key/value data for events without a typed payload. Every field is a
+ * separate allocation, so keep it off hot paths.
  */
 class EventData {
 public:
@@ -51,10 +135,8 @@ public:
     T getValue(const std::string& key, const T& defaultValue = T{}) const {
         auto it = m_data.find(key);
         if (it != m_data.end()) {
-            try {
-                return std::any_cast<T>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return defaultValue;
+            if (const T* value = std::any_cast<T>(&it->second)) {
+                return *value;
             }
         }
         return defaultValue;
@@ -74,31 +156,107 @@ private:
 };
 
 /**
- * @brief Event structure containing type and data
+ * @brief Event structure containing type, inline payload and optional data
  */
 struct Event {
     EventType type;
+    EventPayload payload;
     std::shared_ptr<EventData> data;
     std::chrono::steady_clock::time_point timestamp;
     
     Event(EventType t, std::shared_ptr<EventData> d = nullptr)
-        : type(t), data(d), timestamp(std::chrono::steady_clock::now()) {}
+        : type(t), data(std::move(d)), timestamp(std::chrono::steady_clock::now()) {}
+    
+    Event(EventType t, const EventPayload& p)
+        : type(t), payload(p), timestamp(std::chrono::steady_clock::now()) {}
+    
+    // Typed access: nullptr if the event carries a different payload
+    template<typename T>
+    const T* get() const {
+        return std::get_if<T>(&payload);
+    }
+    
+    // Slow-path adapter for string-keyed access; checks data, then the payload
+    template<typename T>
+    T getValue(const std::string& key, const T& defaultValue = T{}) const {
+        if (data && data->hasKey(key)) {
+            return data->getValue<T>(key, defaultValue);
+        }
+        std::any field = getPayloadField(payload, key);
+        if (const T* value = std::any_cast<T>(&field)) {
+            return *value;
+        }
+        return defaultValue;
+    }
+};
+
+/**
+ * @brief Per-type delivery policy
+ * 
+ * By default AudioLevelChanged and ProcessingStatsUpdated are coalesced, and
+ * AudioDeviceError and ApplicationShutdown use the priority lane.
+ */
+struct EventPolicy {
+    // Latest value wins: at most one event of the type waits in the queue and
+    // a newer one replaces it. Coalesced events may overtake older events of
+    // other types.
+    bool coalesce = false;
+    
+    // Per-subscriber delivery cap in Hz (0 = unlimited). Events arriving too
+    // soon are merged and the newest is delivered when the next slot opens.
+    // Applies to type-specific subscribers only, not subscribeAll().
+    double maxRateHz = 0.0;
+    
+    // Separate queue that is always drained first, never dropped for queue
+    // size, and placed at the head of each listener's backlog
+    bool priority = false;
+};
+
+/**
+ * @brief Thread on which a subscriber's callback runs
+ */
+enum class DeliveryMode {
+    // Inline on the publishing thread, before publish() returns. For cheap,
+    // thread-safe consumers. Policies do not apply; publishRT() events reach
+    // Direct listeners on the dispatcher thread, never on the audio thread.
+    Direct,
+    
+    // On the delivery thread pool, in order per listener (default)
+    Dispatcher,
+    
+    // Batched onto the message thread: one executor task per frame tick
+    // delivers everything queued since the previous tick
+    MessageThread
 };
 
 /**
  * @brief Thread-safe event dispatcher for decoupled communication
  * 
  * This class provides:
- * - Thread-safe event publishing and subscription
- * - Asynchronous event delivery
- * - Event filtering and prioritization
+ * - Thread-safe event publishing and subscription; delivery reads per-type
+ *   copy-on-write listener arrays without taking a lock
+ * - Asynchronous event delivery on a fixed pool of delivery threads, with
+ *   events for any one listener always delivered in order (serial executor)
+ * - Per-subscriber delivery modes: inline on the publisher, on the pool, or
+ *   batched onto the UI message thread once per frame
+ * - Watchdog that flags listeners exceeding the delivery timeout
+ * - Real-time safe publishRT() for audio threads: no allocation, locks or
+ *   syscalls on the publisher side
+ * - Typed payloads stored inline in each Event, so common events are
+ *   published and delivered without heap allocation
+ * - Event filtering and per-type policies: coalescing, per-subscriber rate
+ *   limits and a priority lane
  * - Automatic listener cleanup
- * - Performance monitoring
+ * - Performance monitoring, plus an optional trace ring recording every
+ *   publish and listener invocation for offline analysis
  */
 class EventDispatcher {
 public:
     using EventListener = std::function<void(const Event&)>;
     using ListenerHandle = uint64_t;
+    
+    // Runs a task on the message (UI) thread, e.g. juce::MessageManager::callAsync
+    using MessageThreadExecutor = std::function<void(std::function<void()>)>;
 
     EventDispatcher();
     ~EventDispatcher();
@@ -110,93 +268,260 @@ public:
 
     // Event publishing
     void publish(EventType type, std::shared_ptr<EventData> data = nullptr);
+    void publish(EventType type, const EventPayload& payload);
     void publishImmediate(EventType type, std::shared_ptr<EventData> data = nullptr);
+    void publishImmediate(EventType type, const EventPayload& payload);
+    
+    // Real-time safe: copies the payload into a preallocated lock-free ring that
+    // the dispatcher thread drains. Returns false if the ring is full (dropped).
+    bool publishRT(EventType type, const EventPayload& payload = {}) noexcept;
     
     // Event subscription
-    ListenerHandle subscribe(EventType type, EventListener listener);
-    ListenerHandle subscribeAll(EventListener listener);
+    ListenerHandle subscribe(EventType type, EventListener listener,
+                             DeliveryMode mode = DeliveryMode::Dispatcher);
+    ListenerHandle subscribeAll(EventListener listener,
+                                DeliveryMode mode = DeliveryMode::Dispatcher);
     bool unsubscribe(ListenerHandle handle);
     void unsubscribeAll();
+    
+    // Whether any listener, typed or global, would receive this type. Real-time
+    // safe, so publishers can skip computing payloads nobody reads.
+    bool hasSubscribers(EventType type) const noexcept;
 
     // Event filtering
     void setEventFilter(EventType type, bool enabled);
     bool isEventFiltered(EventType type) const;
+    
+    // Delivery policies
+    void setEventPolicy(EventType type, const EventPolicy& policy);
+    EventPolicy getEventPolicy(EventType type) const;
+    
+    // Message thread delivery. Without an executor, MessageThread listeners
+    // only run when the owner calls drainMessageThreadQueue() on that thread.
+    void setMessageThreadExecutor(MessageThreadExecutor executor);
+    void setMessageThreadFrameRate(double framesPerSecond);
+    size_t drainMessageThreadQueue();
+    
+    // Event tracing. The buffer is allocated on first enable and kept until
+    // destruction, so tracing can be switched on and off while running.
+    // With a dump path set, the trace is written there on AudioDeviceError.
+    void enableTracing(size_t capacity = 16384);
+    void disableTracing();
+    bool isTracing() const;
+    std::vector<EventTraceRecord> getTrace() const;
+    bool dumpTrace(const std::string& path) const;
+    void setTraceDumpPath(const std::string& path);
 
     // Statistics
     struct Stats {
         uint64_t eventsPublished = 0;
         uint64_t eventsDelivered = 0;
         uint64_t eventsDropped = 0;
+        uint64_t eventsCoalesced = 0;      // Superseded by a newer event before delivery
         uint64_t activeListeners = 0;
-        double averageDeliveryTime = 0.0;  // milliseconds
+        double averageDeliveryTime = 0.0;  // milliseconds, per listener invocation
         size_t queueSize = 0;
+        uint64_t deliveryTimeouts = 0;     // Invocations that overran the delivery timeout
+        uint64_t slowListeners = 0;        // Listeners currently flagged as slow
+        uint64_t messageThreadPosts = 0;   // Batches handed to the message thread executor
     };
     
     Stats getStats() const;
     void resetStats();
 
+    // Listener health
+    bool isListenerSlow(ListenerHandle handle) const;
+
     // Configuration
     void setMaxQueueSize(size_t maxSize);
     void setDeliveryTimeout(std::chrono::milliseconds timeout);
+    void setDeliveryThreadCount(size_t threadCount);  // Takes effect on next start()
+    void setRealtimeQueueCapacity(size_t capacity);   // Ignored while running
+    void setRealtimePollInterval(std::chrono::milliseconds interval);
 
 private:
-    // Internal event processing
-    void processEvents();
-    void deliverEvent(const Event& event);
-    void deliverToListener(const EventListener& listener, const Event& event);
-    void updateStats(const Event& event, double deliveryTime);
-    
     // Listener management
     struct ListenerInfo {
         EventType type;
         EventListener listener;
-        std::chrono::steady_clock::time_point lastActivity;
-        uint64_t eventsReceived = 0;
+        DeliveryMode mode = DeliveryMode::Dispatcher;
+        ListenerHandle handle = 0;
+        
+        // Updated on every delivery without a lock
+        std::atomic<std::chrono::steady_clock::rep> lastActivity{0};
+        std::atomic<uint64_t> eventsReceived{0};
+        
+        // Serial executor state, guarded by the delivery pool mutex
+        utils::RingQueue<Event> pending;
+        utils::RingQueue<Event> priorityPending;   // Served before pending, in publish order
+        bool scheduled = false;
+        
+        // Set once unsubscribed; checked before every queued invocation
+        std::atomic<bool> removed{false};
+        
+        // Set by the watchdog, cleared once an invocation completes in time
+        std::atomic<bool> slow{false};
+        
+        // Rate limiting state, dispatcher thread only
+        std::chrono::steady_clock::time_point lastDelivery;
+        std::optional<Event> held;
     };
     
+    using ListenerPtr = std::shared_ptr<ListenerInfo>;
+    
+    // Immutable listener snapshot. Writers copy, modify and atomically swap in
+    // a new list, so delivery walks it without taking a lock.
+    using ListenerList = std::vector<ListenerPtr>;
+    using ListenerListPtr = std::shared_ptr<const ListenerList>;
+    
+    // Fixed pool of delivery threads plus watchdog (defined in EventDispatcher.cpp)
+    class DeliveryPool;
+    
+    // Per-frame batch of MessageThread deliveries (defined in EventDispatcher.cpp)
+    class MessageThreadQueue;
+    
+    // Fixed-size record stored in the real-time ring
+    struct RealtimeRecord {
+        EventType type;
+        EventPayload payload;
+        std::chrono::steady_clock::time_point timestamp;
+    };
+    
+    // Policy state readable from any thread, including real-time publishers
+    struct PolicyState {
+        std::atomic<bool> coalesce{false};
+        std::atomic<bool> priority{false};
+        std::atomic<int64_t> minIntervalUs{0};
+    };
+    
+    // Internal event processing
+    void enqueueEvent(Event&& event);
+    void queueEventLocked(Event&& event);
+    bool hasQueuedEventsLocked() const;
+    bool popNextEventLocked(std::optional<Event>& event);
+    size_t queuedEventCountLocked() const;
+    void processEvents();
+    bool drainRealtimeEvents();
+    bool admitRateLimited(const ListenerPtr& listener, const Event& event,
+                          std::chrono::microseconds minInterval);
+    std::chrono::steady_clock::time_point flushHeldEvents();
+    void deliverEvent(const Event& event, bool deliverInline = false);
+    bool dispatchToListener(const ListenerPtr& listener, const Event& event, bool priority);
+    void deliverDirect(const Event& event);
+    std::chrono::steady_clock::time_point flushMessageThreadQueue();
+    void invokeListener(ListenerInfo& info, const Event& event);
+    void recordInvocation(ListenerInfo& info, const Event& event,
+                          std::chrono::steady_clock::time_point started,
+                          std::chrono::nanoseconds elapsed, bool timedOut);
+    void flagSlowListener(ListenerInfo& info);
+    void tracePublish(EventType type, std::chrono::steady_clock::time_point timestamp,
+                      size_t queueDepth) noexcept;
+    void dumpTraceOnError();
+    
+    ListenerHandle addListener(EventType type, EventListener listener, DeliveryMode mode);
+    static void appendListener(ListenerListPtr& list, const ListenerPtr& info);
+    static void removeListener(ListenerListPtr& list, const ListenerPtr& info);
+    void detachListener(const ListenerPtr& info);
+    void retireListener(const ListenerPtr& info);
     void cleanupInactiveListeners();
     
     // Thread safety
     mutable std::mutex m_queueMutex;
-    mutable std::mutex m_listenersMutex;
-    mutable std::mutex m_statsMutex;
+    mutable std::mutex m_listenersMutex;  // Serializes registry writers only
     
-    // Event queue
-    std::queue<Event> m_eventQueue;
+    // Event queues (guarded by m_queueMutex). Coalesced types keep one slot each.
+    utils::RingQueue<Event> m_eventQueue;
+    utils::RingQueue<Event> m_priorityQueue;
+    std::array<std::optional<Event>, kEventTypeCount> m_coalescedEvents;
+    size_t m_coalescedCount{0};
+    size_t m_regularSinceCoalesced{0};   // Regular events served since the last coalesced one
+    size_t m_coalescedCursor{0};         // Next slot to look at, so types take turns
     size_t m_maxQueueSize{10000};
+    bool m_flushRequested{false};  // Message thread batch needs posting
     std::condition_variable m_queueCondition;
     
-    // Listeners
-    std::unordered_map<ListenerHandle, ListenerInfo> m_listeners;
-    std::unordered_map<EventType, std::vector<ListenerHandle>> m_typeListeners;
-    std::vector<ListenerHandle> m_globalListeners;
+    // Delivery policies, indexed by EventType
+    std::array<PolicyState, kEventTypeCount> m_policies;
+    
+    // Rate-limited listeners holding an event for their next slot (dispatcher thread only)
+    std::vector<ListenerPtr> m_heldListeners;
+    
+    // Listeners. m_listeners is guarded by m_listenersMutex; the snapshots are
+    // read with std::atomic_load and replaced with std::atomic_store.
+    std::unordered_map<ListenerHandle, ListenerPtr> m_listeners;
+    std::array<ListenerListPtr, kEventTypeCount> m_typeListeners;
+    ListenerListPtr m_globalListeners;
+    
+    // Direct listeners are kept apart so publishers skip the lookup entirely
+    // while there are none
+    std::array<ListenerListPtr, kEventTypeCount> m_directTypeListeners;
+    ListenerListPtr m_directGlobalListeners;
+    std::atomic<size_t> m_directListenerCount{0};
+    
+    // Listener counts for hasSubscribers(), any delivery mode
+    std::array<std::atomic<size_t>, kEventTypeCount> m_subscriberCounts{};
+    std::atomic<size_t> m_globalSubscriberCount{0};
     
     ListenerHandle m_nextHandle{1};
     
-    // Event filtering
-    std::unordered_map<EventType, bool> m_eventFilters;
+    // Event filtering (true means filtered), indexed by EventType
+    std::array<std::atomic<bool>, kEventTypeCount> m_eventFilters{};
+    
+    // Real-time publishing
+    std::unique_ptr<utils::MpscRingBuffer<RealtimeRecord>> m_realtimeQueue;
+    std::atomic<int64_t> m_realtimePollIntervalMs{5};
+    std::chrono::steady_clock::time_point m_lastRealtimeActivity;
     
     // Processing thread
     std::unique_ptr<std::thread> m_processingThread;
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_shouldStop{false};
     
+    // Delivery threads
+    std::unique_ptr<DeliveryPool> m_deliveryPool;
+    size_t m_deliveryThreadCount{2};
+    
+    // Message thread batching; shared so pending executor tasks can outlive us
+    std::shared_ptr<MessageThreadQueue> m_messageThreadQueue;
+    
     // Configuration
-    std::chrono::milliseconds m_deliveryTimeout{100};
+    std::atomic<int64_t> m_deliveryTimeoutMs{100};
+    static constexpr size_t kMaxPendingPerListener = 1024;
+    static constexpr size_t kMaxPriorityPendingPerListener = 64;
     
-    // Statistics
-    mutable Stats m_stats;
-    std::chrono::steady_clock::time_point m_lastStatsUpdate;
+    // Under sustained regular traffic, one coalesced slot is served after this
+    // many regular events instead of waiting for the queue to drain
+    static constexpr size_t kCoalescedInterleave = 16;
+    
+    // Statistics: relaxed atomics, so publishers and delivery threads never
+    // serialize on them. getStats() assembles a Stats snapshot.
+    std::atomic<uint64_t> m_eventsPublished{0};
+    std::atomic<uint64_t> m_eventsDelivered{0};
+    std::atomic<uint64_t> m_eventsDropped{0};
+    std::atomic<uint64_t> m_eventsCoalesced{0};
+    std::atomic<uint64_t> m_deliveryTimeouts{0};
+    std::atomic<uint64_t> m_slowListeners{0};
+    std::atomic<uint64_t> m_activeListeners{0};
+    std::atomic<size_t> m_queueSize{0};
+    std::atomic<double> m_averageDeliveryTime{0.0};
+    
+    // Tracing: m_activeTrace points at m_traceBuffer while enabled. The buffer
+    // itself is never released before destruction.
+    std::unique_ptr<EventTraceBuffer> m_traceBuffer;
+    std::atomic<EventTraceBuffer*> m_activeTrace{nullptr};
+    mutable std::mutex m_traceMutex;
+    std::string m_traceDumpPath;
+    std::chrono::steady_clock::time_point m_lastTraceDump;
 };
 
 /**
- * @brief Helper functions for creating common event data
+ * @brief Helper functions for creating common event payloads
  */
 namespace EventDataFactory {
-    std::shared_ptr<EventData> createAudioLevelData(float level);
-    std::shared_ptr<EventData> createDeviceChangedData(const std::string& deviceId, const std::string& deviceName);
-    std::shared_ptr<EventData> createErrorData(const std::string& message, int errorCode = 0);
-    std::shared_ptr<EventData> createProcessingStatsData(float cpuUsage, float latency, float reductionLevel);
+    AudioLevelPayload createAudioLevelData(float level, bool isInput = true);
+    DeviceChangedPayload createDeviceChangedData(const std::string& deviceId, const std::string& deviceName);
+    ErrorPayload createErrorData(const std::string& message, int errorCode = 0);
+    ProcessingStatsPayload createProcessingStatsData(float cpuUsage, float latency, float reductionLevel);
 }
 
 } // namespace core
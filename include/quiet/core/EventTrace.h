@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quiet {
+namespace core {
+
+/**
+ * @brief One entry in an event trace
+ *
+ * Publish records describe an event entering the dispatcher; Deliver records
+ * describe one listener invocation for that event. Times are steady_clock
+ * nanoseconds, so records from one process can be compared directly.
+ */
+struct EventTraceRecord {
+    enum class Kind : uint8_t {
+        Publish,
+        Deliver
+    };
+
+    uint64_t timestampNs = 0;   // When the event was published
+    uint64_t startNs = 0;       // Deliver: when the listener was invoked
+    uint64_t durationNs = 0;    // Deliver: time spent in the listener
+    uint32_t queueDepth = 0;    // Publish: events queued after this one was added
+    uint32_t threadId = 0;      // Publishing or delivering thread (hashed id)
+    uint32_t listenerId = 0;    // Deliver: listener handle (truncated)
+    uint16_t type = 0;          // EventType
+    Kind kind = Kind::Publish;
+
+    // Time the event spent waiting before this listener started (Deliver only)
+    uint64_t queueLatencyNs() const {
+        return startNs > timestampNs ? startNs - timestampNs : 0;
+    }
+};
+
+/**
+ * @brief Fixed-size flight recorder of event trace records
+ *
+ * Any thread may record concurrently: a slot is claimed with one fetch_add
+ * and written under a per-slot sequence number, so recording never locks,
+ * waits or allocates and is safe from real-time threads. Once full, the
+ * oldest records are overwritten; a record whose slot is still held by a
+ * writer from the previous lap is dropped. snapshot() skips slots that are
+ * mid-write.
+ */
+class EventTraceBuffer {
+public:
+    explicit EventTraceBuffer(size_t capacity);
+
+    EventTraceBuffer(const EventTraceBuffer&) = delete;
+    EventTraceBuffer& operator=(const EventTraceBuffer&) = delete;
+
+    void record(const EventTraceRecord& record) noexcept;
+
+    // Oldest first; at most capacity() records
+    std::vector<EventTraceRecord> snapshot() const;
+
+    void clear() noexcept;
+    size_t capacity() const noexcept { return m_capacity; }
+    uint64_t recorded() const noexcept { return m_head.load(std::memory_order_relaxed); }
+
+    // Compact binary file: 16-byte header followed by 40-byte little-endian records
+    static bool writeFile(const std::string& path, const std::vector<EventTraceRecord>& records);
+    static bool readFile(const std::string& path, std::vector<EventTraceRecord>& records);
+
+    // Small stable id for the calling thread; cached per thread
+    static uint32_t currentThreadId() noexcept;
+
+    // steady_clock time in nanoseconds
+    static uint64_t nowNs() noexcept;
+
+private:
+    // Records are stored as words so readers never race on plain memory
+    static constexpr size_t kWords = 5;
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> words[kWords];
+    };
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<uint64_t> m_head{0};
+};
+
+} // namespace core
+} // namespace quiet
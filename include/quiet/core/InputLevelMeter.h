@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace quiet {
+namespace core {
+
+class AudioBuffer;
+class EventDispatcher;
+
+/**
+ * @brief Smoothed input level, measured and published on the audio thread
+ *
+ * Each block's RMS across channels is mapped from -60..0 dB onto 0..1,
+ * smoothed, and published as AudioLevelChanged through publishRT() at most
+ * every 50 ms. While nobody subscribes to AudioLevelChanged all of it is
+ * skipped, so a headless run pays for one subscriber check per block and
+ * getLevel() keeps its last value.
+ */
+class InputLevelMeter {
+public:
+    static constexpr float kMinLevelDb = -60.0f;
+    static constexpr float kMaxLevelDb = 0.0f;
+    static constexpr float kSmoothingFactor = 0.9f;
+    static constexpr std::chrono::milliseconds kPublishInterval{50};
+
+    explicit InputLevelMeter(EventDispatcher& eventDispatcher);
+
+    InputLevelMeter(const InputLevelMeter&) = delete;
+    InputLevelMeter& operator=(const InputLevelMeter&) = delete;
+
+    // Audio thread: measures the first numChannels channels of the block
+    void process(const AudioBuffer& buffer, int numChannels, int numSamples) noexcept;
+
+    // Any thread
+    void reset() noexcept { m_level.store(0.0f, std::memory_order_relaxed); }
+    float getLevel() const noexcept { return m_level.load(std::memory_order_relaxed); }
+
+private:
+    EventDispatcher& m_eventDispatcher;
+    std::atomic<float> m_level{0.0f};
+    std::chrono::steady_clock::time_point m_lastPublish;  // Audio thread only
+};
+
+} // namespace core
+} // namespace quiet
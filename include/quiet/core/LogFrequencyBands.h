@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace quiet {
+namespace core {
+
+/**
+ * @brief Precomputed mapping from FFT bins to bands on a log-frequency axis
+ *
+ * Bands are spaced evenly in log frequency between a low and high limit
+ * (the high limit is capped at Nyquist). Each band covers the bins whose
+ * centre frequencies fall inside it, and always at least the one nearest
+ * its centre, so low bands that are narrower than a bin repeat that bin
+ * rather than going blank. Computed once per layout, sample rate or FFT
+ * size; aggregating a frame is then a pass over the bins with no log math.
+ */
+class LogFrequencyBands {
+public:
+    struct Band {
+        int firstBin = 0;     // Inclusive
+        int lastBin = 0;      // Inclusive
+        float lowHz = 0.0f;
+        float highHz = 0.0f;
+    };
+
+    void configure(int numBands, int fftSize, double sampleRate,
+                   float minHz = 20.0f, float maxHz = 20000.0f);
+
+    // Peak dB of each band's bins; bandDb must hold size() values
+    void aggregate(const float* magnitudesDb, size_t numBins, float* bandDb) const;
+
+    // Position of a frequency along the axis: 0 at the low limit, 1 at the high one
+    float proportionOfFrequency(float hz) const;
+
+    size_t size() const { return m_bands.size(); }
+    const std::vector<Band>& bands() const { return m_bands; }
+    float minHz() const { return m_minHz; }
+    float maxHz() const { return m_maxHz; }
+    int fftSize() const { return m_fftSize; }
+    double sampleRate() const { return m_sampleRate; }
+
+private:
+    std::vector<Band> m_bands;
+    float m_minHz = 20.0f;
+    float m_maxHz = 20000.0f;
+    float m_logMin = 0.0f;
+    float m_logRange = 1.0f;
+    int m_fftSize = 0;
+    double m_sampleRate = 0.0;
+};
+
+} // namespace core
+} // namespace quiet
@@ -156,7 +156,10 @@ private:
     mutable std::mutex m_statsMutex;
     NoiseReductionStats m_stats;
     
-    // Performance monitoring
+    // Performance monitoring. Span names are registered on the constructing
+    // thread; process() runs on the audio thread.
+    const uint32_t m_bufferSpanId;
+    const uint32_t m_frameSpanId;
     std::atomic<float> m_cpuUsage{0.0f};
     std::atomic<float> m_latency{0.0f};
     uint64_t m_lastProcessingTime{0};
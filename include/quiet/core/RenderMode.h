@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace quiet {
+namespace core {
+
+// How the visualizations are rasterized; see ui::VisualizationRenderer
+enum class RenderMode {
+    Software,
+    OpenGL,
+    Auto
+};
+
+// "software", "opengl" or "auto" (the ui.render_mode config value), in any
+// case; anything else is Auto
+RenderMode parseRenderMode(std::string_view text);
+const char* renderModeName(RenderMode mode);
+
+// True for GL_RENDERER strings of drivers that rasterize on the CPU (Mesa
+// llvmpipe, softpipe, swrast, SwiftShader, Microsoft GDI Generic)
+bool isSoftwareRasterizer(std::string_view rendererName);
+
+/**
+ * @brief Process CPU share and frame rate over fixed windows
+ *
+ * Fed cumulative process CPU seconds, a wall clock and a frame count once
+ * per frame; each time a window has elapsed it closes it and reports the
+ * CPU used as a percentage of one core, and the frames per second. Used to
+ * compare render modes on the same machine under the same audio load.
+ */
+class RenderCpuMeter {
+public:
+    explicit RenderCpuMeter(double windowSeconds = 10.0) : m_windowSeconds(windowSeconds) {}
+
+    // Whether the next sample() can close a window; lets callers skip
+    // reading the CPU time on the other frames
+    bool isDue(double wallSeconds) const { return !m_started || wallSeconds - m_startWall >= m_windowSeconds; }
+
+    // True when this sample closed a window; the first sample only starts one
+    bool sample(double cpuSeconds, double wallSeconds, uint64_t frameCount);
+
+    double cpuPercent() const { return m_cpuPercent; }
+    double framesPerSecond() const { return m_framesPerSecond; }
+
+private:
+    double m_windowSeconds;
+    bool m_started = false;
+    double m_startCpu = 0.0;
+    double m_startWall = 0.0;
+    uint64_t m_startFrames = 0;
+    double m_cpuPercent = 0.0;
+    double m_framesPerSecond = 0.0;
+};
+
+} // namespace core
+} // namespace quiet
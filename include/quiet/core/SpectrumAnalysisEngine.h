@@ -0,0 +1,127 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "quiet/utils/SpscRingBuffer.h"
+#include "quiet/utils/TripleBuffer.h"
+
+namespace quiet {
+namespace core {
+
+/**
+ * @brief One finished magnitude spectrum
+ */
+struct SpectrumFrame {
+    std::vector<float> magnitudesDb;   // fftSize / 2 bins; a full-scale sine reads 0 dB
+    double sampleRate = 0.0;           // Of the samples analysed, 0 if unknown
+    int fftSize = 0;
+    uint64_t sequence = 0;             // Frames analysed before and including this one
+};
+
+/**
+ * @brief Streaming overlap-add spectrum analysis on a background thread
+ *
+ * Samples arrive in blocks of any size and collect in a ring; every hopSize
+ * samples the analysis thread windows the most recent fftSize of them,
+ * transforms them and publishes the magnitudes through a triple buffer. The
+ * painting side picks up the latest frame without waiting on the FFT, and
+ * skips frames if it paints less often than the hop rate. Readers that need
+ * every frame, such as a spectrogram, can have frames queued as well, so one
+ * FFT per hop serves both.
+ *
+ * One thread pushes samples and one thread reads frames; settings and
+ * start/stop belong to the owner.
+ */
+class SpectrumAnalysisEngine {
+public:
+    struct Settings {
+        int fftSize = 2048;   // Rounded up to a power of two, 256..16384
+        int hopSize = 512;    // Samples between frames; 512 of 2048 is 75% overlap
+        int queuedFrames = 0; // Frames kept for popQueuedFrame(); 0 keeps none
+    };
+
+    static constexpr float kFloorDb = -120.0f;
+
+    SpectrumAnalysisEngine();
+    explicit SpectrumAnalysisEngine(const Settings& settings);
+    ~SpectrumAnalysisEngine();
+
+    SpectrumAnalysisEngine(const SpectrumAnalysisEngine&) = delete;
+    SpectrumAnalysisEngine& operator=(const SpectrumAnalysisEngine&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_relaxed); }
+
+    // Restarts the thread if it was running; samples not yet analysed are dropped
+    void setSettings(const Settings& settings);
+    Settings getSettings() const { return m_settings; }
+
+    // Producer side. Never blocks; samples are dropped if the analysis thread
+    // has fallen a whole ring behind.
+    void pushSamples(const float* samples, size_t count, double sampleRate);
+
+    // Analyses every complete hop pushed so far on the calling thread; for use
+    // while the engine is stopped (tests, offline analysis)
+    void processPending();
+
+    // Consumer side: takes the latest published frame; true if it is new
+    bool updateFrame() noexcept { return m_frames.update(); }
+    const SpectrumFrame& getFrame() const noexcept { return m_frames.readBuffer(); }
+
+    // Consumer side, with queuedFrames set: copies the oldest unread frame's
+    // fftSize / 2 magnitudes; false if none is queued. Frames that find the
+    // queue full are dropped whole.
+    bool popQueuedFrame(float* magnitudesDb) noexcept;
+
+    // Of the most recent samples pushed, 0 if unknown
+    double getSampleRate() const { return m_sampleRate.load(std::memory_order_relaxed); }
+
+    uint64_t getFramesAnalyzed() const { return m_framesAnalyzed.load(std::memory_order_relaxed); }
+    uint64_t getDroppedSamples() const { return m_droppedSamples.load(std::memory_order_relaxed); }
+    uint64_t getDroppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+
+private:
+    void configure(const Settings& settings);
+    void analysisThread();
+    void analyseFrame();
+
+    Settings m_settings;
+    float m_magnitudeScale = 1.0f;
+
+    // Producer to analysis thread
+    std::unique_ptr<utils::SpscRingBuffer<float>> m_input;
+    std::atomic<double> m_sampleRate{0.0};
+    std::atomic<uint64_t> m_droppedSamples{0};
+
+    // Analysis thread only
+    std::unique_ptr<juce::dsp::FFT> m_fft;
+    std::vector<float> m_window;
+    std::vector<float> m_history;       // Most recent fftSize samples, oldest first
+    std::vector<float> m_hopBuffer;     // Samples of the hop being collected
+    std::vector<float> m_fftData;       // 2 * fftSize, as juce::dsp::FFT requires
+    int m_hopFill = 0;
+    std::atomic<uint64_t> m_framesAnalyzed{0};
+
+    // Analysis thread to consumer
+    utils::TripleBuffer<SpectrumFrame> m_frames;
+    std::unique_ptr<utils::SpscRingBuffer<float>> m_queue;   // Whole frames of magnitudes
+    std::atomic<uint64_t> m_droppedFrames{0};
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_wakeRequested = false;
+    bool m_stopRequested = false;
+};
+
+} // namespace core
+} // namespace quiet
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "quiet/utils/SpscRingBuffer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace quiet {
+namespace core {
+
+class AudioBuffer;
+
+/**
+ * @brief Wait-free sample FIFOs from the audio thread to the visualizers
+ *
+ * The audio callback writes each processed block's input and output samples
+ * (channel 0) into a preallocated SPSC ring per source; the UI drains
+ * whatever has arrived on its own timer. Writing never locks, allocates or
+ * posts a message, so it is safe from real-time threads. When the UI falls
+ * behind and a ring fills up, the samples that do not fit are dropped and
+ * counted, and the audio thread carries on.
+ *
+ * Each source has exactly one writer and one reader thread.
+ */
+class VisualizationTap {
+public:
+    enum class Source : uint8_t {
+        Input = 0,
+        Output = 1
+    };
+
+    // About 340 ms at 48 kHz: several UI frames of slack
+    static constexpr size_t kDefaultCapacity = 16384;
+
+    explicit VisualizationTap(size_t capacity = kDefaultCapacity);
+
+    VisualizationTap(const VisualizationTap&) = delete;
+    VisualizationTap& operator=(const VisualizationTap&) = delete;
+
+    // Audio thread: writes channel 0 of the block and records its sample rate
+    void write(Source source, const AudioBuffer& buffer) noexcept;
+    void write(Source source, const float* samples, size_t count) noexcept;
+
+    // UI thread: takes up to maxSamples of the oldest samples not yet read
+    size_t read(Source source, float* destination, size_t maxSamples) noexcept;
+
+    size_t available(Source source) const noexcept;
+    size_t capacity() const noexcept { return m_streams[0].samples.capacity(); }
+
+    // A disabled tap ignores writes, so nothing is copied while no one watches
+    void setEnabled(bool enabled) noexcept { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Sample rate of the most recent block written, 0 before the first one
+    double getSampleRate() const noexcept { return m_sampleRate.load(std::memory_order_relaxed); }
+
+    uint64_t getWrittenSamples(Source source) const noexcept;
+    uint64_t getDroppedSamples(Source source) const noexcept;
+
+private:
+    struct Stream {
+        explicit Stream(size_t capacity) : samples(capacity) {}
+
+        utils::SpscRingBuffer<float> samples;
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    Stream& stream(Source source) noexcept { return m_streams[static_cast<size_t>(source)]; }
+    const Stream& stream(Source source) const noexcept { return m_streams[static_cast<size_t>(source)]; }
+
+    Stream m_streams[2];
+    std::atomic<bool> m_enabled{true};
+    std::atomic<double> m_sampleRate{0.0};
+};
+
+} // namespace core
+} // namespace quiet
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace quiet {
+namespace core {
+
+/**
+ * @brief Multi-resolution min/max history of a sample stream
+ *
+ * Level 0 holds one min/max pair per sample; each level above merges four
+ * pairs of the one below, so level k summarises 4^k samples per pair. All
+ * levels are circular and updated incrementally as samples arrive, at an
+ * amortised cost of about 1.33 pair writes per sample.
+ *
+ * getPeaks() reads each display column from the coarsest level that is
+ * still at least as fine as the column, so a column merges at most a
+ * handful of pairs whatever the span: drawing is O(columns) for a 100 ms
+ * window or a 30 s one. Fine levels keep only the recent past (the part a
+ * zoomed-in view can show), so 30 s at 48 kHz takes about 1 MB.
+ *
+ * Not thread-safe: add and read from one thread, or lock around both.
+ */
+class WaveformPeakCache {
+public:
+    struct Peak {
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+
+    explicit WaveformPeakCache(size_t historySamples);
+
+    void addSamples(const float* samples, size_t count);
+
+    // Peaks for `columns` equal slices of the most recent spanSamples
+    // samples, oldest first. The span ends on the last pair completed at the
+    // level read, so the newest few samples (under a quarter of a column)
+    // show up on a later call. Slices with no samples left in the history
+    // read as {0, 0}.
+    void getPeaks(size_t spanSamples, Peak* peaks, size_t columns) const;
+
+    void clear();
+
+    size_t historySamples() const { return m_historySamples; }
+    uint64_t totalSamples() const { return m_totalSamples; }
+    size_t levelCount() const { return m_levels.size(); }
+
+    // Peaks a fine level keeps; levels whose pairs cover more samples keep less
+    static constexpr size_t kMaxPeaksPerLevel = 32768;
+    static constexpr uint64_t kFanOut = 4;
+
+private:
+    struct Level {
+        uint64_t samplesPerPeak = 1;
+        std::vector<Peak> peaks;     // Ring of completed pairs, power-of-two sized
+        uint64_t mask = 0;
+        uint64_t completed = 0;      // Pairs completed so far
+        Peak partial;                // Merged pairs of the level below, not yet a whole pair here
+        uint64_t partialCount = 0;
+    };
+
+    void pushPeak(size_t level, const Peak& peak);
+
+    size_t m_historySamples;
+    uint64_t m_totalSamples = 0;
+    std::vector<Level> m_levels;
+};
+
+} // namespace core
+} // namespace quiet
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace quiet {
+namespace ui {
+
+/**
+ * @brief One display-synchronised frame clock for all visualizations
+ *
+ * Ticks from a juce::VBlankAttachment on the host component, thinned out to
+ * the configured rate (ui.visualization_fps), so every view updates in the
+ * same vblank instead of on its own timer. Each tick first lets every client
+ * pull in new data, in the order they were added, then repaints only the
+ * components whose frame generation moved since they were last painted.
+ *
+ * stop() releases the vblank attachment, so nothing runs at all while the
+ * window is hidden or minimised. Message thread only.
+ */
+class FrameScheduler
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+        
+        // Pulls in whatever arrived since the last frame; frameSeconds is the
+        // time since then, for animations
+        virtual void prepareFrame(double frameSeconds) { juce::ignoreUnused(frameSeconds); }
+        
+        // Advances whenever what the client draws changes
+        virtual uint64_t getFrameGeneration() const { return 0; }
+    };
+    
+    static constexpr int kDefaultFrameRate = 30;
+    
+    FrameScheduler();
+    ~FrameScheduler();
+    
+    // component is repainted when the client's generation moves; nullptr for
+    // clients that only feed others, which should be added first
+    void addClient(Client& client, juce::Component* component);
+    void removeClient(Client& client);
+    
+    // Clamped to 1..240 frames per second
+    void setFrameRate(int framesPerSecond);
+    int getFrameRate() const { return m_frameRate; }
+    
+    void start(juce::Component& host);
+    void stop();
+    bool isRunning() const { return m_vblank != nullptr; }
+    
+    uint64_t getFrameCount() const { return m_frameCount; }
+    uint64_t getSkippedRepaints() const { return m_skippedRepaints; }
+    
+private:
+    struct Entry
+    {
+        Client* client = nullptr;
+        juce::Component::SafePointer<juce::Component> component;
+        uint64_t paintedGeneration = 0;
+        bool painted = false;
+    };
+    
+    void onVBlank();
+    void tick(double frameSeconds);
+    
+    std::vector<Entry> m_clients;
+    std::unique_ptr<juce::VBlankAttachment> m_vblank;
+    
+    int m_frameRate = kDefaultFrameRate;
+    double m_nextFrameMs = 0.0;
+    double m_lastFrameMs = 0.0;
+    
+    uint64_t m_frameCount = 0;
+    uint64_t m_skippedRepaints = 0;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameScheduler)
+};
+
+} // namespace ui
+} // namespace quiet
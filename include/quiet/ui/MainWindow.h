@@ -16,11 +16,13 @@
 #include <JuceHeader.h>
 #include <memory>
 #include "../interfaces/IAudioEventListener.h"
+#include "quiet/ui/FrameScheduler.h"
 
 // Forward declarations
 class AudioDeviceManager;
 class ConfigurationManager;
 class EventDispatcher;
+class VisualizationTap;
 
 //==============================================================================
 /**
@@ -38,7 +40,8 @@ public:
     //==============================================================================
     /** Constructor */
     MainWindow(juce::String name, AudioDeviceManager& audioDeviceManager,
-               ConfigurationManager& configManager, EventDispatcher& eventDispatcher);
+               ConfigurationManager& configManager, EventDispatcher& eventDispatcher,
+               VisualizationTap& visualizationTap);
     
     /** Destructor */
     ~MainWindow() override;
@@ -47,12 +50,17 @@ public:
     /** Factory method to create the main window */
     static std::unique_ptr<MainWindow> create(AudioDeviceManager& audioDeviceManager,
                                               ConfigurationManager& configManager,
-                                              EventDispatcher& eventDispatcher);
+                                              EventDispatcher& eventDispatcher,
+                                              VisualizationTap& visualizationTap);
     
     //==============================================================================
     /** DocumentWindow overrides */
     void closeButtonPressed() override;
     
+    /** Component overrides; report WindowShown / WindowHidden */
+    void visibilityChanged() override;
+    void minimisationStateChanged(bool isNowMinimised) override;
+    
     /** KeyListener overrides */
     bool keyPressed(const juce::KeyPress& key, juce::Component* originatingComponent) override;
     
@@ -74,6 +82,9 @@ public:
     /** Get the event dispatcher reference */
     EventDispatcher& getEventDispatcher() { return eventDispatcher; }
     
+    /** Get the audio-to-UI sample tap feeding the visualizations */
+    VisualizationTap& getVisualizationTap() { return visualizationTap; }
+    
 private:
     //==============================================================================
     /** Internal component class that contains all UI elements */
@@ -84,6 +95,7 @@ private:
     AudioDeviceManager& audioDeviceManager;
     ConfigurationManager& configManager;
     EventDispatcher& eventDispatcher;
+    VisualizationTap& visualizationTap;
     
     /** UI components */
     std::unique_ptr<MainContentComponent> mainComponent;
@@ -94,6 +106,10 @@ private:
     /** Initialize system tray functionality */
     void initializeSystemTray();
     
+    /** Publishes WindowShown or WindowHidden when the window's on-screen state flips */
+    void publishWindowVisibility();
+    bool windowShown = false;
+    
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainWindow)
 };
@@ -116,15 +132,18 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModernToggleButton)
 };
 
-/** Animated level meter component */
-class AnimatedLevelMeter : public juce::Component, public juce::Timer
+/** Animated level meter component, stepped by the FrameScheduler */
+class AnimatedLevelMeter : public juce::Component, public quiet::ui::FrameScheduler::Client
 {
 public:
     AnimatedLevelMeter();
     ~AnimatedLevelMeter() override;
     
     void paint(juce::Graphics& g) override;
-    void timerCallback() override;
+    
+    /** FrameScheduler::Client; only moves the generation while the bar animates */
+    void prepareFrame(double frameSeconds) override;
+    uint64_t getFrameGeneration() const override { return generation; }
     
     void setLevel(float newLevel);
     void setPeakLevel(float peak);
@@ -134,6 +153,7 @@ private:
     float targetLevel = 0.0f;
     float peakLevel = 0.0f;
     float peakHoldTime = 0.0f;
+    uint64_t generation = 0;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnimatedLevelMeter)
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "quiet/core/LogFrequencyBands.h"
+#include "quiet/core/SpectrumAnalysisEngine.h"
+#include "quiet/ui/FrameScheduler.h"
+#include <array>
+#include <vector>
+
+namespace quiet {
+namespace ui {
+
+/**
+ * @brief Scrolling time-frequency waterfall of the input above the output
+ *
+ * Each analysis frame the engines queue becomes one pixel column, written
+ * through a colour lookup table into an image used as a ring: the newest
+ * column overwrites the oldest. Painting blits the two halves of the ring
+ * either side of the write position, so history is never recomputed.
+ * Rows are log-spaced frequency bands, low frequencies at the bottom.
+ *
+ * The engines need Settings::queuedFrames set; the spectrum view reads the
+ * latest frame of the same input engine, so the FFT runs once per hop.
+ * Frames are drained once per FrameScheduler tick.
+ */
+class SpectrogramDisplay : public juce::Component, public FrameScheduler::Client
+{
+public:
+    SpectrogramDisplay(core::SpectrumAnalysisEngine& inputEngine,
+                       core::SpectrumAnalysisEngine& outputEngine);
+    ~SpectrogramDisplay() override;
+    
+    void clear();
+    
+    // Component overrides
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    
+    // FrameScheduler::Client
+    void prepareFrame(double frameSeconds) override;
+    uint64_t getFrameGeneration() const override { return m_generation; }
+    
+private:
+    struct Lane
+    {
+        core::SpectrumAnalysisEngine& engine;
+        juce::String title;
+        juce::Rectangle<int> area;
+        juce::Image image;              // Column ring, one column per frame
+        int writeColumn = 0;            // Next column to write, the oldest on screen
+        core::LogFrequencyBands rows;
+        std::vector<float> frameDb;     // Scratch for one queued frame
+        std::vector<float> rowDb;
+    };
+    
+    bool drainFrames(Lane& lane);
+    void resetLane(Lane& lane);
+    void paintLane(juce::Graphics& g, const Lane& lane) const;
+    
+    static constexpr float m_minDb = -100.0f;
+    static constexpr float m_maxDb = 0.0f;
+    static constexpr int m_lutSize = 256;
+    
+    std::array<Lane, 2> m_lanes;
+    std::array<juce::Colour, m_lutSize> m_lut;
+    uint64_t m_generation = 0;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramDisplay)
+};
+
+} // namespace ui
+} // namespace quiet
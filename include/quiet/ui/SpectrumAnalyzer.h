@@ -2,7 +2,10 @@
 
 #include <JuceHeader.h>
 #include "quiet/core/AudioBuffer.h"
-#include <array>
+#include "quiet/core/LogFrequencyBands.h"
+#include "quiet/core/SpectrumAnalysisEngine.h"
+#include "quiet/ui/FrameScheduler.h"
+#include <vector>
 
 namespace quiet {
 namespace ui {
@@ -10,15 +13,23 @@ namespace ui {
 /**
  * @brief Simple spectrum analyzer component
  * 
- * Displays frequency spectrum using FFT analysis with basic bar visualization.
+ * Displays the frames of a SpectrumAnalysisEngine as bars on a log-frequency
+ * axis. The FFT runs on the engine's thread; this component only picks up
+ * the latest finished frame, so painting never waits on the analysis.
+ *
+ * Everything that depends only on the size, sample rate and FFT size (the
+ * bin-to-bar mapping, bar colours, grid and labels) is computed when one of
+ * those changes; painting a frame is one image blit and a rectangle per bar.
+ * Driven by the FrameScheduler, which repaints it only after a new frame.
  */
-class SpectrumAnalyzer : public juce::Component, private juce::Timer
+class SpectrumAnalyzer : public juce::Component, public FrameScheduler::Client
 {
 public:
-    SpectrumAnalyzer(const juce::Colour& barColor = juce::Colours::cyan);
+    SpectrumAnalyzer(core::SpectrumAnalysisEngine& engine,
+                     const juce::Colour& barColor = juce::Colours::cyan);
     ~SpectrumAnalyzer() override;
     
-    // Update the spectrum with new audio data
+    // Feed audio data to the analysis engine
     void updateSpectrum(const core::AudioBuffer& buffer);
     
     // Clear the display
@@ -31,23 +42,33 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
     
+    // FrameScheduler::Client
+    void prepareFrame(double frameSeconds) override;
+    uint64_t getFrameGeneration() const override { return m_generation; }
+    
 private:
-    void timerCallback() override;
-    void createWindow();
+    void rebuildLayout();
+    void renderBackground();
+    
+    static constexpr int m_barPitch = 4;       // Pixels per bar, including the gap
+    static constexpr float m_minDb = -60.0f;
+    static constexpr float m_maxDb = 0.0f;
     
-    static constexpr int m_fftOrder = 11;
-    static constexpr int m_fftSize = 1 << m_fftOrder; // 2048
+    core::SpectrumAnalysisEngine& m_engine;
+    core::LogFrequencyBands m_bands;
+    int m_fftSize = 0;
+    double m_sampleRate = 0.0;
     
-    juce::dsp::FFT m_forwardFFT;
-    std::array<float, m_fftSize * 2> m_fftData;
-    std::array<float, m_fftSize / 2> m_smoothedMagnitudes;
-    std::array<float, m_fftSize> m_window;
+    std::vector<float> m_frameBandDb;          // Latest frame, one value per bar
+    std::vector<float> m_smoothedDb;
+    std::vector<juce::Colour> m_barColours;
+    juce::Image m_background;                  // Grid and labels
     
     juce::Colour m_barColor;
-    juce::CriticalSection m_fftLock;
+    uint64_t m_generation = 0;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
 };
 
 } // namespace ui
-} // namespace quiet
\ No newline at end of file
+} // namespace quiet
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <juce_opengl/juce_opengl.h>
+#include "quiet/core/RenderMode.h"
+#include <atomic>
+
+namespace quiet {
+namespace ui {
+
+/**
+ * @brief Chooses how the visualizations are rasterized and owns the GL context
+ *
+ * In OpenGL mode an OpenGLContext is attached to the window content (level
+ * meters and visualization tabs alike) and JUCE draws that component tree
+ * through its GL renderer: fills and lines are batched into vertex buffers
+ * and cached images (the spectrum grid) become textures, all on the
+ * context's render thread. The components keep a single paint() path, so
+ * Software mode is the same code on the CPU rasterizer.
+ *
+ * Auto uses OpenGL when a hardware context comes up and falls back to
+ * software when no context is created or the driver is itself a software
+ * rasterizer (Mesa llvmpipe, softpipe, SwiftShader, Microsoft GDI), where
+ * emulated GL costs more CPU than JUCE's own renderer. OpenGL forces GL
+ * even on those drivers, e.g. to test the GL path on machines without a GPU.
+ *
+ * Message thread only, except for the OpenGLRenderer callbacks.
+ */
+class VisualizationRenderer : private juce::OpenGLRenderer
+{
+public:
+    using Mode = core::RenderMode;
+    
+    VisualizationRenderer();
+    ~VisualizationRenderer() override;
+    
+    void attachTo(juce::Component& target, Mode mode);
+    void detach();
+    
+    // Call once per frame. At debug log level, logs the process CPU share
+    // and frame rate every 10 s with the active renderer, so render modes can
+    // be compared on one machine (ui.render_mode software against opengl).
+    void reportCpuUsage(uint64_t frameCount);
+    
+    bool isUsingOpenGL() const { return m_usingOpenGL; }
+    
+    // GL_RENDERER of the context, empty until one has been created
+    juce::String getRendererName() const;
+    
+private:
+    void newOpenGLContextCreated() override;
+    void renderOpenGL() override;
+    void openGLContextClosing() override;
+    
+    void fallBackToSoftware(const juce::String& reason);
+    
+    // How long Auto waits for a context before giving up on OpenGL
+    static constexpr int m_contextTimeoutMs = 2000;
+    
+    juce::OpenGLContext m_context;
+    Mode m_mode = Mode::Software;
+    bool m_usingOpenGL = false;
+    std::atomic<bool> m_contextCreated{false};
+    
+    juce::CriticalSection m_nameLock;
+    juce::String m_rendererName;
+    
+    core::RenderCpuMeter m_cpuMeter;
+    
+    JUCE_DECLARE_WEAK_REFERENCEABLE(VisualizationRenderer)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VisualizationRenderer)
+};
+
+} // namespace ui
+} // namespace quiet
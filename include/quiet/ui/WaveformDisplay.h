@@ -2,6 +2,10 @@
 
 #include <JuceHeader.h>
 #include "quiet/core/AudioBuffer.h"
+#include "quiet/core/WaveformPeakCache.h"
+#include "quiet/ui/FrameScheduler.h"
+#include <atomic>
+#include <vector>
 
 namespace quiet {
 namespace ui {
@@ -10,8 +14,11 @@ namespace ui {
  * @brief Simple waveform display component
  * 
  * Displays audio waveforms with basic rendering for input/output visualization.
+ * Samples go into a min/max peak cache as they arrive, so drawing costs
+ * O(width) whether the visible span is 4096 samples or the full 30 s history.
+ * Repainted by the FrameScheduler when new samples have arrived.
  */
-class WaveformDisplay : public juce::Component, private juce::Timer
+class WaveformDisplay : public juce::Component, public FrameScheduler::Client
 {
 public:
     WaveformDisplay(const juce::String& title = "Waveform", 
@@ -21,26 +28,38 @@ public:
     // Update the display with new audio data
     void updateBuffer(const core::AudioBuffer& buffer);
     
+    // Append mono samples, e.g. drained from the visualization tap
+    void pushSamples(const float* samples, int numSamples);
+    
     // Clear the display
     void clear();
     
     // Set waveform color
     void setWaveformColor(const juce::Colour& color);
     
+    // How many of the most recent samples span the width, up to the history
+    void setVisibleSamples(int numSamples);
+    int getVisibleSamples() const { return m_visibleSamples; }
+    
     // Component overrides
     void paint(juce::Graphics& g) override;
     void resized() override;
     
-private:
-    void timerCallback() override;
+    // FrameScheduler::Client
+    uint64_t getFrameGeneration() const override { return m_generation.load(std::memory_order_relaxed); }
     
+private:
     juce::String m_title;
     juce::Colour m_waveformColor;
-    juce::AudioBuffer<float> m_audioBuffer;
     juce::CriticalSection m_bufferLock;
     
+    static constexpr int m_historySamples = 30 * 48000;
+    core::WaveformPeakCache m_peakCache{m_historySamples};
+    std::vector<core::WaveformPeakCache::Peak> m_columnPeaks;
+    int m_visibleSamples = 4096;
+    
     float m_currentLevel = 0.0f;
-    static constexpr int m_bufferSize = 4096;
+    std::atomic<uint64_t> m_generation{0};
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
 };
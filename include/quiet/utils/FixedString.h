@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief Inline, trivially copyable string of at most N-1 characters
+ *
+ * Used where text must travel inside fixed-size records (event payloads,
+ * lock-free ring slots) without touching the heap. Longer input is truncated.
+ */
+template<size_t N>
+class FixedString {
+    static_assert(N > 1 && N <= 65536, "FixedString capacity out of range");
+
+public:
+    FixedString() = default;
+    FixedString(const char* text) { assign(text, text ? std::strlen(text) : 0); }
+    FixedString(const std::string& text) { assign(text.data(), text.size()); }
+
+    void assign(const char* text, size_t length) {
+        m_size = static_cast<uint16_t>(std::min(length, N - 1));
+        if (m_size > 0) {
+            std::memcpy(m_data, text, m_size);
+        }
+        m_data[m_size] = '\0';
+    }
+
+    const char* c_str() const noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    static constexpr size_t capacity() noexcept { return N - 1; }
+
+    std::string str() const { return std::string(m_data, m_size); }
+
+    bool operator==(const FixedString& other) const noexcept {
+        return m_size == other.m_size && std::memcmp(m_data, other.m_data, m_size) == 0;
+    }
+    bool operator!=(const FixedString& other) const noexcept { return !(*this == other); }
+
+private:
+    char m_data[N]{};
+    uint16_t m_size{0};
+};
+
+} // namespace utils
+} // namespace quiet
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief High dynamic range histogram of integer values
+ *
+ * Values from 1 up to highestTrackableValue are counted in log-linear
+ * buckets that keep the given number of significant decimal digits, so a
+ * histogram of nanosecond durations is as precise at 50 ns as at 5 s while
+ * using a fixed, small amount of memory (about 30 KB for one minute at two
+ * digits). Recording is a few shifts and an increment and never allocates.
+ * Larger values are clamped to the highest trackable value.
+ *
+ * Not thread-safe; aggregate per thread and merge().
+ */
+class HdrHistogram {
+public:
+    explicit HdrHistogram(uint64_t highestTrackableValue, int significantDigits = 2) {
+        significantDigits = std::clamp(significantDigits, 1, 5);
+        m_highestTrackableValue = std::max<uint64_t>(highestTrackableValue, 2);
+
+        // Enough sub-buckets to tell apart values that differ in the last digit
+        auto largestSingleUnitValue = static_cast<uint64_t>(2 * std::pow(10.0, significantDigits));
+        int subBucketCountMagnitude = 0;
+        while ((uint64_t(1) << subBucketCountMagnitude) < largestSingleUnitValue) {
+            ++subBucketCountMagnitude;
+        }
+        m_subBucketHalfCountMagnitude = std::max(subBucketCountMagnitude, 1) - 1;
+        m_subBucketCount = uint64_t(1) << (m_subBucketHalfCountMagnitude + 1);
+        m_subBucketHalfCount = m_subBucketCount / 2;
+        m_subBucketMask = m_subBucketCount - 1;
+
+        // Each bucket doubles the range covered by the previous one
+        int bucketCount = 1;
+        uint64_t smallestUntrackable = m_subBucketCount;
+        while (smallestUntrackable <= m_highestTrackableValue && smallestUntrackable < (uint64_t(1) << 62)) {
+            smallestUntrackable <<= 1;
+            ++bucketCount;
+        }
+        m_counts.assign(static_cast<size_t>(bucketCount + 1) * m_subBucketHalfCount, 0);
+    }
+
+    void record(uint64_t value, uint64_t count = 1) noexcept {
+        value = std::min(value, m_highestTrackableValue);
+        m_counts[countsIndex(value)] += count;
+        m_totalCount += count;
+        m_sum += static_cast<double>(value) * static_cast<double>(count);
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    // Both histograms must have been created with the same arguments
+    void merge(const HdrHistogram& other) noexcept {
+        if (other.m_counts.size() != m_counts.size() || other.m_totalCount == 0) {
+            return;
+        }
+        for (size_t i = 0; i < m_counts.size(); ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_totalCount += other.m_totalCount;
+        m_sum += other.m_sum;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    void reset() noexcept {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_totalCount = 0;
+        m_sum = 0;
+        m_min = UINT64_MAX;
+        m_max = 0;
+    }
+
+    uint64_t count() const noexcept { return m_totalCount; }
+    uint64_t min() const noexcept { return m_totalCount ? m_min : 0; }
+    uint64_t max() const noexcept { return m_max; }
+    double mean() const noexcept { return m_totalCount ? m_sum / static_cast<double>(m_totalCount) : 0.0; }
+
+    // Smallest value that percentile (0-100) percent of recorded values are
+    // at or below, to the histogram's precision
+    uint64_t valueAtPercentile(double percentile) const noexcept {
+        if (m_totalCount == 0) {
+            return 0;
+        }
+
+        percentile = std::clamp(percentile, 0.0, 100.0);
+        auto target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(m_totalCount)));
+        target = std::max<uint64_t>(target, 1);
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < m_counts.size(); ++i) {
+            cumulative += m_counts[i];
+            if (cumulative >= target) {
+                return std::min(highestEquivalentValue(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    size_t memoryFootprint() const noexcept {
+        return m_counts.size() * sizeof(uint64_t);
+    }
+
+private:
+    size_t countsIndex(uint64_t value) const noexcept {
+        // Bucket from the position of the highest set bit; small values share bucket 0
+        int bucketIndex = 64 - countLeadingZeros(value | m_subBucketMask) - (m_subBucketHalfCountMagnitude + 1);
+        auto subBucketIndex = static_cast<size_t>(value >> bucketIndex);
+        return (static_cast<size_t>(bucketIndex + 1) << m_subBucketHalfCountMagnitude) +
+               (subBucketIndex - m_subBucketHalfCount);
+    }
+
+    uint64_t highestEquivalentValue(size_t index) const noexcept {
+        int bucketIndex = static_cast<int>(index >> m_subBucketHalfCountMagnitude) - 1;
+        uint64_t subBucketIndex = (index & (m_subBucketHalfCount - 1)) + m_subBucketHalfCount;
+        if (bucketIndex < 0) {
+            subBucketIndex -= m_subBucketHalfCount;
+            bucketIndex = 0;
+        }
+        uint64_t lowest = subBucketIndex << bucketIndex;
+        return lowest + (uint64_t(1) << bucketIndex) - 1;
+    }
+
+    static int countLeadingZeros(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#else
+        int zeros = 0;
+        for (uint64_t bit = uint64_t(1) << 63; bit && !(value & bit); bit >>= 1) {
+            ++zeros;
+        }
+        return zeros;
+#endif
+    }
+
+    uint64_t m_highestTrackableValue = 0;
+    int m_subBucketHalfCountMagnitude = 0;
+    uint64_t m_subBucketCount = 0;
+    uint64_t m_subBucketHalfCount = 0;
+    uint64_t m_subBucketMask = 0;
+
+    std::vector<uint64_t> m_counts;
+    uint64_t m_totalCount = 0;
+    double m_sum = 0;
+    uint64_t m_min = UINT64_MAX;
+    uint64_t m_max = 0;
+};
+
+} // namespace utils
+} // namespace quiet
@@ -3,18 +3,27 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <initializer_list>
 #include <iomanip>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
+#include "quiet/utils/FixedString.h"
+#include "quiet/utils/MpscRingBuffer.h"
+#include "quiet/utils/PerfSpan.h"
+#include "quiet/utils/RemoteLogSink.h"
 
 namespace quiet {
 namespace utils {
@@ -28,7 +37,14 @@ enum class LogLevel {
     CRITICAL = 4
 };
 
-// Log entry structure
+// How the file sink (and the remote sink, for anything but Text) writes records
+enum class LogOutputFormat {
+    Text,       // Formatter output, one line per record
+    JsonLines,  // One JSON object per line
+    Binary      // Length-prefixed records, see StructuredLog.h; read with quiet_log_decode
+};
+
+// Log entry structure, as seen by formatters and sinks
 struct LogEntry {
     std::chrono::system_clock::time_point timestamp;
     LogLevel level;
@@ -40,6 +56,220 @@ struct LogEntry {
     std::unordered_map<std::string, std::string> context;
 };
 
+// Static description of one LOGF_* call site. Deferred records carry a
+// pointer to it plus the raw arguments; the text is built on the worker.
+struct LogFormatSite {
+    LogLevel level;
+    const char* format;      // "{}" placeholders, "{{" and "}}" for braces
+    const char* file;        // File name without directories
+    const char* function;
+    int line;
+};
+
+// Fixed-size record stored in the log queue. The call site writes straight
+// into a preallocated slot, so logging never allocates; text longer than a
+// field is truncated. The worker turns records back into LogEntry.
+struct LogRecord {
+    std::chrono::system_clock::time_point timestamp;
+    LogLevel level = LogLevel::INFO;
+    std::thread::id threadId;
+    int line = 0;
+    const LogFormatSite* site = nullptr;  // LOGF_* records: message holds encoded arguments
+    FixedString<48> file;        // File name without directories
+    FixedString<64> function;
+    FixedString<256> message;
+    FixedString<160> context;    // Encoded key/value fields, see LogFieldReader
+};
+
+namespace detail {
+
+// Compile-time helpers for the LOGF_* macros
+constexpr size_t countLogPlaceholders(const char* format) {
+    size_t count = 0;
+    for (const char* p = format; *p; ++p) {
+        if (*p == '{') {
+            if (p[1] == '{') {
+                ++p;
+            } else {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+constexpr const char* logFileBaseName(const char* path) {
+    const char* name = path;
+    for (const char* p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') {
+            name = p + 1;
+        }
+    }
+    return name;
+}
+
+enum class LogArgType : uint8_t {
+    Bool,
+    Char,
+    Int,
+    UInt,
+    Double,
+    String,   // uint16_t length followed by the bytes
+    Pointer
+};
+
+/**
+ * @brief Packs LOGF_* arguments as tagged raw bytes
+ *
+ * Scalars are copied as-is and strings are copied with a length prefix, so
+ * the caller never formats anything. Arguments that no longer fit are left
+ * out and show up as "?" in the formatted message.
+ */
+class LogArgEncoder {
+public:
+    LogArgEncoder(char* buffer, size_t capacity) noexcept
+        : m_buffer(buffer), m_capacity(capacity) {}
+
+    size_t size() const noexcept { return m_size; }
+
+    // Field keys: uint8_t length followed by the bytes. A key is only
+    // written if a scalar value still fits after it.
+    void addKey(std::string_view key) noexcept {
+        size_t length = std::min<size_t>(key.size(), UINT8_MAX);
+        if (m_size + 1 + length + 1 + sizeof(uint64_t) > m_capacity) {
+            m_capacity = m_size;
+            return;
+        }
+        m_buffer[m_size++] = static_cast<char>(length);
+        std::memcpy(m_buffer + m_size, key.data(), length);
+        m_size += length;
+    }
+
+    template<typename T>
+    void add(const T& value) noexcept {
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>) {
+            putScalar(LogArgType::Bool, static_cast<uint8_t>(value));
+        } else if constexpr (std::is_same_v<D, char>) {
+            putScalar(LogArgType::Char, value);
+        } else if constexpr (std::is_enum_v<D>) {
+            add(static_cast<std::underlying_type_t<D>>(value));
+        } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+            putScalar(LogArgType::Int, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<D>) {
+            putScalar(LogArgType::UInt, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<D>) {
+            putScalar(LogArgType::Double, static_cast<double>(value));
+        } else if constexpr (std::is_array_v<T>) {
+            putString(std::string_view(value));  // String literal or char buffer
+        } else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+            putString(value ? std::string_view(value) : std::string_view("(null)"));
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            putString(std::string_view(value));
+        } else if constexpr (std::is_pointer_v<D>) {
+            putScalar(LogArgType::Pointer, reinterpret_cast<uintptr_t>(value));
+        } else {
+            static_assert(sizeof(T) == 0, "Unsupported LOGF argument type");
+        }
+    }
+
+private:
+    template<typename V>
+    void putScalar(LogArgType type, V value) noexcept {
+        if (m_size + 1 + sizeof(V) > m_capacity) {
+            m_capacity = m_size;  // Drop this and every later argument
+            return;
+        }
+        m_buffer[m_size++] = static_cast<char>(type);
+        std::memcpy(m_buffer + m_size, &value, sizeof(V));
+        m_size += sizeof(V);
+    }
+
+    void putString(std::string_view text) noexcept {
+        if (m_size + 1 + sizeof(uint16_t) > m_capacity) {
+            m_capacity = m_size;
+            return;
+        }
+        auto length = static_cast<uint16_t>(std::min(text.size(), m_capacity - m_size - 1 - sizeof(uint16_t)));
+        m_buffer[m_size++] = static_cast<char>(LogArgType::String);
+        std::memcpy(m_buffer + m_size, &length, sizeof(length));
+        m_size += sizeof(length);
+        std::memcpy(m_buffer + m_size, text.data(), length);
+        m_size += length;
+    }
+
+    char* m_buffer;
+    size_t m_capacity;
+    size_t m_size = 0;
+};
+
+// Worker side: substitutes encoded arguments into a LOGF_* format string
+std::string formatLogArgs(const char* format, const char* data, size_t size);
+
+} // namespace detail
+
+/**
+ * @brief One key/value pair of structured context
+ *
+ * Holds views of the key and of string values, so fields belong in the
+ * argument list of the logging call that consumes them:
+ * LOG_WITH_FIELDS(LogLevel::INFO, "Device opened", {"device", name}, {"rate", 48000}).
+ * Numbers and booleans keep their type in JSON and binary output.
+ */
+class LogField {
+public:
+    template<typename T>
+    LogField(std::string_view key, const T& value) noexcept : m_key(key) {
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>) {
+            m_type = detail::LogArgType::Bool;
+            m_uint = value ? 1 : 0;
+        } else if constexpr (std::is_same_v<D, char>) {
+            m_type = detail::LogArgType::Char;
+            m_int = value;
+        } else if constexpr (std::is_enum_v<D> || (std::is_integral_v<D> && std::is_signed_v<D>)) {
+            m_type = detail::LogArgType::Int;
+            m_int = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<D>) {
+            m_type = detail::LogArgType::UInt;
+            m_uint = static_cast<uint64_t>(value);
+        } else if constexpr (std::is_floating_point_v<D>) {
+            m_type = detail::LogArgType::Double;
+            m_double = static_cast<double>(value);
+        } else if constexpr (std::is_array_v<T>) {
+            m_text = std::string_view(value);
+        } else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+            m_text = value ? std::string_view(value) : std::string_view("(null)");
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            m_text = std::string_view(value);
+        } else {
+            static_assert(sizeof(T) == 0, "Unsupported log field type");
+        }
+    }
+
+    void encode(detail::LogArgEncoder& encoder) const noexcept {
+        encoder.addKey(m_key);
+        switch (m_type) {
+            case detail::LogArgType::Bool:   encoder.add(m_uint != 0); break;
+            case detail::LogArgType::Char:   encoder.add(static_cast<char>(m_int)); break;
+            case detail::LogArgType::Int:    encoder.add(m_int); break;
+            case detail::LogArgType::UInt:   encoder.add(m_uint); break;
+            case detail::LogArgType::Double: encoder.add(m_double); break;
+            default:                         encoder.add(m_text); break;
+        }
+    }
+
+private:
+    std::string_view m_key;
+    detail::LogArgType m_type = detail::LogArgType::String;
+    union {
+        int64_t m_int;
+        uint64_t m_uint;
+        double m_double = 0;
+    };
+    std::string_view m_text;
+};
+
 // Logger configuration
 struct LoggerConfig {
     bool enableConsole = true;
@@ -52,16 +282,10 @@ struct LoggerConfig {
     std::string dateFormat = "%Y-%m-%d %H:%M:%S";
     bool includeThreadId = true;
     bool includeSourceLocation = true;
-    size_t queueSize = 10000;
-};
-
-// Remote logging configuration
-struct RemoteLogConfig {
-    std::string host;
-    int port;
-    std::string protocol = "tcp"; // tcp or udp
-    bool useSSL = false;
-    std::chrono::milliseconds timeout{5000};
+    size_t queueSize = 4096;  // Preallocated slots, rounded up to a power of two
+    size_t writeBufferSize = 64 * 1024;  // File output is written once per batch or when this fills
+    std::chrono::milliseconds fsyncInterval{1000};  // Background fsync after writes; 0 = only on errors and flush()
+    LogOutputFormat outputFormat = LogOutputFormat::Text;  // Use a separate logFilePath per format
 };
 
 // Performance metrics
@@ -71,63 +295,63 @@ struct PerformanceMetrics {
     std::unordered_map<std::string, double> metrics;
 };
 
-// Lock-free queue for high-performance logging
-template<typename T>
-class LockFreeQueue {
-public:
-    explicit LockFreeQueue(size_t capacity);
-    ~LockFreeQueue();
-    
-    bool push(T&& item);
-    bool pop(T& item);
-    size_t size() const;
-    bool empty() const;
-    
-private:
-    struct Node {
-        std::atomic<T*> data;
-        std::atomic<Node*> next;
-        
-        Node() : data(nullptr), next(nullptr) {}
-    };
-    
-    std::atomic<Node*> head;
-    std::atomic<Node*> tail;
-    std::atomic<size_t> count;
-    const size_t capacity;
-};
-
 // Logger class
 class Logger {
 public:
     static Logger& getInstance();
     
-    // Configuration
+    // Configuration. Safe while other threads are logging: the queue is
+    // swapped atomically and the old one is freed only after every producer
+    // that could still see it has finished its push.
     void configure(const LoggerConfig& config);
     void configureRemote(const RemoteLogConfig& config);
+    void disableRemote();
+    RemoteLogStats getRemoteStats() const;
     
-    // Logging methods
-    void log(LogLevel level, const std::string& message,
-             const std::string& file = "", const std::string& function = "", int line = 0);
+    // Logging methods. Safe to call from any thread; never allocates or
+    // blocks. When the queue is full the message is dropped and counted.
+    void log(LogLevel level, std::string_view message,
+             const char* file = "", const char* function = "", int line = 0);
     
-    void logWithContext(LogLevel level, const std::string& message,
+    void logWithContext(LogLevel level, std::string_view message,
                        const std::unordered_map<std::string, std::string>& context,
-                       const std::string& file = "", const std::string& function = "", int line = 0);
+                       const char* file = "", const char* function = "", int line = 0);
+    
+    // Structured context without building a map: the fields are encoded
+    // straight into the queued record. Text output shows them like
+    // logWithContext(); JSON and binary output keep their types.
+    void logWithFields(LogLevel level, std::string_view message, std::initializer_list<LogField> fields,
+                       const char* file = "", const char* function = "", int line = 0);
+    
+    // Deferred formatting, used through the LOGF_* macros: only the call
+    // site and the raw argument bytes are queued, and the worker thread
+    // builds the text. Never locks, so it is usable on audio threads; the
+    // line may then reach the sinks up to 100 ms later.
+    template<size_t Placeholders, typename... Args>
+    void logFormat(const LogFormatSite& site, const Args&... args) noexcept;
     
-    // Performance logging
+    // Performance logging. These take a mutex and allocate; on hot paths
+    // and audio threads use QUIET_PERF_SPAN instead.
     void startPerformanceLog(const std::string& operation);
     void endPerformanceLog(const std::string& operation);
     void logPerformanceMetric(const std::string& operation, const std::string& metric, double value);
     
+    // Logs the QUIET_PERF_SPAN statistics table, one line per span name
+    void logPerformanceReport(LogLevel level = LogLevel::INFO);
+    
     // Log level control
     void setLogLevel(LogLevel level);
     LogLevel getLogLevel() const;
     
-    // Flush and shutdown
+    // Messages dropped because the queue was full
+    uint64_t getDroppedCount() const;
+    
+    // Flush and shutdown. flush() returns once everything logged so far is
+    // written and synced to disk.
     void flush();
     void shutdown();
     
-    // Custom formatting
+    // Custom formatting; an empty formatter restores the default format
     using Formatter = std::function<std::string(const LogEntry&)>;
     void setFormatter(Formatter formatter);
     
@@ -138,12 +362,38 @@ private:
     Logger& operator=(const Logger&) = delete;
     
     void workerThread();
-    void processLogEntry(const LogEntry& entry);
-    void writeToConsole(const LogEntry& entry);
-    void writeToFile(const LogEntry& entry);
-    void sendToRemote(const LogEntry& entry);
+    void startWorker();
+    bool stopWorker();
+    // Real-time callers never wait on cvMutex_; if the worker holds it the
+    // wake-up may be missed and the worker's 100 ms poll picks the record up
+    void wakeWorker(bool realtime = false);
+    template<typename Fill>
+    bool pushRecord(bool realtime, Fill&& fill) noexcept;
+    void retireQueue(MpscRingBuffer<LogRecord>* replacement);
+    bool enqueue(LogLevel level, std::string_view message, const char* file, const char* function,
+                 int line, const std::unordered_map<std::string, std::string>* context,
+                 std::initializer_list<LogField> fields);
+    void processRecord(const LogRecord& record);
+    void reportDroppedMessages();
+    static LogEntry toLogEntry(const LogRecord& record);
+    void appendStructured(std::string& out, const LogRecord& record, LogOutputFormat format,
+                          std::string& messageScratch);
+    void writeToConsole(LogLevel level, const std::string& formatted);
+    void writeToFile(LogLevel level, std::string_view data, bool appendNewline = true);
+    void writeBatch();
+    void remoteThread();
+    void startRemote();
+    bool stopRemote();
+    bool openLogFile();
+    void retireLogFile();
     void rotateLogFile();
     void checkLogRotation();
+    
+    // Housekeeping thread: fsync, closing rotated files and pruning old ones,
+    // so none of it blocks the worker
+    void housekeepingThread();
+    void requestSync();
+    void waitForHousekeeping();
     std::string formatLogEntry(const LogEntry& entry);
     std::string getLogLevelString(LogLevel level) const;
     std::string getCurrentTimestamp() const;
@@ -152,20 +402,52 @@ private:
     LoggerConfig config_;
     RemoteLogConfig remoteConfig_;
     std::atomic<LogLevel> minLevel_;
+    std::mutex configMutex_;  // Serializes configure(), configureRemote() and shutdown()
     
     // Threading
     std::unique_ptr<std::thread> workerThread_;
     std::atomic<bool> running_;
+    std::atomic<bool> workerRunning_{false};
+    std::atomic<bool> workerWaiting_{false};  // Producers only notify while set
     std::condition_variable cv_;
     std::mutex cvMutex_;
     
-    // Queue
-    std::unique_ptr<LockFreeQueue<LogEntry>> queue_;
+    // Queue (single consumer: the worker thread). Producers register in the
+    // writer count of the current generation before loading queue_, so
+    // configure() knows when the queue it swapped out can be freed.
+    std::atomic<MpscRingBuffer<LogRecord>*> queue_{nullptr};
+    std::unique_ptr<MpscRingBuffer<LogRecord>> ownedQueue_;
+    std::atomic<uint32_t> queueGeneration_{0};
+    std::atomic<uint32_t> queueWriters_[2] = {};
+    std::atomic<uint64_t> processedCount_{0};  // Records taken off queue_ and written
+    std::atomic<uint64_t> droppedCount_{0};
+    uint64_t reportedDrops_{0};  // Worker thread only
     
-    // File handling
-    std::unique_ptr<std::ofstream> fileStream_;
-    std::mutex fileMutex_;
+    // File handling (worker thread, or the caller while the worker is parked)
+    int fileFd_ = -1;
     size_t currentFileSize_;
+    std::string fileBuffer_;
+    std::string consoleOut_;
+    std::string consoleErr_;
+    std::string structuredLine_;  // JSON or binary record being built, reused
+    std::string formattedArgs_;   // LOGF_* message text for structured output, reused
+    bool errorSinceSync_ = false;
+    
+    // Housekeeping state, guarded by housekeepingMutex_
+    std::unique_ptr<std::thread> housekeepingThread_;
+    std::mutex housekeepingMutex_;
+    std::condition_variable housekeepingCv_;
+    std::condition_variable housekeepingDoneCv_;
+    bool housekeepingRunning_ = false;
+    int syncFd_ = -1;                    // Duplicate of fileFd_ for background fsync
+    std::vector<int> retiredFds_;        // Synced, then closed
+    bool unsynced_ = false;              // Written since the last fsync
+    std::chrono::milliseconds syncInterval_{1000};
+    bool syncRequested_ = false;
+    std::string prunePath_;              // Non-empty: prune rotated copies of this file
+    size_t pruneMaxFiles_ = 0;
+    uint64_t housekeepingRequested_ = 0;
+    uint64_t housekeepingCompleted_ = 0;
     
     // Performance tracking
     std::unordered_map<std::string, PerformanceMetrics> performanceMetrics_;
@@ -174,12 +456,75 @@ private:
     // Custom formatter
     Formatter formatter_;
     
-    // Remote logging
+    // Remote logging: the worker forwards records, the remote thread formats
+    // them and owns the connection
     std::atomic<bool> remoteEnabled_;
+    std::atomic<LogOutputFormat> remoteFormat_{LogOutputFormat::Text};  // Mirrors config_.outputFormat
+    std::atomic<bool> remoteRunning_{false};
     std::unique_ptr<std::thread> remoteThread_;
-    std::unique_ptr<LockFreeQueue<LogEntry>> remoteQueue_;
+    std::unique_ptr<MpscRingBuffer<LogRecord>> remoteQueue_;
+    std::unique_ptr<RemoteLogSink> remoteSink_;
+    mutable std::mutex remoteSinkMutex_;  // Held while remoteSink_ is replaced or read from outside its thread
+    std::mutex remoteMutex_;
+    std::condition_variable remoteCv_;
+    bool remotePending_ = false;       // Guarded by remoteMutex_
+    bool remoteForwarded_ = false;     // Worker thread only
+    std::atomic<uint64_t> remoteDropped_{0};  // Remote queue was full
 };
 
+template<size_t Placeholders, typename... Args>
+void Logger::logFormat(const LogFormatSite& site, const Args&... args) noexcept {
+    static_assert(Placeholders == sizeof...(Args),
+                  "LOGF format string and argument count do not match");
+    
+    if (site.level < minLevel_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    auto timestamp = std::chrono::system_clock::now();
+    pushRecord(true, [&](LogRecord& record) noexcept {
+        record.timestamp = timestamp;
+        record.level = site.level;
+        record.threadId = std::this_thread::get_id();
+        record.line = site.line;
+        record.site = &site;
+        record.context.assign("", 0);
+        
+        char buffer[decltype(record.message)::capacity()];
+        detail::LogArgEncoder encoder(buffer, sizeof(buffer));
+        (encoder.add(args), ...);
+        record.message.assign(buffer, encoder.size());
+    });
+}
+
+template<typename Fill>
+bool Logger::pushRecord(bool realtime, Fill&& fill) noexcept {
+    // Register as a writer of the current generation, re-checking it so a
+    // configure() that has already moved on is not waiting on the wrong count
+    uint32_t generation = queueGeneration_.load();
+    while (true) {
+        queueWriters_[generation & 1].fetch_add(1);
+        uint32_t current = queueGeneration_.load();
+        if (current == generation) {
+            break;
+        }
+        queueWriters_[generation & 1].fetch_sub(1, std::memory_order_release);
+        generation = current;
+    }
+    
+    bool pushed = queue_.load()->tryPushWith(fill);
+    queueWriters_[generation & 1].fetch_sub(1, std::memory_order_release);
+    
+    if (!pushed) {
+        // Reported by the worker once there is room again
+        droppedCount_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    wakeWorker(realtime);
+    return true;
+}
+
 // Convenience macros
 #define LOG_DEBUG(msg) \
     quiet::utils::Logger::getInstance().log(quiet::utils::LogLevel::DEBUG, msg, __FILE__, __FUNCTION__, __LINE__)
@@ -196,10 +541,34 @@ private:
 #define LOG_CRITICAL(msg) \
     quiet::utils::Logger::getInstance().log(quiet::utils::LogLevel::CRITICAL, msg, __FILE__, __FUNCTION__, __LINE__)
 
+// Deferred formatting macros: LOGF_INFO("Opened {} at {} Hz", name, rate).
+// The format must be a string literal; the placeholder count is checked at
+// compile time and arguments are only evaluated when the level is enabled.
+#define LOGF(level, format, ...) \
+    do { \
+        static const quiet::utils::LogFormatSite quietLogSite_{ \
+            level, format, quiet::utils::detail::logFileBaseName(__FILE__), __FUNCTION__, __LINE__}; \
+        quiet::utils::Logger& quietLogger_ = quiet::utils::Logger::getInstance(); \
+        if (quietLogger_.getLogLevel() <= level) { \
+            quietLogger_.logFormat<quiet::utils::detail::countLogPlaceholders(format)>( \
+                quietLogSite_, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOGF_DEBUG(format, ...) LOGF(quiet::utils::LogLevel::DEBUG, format, ##__VA_ARGS__)
+#define LOGF_INFO(format, ...) LOGF(quiet::utils::LogLevel::INFO, format, ##__VA_ARGS__)
+#define LOGF_WARNING(format, ...) LOGF(quiet::utils::LogLevel::WARNING, format, ##__VA_ARGS__)
+#define LOGF_ERROR(format, ...) LOGF(quiet::utils::LogLevel::ERROR, format, ##__VA_ARGS__)
+#define LOGF_CRITICAL(format, ...) LOGF(quiet::utils::LogLevel::CRITICAL, format, ##__VA_ARGS__)
+
 // Context logging macros
 #define LOG_WITH_CONTEXT(level, msg, context) \
     quiet::utils::Logger::getInstance().logWithContext(level, msg, context, __FILE__, __FUNCTION__, __LINE__)
 
+// LOG_WITH_FIELDS(LogLevel::WARNING, "Buffer underrun", {"device", name}, {"frames", frames})
+#define LOG_WITH_FIELDS(level, msg, ...) \
+    quiet::utils::Logger::getInstance().logWithFields(level, msg, {__VA_ARGS__}, __FILE__, __FUNCTION__, __LINE__)
+
 // Performance logging macros
 #define LOG_PERF_START(operation) \
     quiet::utils::Logger::getInstance().startPerformanceLog(operation)
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief CPU time and resident memory of the current process
+ */
+struct ProcessUsage {
+    double cpuSeconds = 0.0;       // User plus system time since start
+    uint64_t residentBytes = 0;    // Current RSS; peak RSS where that is all the OS reports
+};
+
+ProcessUsage readProcessUsage();
+
+/**
+ * @brief Loopback HTTP endpoint serving metrics in Prometheus text format
+ *
+ * GET /metrics (or /) answers with whatever the provider returns; anything
+ * else gets a 404. Listens on 127.0.0.1 only and serves one connection at a
+ * time on its own thread, which sleeps in poll() between scrapes, so an idle
+ * endpoint costs nothing. The provider runs on that thread.
+ */
+class MetricsServer {
+public:
+    using Provider = std::function<std::string()>;
+
+    explicit MetricsServer(Provider provider);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // port 0 picks a free one; see getPort()
+    bool start(int port);
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    int getPort() const { return m_port; }
+    uint64_t getRequestCount() const { return m_requests.load(std::memory_order_relaxed); }
+
+    // Appends one sample with its HELP and TYPE lines
+    static void appendMetric(std::string& out, const char* name, const char* type,
+                             const char* help, double value);
+
+private:
+    void serverThread();
+    void handleConnection(int fd);
+
+    Provider m_provider;
+    int m_listenFd = -1;
+    int m_wakeFds[2] = {-1, -1};   // Written by stop() to end the poll()
+    int m_port = 0;
+    std::thread m_thread;
+    std::atomic<uint64_t> m_requests{0};
+};
+
+} // namespace utils
+} // namespace quiet
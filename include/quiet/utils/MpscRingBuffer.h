@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief Bounded multi-producer / single-consumer ring of preallocated slots
+ *
+ * Producers claim a slot with one CAS on the enqueue position and publish it
+ * through a per-slot sequence number (Vyukov's bounded queue). Pushing never
+ * allocates, locks or blocks: when the ring is full tryPush() fails and the
+ * caller decides what to drop. Only one thread may pop at a time.
+ *
+ * Safe to call tryPush() from real-time audio threads.
+ */
+template<typename T>
+class MpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MpscRingBuffer slots are copied without constructors");
+
+public:
+    explicit MpscRingBuffer(size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(capacity))
+        , m_mask(m_capacity - 1)
+        , m_slots(new Slot[m_capacity]) {
+
+        for (size_t i = 0; i < m_capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // Producer side: any thread, wait-free apart from CAS retries between producers
+    bool tryPush(const T& item) noexcept {
+        return tryPushWith([&item](T& slot) noexcept { slot = item; });
+    }
+
+    // Producer side, writing the item in place: write(T&) fills the claimed
+    // slot before it is published, which saves a copy of large records.
+    // The slot holds whatever the previous lap left there.
+    template<typename Write>
+    bool tryPushWith(Write&& write) noexcept {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        while (true) {
+            slot = &m_slots[pos & m_mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        write(slot->value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: a single thread only
+    bool tryPop(T& item) noexcept {
+        Slot& slot = m_slots[m_dequeuePos & m_mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence != m_dequeuePos + 1) {
+            return false;  // Empty, or the producer has not finished writing
+        }
+
+        item = slot.value;
+        slot.sequence.store(m_dequeuePos + m_capacity, std::memory_order_release);
+        ++m_dequeuePos;
+        m_dequeuePosShadow.store(m_dequeuePos, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t capacity() const noexcept {
+        return m_capacity;
+    }
+
+    // Total pushes accepted so far, including ones still being written
+    size_t pushedCount() const noexcept {
+        return m_enqueuePos.load(std::memory_order_acquire);
+    }
+
+    // Approximate while producers are active
+    size_t size() const noexcept {
+        size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t dequeued = m_dequeuePosShadow.load(std::memory_order_relaxed);
+        return enqueued >= dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) size_t m_dequeuePos{0};
+    std::atomic<size_t> m_dequeuePosShadow{0};
+};
+
+} // namespace utils
+} // namespace quiet
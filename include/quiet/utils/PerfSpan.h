@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "quiet/utils/HdrHistogram.h"
+#include "quiet/utils/SpscRingBuffer.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define QUIET_PERF_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define QUIET_PERF_HAS_TSC 1
+#endif
+
+namespace quiet {
+namespace utils {
+
+// One finished span as recorded by the thread that ran it
+struct PerfSpanSample {
+    uint64_t startTicks = 0;
+    uint64_t endTicks = 0;
+    uint32_t nameId = 0;
+};
+
+// Aggregated durations of one span name, in nanoseconds
+struct PerfSpanStats {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t minNs = 0;
+    uint64_t p50Ns = 0;
+    uint64_t p90Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t p999Ns = 0;
+    uint64_t maxNs = 0;
+    double meanNs = 0;
+};
+
+/**
+ * @brief Collects QUIET_PERF_SPAN timings from every thread
+ *
+ * Each thread records finished spans (start and end timestamp counter
+ * readings) into its own preallocated single-producer ring, so recording a
+ * span takes no locks, never allocates and never waits. A background thread
+ * drains the rings, converts ticks to nanoseconds and aggregates durations
+ * into one HDR histogram per span name, keeping the most recent spans for
+ * Chrome trace export (chrome://tracing, Perfetto).
+ *
+ * The first span on a thread allocates that thread's ring. Real-time
+ * threads call prepareThread() instead, which claims one of a few rings
+ * preallocated with the collector and takes no lock. Spans are dropped and
+ * counted when a ring fills between two collections.
+ */
+class PerfSpanCollector {
+public:
+    static PerfSpanCollector& getInstance();
+
+    // Interns a span name; QUIET_PERF_SPAN calls this once per call site
+    static uint32_t registerName(const char* name);
+
+    // Timestamp counter on x86, steady_clock nanoseconds elsewhere
+    static uint64_t readTicks() noexcept {
+#ifdef QUIET_PERF_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Gives the calling thread its ring ahead of its first span and names
+    // the thread in trace exports. Claims a preallocated ring while any are
+    // left, so it neither allocates nor locks; once they are used up it
+    // falls back to allocating one. A claimed ring stays with its thread.
+    // threadName must outlive the collector (a string literal).
+    void prepareThread(const char* threadName = nullptr);
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Drains every thread's ring now rather than on the next timer tick
+    void collect();
+
+    // Collected so far, sorted by name
+    std::vector<PerfSpanStats> getStats();
+
+    // Plain text table of getStats()
+    std::string formatReport();
+
+    // Chrome trace event JSON of the most recent spans
+    std::string exportChromeTrace();
+    bool writeChromeTrace(const std::string& path);
+
+    // Forgets all statistics and retained spans; names stay registered
+    void reset();
+
+    uint64_t getDroppedCount() const;
+
+    void setCollectInterval(std::chrono::milliseconds interval);
+
+    // Per-thread state, shared with the collector so spans recorded just
+    // before a thread exits are still collected
+    struct ThreadBuffer {
+        explicit ThreadBuffer(size_t capacity) : samples(capacity) {}
+
+        SpscRingBuffer<PerfSpanSample> samples;
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> retired{false};
+        std::atomic<const char*> pendingName{nullptr};  // Recorded by the collector
+        uint32_t threadId = 0;
+    };
+
+    // Current thread's buffer, created on first use
+    static ThreadBuffer* threadBuffer();
+
+private:
+    PerfSpanCollector();
+    ~PerfSpanCollector();
+    PerfSpanCollector(const PerfSpanCollector&) = delete;
+    PerfSpanCollector& operator=(const PerfSpanCollector&) = delete;
+
+    std::shared_ptr<ThreadBuffer> registerThread();
+    void collectorThread();
+    void collectLocked();
+    double ticksPerNs();
+
+    // Retained spans for trace export, oldest overwritten first
+    struct TraceSpan {
+        uint64_t startNs;
+        uint64_t durationNs;
+        uint32_t threadId;
+        uint32_t nameId;
+    };
+
+    std::atomic<bool> m_enabled{true};
+
+    mutable std::mutex m_mutex;
+    std::vector<std::string> m_names;
+    std::vector<std::unique_ptr<HdrHistogram>> m_histograms;   // By name id
+    std::vector<std::shared_ptr<ThreadBuffer>> m_threads;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_reserved;    // Fixed at construction
+    std::atomic<size_t> m_nextReserved{0};
+    std::map<uint32_t, std::string> m_threadNames;             // Outlive the threads, for export
+    std::vector<TraceSpan> m_trace;
+    size_t m_traceNext = 0;
+    uint64_t m_retiredDrops = 0;
+
+    // Tick calibration against steady_clock
+    uint64_t m_epochTicks;
+    std::chrono::steady_clock::time_point m_epochTime;
+
+    std::thread m_thread;
+    std::condition_variable m_cv;
+    bool m_running = true;
+    std::chrono::milliseconds m_collectInterval{100};
+};
+
+/**
+ * @brief Times the enclosing scope as one span; see QUIET_PERF_SPAN
+ */
+class PerfSpan {
+public:
+    explicit PerfSpan(uint32_t nameId) noexcept {
+        if (!PerfSpanCollector::getInstance().isEnabled()) {
+            return;
+        }
+        m_buffer = PerfSpanCollector::threadBuffer();
+        m_sample.nameId = nameId;
+        m_sample.startTicks = PerfSpanCollector::readTicks();
+    }
+
+    ~PerfSpan() {
+        if (!m_buffer) {
+            return;
+        }
+        m_sample.endTicks = PerfSpanCollector::readTicks();
+        if (!m_buffer->samples.tryPush(m_sample)) {
+            m_buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    PerfSpan(const PerfSpan&) = delete;
+    PerfSpan& operator=(const PerfSpan&) = delete;
+
+private:
+    PerfSpanCollector::ThreadBuffer* m_buffer = nullptr;
+    PerfSpanSample m_sample;
+};
+
+#define QUIET_PERF_CONCAT_INNER(a, b) a##b
+#define QUIET_PERF_CONCAT(a, b) QUIET_PERF_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope: QUIET_PERF_SPAN("denoise.frame").
+// The name is interned once per call site; spans nest and may run
+// concurrently on any number of threads.
+#define QUIET_PERF_SPAN(name) \
+    static const uint32_t QUIET_PERF_CONCAT(quietPerfSpanId_, __LINE__) = \
+        quiet::utils::PerfSpanCollector::registerName(name); \
+    quiet::utils::PerfSpan QUIET_PERF_CONCAT(quietPerfSpan_, __LINE__)(QUIET_PERF_CONCAT(quietPerfSpanId_, __LINE__))
+
+// Same, for a name interned ahead of time with registerName(). Real-time code
+// uses this so its first pass takes neither the registration lock nor a
+// function-local static guard.
+#define QUIET_PERF_SPAN_ID(nameId) \
+    quiet::utils::PerfSpan QUIET_PERF_CONCAT(quietPerfSpan_, __LINE__)(nameId)
+
+} // namespace utils
+} // namespace quiet
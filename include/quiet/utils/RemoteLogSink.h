@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace quiet {
+namespace utils {
+
+// Remote logging configuration
+struct RemoteLogConfig {
+    std::string host;
+    int port = 0;
+    std::string protocol = "tcp"; // tcp or udp
+    bool useSSL = false;
+    std::chrono::milliseconds timeout{5000};
+
+    // TCP: reconnect delay doubles from the initial value up to the maximum
+    std::chrono::milliseconds initialBackoff{100};
+    std::chrono::milliseconds maxBackoff{30000};
+
+    // TCP: lines that cannot be sent are appended here and replayed in order
+    // after reconnecting. Empty disables spilling; lines are then dropped.
+    std::string spillPath = "logs/remote-spill.log";
+    size_t maxSpillBytes = 8 * 1024 * 1024;
+
+    // UDP: lines are packed into datagrams of at most this many bytes
+    size_t maxDatagramSize = 1400;
+};
+
+// Counters for the remote transport
+struct RemoteLogStats {
+    uint64_t linesSent = 0;       // Handed to the socket (UDP: not necessarily delivered)
+    uint64_t sendCalls = 0;
+    uint64_t connects = 0;
+    uint64_t bytesSpilled = 0;
+    uint64_t bytesReplayed = 0;
+    uint64_t bytesDropped = 0;    // Spill file full or disabled, or UDP send failed
+    uint64_t linesDropped = 0;    // Logger: remote queue full before formatting
+};
+
+/**
+ * @brief Persistent TCP or UDP connection to a log collector
+ *
+ * Takes newline-terminated lines in batches and sends each batch with as few
+ * send() calls as possible. TCP keeps one connection open; when it drops,
+ * reconnects are attempted with exponential backoff and lines are spilled to
+ * a bounded file meanwhile, then replayed ahead of new lines once the
+ * collector is back (at-least-once: a batch cut short by a failure may be
+ * sent again). UDP packs lines into datagrams and never blocks on the
+ * collector.
+ *
+ * Not thread-safe; owned and driven by the Logger's remote thread.
+ * getStats() may be called from any thread.
+ */
+class RemoteLogSink {
+public:
+    explicit RemoteLogSink(const RemoteLogConfig& config);
+    ~RemoteLogSink();
+
+    RemoteLogSink(const RemoteLogSink&) = delete;
+    RemoteLogSink& operator=(const RemoteLogSink&) = delete;
+
+    // lines holds lineCount complete lines, each ending in '\n'
+    void write(const std::string& lines, size_t lineCount);
+
+    // Reconnects when due and replays spilled lines. Returns how long the
+    // caller may wait before calling again.
+    std::chrono::milliseconds maintain();
+
+    bool isConnected() const { return fd_ >= 0; }
+    RemoteLogStats getStats() const;
+
+private:
+    bool connect();
+    void disconnect();
+    bool sendAll(const char* data, size_t size);
+    bool replaySpill();
+    void spill(const std::string& lines);
+    void writeDatagrams(const std::string& lines);
+
+    RemoteLogConfig config_;
+    bool udp_;
+    int fd_ = -1;
+
+    // Reconnect backoff (TCP)
+    std::chrono::steady_clock::time_point nextConnect_;
+    std::chrono::milliseconds backoff_;
+
+    // Spill file (TCP); bytes before spillOffset_ were already replayed
+    int spillFd_ = -1;
+    uint64_t spillSize_ = 0;
+    uint64_t spillOffset_ = 0;
+
+    std::atomic<uint64_t> linesSent_{0};
+    std::atomic<uint64_t> sendCalls_{0};
+    std::atomic<uint64_t> connects_{0};
+    std::atomic<uint64_t> bytesSpilled_{0};
+    std::atomic<uint64_t> bytesReplayed_{0};
+    std::atomic<uint64_t> bytesDropped_{0};
+};
+
+} // namespace utils
+} // namespace quiet
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief Growable FIFO over a circular buffer that keeps its storage
+ *
+ * Drop-in for the std::queue/std::deque uses on hot paths: once the buffer has
+ * grown to the working-set size, push and pop never allocate (std::deque
+ * allocates and frees a block every few elements for large T). Not
+ * thread-safe; callers provide their own locking.
+ */
+template<typename T>
+class RingQueue {
+public:
+    RingQueue() = default;
+    explicit RingQueue(size_t initialCapacity) { reserve(initialCapacity); }
+    ~RingQueue() { clear(); }
+
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+
+    bool empty() const noexcept { return m_size == 0; }
+    size_t size() const noexcept { return m_size; }
+    size_t capacity() const noexcept { return m_capacity; }
+
+    T& front() { return *slot(m_head); }
+    const T& front() const { return *slot(m_head); }
+
+    void push_back(const T& item) { emplace_back(item); }
+    void push_back(T&& item) { emplace_back(std::move(item)); }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (m_size == m_capacity) {
+            reallocate(m_capacity == 0 ? kInitialCapacity : m_capacity * 2);
+        }
+        T* item = new (slot(m_head + m_size)) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *item;
+    }
+
+    void push_front(const T& item) { emplace_front(item); }
+    void push_front(T&& item) { emplace_front(std::move(item)); }
+
+    template<typename... Args>
+    T& emplace_front(Args&&... args) {
+        if (m_size == m_capacity) {
+            reallocate(m_capacity == 0 ? kInitialCapacity : m_capacity * 2);
+        }
+        size_t head = (m_head - 1) & (m_capacity - 1);
+        T* item = new (slot(head)) T(std::forward<Args>(args)...);
+        m_head = head;
+        ++m_size;
+        return *item;
+    }
+
+    void pop_front() {
+        slot(m_head)->~T();
+        m_head = (m_head + 1) & (m_capacity - 1);
+        --m_size;
+    }
+
+    void clear() {
+        while (!empty()) {
+            pop_front();
+        }
+    }
+
+    void reserve(size_t capacity) {
+        size_t rounded = kInitialCapacity;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        if (rounded > m_capacity) {
+            reallocate(rounded);
+        }
+    }
+
+private:
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    static constexpr size_t kInitialCapacity = 16;
+
+    T* slot(size_t index) const {
+        return std::launder(reinterpret_cast<T*>(&m_storage[index & (m_capacity - 1)]));
+    }
+
+    void reallocate(size_t newCapacity) {
+        std::unique_ptr<Storage[]> storage(new Storage[newCapacity]);
+        for (size_t i = 0; i < m_size; ++i) {
+            T* item = slot(m_head + i);
+            new (&storage[i]) T(std::move(*item));
+            item->~T();
+        }
+        m_storage = std::move(storage);
+        m_capacity = newCapacity;
+        m_head = 0;
+    }
+
+    std::unique_ptr<Storage[]> m_storage;
+    size_t m_capacity{0};
+    size_t m_head{0};
+    size_t m_size{0};
+};
+
+} // namespace utils
+} // namespace quiet
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief Bounded single-producer / single-consumer ring of preallocated slots
+ *
+ * One thread pushes and one thread pops; each side owns its index and only
+ * reads the other's, so neither side ever waits, locks or allocates. Each
+ * side caches the other's index and only re-reads it when the ring looks
+ * full or empty, which keeps the shared cache line quiet. When the ring is
+ * full tryPush() fails and the caller decides what to drop.
+ *
+ * Safe to call tryPush() from real-time audio threads.
+ */
+template<typename T>
+class SpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRingBuffer slots are copied without constructors");
+
+public:
+    explicit SpscRingBuffer(size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(capacity))
+        , m_mask(m_capacity - 1)
+        , m_slots(new T[m_capacity]()) {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side: a single thread only
+    bool tryPush(const T& item) noexcept {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_capacity) {
+                return false;  // Full
+            }
+        }
+
+        m_slots[tail & m_mask] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: a single thread only
+    bool tryPop(T& item) noexcept {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;  // Empty
+            }
+        }
+
+        item = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side: pushes as many of the items as fit and returns how many
+    // did. Suits sample streams, where a partly full ring keeps what it can.
+    size_t tryPushBulk(const T* items, size_t count) noexcept {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_capacity - (tail - m_cachedHead) < count) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+        }
+        size_t toPush = std::min(count, m_capacity - (tail - m_cachedHead));
+        if (toPush == 0) {
+            return 0;
+        }
+
+        // At most two runs: up to the end of the slots, then from the start
+        size_t start = tail & m_mask;
+        size_t first = std::min(toPush, m_capacity - start);
+        std::memcpy(&m_slots[start], items, first * sizeof(T));
+        std::memcpy(&m_slots[0], items + first, (toPush - first) * sizeof(T));
+        m_tail.store(tail + toPush, std::memory_order_release);
+        return toPush;
+    }
+
+    // Consumer side: pops up to maxCount items and returns how many it did
+    size_t tryPopBulk(T* items, size_t maxCount) noexcept {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_cachedTail - head < maxCount) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+        size_t toPop = std::min(maxCount, m_cachedTail - head);
+        if (toPop == 0) {
+            return 0;
+        }
+
+        size_t start = head & m_mask;
+        size_t first = std::min(toPop, m_capacity - start);
+        std::memcpy(items, &m_slots[start], first * sizeof(T));
+        std::memcpy(items + first, &m_slots[0], (toPop - first) * sizeof(T));
+        m_head.store(head + toPop, std::memory_order_release);
+        return toPop;
+    }
+
+    size_t capacity() const noexcept {
+        return m_capacity;
+    }
+
+    // Exact from either side; approximate from any other thread
+    size_t size() const noexcept {
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        size_t head = m_head.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+
+    // Producer line: its index and its view of the consumer's
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead{0};
+
+    // Consumer line
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail{0};
+};
+
+} // namespace utils
+} // namespace quiet
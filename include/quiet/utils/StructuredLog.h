@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "quiet/utils/Logger.h"
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief One log record as the JSON and binary writers see it
+ *
+ * All text is borrowed: from the queued LogRecord when writing, or from the
+ * file contents when reading a binary log back.
+ */
+struct StructuredLogRecord {
+    int64_t timestampNs = 0;     // Since the Unix epoch
+    LogLevel level = LogLevel::INFO;
+    uint64_t threadId = 0;       // std::hash of the std::thread::id
+    uint32_t line = 0;
+    std::string_view file;
+    std::string_view function;
+    std::string_view message;
+    std::string_view fields;     // Encoded key/value fields, see LogFieldReader
+};
+
+// A decoded field. text is set for strings; otherwise the member matching
+// type holds the value (Bool and UInt use uintValue, Char uses intValue).
+struct LogFieldValue {
+    std::string_view key;
+    detail::LogArgType type = detail::LogArgType::String;
+    int64_t intValue = 0;
+    uint64_t uintValue = 0;
+    double doubleValue = 0;
+    std::string_view text;
+};
+
+/**
+ * @brief Walks the fields written by LogField::encode()
+ *
+ * Each field is a length-prefixed key followed by one value in the
+ * LogArgEncoder layout. A field cut short by truncation ends the walk.
+ */
+class LogFieldReader {
+public:
+    explicit LogFieldReader(std::string_view encoded) noexcept
+        : m_data(encoded.data()), m_end(encoded.data() + encoded.size()) {}
+
+    bool next(LogFieldValue& field) noexcept;
+
+private:
+    const char* m_data;
+    const char* m_end;
+};
+
+/*
+ * Binary log layout. A file starts with kBinaryLogMagic, then holds records:
+ *
+ *   uint32_t size          bytes that follow, up to the next record
+ *   uint8_t  level
+ *   int64_t  timestampNs
+ *   uint64_t threadId
+ *   uint32_t line
+ *   uint16_t length, file bytes
+ *   uint16_t length, function bytes
+ *   uint32_t length, message bytes
+ *   uint16_t length, encoded fields
+ *
+ * Integers are in host byte order (little-endian on every supported platform).
+ * A record cut short by a crash is detectable from its size prefix.
+ */
+constexpr char kBinaryLogMagic[8] = {'Q', 'L', 'O', 'G', 'B', 'I', 'N', '1'};
+
+// Level names shared by the text, JSON and binary tooling
+const char* logLevelName(LogLevel level) noexcept;
+
+// Plain text of a field value, as the text formatter shows it
+void appendLogFieldValue(std::string& out, const LogFieldValue& field);
+
+// Appends text as a quoted JSON string
+void appendJsonString(std::string& out, std::string_view text);
+
+// Appends one JSON object and its trailing newline:
+// {"ts":"2026-01-31T12:00:00.123456Z","level":"INFO","thread":..,"file":..,
+//  "line":..,"function":..,"msg":..,"ctx":{"key":value,..}}
+void appendJsonLogLine(std::string& out, const StructuredLogRecord& record);
+
+// Appends one binary record in the layout above
+void appendBinaryLogRecord(std::string& out, const StructuredLogRecord& record);
+
+// Reads the record at the start of data. Returns the bytes it occupies, or 0
+// if data holds no complete, well-formed record.
+size_t readBinaryLogRecord(const char* data, size_t size, StructuredLogRecord& record) noexcept;
+
+} // namespace utils
+} // namespace quiet
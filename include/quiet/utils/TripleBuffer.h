@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace quiet {
+namespace utils {
+
+/**
+ * @brief Latest-value handoff from one writer thread to one reader thread
+ *
+ * Three slots: the writer fills its back slot and publishes it by swapping
+ * it with the middle slot; the reader swaps the middle slot into its front
+ * slot when a newer one has been published. Neither side ever waits for the
+ * other or copies a slot, so a slow reader simply skips frames and a slow
+ * writer leaves the reader on the last complete one.
+ *
+ * Slots are constructed up front and reused: size them once (e.g. with
+ * forEachSlot) and the handoff never allocates.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side: the slot to fill next; stays the writer's until publish()
+    T& writeBuffer() noexcept { return m_slots[m_back]; }
+
+    // Writer side: makes the filled slot the latest one
+    void publish() noexcept {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | kFresh), std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+    }
+
+    // Reader side: switches to the latest published slot, if there is a new
+    // one; returns false if the front slot is already the latest
+    bool update() noexcept {
+        if ((m_middle.load(std::memory_order_relaxed) & kFresh) == 0) {
+            return false;
+        }
+        uint8_t latest = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = latest & kIndexMask;
+        return true;
+    }
+
+    // Reader side: the most recent slot seen by update()
+    const T& readBuffer() const noexcept { return m_slots[m_front]; }
+
+    // Not thread-safe: for sizing or resetting the slots before use
+    template<typename Function>
+    void forEachSlot(Function&& function) {
+        for (auto& slot : m_slots) {
+            function(slot);
+        }
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T m_slots[3]{};
+    uint8_t m_back = 0;                  // Writer-owned
+    std::atomic<uint8_t> m_middle{1};    // Index, plus kFresh while unread
+    uint8_t m_front = 2;                 // Reader-owned
+};
+
+} // namespace utils
+} // namespace quiet
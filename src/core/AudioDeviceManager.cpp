@@ -1,5 +1,6 @@
 #include "quiet/core/AudioDeviceManager.h"
 #include "quiet/core/EventDispatcher.h"
+#include "quiet/utils/Logger.h"
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <algorithm>
 #include <cmath>
@@ -12,12 +13,9 @@ namespace core {
 
 // Constants for audio processing
 namespace {
-    constexpr float MIN_LEVEL_DB = -60.0f;
-    constexpr float MAX_LEVEL_DB = 0.0f;
     constexpr int MAX_CHANNELS = 2;
     constexpr int DEFAULT_SAMPLE_RATE = 48000;
     constexpr int DEFAULT_BUFFER_SIZE = 256;
-    constexpr double LEVEL_SMOOTHING_FACTOR = 0.9;
 }
 
 // Device change listener implementation
@@ -38,6 +36,7 @@ private:
 AudioDeviceManager::AudioDeviceManager(EventDispatcher& eventDispatcher)
     : m_eventDispatcher(eventDispatcher)
     , m_juceDeviceManager(std::make_unique<juce::AudioDeviceManager>())
+    , m_levelMeter(eventDispatcher)
 {
 }
 
@@ -343,7 +342,7 @@ void AudioDeviceManager::stopAudio()
     m_isAudioActive = false;
     
     // Reset audio levels
-    m_inputLevel = 0.0f;
+    m_levelMeter.reset();
     
     // Notify audio stopped
     m_eventDispatcher.publish(EventType::AudioProcessingStopped);
@@ -357,7 +356,7 @@ bool AudioDeviceManager::isAudioActive() const
 
 float AudioDeviceManager::getInputLevel() const
 {
-    return m_inputLevel.load(std::memory_order_relaxed);
+    return m_levelMeter.getLevel();
 }
 
 bool AudioDeviceManager::isInputMuted() const
@@ -379,6 +378,14 @@ void AudioDeviceManager::audioDeviceIOCallbackWithContext(
     int numSamples,
     const juce::AudioIODeviceCallbackContext& context)
 {
+    // JUCE announces a start on the thread that opened the device, so the
+    // audio thread claims one of the collector's preallocated span rings
+    // here, before the first block is processed; this takes no lock
+    if (!m_audioThreadPrepared.load(std::memory_order_relaxed)) {
+        utils::PerfSpanCollector::getInstance().prepareThread("audio");
+        m_audioThreadPrepared.store(true, std::memory_order_relaxed);
+    }
+    
     // Ignore output (we don't produce any)
     if (outputChannelData != nullptr) {
         for (int ch = 0; ch < numOutputChannels; ++ch) {
@@ -407,17 +414,24 @@ void AudioDeviceManager::audioDeviceAboutToStart(juce::AudioIODevice* device)
             m_currentBufferSize,
             m_currentSampleRate
         );
+        
+        LOGF_INFO("Audio device started: {} Hz, {} samples", m_currentSampleRate, m_currentBufferSize);
     }
+    
+    // The restarted device may call back on a new thread
+    m_audioThreadPrepared.store(false, std::memory_order_relaxed);
 }
 
 void AudioDeviceManager::audioDeviceStopped()
 {
     // Reset level when device stops
-    m_inputLevel.store(0.0f, std::memory_order_relaxed);
+    m_levelMeter.reset();
 }
 
 void AudioDeviceManager::audioDeviceError(const juce::String& errorMessage)
 {
+    LOGF_ERROR("Audio device error: {}", errorMessage.toRawUTF8());
+    
     // Publish error event
     m_eventDispatcher.publish(
         EventType::AudioDeviceError,
@@ -512,12 +526,16 @@ void AudioDeviceManager::processAudioBlock(const float* const* inputData,
 {
     // Check if input is muted
     if (m_inputMuted.load(std::memory_order_relaxed)) {
-        m_inputLevel.store(0.0f, std::memory_order_relaxed);
+        m_levelMeter.reset();
         return;
     }
     
-    // Ensure we have a valid buffer
+    // Ensure we have a valid buffer. Growing it allocates on the audio
+    // thread, which should only happen when the device hands us a larger
+    // block than it announced in audioDeviceAboutToStart()
     if (!m_inputBuffer || m_inputBuffer->getNumSamples() < numSamples) {
+        LOGF_WARNING("Audio block of {} samples exceeds the {} sample input buffer, reallocating",
+                     numSamples, m_inputBuffer ? m_inputBuffer->getNumSamples() : 0);
         m_inputBuffer = std::make_unique<AudioBuffer>(
             std::min(numChannels, MAX_CHANNELS),
             numSamples,
@@ -535,39 +553,9 @@ void AudioDeviceManager::processAudioBlock(const float* const* inputData,
         }
     }
     
-    // Calculate input level (RMS across all channels)
-    float rmsLevel = 0.0f;
-    for (int ch = 0; ch < channelsToProcess; ++ch) {
-        float channelRms = m_inputBuffer->getRMSLevel(ch, 0, numSamples);
-        rmsLevel += channelRms * channelRms;
-    }
-    rmsLevel = std::sqrt(rmsLevel / channelsToProcess);
-    
-    // Convert to dB and smooth
-    float levelDb = 20.0f * std::log10(std::max(rmsLevel, 1e-6f));
-    levelDb = std::max(levelDb, MIN_LEVEL_DB);
-    levelDb = std::min(levelDb, MAX_LEVEL_DB);
-    
-    // Normalize to 0-1 range
-    float normalizedLevel = (levelDb - MIN_LEVEL_DB) / (MAX_LEVEL_DB - MIN_LEVEL_DB);
-    
-    // Apply smoothing
-    float currentLevel = m_inputLevel.load(std::memory_order_relaxed);
-    float smoothedLevel = currentLevel * LEVEL_SMOOTHING_FACTOR + 
-                         normalizedLevel * (1.0f - LEVEL_SMOOTHING_FACTOR);
-    
-    m_inputLevel.store(smoothedLevel, std::memory_order_relaxed);
-    
-    // Publish level update (throttled to avoid flooding)
-    static std::chrono::steady_clock::time_point lastLevelUpdate;
-    auto now = std::chrono::steady_clock::now();
-    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastLevelUpdate).count() > 50) {
-        m_eventDispatcher.publish(
-            EventType::AudioLevelChanged,
-            EventDataFactory::createAudioLevelData(smoothedLevel)
-        );
-        lastLevelUpdate = now;
-    }
+    // Level metering and its AudioLevelChanged updates exist only for the
+    // UI; skipped entirely when nothing listens (headless runs)
+    m_levelMeter.process(*m_inputBuffer, channelsToProcess, numSamples);
     
     // Call audio callback if set
     if (m_audioCallback) {
@@ -0,0 +1,561 @@
+#include "quiet/core/ConfigJson.h"
+#include "quiet/utils/StructuredLog.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace quiet {
+namespace core {
+
+namespace {
+
+// Deeper documents are rejected rather than risking the stack
+constexpr int kMaxDepth = 64;
+
+class ConfigJsonParser {
+public:
+    explicit ConfigJsonParser(std::string_view text)
+        : m_text(text) {
+    }
+
+    ConfigJsonResult parseDocument(std::unordered_map<std::string, ConfigValue>& values) {
+        skipWhitespace();
+        if (!consume('{')) {
+            fail("Expected '{' at the start of the document");
+        } else {
+            std::string path;
+            if (parseSection(path, values, 1)) {
+                skipWhitespace();
+                if (m_pos != m_text.size()) {
+                    fail("Unexpected text after the document");
+                }
+            }
+        }
+
+        ConfigJsonResult result;
+        result.ok = m_error.empty();
+        result.offset = m_pos;
+        result.error = std::move(m_error);
+        return result;
+    }
+
+private:
+    // Members of a section object; nested sections extend the dotted path
+    bool parseSection(std::string& path, std::unordered_map<std::string, ConfigValue>& values, int depth) {
+        if (depth > kMaxDepth) {
+            return fail("Sections nested too deeply");
+        }
+
+        skipWhitespace();
+        if (consume('}')) {
+            return true;
+        }
+
+        for (;;) {
+            skipWhitespace();
+            if (!parseString(m_key)) {
+                return false;
+            }
+
+            size_t pathLength = path.size();
+            if (depth > 1) {
+                path += '.';
+            }
+            path += m_key;
+
+            skipWhitespace();
+            if (!consume(':')) {
+                return fail("Expected ':' after a key");
+            }
+            skipWhitespace();
+
+            if (consume('{')) {
+                if (!parseSection(path, values, depth + 1)) {
+                    return false;
+                }
+            } else {
+                ConfigValue value;
+                if (!parseValue(value, depth)) {
+                    return false;
+                }
+                values.insert_or_assign(path, std::move(value));
+            }
+            path.resize(pathLength);
+
+            skipWhitespace();
+            if (consume(',')) {
+                continue;
+            }
+            if (consume('}')) {
+                return true;
+            }
+            return fail("Expected ',' or '}' after a value");
+        }
+    }
+
+    bool parseValue(ConfigValue& out, int depth) {
+        if (depth > kMaxDepth) {
+            return fail("Values nested too deeply");
+        }
+        if (m_pos >= m_text.size()) {
+            return fail("Unexpected end of document");
+        }
+
+        switch (m_text[m_pos]) {
+            case '"': {
+                std::string text;
+                if (!parseString(text)) {
+                    return false;
+                }
+                out.set(std::move(text));
+                return true;
+            }
+            case '{':
+                ++m_pos;
+                return parseObject(out, depth + 1);
+            case '[':
+                ++m_pos;
+                return parseArray(out, depth + 1);
+            case 't':
+                return parseLiteral("true", [&out] { out.set(true); });
+            case 'f':
+                return parseLiteral("false", [&out] { out.set(false); });
+            case 'n':
+                return parseLiteral("null", [&out] { out.clear(); });
+            default:
+                return parseNumber(out);
+        }
+    }
+
+    bool parseObject(ConfigValue& out, int depth) {
+        ConfigObject object;
+        skipWhitespace();
+        if (!consume('}')) {
+            std::string key;
+            for (;;) {
+                skipWhitespace();
+                if (!parseString(key)) {
+                    return false;
+                }
+                skipWhitespace();
+                if (!consume(':')) {
+                    return fail("Expected ':' after a key");
+                }
+                skipWhitespace();
+
+                ConfigValue value;
+                if (!parseValue(value, depth)) {
+                    return false;
+                }
+                object.insert_or_assign(key, std::move(value));
+
+                skipWhitespace();
+                if (consume(',')) {
+                    continue;
+                }
+                if (consume('}')) {
+                    break;
+                }
+                return fail("Expected ',' or '}' in an object");
+            }
+        }
+        out.set(std::move(object));
+        return true;
+    }
+
+    bool parseArray(ConfigValue& out, int depth) {
+        ConfigArray array;
+        skipWhitespace();
+        if (!consume(']')) {
+            for (;;) {
+                skipWhitespace();
+                array.emplace_back();
+                if (!parseValue(array.back(), depth)) {
+                    return false;
+                }
+
+                skipWhitespace();
+                if (consume(',')) {
+                    continue;
+                }
+                if (consume(']')) {
+                    break;
+                }
+                return fail("Expected ',' or ']' in an array");
+            }
+        }
+        out.set(std::move(array));
+        return true;
+    }
+
+    template<typename Assign>
+    bool parseLiteral(std::string_view literal, Assign assign) {
+        if (m_text.substr(m_pos, literal.size()) != literal) {
+            return fail("Unknown literal");
+        }
+        m_pos += literal.size();
+        assign();
+        return true;
+    }
+
+    bool parseNumber(ConfigValue& out) {
+        size_t start = m_pos;
+        bool isInteger = true;
+
+        consume('-');
+        if (!skipDigits()) {
+            return fail("Expected a value");
+        }
+        if (consume('.')) {
+            isInteger = false;
+            if (!skipDigits()) {
+                return fail("Expected digits after '.'");
+            }
+        }
+        if (consume('e') || consume('E')) {
+            isInteger = false;
+            if (!consume('+')) {
+                consume('-');
+            }
+            if (!skipDigits()) {
+                return fail("Expected digits in the exponent");
+            }
+        }
+
+        const char* begin = m_text.data() + start;
+        const char* end = m_text.data() + m_pos;
+
+        if (isInteger) {
+            int64_t value = 0;
+            auto [ptr, ec] = std::from_chars(begin, end, value);
+            if (ec == std::errc() && ptr == end) {
+                if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()) {
+                    out.set(static_cast<int>(value));
+                } else {
+                    out.set(value);
+                }
+                return true;
+            }
+            // Too large for int64_t: keep it as a double
+        }
+
+        double value = 0.0;
+        auto [ptr, ec] = std::from_chars(begin, end, value);
+        if (ec != std::errc() || ptr != end) {
+            m_pos = start;
+            return fail("Number out of range");
+        }
+        out.set(value);
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        if (!consume('"')) {
+            return fail("Expected a string");
+        }
+
+        out.clear();
+        for (;;) {
+            // Copy the run up to the next quote or escape in one go
+            size_t runStart = m_pos;
+            while (m_pos < m_text.size() && m_text[m_pos] != '"' && m_text[m_pos] != '\\') {
+                ++m_pos;
+            }
+            out.append(m_text.data() + runStart, m_pos - runStart);
+
+            if (m_pos >= m_text.size()) {
+                return fail("Unterminated string");
+            }
+            if (m_text[m_pos++] == '"') {
+                return true;
+            }
+            if (!parseEscape(out)) {
+                return false;
+            }
+        }
+    }
+
+    bool parseEscape(std::string& out) {
+        if (m_pos >= m_text.size()) {
+            return fail("Unterminated string");
+        }
+
+        char c = m_text[m_pos++];
+        switch (c) {
+            case '"': out += '"'; return true;
+            case '\\': out += '\\'; return true;
+            case '/': out += '/'; return true;
+            case 'b': out += '\b'; return true;
+            case 'f': out += '\f'; return true;
+            case 'n': out += '\n'; return true;
+            case 'r': out += '\r'; return true;
+            case 't': out += '\t'; return true;
+            case 'u': break;
+            default: return fail("Invalid escape");
+        }
+
+        uint32_t codePoint = 0;
+        if (!parseHex4(codePoint)) {
+            return false;
+        }
+
+        // A high surrogate must be followed by its low half
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+            uint32_t low = 0;
+            if (!consume('\\') || !consume('u') || !parseHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                return fail("Invalid surrogate pair");
+            }
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+        } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+            return fail("Invalid surrogate pair");
+        }
+
+        appendUtf8(out, codePoint);
+        return true;
+    }
+
+    bool parseHex4(uint32_t& value) {
+        if (m_text.size() - m_pos < 4) {
+            return fail("Truncated \\u escape");
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = m_text[m_pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                return fail("Invalid \\u escape");
+            }
+        }
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    bool skipDigits() {
+        size_t start = m_pos;
+        while (m_pos < m_text.size() && m_text[m_pos] >= '0' && m_text[m_pos] <= '9') {
+            ++m_pos;
+        }
+        return m_pos > start;
+    }
+
+    void skipWhitespace() {
+        while (m_pos < m_text.size() &&
+               (m_text[m_pos] == ' ' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r' || m_text[m_pos] == '\t')) {
+            ++m_pos;
+        }
+    }
+
+    bool consume(char c) {
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool fail(const char* message) {
+        if (m_error.empty()) {
+            m_error = message;
+        }
+        return false;
+    }
+
+    std::string_view m_text;
+    size_t m_pos = 0;
+    std::string m_key;     // Reused for section keys
+    std::string m_error;
+};
+
+template<typename T>
+void appendInteger(std::string& out, T value) {
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, static_cast<size_t>(result.ptr - text));
+}
+
+void appendDouble(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+
+    // Shortest text that parses back to the same double
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    std::string_view number(text, static_cast<size_t>(result.ptr - text));
+    out += number;
+    if (number.find_first_of(".e") == std::string_view::npos) {
+        out += ".0";  // Still a double when read back
+    }
+}
+
+// Splits a key into the sections to nest it under and the name left for the
+// value. A prefix that is itself a key holds a value, so it cannot also be a
+// section; the rest of the key then stays dotted
+size_t sectionCount(const std::string& key, const std::unordered_map<std::string, ConfigValue>& values,
+                    std::vector<std::string_view>& sections) {
+    sections.clear();
+    size_t start = 0;
+    for (size_t dot = key.find('.'); dot != std::string::npos; dot = key.find('.', start)) {
+        if (values.count(key.substr(0, dot)) != 0) {
+            break;
+        }
+        sections.emplace_back(key.data() + start, dot - start);
+        start = dot + 1;
+    }
+    return start;
+}
+
+void appendIndent(std::string& out, size_t depth) {
+    out.append(depth * 2, ' ');
+}
+
+} // namespace
+
+ConfigJsonResult parseConfigJson(std::string_view text, std::unordered_map<std::string, ConfigValue>& values) {
+    return ConfigJsonParser(text).parseDocument(values);
+}
+
+void appendConfigJsonValue(std::string& out, const ConfigValue& value) {
+    if (value.empty()) {
+        out += "null";
+    } else if (const auto* v = value.getIf<bool>()) {
+        out += *v ? "true" : "false";
+    } else if (const auto* v = value.getIf<int>()) {
+        appendInteger(out, *v);
+    } else if (const auto* v = value.getIf<double>()) {
+        appendDouble(out, *v);
+    } else if (const auto* v = value.getIf<std::string>()) {
+        utils::appendJsonString(out, *v);
+    } else if (const auto* v = value.getIf<const char*>()) {
+        utils::appendJsonString(out, *v ? std::string_view(*v) : std::string_view());
+    } else if (const auto* v = value.getIf<long>()) {
+        appendInteger(out, *v);
+    } else if (const auto* v = value.getIf<long long>()) {
+        appendInteger(out, *v);
+    } else if (const auto* v = value.getIf<unsigned>()) {
+        appendInteger(out, *v);
+    } else if (const auto* v = value.getIf<unsigned long>()) {
+        appendInteger(out, *v);
+    } else if (const auto* v = value.getIf<unsigned long long>()) {
+        appendInteger(out, *v);
+    } else if (const auto* v = value.getIf<float>()) {
+        appendDouble(out, static_cast<double>(*v));
+    } else if (const auto* v = value.getIf<ConfigArray>()) {
+        out += '[';
+        for (size_t i = 0; i < v->size(); ++i) {
+            if (i > 0) {
+                out += ", ";
+            }
+            appendConfigJsonValue(out, (*v)[i]);
+        }
+        out += ']';
+    } else if (const auto* v = value.getIf<ConfigObject>()) {
+        out += '{';
+        bool first = true;
+        for (const auto& [key, member] : *v) {
+            if (!first) {
+                out += ", ";
+            }
+            first = false;
+            utils::appendJsonString(out, key);
+            out += ": ";
+            appendConfigJsonValue(out, member);
+        }
+        out += '}';
+    } else {
+        out += "null";
+    }
+}
+
+std::string writeConfigJson(const std::unordered_map<std::string, ConfigValue>& values) {
+    // Sorted, so keys sharing a section are next to each other
+    std::vector<const std::pair<const std::string, ConfigValue>*> entries;
+    entries.reserve(values.size());
+    for (const auto& entry : values) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    std::string out;
+    out.reserve(values.size() * 48 + 16);
+    out += '{';
+
+    std::vector<std::string_view> open;          // Sections currently open
+    std::vector<bool> firstAtDepth{true};        // Whether each open level is still empty
+    std::vector<std::string_view> sections;
+
+    auto startMember = [&](size_t depth) {
+        out += firstAtDepth[depth] ? "\n" : ",\n";
+        firstAtDepth[depth] = false;
+        appendIndent(out, depth + 1);
+    };
+
+    for (const auto* entry : entries) {
+        const std::string& key = entry->first;
+        size_t nameStart = sectionCount(key, values, sections);
+
+        // Close the sections this key is not in, then open the ones it is
+        size_t common = 0;
+        while (common < open.size() && common < sections.size() && open[common] == sections[common]) {
+            ++common;
+        }
+        while (open.size() > common) {
+            out += '\n';
+            appendIndent(out, open.size());
+            out += '}';
+            open.pop_back();
+            firstAtDepth.pop_back();
+        }
+        for (size_t i = common; i < sections.size(); ++i) {
+            startMember(open.size());
+            utils::appendJsonString(out, sections[i]);
+            out += ": {";
+            open.push_back(sections[i]);
+            firstAtDepth.push_back(true);
+        }
+
+        startMember(open.size());
+        utils::appendJsonString(out, std::string_view(key).substr(nameStart));
+        out += ": ";
+        appendConfigJsonValue(out, entry->second);
+    }
+
+    while (!open.empty()) {
+        out += '\n';
+        appendIndent(out, open.size());
+        out += '}';
+        open.pop_back();
+    }
+    out += "\n}\n";
+    return out;
+}
+
+} // namespace core
+} // namespace quiet
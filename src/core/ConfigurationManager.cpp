@@ -1,25 +1,25 @@
 #include "quiet/core/ConfigurationManager.h"
+#include "quiet/core/ConfigJson.h"
 #include <fstream>
 #include <filesystem>
 #include <thread>
 #include <chrono>
 #include <algorithm>
-#include <regex>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
 
-// Simple JSON parsing for configuration
-#include <sstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace quiet {
 namespace core {
 
 namespace {
-    // Simple JSON parsing functions
-    std::string trim(const std::string& str) {
-        size_t start = str.find_first_not_of(" \t\n\r");
-        if (start == std::string::npos) return "";
-        size_t end = str.find_last_not_of(" \t\n\r");
-        return str.substr(start, end - start + 1);
-    }
+    // First retry after a failed save, when the save delay is shorter
+    constexpr std::chrono::milliseconds kMinSaveRetryDelay{100};
     
     std::string getDefaultConfigPath() {
         #ifdef _WIN32
@@ -36,10 +36,133 @@ namespace {
             return "config.json";
         #endif
     }
+    
+    // Exact keys and "section.*" patterns go in the callback index: path is
+    // the key or section, subtree says which. Other globs return false.
+    bool indexedPattern(const std::string& pattern, std::string_view& path, bool& subtree) {
+        path = pattern;
+        subtree = path.size() > 2 && path.substr(path.size() - 2) == ".*";
+        if (subtree) {
+            path.remove_suffix(2);
+        }
+        return path.find('*') == std::string_view::npos;
+    }
+    
+    // Calls visit(segment) for each dot-separated segment until it returns false
+    template<typename Visit>
+    bool forEachSegment(std::string_view path, Visit visit) {
+        size_t start = 0;
+        for (;;) {
+            size_t dot = path.find('.', start);
+            if (!visit(path.substr(start, dot == std::string_view::npos ? std::string_view::npos : dot - start))) {
+                return false;
+            }
+            if (dot == std::string_view::npos) {
+                return true;
+            }
+            start = dot + 1;
+        }
+    }
+    
+    // '*' matches any run of characters, dots included
+    bool globMatch(std::string_view pattern, std::string_view text) {
+        size_t p = 0;
+        size_t t = 0;
+        size_t starPattern = std::string_view::npos;
+        size_t starText = 0;
+        while (t < text.size()) {
+            if (p < pattern.size() && pattern[p] == '*') {
+                starPattern = p++;
+                starText = t;
+            } else if (p < pattern.size() && pattern[p] == text[t]) {
+                ++p;
+                ++t;
+            } else if (starPattern != std::string_view::npos) {
+                p = starPattern + 1;
+                t = ++starText;
+            } else {
+                return false;
+            }
+        }
+        while (p < pattern.size() && pattern[p] == '*') {
+            ++p;
+        }
+        return p == pattern.size();
+    }
+    
+    // Compares through the JSON form; values JSON cannot hold never compare equal
+    bool sameValue(const ConfigValue& a, const ConfigValue& b) {
+        if (a.empty() || b.empty()) {
+            return a.empty() && b.empty();
+        }
+        std::string left;
+        std::string right;
+        appendConfigJsonValue(left, a);
+        appendConfigJsonValue(right, b);
+        return left == right && left != "null";
+    }
+    
+    // Tells apart managers in the per-thread snapshot cache
+    std::atomic<uint64_t> g_nextInstanceId{1};
+    
+    // Writes a sibling temp file and renames it over the target, so a crash
+    // mid-save leaves either the old file or the new one, never a torn one
+    bool writeFileAtomically(const std::string& path, const std::string& content, std::string& error) {
+        std::string tempPath = path + ".tmp";
+        
+#ifdef _WIN32
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        file.close();
+        if (!file) {
+            error = "Cannot write " + tempPath;
+            return false;
+        }
+#else
+        int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            error = "Cannot open " + tempPath + ": " + std::strerror(errno);
+            return false;
+        }
+        
+        const char* data = content.data();
+        size_t remaining = content.size();
+        while (remaining > 0) {
+            ssize_t written = ::write(fd, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                error = "Cannot write " + tempPath + ": " + std::strerror(errno);
+                ::close(fd);
+                return false;
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        
+        // The data has to be on disk before the rename makes it the config
+        if (::fsync(fd) != 0 || ::close(fd) != 0) {
+            error = "Cannot sync " + tempPath + ": " + std::strerror(errno);
+            return false;
+        }
+#endif
+        
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec) {
+            error = "Cannot replace " + path + ": " + ec.message();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
 }
 
 ConfigurationManager::ConfigurationManager(EventDispatcher& eventDispatcher)
-    : m_eventDispatcher(eventDispatcher) {
+    : m_eventDispatcher(eventDispatcher)
+    , m_instanceId(g_nextInstanceId.fetch_add(1, std::memory_order_relaxed))
+    , m_snapshot(std::make_shared<const ConfigSnapshot>()) {
     
     initializeDefaults();
 }
@@ -78,6 +201,7 @@ bool ConfigurationManager::initialize(const std::string& configFilePath) {
             {
                 std::lock_guard<std::mutex> lock(m_mutex);
                 m_values = m_defaults;
+                publishSnapshotLocked();
             }
             saveConfiguration();
         }
@@ -86,14 +210,17 @@ bool ConfigurationManager::initialize(const std::string& configFilePath) {
         {
             std::lock_guard<std::mutex> lock(m_mutex);
             m_values = m_defaults;
+            publishSnapshotLocked();
         }
         saveConfiguration();
     }
     
-    // Start auto-save thread
-    if (m_autoSaveEnabled) {
-        m_shouldStopAutoSave.store(false);
-        m_autoSaveThread = std::make_unique<std::thread>(&ConfigurationManager::autoSaveWorker, this);
+    // Start the persistence thread
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_autoSaveEnabled) {
+            startPersistenceLocked();
+        }
     }
     
     m_isInitialized = true;
@@ -112,17 +239,15 @@ void ConfigurationManager::shutdown() {
         return;
     }
     
-    // Stop auto-save thread
-    if (m_autoSaveThread) {
-        m_shouldStopAutoSave.store(true);
-        if (m_autoSaveThread->joinable()) {
-            m_autoSaveThread->join();
-        }
-        m_autoSaveThread.reset();
-    }
+    // Stop the persistence thread, then write whatever it had not yet
+    stopPersistence();
     
-    // Save any pending changes
-    if (m_isDirty) {
+    bool dirty;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dirty = m_isDirty || m_saveRequested;
+    }
+    if (dirty) {
         saveConfiguration();
     }
     
@@ -131,6 +256,9 @@ void ConfigurationManager::shutdown() {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_values.clear();
         m_callbacks.clear();
+        m_callbackIndex = CallbackTrieNode{};
+        m_wildcardCallbacks.clear();
+        publishSnapshotLocked();
     }
     
     m_isInitialized = false;
@@ -141,8 +269,7 @@ bool ConfigurationManager::isInitialized() const {
 }
 
 bool ConfigurationManager::hasValue(const std::string& key) const {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_values.find(key) != m_values.end();
+    return currentSnapshot().has(key);
 }
 
 void ConfigurationManager::removeValue(const std::string& key) {
@@ -153,7 +280,8 @@ void ConfigurationManager::removeValue(const std::string& key) {
         if (it != m_values.end()) {
             oldValue = it->second;
             m_values.erase(it);
-            m_isDirty = true;
+            markDirtyLocked();
+            publishSnapshotLocked();
         } else {
             return;  // Key doesn't exist
         }
@@ -163,30 +291,37 @@ void ConfigurationManager::removeValue(const std::string& key) {
 }
 
 void ConfigurationManager::clear() {
-    std::unordered_map<std::string, ConfigValue> oldValues;
+    std::vector<ConfigChange> changes;
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        oldValues = m_values;
+        changes.reserve(m_values.size());
+        for (auto& [key, oldValue] : m_values) {
+            changes.push_back(ConfigChange{key, std::move(oldValue), ConfigValue()});
+        }
         m_values.clear();
-        m_isDirty = true;
+        markDirtyLocked();
+        publishSnapshotLocked();
     }
     
-    // Notify about all changes
-    for (const auto& [key, oldValue] : oldValues) {
-        notifyChange(key, oldValue, ConfigValue());
-    }
+    // Notify about all changes at once
+    std::sort(changes.begin(), changes.end(),
+              [](const ConfigChange& a, const ConfigChange& b) { return a.key < b.key; });
+    notifyChanges(changes);
 }
 
 bool ConfigurationManager::loadConfiguration() {
     try {
-        std::ifstream file(m_configFilePath);
+        std::ifstream file(m_configFilePath, std::ios::binary | std::ios::ate);
         if (!file.is_open()) {
             m_stats.lastError = "Cannot open config file for reading";
             return false;
         }
         
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
+        // Read in one go; the parser works on the whole document
+        std::string content(static_cast<size_t>(std::max<std::streamoff>(file.tellg(), 0)), '\0');
+        file.seekg(0);
+        file.read(content.data(), static_cast<std::streamsize>(content.size()));
+        content.resize(static_cast<size_t>(std::max<std::streamsize>(file.gcount(), 0)));
         file.close();
         
         if (content.empty()) {
@@ -194,61 +329,23 @@ bool ConfigurationManager::loadConfiguration() {
             return false;
         }
         
-        // Simple JSON parsing (in a real implementation, use a proper JSON library)
         std::unordered_map<std::string, ConfigValue> loadedValues;
-        
-        // Remove outer braces and parse key-value pairs
-        content = trim(content);
-        if (content.front() == '{' && content.back() == '}') {
-            content = content.substr(1, content.length() - 2);
-        }
-        
-        std::istringstream iss(content);
-        std::string line;
-        
-        while (std::getline(iss, line, ',')) {
-            size_t colonPos = line.find(':');
-            if (colonPos == std::string::npos) continue;
-            
-            std::string key = trim(line.substr(0, colonPos));
-            std::string value = trim(line.substr(colonPos + 1));
-            
-            // Remove quotes from key
-            if (key.front() == '"' && key.back() == '"') {
-                key = key.substr(1, key.length() - 2);
-            }
-            
-            // Parse value based on type
-            ConfigValue configValue;
-            if (value == "true") {
-                configValue.set(true);
-            } else if (value == "false") {
-                configValue.set(false);
-            } else if (value.front() == '"' && value.back() == '"') {
-                // String value
-                configValue.set(value.substr(1, value.length() - 2));
-            } else {
-                // Try to parse as number
-                try {
-                    if (value.find('.') != std::string::npos) {
-                        configValue.set(std::stod(value));
-                    } else {
-                        configValue.set(std::stoi(value));
-                    }
-                } catch (...) {
-                    // Fall back to string
-                    configValue.set(value);
-                }
-            }
-            
-            loadedValues[key] = configValue;
+        ConfigJsonResult parsed = parseConfigJson(content, loadedValues);
+        if (!parsed.ok) {
+            m_stats.lastError = "Invalid config file at offset " + std::to_string(parsed.offset) + ": " + parsed.error;
+            return false;
         }
         
-        // Update values
+        // Update values; what is on disk now matches them
         {
+            std::lock_guard<std::mutex> saveLock(m_saveMutex);
             std::lock_guard<std::mutex> lock(m_mutex);
             m_values = std::move(loadedValues);
             m_isDirty = false;
+            m_unsavedChanges = 0;
+            publishSnapshotLocked();
+            m_savedVersion = m_snapshotVersion.load(std::memory_order_relaxed);
+            m_lastSavedContent = std::move(content);
         }
         
         m_stats.loadCount++;
@@ -263,115 +360,167 @@ bool ConfigurationManager::loadConfiguration() {
 }
 
 bool ConfigurationManager::saveConfiguration() {
-    try {
-        // Ensure directory exists
-        std::filesystem::path configPath(m_configFilePath);
-        std::error_code ec;
-        std::filesystem::create_directories(configPath.parent_path(), ec);
-        
-        std::ofstream file(m_configFilePath);
-        if (!file.is_open()) {
-            m_stats.lastError = "Cannot open config file for writing";
-            return false;
-        }
-        
-        file << "{\n";
-        
-        bool first = true;
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            
-            for (const auto& [key, value] : m_values) {
-                if (!first) {
-                    file << ",\n";
-                }
-                first = false;
-                
-                file << "  \"" << key << "\": ";
-                
-                // Serialize value based on type
-                // This is a simplified approach - in practice, use proper JSON serialization
-                try {
-                    // Try different types
-                    if (auto strVal = value.get<std::string>(""); !strVal.empty() || 
-                        (strVal.empty() && !value.empty())) {
-                        file << "\"" << strVal << "\"";
-                    } else if (auto boolVal = value.get<bool>(false); 
-                              value.get<bool>(true) != value.get<bool>(false)) {
-                        file << (boolVal ? "true" : "false");
-                    } else if (auto intVal = value.get<int>(0); 
-                              value.get<int>(-1) != value.get<int>(0)) {
-                        file << intVal;
-                    } else if (auto doubleVal = value.get<double>(0.0); 
-                              value.get<double>(-1.0) != value.get<double>(0.0)) {
-                        file << doubleVal;
-                    } else {
-                        file << "null";
-                    }
-                } catch (...) {
-                    file << "null";
-                }
-            }
-            
+    std::lock_guard<std::mutex> saveLock(m_saveMutex);
+    auto start = std::chrono::steady_clock::now();
+    
+    // Take the current snapshot; it is serialized without holding the lock
+    std::shared_ptr<const ConfigSnapshot> snapshot;
+    std::string path;
+    uint64_t changes = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_saveRequested = false;
+        snapshot = getSnapshot();
+        if (snapshot->version() == m_savedVersion) {
             m_isDirty = false;
+            m_stats.skippedSaves++;
+            return true;
         }
         
-        file << "\n}\n";
-        file.close();
-        
-        m_stats.saveCount++;
-        
-        return true;
+        changes = m_unsavedChanges;
+        m_unsavedChanges = 0;
+        m_isDirty = false;
+        path = m_configFilePath;
+    }
+    
+    std::string content;
+    std::string error;
+    bool unchanged = false;
+    bool saved = false;
+    try {
+        content = serializeSnapshot(*snapshot);
         
+        // Values changed and changed back: the file is already right
+        unchanged = content == m_lastSavedContent;
+        if (!unchanged) {
+            std::filesystem::path configPath(path);
+            std::error_code ec;
+            std::filesystem::create_directories(configPath.parent_path(), ec);
+        }
+        saved = unchanged || writeFileAtomically(path, content, error);
     } catch (const std::exception& e) {
-        m_stats.lastError = "Exception during save: " + std::string(e.what());
+        error = "Exception during save: " + std::string(e.what());
+    }
+    
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!saved) {
+        // Keep the changes pending so the next save retries them
+        m_isDirty = true;
+        m_unsavedChanges += changes;
+        m_stats.failedSaves++;
+        m_stats.lastError = error;
         return false;
     }
+    
+    m_savedVersion = std::max(m_savedVersion, snapshot->version());
+    m_stats.coalescedChanges += changes;
+    if (unchanged) {
+        m_stats.skippedSaves++;
+        return true;
+    }
+    
+    m_lastSavedContent = std::move(content);
+    m_stats.saveCount++;
+    m_stats.lastSaveMs = elapsedMs;
+    m_stats.maxSaveMs = std::max(m_stats.maxSaveMs, elapsedMs);
+    m_totalSaveMs += elapsedMs;
+    
+    return true;
 }
 
-void ConfigurationManager::setAutoSave(bool enabled, int intervalSeconds) {
-    m_autoSaveEnabled = enabled;
-    m_autoSaveInterval = intervalSeconds;
-    
-    // Restart auto-save thread if running
-    if (m_isInitialized && m_autoSaveThread) {
-        m_shouldStopAutoSave.store(true);
-        if (m_autoSaveThread->joinable()) {
-            m_autoSaveThread->join();
+void ConfigurationManager::requestSave() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_persistenceRunning) {
+            m_saveRequested = true;
+            m_persistenceCondition.notify_one();
+            return;
         }
+    }
+    
+    // No persistence thread to hand it to
+    saveConfiguration();
+}
+
+void ConfigurationManager::setAutoSave(bool enabled, int intervalSeconds) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_autoSaveEnabled = enabled;
+        m_autoSaveInterval = std::max(intervalSeconds, 1);
         
+        // A running thread picks up the new interval on its next save
         if (enabled) {
-            m_shouldStopAutoSave.store(false);
-            m_autoSaveThread = std::make_unique<std::thread>(&ConfigurationManager::autoSaveWorker, this);
+            if (m_isInitialized && !m_persistenceRunning) {
+                startPersistenceLocked();
+            }
+            m_persistenceCondition.notify_all();
+            return;
         }
     }
+    
+    stopPersistence();
+}
+
+void ConfigurationManager::setSaveDelay(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_saveDelay = std::max(delay, std::chrono::milliseconds(0));
+    m_persistenceCondition.notify_all();
+}
+
+std::shared_ptr<const ConfigSnapshot> ConfigurationManager::getSnapshot() const {
+    return std::atomic_load(&m_snapshot);
 }
 
 ConfigurationManager::CallbackHandle ConfigurationManager::addChangeCallback(
     const std::string& keyPattern, ChangeCallback callback) {
     
     std::lock_guard<std::mutex> lock(m_mutex);
-    
-    CallbackHandle handle = m_nextCallbackHandle++;
-    CallbackInfo info;
-    info.pattern = keyPattern;
-    info.callback = std::move(callback);
-    info.isGlobal = false;
-    
-    m_callbacks[handle] = std::move(info);
-    m_stats.callbacks = m_callbacks.size();
-    
-    return handle;
+    return addCallbackLocked(keyPattern, std::make_shared<const ChangeCallback>(std::move(callback)), nullptr);
 }
 
 ConfigurationManager::CallbackHandle ConfigurationManager::addGlobalChangeCallback(ChangeCallback callback) {
     std::lock_guard<std::mutex> lock(m_mutex);
+    return addCallbackLocked("*", std::make_shared<const ChangeCallback>(std::move(callback)), nullptr);
+}
+
+ConfigurationManager::CallbackHandle ConfigurationManager::addBatchChangeCallback(
+    const std::string& keyPattern, BatchChangeCallback callback) {
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return addCallbackLocked(keyPattern, nullptr, std::make_shared<const BatchChangeCallback>(std::move(callback)));
+}
+
+ConfigurationManager::CallbackHandle ConfigurationManager::addCallbackLocked(
+    const std::string& keyPattern, std::shared_ptr<const ChangeCallback> callback,
+    std::shared_ptr<const BatchChangeCallback> batchCallback) {
     
     CallbackHandle handle = m_nextCallbackHandle++;
     CallbackInfo info;
-    info.pattern = "*";
+    info.pattern = keyPattern;
     info.callback = std::move(callback);
-    info.isGlobal = true;
+    info.batchCallback = std::move(batchCallback);
+    info.isGlobal = keyPattern == "*";
+    
+    std::string_view path;
+    bool subtree = false;
+    if (info.isGlobal) {
+        m_callbackIndex.subtree.push_back(handle);
+    } else if (indexedPattern(keyPattern, path, subtree)) {
+        CallbackTrieNode* node = &m_callbackIndex;
+        forEachSegment(path, [&node](std::string_view segment) {
+            auto it = node->children.find(segment);
+            if (it == node->children.end()) {
+                it = node->children.emplace(std::string(segment), std::make_unique<CallbackTrieNode>()).first;
+            }
+            node = it->second.get();
+            return true;
+        });
+        (subtree ? node->subtree : node->exact).push_back(handle);
+    } else {
+        m_wildcardCallbacks.push_back(handle);
+    }
     
     m_callbacks[handle] = std::move(info);
     m_stats.callbacks = m_callbacks.size();
@@ -383,13 +532,38 @@ bool ConfigurationManager::removeChangeCallback(CallbackHandle handle) {
     std::lock_guard<std::mutex> lock(m_mutex);
     
     auto it = m_callbacks.find(handle);
-    if (it != m_callbacks.end()) {
-        m_callbacks.erase(it);
-        m_stats.callbacks = m_callbacks.size();
-        return true;
+    if (it == m_callbacks.end()) {
+        return false;
+    }
+    
+    auto eraseHandle = [handle](std::vector<CallbackHandle>& handles) {
+        handles.erase(std::remove(handles.begin(), handles.end(), handle), handles.end());
+    };
+    
+    std::string_view path;
+    bool subtree = false;
+    if (it->second.isGlobal) {
+        eraseHandle(m_callbackIndex.subtree);
+    } else if (indexedPattern(it->second.pattern, path, subtree)) {
+        CallbackTrieNode* node = &m_callbackIndex;
+        bool found = forEachSegment(path, [&node](std::string_view segment) {
+            auto child = node->children.find(segment);
+            if (child == node->children.end()) {
+                return false;
+            }
+            node = child->second.get();
+            return true;
+        });
+        if (found) {
+            eraseHandle(subtree ? node->subtree : node->exact);
+        }
+    } else {
+        eraseHandle(m_wildcardCallbacks);
     }
     
-    return false;
+    m_callbacks.erase(it);
+    m_stats.callbacks = m_callbacks.size();
+    return true;
 }
 
 std::vector<std::string> ConfigurationManager::getKeys() const {
@@ -425,20 +599,32 @@ void ConfigurationManager::setDefaults(const std::unordered_map<std::string, Con
 }
 
 void ConfigurationManager::restoreDefaults() {
-    std::unordered_map<std::string, ConfigValue> oldValues;
+    std::vector<ConfigChange> changes;
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        oldValues = m_values;
+        
+        // Only keys whose value actually changes, including ones that go away
+        for (const auto& [key, defaultValue] : m_defaults) {
+            auto oldIt = m_values.find(key);
+            ConfigValue oldValue = (oldIt != m_values.end()) ? oldIt->second : ConfigValue();
+            if (!sameValue(oldValue, defaultValue)) {
+                changes.push_back(ConfigChange{key, std::move(oldValue), defaultValue});
+            }
+        }
+        for (const auto& [key, oldValue] : m_values) {
+            if (m_defaults.find(key) == m_defaults.end()) {
+                changes.push_back(ConfigChange{key, oldValue, ConfigValue()});
+            }
+        }
+        
         m_values = m_defaults;
-        m_isDirty = true;
+        markDirtyLocked();
+        publishSnapshotLocked();
     }
     
-    // Notify about changes
-    for (const auto& [key, defaultValue] : m_defaults) {
-        auto oldIt = oldValues.find(key);
-        ConfigValue oldValue = (oldIt != oldValues.end()) ? oldIt->second : ConfigValue();
-        notifyChange(key, oldValue, defaultValue);
-    }
+    std::sort(changes.begin(), changes.end(),
+              [](const ConfigChange& a, const ConfigChange& b) { return a.key < b.key; });
+    notifyChanges(changes);
 }
 
 void ConfigurationManager::restoreDefault(const std::string& key) {
@@ -452,7 +638,8 @@ void ConfigurationManager::restoreDefault(const std::string& key) {
                 oldValue = valueIt->second;
             }
             m_values[key] = it->second;
-            m_isDirty = true;
+            markDirtyLocked();
+            publishSnapshotLocked();
         }
         
         notifyChange(key, oldValue, it->second);
@@ -460,16 +647,26 @@ void ConfigurationManager::restoreDefault(const std::string& key) {
 }
 
 std::string ConfigurationManager::getConfigFilePath() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_configFilePath;
 }
 
 void ConfigurationManager::setConfigFilePath(const std::string& path) {
+    std::lock_guard<std::mutex> saveLock(m_saveMutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_configFilePath = path;
+    
+    // Nothing has been written to the new file yet
+    m_savedVersion = 0;
+    m_lastSavedContent.clear();
 }
 
 ConfigurationManager::Stats ConfigurationManager::getStats() const {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_stats.totalKeys = m_values.size();
+    m_stats.coalescingRatio = m_stats.saveCount > 0
+        ? static_cast<double>(m_stats.coalescedChanges) / static_cast<double>(m_stats.saveCount) : 0.0;
+    m_stats.averageSaveMs = m_stats.saveCount > 0 ? m_totalSaveMs / static_cast<double>(m_stats.saveCount) : 0.0;
     return m_stats;
 }
 
@@ -498,6 +695,9 @@ void ConfigurationManager::initializeDefaults() {
     m_defaults["ui.theme"] = ConfigValue(std::string("dark"));
     m_defaults["ui.show_advanced_controls"] = ConfigValue(false);
     m_defaults["ui.visualization_fps"] = ConfigValue(30);
+    m_defaults["ui.spectrum_fft_size"] = ConfigValue(2048);
+    m_defaults["ui.spectrum_hop_size"] = ConfigValue(512);
+    m_defaults["ui.render_mode"] = ConfigValue(std::string("auto"));
     
     m_defaults["system.auto_start"] = ConfigValue(false);
     m_defaults["system.check_updates"] = ConfigValue(true);
@@ -517,46 +717,221 @@ void ConfigurationManager::initializeDefaults() {
 
 void ConfigurationManager::notifyChange(const std::string& key, const ConfigValue& oldValue, 
                                        const ConfigValue& newValue) {
-    std::vector<ChangeCallback> callbacksToNotify;
+    notifyChanges({ConfigChange{key, oldValue, newValue}});
+}
+
+void ConfigurationManager::notifyChanges(const std::vector<ConfigChange>& changes) {
+    if (changes.empty()) {
+        return;
+    }
     
-    // Collect matching callbacks
+    struct KeyDelivery {
+        std::shared_ptr<const ChangeCallback> callback;
+        size_t change;
+    };
+    struct BatchDelivery {
+        std::shared_ptr<const BatchChangeCallback> callback;
+        std::vector<size_t> changes;
+    };
+    std::vector<KeyDelivery> keyDeliveries;
+    std::vector<BatchDelivery> batchDeliveries;
+    uint64_t version = 0;
+    
+    // Collect matching callbacks from the index
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        for (const auto& [handle, info] : m_callbacks) {
-            if (info.isGlobal || matchesPattern(key, info.pattern)) {
-                callbacksToNotify.push_back(info.callback);
+        std::vector<CallbackHandle> handles;
+        std::unordered_map<CallbackHandle, size_t> batchSlots;
+        
+        for (size_t i = 0; i < changes.size(); ++i) {
+            handles.clear();
+            collectCallbacksLocked(changes[i].key, handles);
+            
+            for (CallbackHandle handle : handles) {
+                const CallbackInfo& info = m_callbacks.at(handle);
+                if (info.callback) {
+                    keyDeliveries.push_back(KeyDelivery{info.callback, i});
+                    continue;
+                }
+                auto [slot, inserted] = batchSlots.emplace(handle, batchDeliveries.size());
+                if (inserted) {
+                    batchDeliveries.push_back(BatchDelivery{info.batchCallback, {}});
+                }
+                batchDeliveries[slot->second].changes.push_back(i);
             }
         }
+        
+        m_stats.changeNotifications += changes.size();
+        version = m_snapshotVersion.load(std::memory_order_relaxed);
     }
     
     // Execute callbacks (outside of lock)
-    for (const auto& callback : callbacksToNotify) {
+    for (const auto& delivery : keyDeliveries) {
+        const ConfigChange& change = changes[delivery.change];
         try {
-            callback(key, oldValue, newValue);
+            (*delivery.callback)(change.key, change.oldValue, change.newValue);
         } catch (...) {
             // Log error but continue
         }
     }
     
-    m_stats.changeNotifications++;
+    for (const auto& delivery : batchDeliveries) {
+        try {
+            if (delivery.changes.size() == changes.size()) {
+                (*delivery.callback)(changes);
+            } else {
+                std::vector<ConfigChange> matching;
+                matching.reserve(delivery.changes.size());
+                for (size_t index : delivery.changes) {
+                    matching.push_back(changes[index]);
+                }
+                (*delivery.callback)(matching);
+            }
+        } catch (...) {
+            // Log error but continue
+        }
+    }
     
-    // Publish event
-    auto eventData = std::make_shared<EventData>();
-    eventData->setValue("key", key);
-    m_eventDispatcher.publish(EventType::SettingsChanged, eventData);
+    // One event for the whole operation
+    SettingsChangedPayload payload;
+    payload.changeCount = static_cast<uint32_t>(changes.size());
+    payload.version = version;
+    if (changes.size() == 1) {
+        payload.key = changes.front().key;
+    }
+    m_eventDispatcher.publish(EventType::SettingsChanged, payload);
 }
 
-void ConfigurationManager::autoSaveWorker() {
-    while (!m_shouldStopAutoSave.load()) {
-        std::this_thread::sleep_for(std::chrono::seconds(m_autoSaveInterval));
+void ConfigurationManager::persistenceWorker() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::chrono::milliseconds retryDelay{0};
+    while (!m_stopPersistence) {
+        m_persistenceCondition.wait(lock, [this] {
+            return m_stopPersistence || m_isDirty || m_saveRequested;
+        });
         
-        if (m_shouldStopAutoSave.load()) {
-            break;
+        // Let a burst of changes, such as a slider being dragged, settle into
+        // one write: wait until none arrive for m_saveDelay, but no longer
+        // than the auto-save interval in total
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(m_autoSaveInterval);
+        while (!m_stopPersistence && !m_saveRequested) {
+            uint64_t changesSeen = m_changeCount;
+            auto wakeAt = std::min(std::chrono::steady_clock::now() + m_saveDelay, deadline);
+            bool changed = m_persistenceCondition.wait_until(lock, wakeAt, [this, changesSeen] {
+                return m_stopPersistence || m_saveRequested || m_changeCount != changesSeen;
+            });
+            if (!changed || std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
         }
         
-        if (m_isDirty) {
-            saveConfiguration();
+        if (m_stopPersistence) {
+            break;  // shutdown() writes whatever is left
+        }
+        
+        uint64_t changesSeen = m_changeCount;
+        lock.unlock();
+        bool saved = saveConfiguration();
+        lock.lock();
+        
+        if (saved) {
+            retryDelay = std::chrono::milliseconds(0);
+            continue;
+        }
+        
+        // The changes are still pending; don't hammer a disk that is full or
+        // read-only. A new change or an explicit request retries right away.
+        std::chrono::milliseconds maxDelay = std::chrono::seconds(m_autoSaveInterval);
+        retryDelay = std::min(std::max({retryDelay * 2, m_saveDelay, kMinSaveRetryDelay}), maxDelay);
+        m_persistenceCondition.wait_for(lock, retryDelay, [this, changesSeen] {
+            return m_stopPersistence || m_saveRequested || m_changeCount != changesSeen;
+        });
+    }
+}
+
+void ConfigurationManager::startPersistenceLocked() {
+    m_stopPersistence = false;
+    m_persistenceRunning = true;
+    m_persistenceThread = std::thread(&ConfigurationManager::persistenceWorker, this);
+}
+
+void ConfigurationManager::stopPersistence() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_persistenceRunning) {
+            return;
         }
+        m_stopPersistence = true;
+        m_persistenceRunning = false;
+        thread = std::move(m_persistenceThread);
+    }
+    
+    m_persistenceCondition.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void ConfigurationManager::markDirtyLocked() {
+    m_isDirty = true;
+    ++m_changeCount;
+    ++m_unsavedChanges;
+    m_persistenceCondition.notify_one();
+}
+
+std::string ConfigurationManager::serializeSnapshot(const ConfigSnapshot& snapshot) {
+    return writeConfigJson(snapshot.values());
+}
+
+const ConfigSnapshot& ConfigurationManager::currentSnapshot() const {
+    // Each thread keeps the snapshot it last read and only fetches a new one
+    // when the version has moved on, so reading an unchanged configuration
+    // costs one atomic load and never touches a shared reference count
+    struct Cache {
+        uint64_t instanceId = 0;
+        uint64_t version = 0;
+        std::shared_ptr<const ConfigSnapshot> snapshot;
+    };
+    thread_local Cache cache;
+    
+    uint64_t version = m_snapshotVersion.load(std::memory_order_acquire);
+    if (cache.instanceId != m_instanceId || cache.version != version || !cache.snapshot) {
+        cache.snapshot = getSnapshot();
+        cache.instanceId = m_instanceId;
+        cache.version = cache.snapshot->version();
+    }
+    return *cache.snapshot;
+}
+
+void ConfigurationManager::publishSnapshotLocked() {
+    auto snapshot = std::make_shared<ConfigSnapshot>();
+    snapshot->m_values = m_values;
+    snapshot->m_version = m_snapshotVersion.load(std::memory_order_relaxed) + 1;
+    uint64_t version = snapshot->m_version;
+    
+    // Snapshot before version: a reader that sees the new version finds the new snapshot
+    std::atomic_store(&m_snapshot, std::shared_ptr<const ConfigSnapshot>(std::move(snapshot)));
+    m_snapshotVersion.store(version, std::memory_order_release);
+    
+    // Refresh every live handle and forget the ones that were dropped
+    for (auto it = m_handleSlots.begin(); it != m_handleSlots.end();) {
+        auto valueIt = m_values.find(it->first);
+        const ConfigValue* value = valueIt != m_values.end() ? &valueIt->second : nullptr;
+        
+        auto& slots = it->second;
+        slots.erase(std::remove_if(slots.begin(), slots.end(),
+                                   [value](const std::weak_ptr<detail::ConfigHandleSlotBase>& weak) {
+                                       auto slot = weak.lock();
+                                       if (!slot) {
+                                           return true;
+                                       }
+                                       slot->update(value);
+                                       return false;
+                                   }),
+                    slots.end());
+        
+        it = slots.empty() ? m_handleSlots.erase(it) : std::next(it);
     }
 }
 
@@ -565,23 +940,40 @@ bool ConfigurationManager::matchesPattern(const std::string& key, const std::str
         return true;  // Global pattern
     }
     
-    // Simple wildcard matching (in practice, use regex or glob)
-    if (pattern.find('*') != std::string::npos) {
-        // Convert wildcard to regex
-        std::string regexPattern = pattern;
-        std::replace(regexPattern.begin(), regexPattern.end(), '*', '.');
-        regexPattern = "^" + regexPattern + "$";
-        
-        try {
-            std::regex regex(regexPattern);
-            return std::regex_match(key, regex);
-        } catch (...) {
-            return false;
+    std::string_view path;
+    bool subtree = false;
+    if (indexedPattern(pattern, path, subtree)) {
+        if (!subtree) {
+            return key == path;
         }
+        return key.size() > path.size() && key.compare(0, path.size(), path) == 0 && key[path.size()] == '.';
     }
+    return globMatch(pattern, key);
+}
+
+void ConfigurationManager::collectCallbacksLocked(const std::string& key, std::vector<CallbackHandle>& handles) const {
+    // Global callbacks, then each section the key is in, then the key itself
+    const CallbackTrieNode* node = &m_callbackIndex;
+    handles.insert(handles.end(), node->subtree.begin(), node->subtree.end());
+    
+    size_t segmentsLeft = static_cast<size_t>(std::count(key.begin(), key.end(), '.')) + 1;
+    forEachSegment(key, [&node, &handles, &segmentsLeft](std::string_view segment) {
+        auto it = node->children.find(segment);
+        if (it == node->children.end()) {
+            return false;
+        }
+        node = it->second.get();
+        const auto& matches = --segmentsLeft == 0 ? node->exact : node->subtree;
+        handles.insert(handles.end(), matches.begin(), matches.end());
+        return true;
+    });
     
-    // Exact match
-    return key == pattern;
+    for (CallbackHandle handle : m_wildcardCallbacks) {
+        auto it = m_callbacks.find(handle);
+        if (it != m_callbacks.end() && matchesPattern(key, it->second.pattern)) {
+            handles.push_back(handle);
+        }
+    }
 }
 
 } // namespace core
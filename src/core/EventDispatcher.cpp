@@ -1,11 +1,340 @@
 #include "quiet/core/EventDispatcher.h"
 #include <algorithm>
 #include <chrono>
+#include <iterator>
+#include <limits>
 
 namespace quiet {
 namespace core {
 
-EventDispatcher::EventDispatcher() = default;
+/**
+ * Fixed set of delivery threads that run listener callbacks.
+ *
+ * Each listener acts as its own serial executor: events queue up in
+ * ListenerInfo::pending and the listener is placed on the ready list at most
+ * once, so a listener never runs on two threads at the same time and always
+ * sees its events in publish order. A watchdog thread scans the in-flight
+ * invocations and flags listeners that overrun the delivery timeout; the
+ * invocation itself is left to finish.
+ */
+class EventDispatcher::DeliveryPool {
+public:
+    DeliveryPool(EventDispatcher& owner, size_t threadCount)
+        : m_owner(owner)
+        , m_slots(std::max<size_t>(threadCount, 1)) {
+        
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            m_workers.emplace_back(&DeliveryPool::workerLoop, this, i);
+        }
+        m_watchdog = std::thread(&DeliveryPool::watchdogLoop, this);
+    }
+    
+    ~DeliveryPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_workCondition.notify_all();
+        m_watchdogCondition.notify_all();
+        
+        for (auto& worker : m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        if (m_watchdog.joinable()) {
+            m_watchdog.join();
+        }
+        
+        // Release events that were never delivered
+        while (!m_ready.empty()) {
+            m_ready.front()->pending.clear();
+            m_ready.front()->priorityPending.clear();
+            m_ready.front()->scheduled = false;
+            m_ready.pop_front();
+        }
+    }
+    
+    // Returns false if the listener's backlog was full and its oldest event was dropped.
+    // Priority events go to their own backlog, served first and in publish
+    // order, with a smaller bound of its own.
+    bool enqueue(const ListenerPtr& listener, const Event& event, bool priority = false) {
+        bool dropped = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping || listener->removed) {
+                return true;
+            }
+            
+            auto& backlog = priority ? listener->priorityPending : listener->pending;
+            const size_t limit = priority ? kMaxPriorityPendingPerListener : kMaxPendingPerListener;
+            if (backlog.size() >= limit) {
+                backlog.pop_front();
+                dropped = true;
+            }
+            backlog.push_back(event);
+            
+            if (listener->scheduled) {
+                return !dropped;
+            }
+            listener->scheduled = true;
+            m_ready.push_back(listener);
+        }
+        m_workCondition.notify_one();
+        return !dropped;
+    }
+    
+    // Called with the owner's listener lock held when a listener is removed
+    void retire(const ListenerPtr& listener) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        listener->pending.clear();
+        listener->priorityPending.clear();
+    }
+    
+    void wakeWatchdog() {
+        m_watchdogCondition.notify_all();
+    }
+
+private:
+    struct WorkerSlot {
+        ListenerPtr listener;
+        std::chrono::steady_clock::time_point started;
+        bool flagged = false;
+    };
+    
+    void workerLoop(size_t slotIndex) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        
+        while (true) {
+            m_workCondition.wait(lock, [this] {
+                return m_stopping || !m_ready.empty();
+            });
+            
+            if (m_stopping) {
+                break;
+            }
+            
+            ListenerPtr listener = std::move(m_ready.front());
+            m_ready.pop_front();
+            
+            if (listener->removed || !hasPending(*listener)) {
+                listener->scheduled = false;
+                continue;
+            }
+            
+            auto& backlog = listener->priorityPending.empty() ? listener->pending : listener->priorityPending;
+            Event event = std::move(backlog.front());
+            backlog.pop_front();
+            
+            WorkerSlot& slot = m_slots[slotIndex];
+            slot.listener = listener;
+            slot.started = std::chrono::steady_clock::now();
+            slot.flagged = false;
+            
+            lock.unlock();
+            
+            auto invokeStart = std::chrono::steady_clock::now();
+            try {
+                listener->listener(event);
+            } catch (...) {
+                // Listener exceptions must not take down the delivery thread
+            }
+            auto elapsed = std::chrono::steady_clock::now() - invokeStart;
+            
+            lock.lock();
+            
+            bool timedOut = slot.flagged;
+            slot.listener.reset();
+            
+            // Round-robin: a busy listener goes to the back of the ready list
+            if (!listener->removed && hasPending(*listener)) {
+                m_ready.push_back(listener);
+                m_workCondition.notify_one();
+            } else {
+                listener->scheduled = false;
+            }
+            
+            lock.unlock();
+            m_owner.recordInvocation(*listener, event, invokeStart, elapsed, timedOut);
+            lock.lock();
+        }
+    }
+    
+    static bool hasPending(const ListenerInfo& listener) {
+        return !listener.priorityPending.empty() || !listener.pending.empty();
+    }
+    
+    void watchdogLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        
+        while (!m_stopping) {
+            auto timeout = std::chrono::milliseconds(m_owner.m_deliveryTimeoutMs.load());
+            m_watchdogCondition.wait_for(lock, std::max(timeout / 2, std::chrono::milliseconds(1)));
+            
+            if (m_stopping) {
+                break;
+            }
+            
+            auto now = std::chrono::steady_clock::now();
+            for (auto& slot : m_slots) {
+                if (slot.listener && !slot.flagged && now - slot.started > timeout) {
+                    slot.flagged = true;
+                    m_owner.flagSlowListener(*slot.listener);
+                }
+            }
+        }
+    }
+    
+    EventDispatcher& m_owner;
+    
+    std::mutex m_mutex;
+    std::condition_variable m_workCondition;
+    std::condition_variable m_watchdogCondition;
+    utils::RingQueue<ListenerPtr> m_ready;
+    std::vector<WorkerSlot> m_slots;
+    bool m_stopping{false};
+    
+    std::vector<std::thread> m_workers;
+    std::thread m_watchdog;
+};
+
+/**
+ * Events waiting for MessageThread listeners, handed to the message thread as
+ * one batch per frame.
+ *
+ * The dispatcher appends from any thread; flush() posts a single drain task
+ * through the executor at most once per frame interval and never while a
+ * previous task is still pending, so a burst of events costs one message
+ * thread hop instead of one per event. Tasks hold a weak reference, so a
+ * task that runs after the dispatcher is gone does nothing.
+ */
+class EventDispatcher::MessageThreadQueue
+    : public std::enable_shared_from_this<MessageThreadQueue> {
+public:
+    // Bounds the batch if the message thread stops draining (e.g. modal loop)
+    static constexpr size_t kMaxBatchSize = 4096;
+    
+    // Returns false if the batch is full and the event was dropped.
+    // wasEmpty tells the caller whether a flush needs to be scheduled.
+    bool add(const ListenerPtr& listener, const Event& event, bool& wasEmpty) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        wasEmpty = m_batch.empty();
+        if (m_batch.size() >= kMaxBatchSize) {
+            return false;
+        }
+        m_batch.emplace_back(listener, event);
+        return true;
+    }
+    
+    // Posts the batch if it is due. Returns when the next post is due, or
+    // time_point::max() if nothing is waiting to be posted.
+    std::chrono::steady_clock::time_point flush(std::chrono::steady_clock::time_point now) {
+        MessageThreadExecutor executor;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_batch.empty() || m_postPending || !m_executor) {
+                return std::chrono::steady_clock::time_point::max();
+            }
+            
+            auto due = m_lastPost + m_frameInterval;
+            if (now < due) {
+                return due;
+            }
+            
+            m_postPending = true;
+            m_lastPost = now;
+            executor = m_executor;
+        }
+        
+        std::weak_ptr<MessageThreadQueue> weak = shared_from_this();
+        executor([weak] {
+            if (auto queue = weak.lock()) {
+                queue->drain();
+            }
+        });
+        m_posts.fetch_add(1, std::memory_order_relaxed);
+        return std::chrono::steady_clock::time_point::max();
+    }
+    
+    // Runs on the message thread. Returns the number of listeners invoked.
+    size_t drain() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_batch.swap(m_draining);
+            m_postPending = false;
+        }
+        
+        size_t invoked = 0;
+        for (auto& [listener, event] : m_draining) {
+            if (listener->removed.load()) {
+                continue;
+            }
+            try {
+                listener->listener(event);
+            } catch (...) {
+                // Listener exceptions must not escape into the message loop
+            }
+            invoked++;
+        }
+        
+        // Keep the storage for the next frame
+        m_draining.clear();
+        return invoked;
+    }
+    
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_batch.clear();
+    }
+    
+    void setExecutor(MessageThreadExecutor executor) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_executor = std::move(executor);
+        m_postPending = false;
+    }
+    
+    void setFrameInterval(std::chrono::microseconds interval) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frameInterval = interval;
+    }
+    
+    uint64_t posts() const {
+        return m_posts.load(std::memory_order_relaxed);
+    }
+    
+    void resetPosts() {
+        m_posts.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    using Batch = std::vector<std::pair<ListenerPtr, Event>>;
+    
+    std::mutex m_mutex;
+    Batch m_batch;
+    Batch m_draining;  // Message thread only
+    MessageThreadExecutor m_executor;
+    bool m_postPending{false};
+    std::chrono::steady_clock::time_point m_lastPost;
+    std::chrono::microseconds m_frameInterval{1000000 / 60};
+    std::atomic<uint64_t> m_posts{0};
+};
+
+EventDispatcher::EventDispatcher()
+    : m_realtimeQueue(std::make_unique<utils::MpscRingBuffer<RealtimeRecord>>(1024))
+    , m_messageThreadQueue(std::make_shared<MessageThreadQueue>()) {
+    
+    // Latest-value events: only the newest matters to consumers
+    EventPolicy latestValue;
+    latestValue.coalesce = true;
+    setEventPolicy(EventType::AudioLevelChanged, latestValue);
+    setEventPolicy(EventType::ProcessingStatsUpdated, latestValue);
+    
+    // Must never wait behind level updates
+    EventPolicy urgent;
+    urgent.priority = true;
+    setEventPolicy(EventType::AudioDeviceError, urgent);
+    setEventPolicy(EventType::ApplicationShutdown, urgent);
+}
 
 EventDispatcher::~EventDispatcher() {
     stop();
@@ -19,6 +348,9 @@ void EventDispatcher::start() {
     m_shouldStop.store(false);
     m_running.store(true);
     
+    // Start delivery threads before anything can be queued for them
+    m_deliveryPool = std::make_unique<DeliveryPool>(*this, m_deliveryThreadCount);
+    
     // Start processing thread
     m_processingThread = std::make_unique<std::thread>(&EventDispatcher::processEvents, this);
 }
@@ -36,13 +368,31 @@ void EventDispatcher::stop() {
     }
     
     m_processingThread.reset();
+    
+    // Joins the delivery threads; in-flight invocations are allowed to finish
+    m_deliveryPool.reset();
+    
     m_running.store(false);
     
     // Clear any remaining events
     {
         std::lock_guard<std::mutex> lock(m_queueMutex);
-        std::queue<Event> empty;
-        std::swap(m_eventQueue, empty);
+        m_eventQueue.clear();
+        m_priorityQueue.clear();
+        for (auto& slot : m_coalescedEvents) {
+            slot.reset();
+        }
+        m_coalescedCount = 0;
+    }
+    
+    for (auto& listener : m_heldListeners) {
+        listener->held.reset();
+    }
+    m_heldListeners.clear();
+    m_messageThreadQueue->clear();
+    
+    RealtimeRecord discarded;
+    while (m_realtimeQueue->tryPop(discarded)) {
     }
 }
 
@@ -60,31 +410,141 @@ void EventDispatcher::publish(EventType type, std::shared_ptr<EventData> data) {
         return;
     }
     
-    Event event(type, data);
+    Event event(type, std::move(data));
+    deliverDirect(event);
+    enqueueEvent(std::move(event));
+}
+
+void EventDispatcher::publish(EventType type, const EventPayload& payload) {
+    if (!m_running.load()) {
+        return;
+    }
+    
+    // Check if event type is filtered
+    if (isEventFiltered(type)) {
+        return;
+    }
     
+    Event event(type, payload);
+    deliverDirect(event);
+    enqueueEvent(std::move(event));
+}
+
+void EventDispatcher::enqueueEvent(Event&& event) {
+    EventType type = event.type;
+    auto timestamp = event.timestamp;
+    bool wasEmpty;
+    size_t queueDepth;
     {
         std::lock_guard<std::mutex> lock(m_queueMutex);
+        wasEmpty = !hasQueuedEventsLocked();
         
-        // Check queue size limit
-        if (m_eventQueue.size() >= m_maxQueueSize) {
-            // Drop oldest event
-            m_eventQueue.pop();
-            {
-                std::lock_guard<std::mutex> statsLock(m_statsMutex);
-                m_stats.eventsDropped++;
-            }
-        }
-        
-        m_eventQueue.push(event);
+        queueEventLocked(std::move(event));
         
-        {
-            std::lock_guard<std::mutex> statsLock(m_statsMutex);
-            m_stats.eventsPublished++;
-            m_stats.queueSize = m_eventQueue.size();
+        queueDepth = queuedEventCountLocked();
+        m_eventsPublished.fetch_add(1, std::memory_order_relaxed);
+        m_queueSize.store(queueDepth, std::memory_order_relaxed);
+    }
+    
+    tracePublish(type, timestamp, queueDepth);
+    
+    // The processing thread only sleeps on an empty queue
+    if (wasEmpty) {
+        m_queueCondition.notify_one();
+    }
+}
+
+void EventDispatcher::queueEventLocked(Event&& event) {
+    auto index = static_cast<size_t>(event.type);
+    const PolicyState& policy = m_policies[index];
+    
+    if (policy.priority.load(std::memory_order_relaxed)) {
+        m_priorityQueue.push_back(std::move(event));
+        return;
+    }
+    
+    if (policy.coalesce.load(std::memory_order_relaxed)) {
+        auto& slot = m_coalescedEvents[index];
+        if (slot) {
+            m_eventsCoalesced.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_coalescedCount++;
         }
+        slot = std::move(event);
+        return;
     }
     
-    m_queueCondition.notify_one();
+    // Check queue size limit
+    if (m_eventQueue.size() >= m_maxQueueSize) {
+        // Drop oldest event
+        m_eventQueue.pop_front();
+        m_eventsDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    m_eventQueue.push_back(std::move(event));
+}
+
+bool EventDispatcher::hasQueuedEventsLocked() const {
+    return !m_priorityQueue.empty() || !m_eventQueue.empty() || m_coalescedCount > 0;
+}
+
+size_t EventDispatcher::queuedEventCountLocked() const {
+    return m_priorityQueue.size() + m_eventQueue.size() + m_coalescedCount;
+}
+
+bool EventDispatcher::popNextEventLocked(std::optional<Event>& event) {
+    // Priority lane first, so urgent events never wait behind a backlog
+    if (!m_priorityQueue.empty()) {
+        event = std::move(m_priorityQueue.front());
+        m_priorityQueue.pop_front();
+        return true;
+    }
+    
+    // Coalesced slots take a turn after every kCoalescedInterleave regular
+    // events, so a steady stream of regular events cannot starve them
+    bool coalescedTurn = m_coalescedCount > 0 &&
+                         (m_eventQueue.empty() || m_regularSinceCoalesced >= kCoalescedInterleave);
+    
+    if (!coalescedTurn && !m_eventQueue.empty()) {
+        event = std::move(m_eventQueue.front());
+        m_eventQueue.pop_front();
+        m_regularSinceCoalesced++;
+        return true;
+    }
+    
+    if (m_coalescedCount > 0) {
+        // Round-robin over the slots, so one busy type cannot starve another
+        for (size_t i = 0; i < kEventTypeCount; ++i) {
+            auto& slot = m_coalescedEvents[(m_coalescedCursor + i) % kEventTypeCount];
+            if (slot) {
+                m_coalescedCursor = (m_coalescedCursor + i + 1) % kEventTypeCount;
+                event = std::move(slot);
+                slot.reset();
+                m_coalescedCount--;
+                m_regularSinceCoalesced = 0;
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+bool EventDispatcher::publishRT(EventType type, const EventPayload& payload) noexcept {
+    // Only atomics and the preallocated ring are touched here
+    if (!m_running.load(std::memory_order_relaxed) || isEventFiltered(type)) {
+        return false;
+    }
+    
+    RealtimeRecord record{type, payload, std::chrono::steady_clock::now()};
+    if (!m_realtimeQueue->tryPush(record)) {
+        m_eventsDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    m_eventsPublished.fetch_add(1, std::memory_order_relaxed);
+    tracePublish(type, record.timestamp, m_realtimeQueue->size());
+    return true;
 }
 
 void EventDispatcher::publishImmediate(EventType type, std::shared_ptr<EventData> data) {
@@ -97,54 +557,70 @@ void EventDispatcher::publishImmediate(EventType type, std::shared_ptr<EventData
         return;
     }
     
-    Event event(type, data);
-    deliverEvent(event);
+    Event event(type, std::move(data));
+    tracePublish(type, event.timestamp, m_queueSize.load(std::memory_order_relaxed));
+    deliverDirect(event);
+    deliverEvent(event, true);
     
-    {
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.eventsPublished++;
-    }
+    m_eventsPublished.fetch_add(1, std::memory_order_relaxed);
 }
 
-EventDispatcher::ListenerHandle EventDispatcher::subscribe(EventType type, EventListener listener) {
-    std::lock_guard<std::mutex> lock(m_listenersMutex);
-    
-    ListenerHandle handle = m_nextHandle++;
-    
-    ListenerInfo info;
-    info.type = type;
-    info.listener = std::move(listener);
-    info.lastActivity = std::chrono::steady_clock::now();
-    
-    m_listeners[handle] = std::move(info);
-    m_typeListeners[type].push_back(handle);
+void EventDispatcher::publishImmediate(EventType type, const EventPayload& payload) {
+    if (!m_running.load()) {
+        return;
+    }
     
-    {
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.activeListeners = m_listeners.size();
+    // Check if event type is filtered
+    if (isEventFiltered(type)) {
+        return;
     }
     
-    return handle;
+    Event event(type, payload);
+    tracePublish(type, event.timestamp, m_queueSize.load(std::memory_order_relaxed));
+    deliverDirect(event);
+    deliverEvent(event, true);
+    
+    m_eventsPublished.fetch_add(1, std::memory_order_relaxed);
+}
+
+EventDispatcher::ListenerHandle EventDispatcher::subscribe(EventType type, EventListener listener,
+                                                           DeliveryMode mode) {
+    return addListener(type, std::move(listener), mode);
+}
+
+EventDispatcher::ListenerHandle EventDispatcher::subscribeAll(EventListener listener, DeliveryMode mode) {
+    return addListener(static_cast<EventType>(-1), std::move(listener), mode);  // Special value for global listeners
 }
 
-EventDispatcher::ListenerHandle EventDispatcher::subscribeAll(EventListener listener) {
+EventDispatcher::ListenerHandle EventDispatcher::addListener(EventType type, EventListener listener,
+                                                             DeliveryMode mode) {
     std::lock_guard<std::mutex> lock(m_listenersMutex);
     
     ListenerHandle handle = m_nextHandle++;
     
-    ListenerInfo info;
-    info.type = static_cast<EventType>(-1);  // Special value for global listeners
-    info.listener = std::move(listener);
-    info.lastActivity = std::chrono::steady_clock::now();
+    auto info = std::make_shared<ListenerInfo>();
+    info->type = type;
+    info->listener = std::move(listener);
+    info->mode = mode;
+    info->handle = handle;
+    info->lastActivity.store(std::chrono::steady_clock::now().time_since_epoch().count());
     
-    m_listeners[handle] = std::move(info);
-    m_globalListeners.push_back(handle);
-    
-    {
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.activeListeners = m_listeners.size();
+    bool direct = mode == DeliveryMode::Direct;
+    auto index = static_cast<size_t>(type);
+    if (index < kEventTypeCount) {
+        appendListener(direct ? m_directTypeListeners[index] : m_typeListeners[index], info);
+        m_subscriberCounts[index].fetch_add(1, std::memory_order_relaxed);
+    } else {
+        appendListener(direct ? m_directGlobalListeners : m_globalListeners, info);
+        m_globalSubscriberCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (direct) {
+        m_directListenerCount.fetch_add(1);
     }
     
+    m_listeners[handle] = std::move(info);
+    m_activeListeners.store(m_listeners.size(), std::memory_order_relaxed);
+    
     return handle;
 }
 
@@ -156,33 +632,10 @@ bool EventDispatcher::unsubscribe(ListenerHandle handle) {
         return false;
     }
     
-    EventType type = it->second.type;
-    
-    // Remove from type-specific listeners
-    if (type != static_cast<EventType>(-1)) {
-        auto& typeListeners = m_typeListeners[type];
-        typeListeners.erase(
-            std::remove(typeListeners.begin(), typeListeners.end(), handle),
-            typeListeners.end()
-        );
-        
-        if (typeListeners.empty()) {
-            m_typeListeners.erase(type);
-        }
-    } else {
-        // Remove from global listeners
-        m_globalListeners.erase(
-            std::remove(m_globalListeners.begin(), m_globalListeners.end(), handle),
-            m_globalListeners.end()
-        );
-    }
-    
+    detachListener(it->second);
+    retireListener(it->second);
     m_listeners.erase(it);
-    
-    {
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.activeListeners = m_listeners.size();
-    }
+    m_activeListeners.store(m_listeners.size(), std::memory_order_relaxed);
     
     return true;
 }
@@ -190,35 +643,132 @@ bool EventDispatcher::unsubscribe(ListenerHandle handle) {
 void EventDispatcher::unsubscribeAll() {
     std::lock_guard<std::mutex> lock(m_listenersMutex);
     
-    m_listeners.clear();
-    m_typeListeners.clear();
-    m_globalListeners.clear();
+    for (auto& list : m_typeListeners) {
+        std::atomic_store(&list, ListenerListPtr());
+    }
+    for (auto& list : m_directTypeListeners) {
+        std::atomic_store(&list, ListenerListPtr());
+    }
+    std::atomic_store(&m_globalListeners, ListenerListPtr());
+    std::atomic_store(&m_directGlobalListeners, ListenerListPtr());
+    m_directListenerCount.store(0);
+    for (auto& count : m_subscriberCounts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    m_globalSubscriberCount.store(0, std::memory_order_relaxed);
     
-    {
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.activeListeners = 0;
+    for (const auto& [handle, info] : m_listeners) {
+        retireListener(info);
     }
+    
+    m_listeners.clear();
+    m_activeListeners.store(0, std::memory_order_relaxed);
+}
+
+bool EventDispatcher::hasSubscribers(EventType type) const noexcept {
+    auto index = static_cast<size_t>(type);
+    if (index < kEventTypeCount) {
+        if (m_eventFilters[index].load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (m_subscriberCounts[index].load(std::memory_order_relaxed) > 0) {
+            return true;
+        }
+    }
+    return m_globalSubscriberCount.load(std::memory_order_relaxed) > 0;
 }
 
 void EventDispatcher::setEventFilter(EventType type, bool enabled) {
-    m_eventFilters[type] = !enabled;  // true means filtered (disabled)
+    auto index = static_cast<size_t>(type);
+    if (index < kEventTypeCount) {
+        m_eventFilters[index].store(!enabled);  // true means filtered (disabled)
+    }
 }
 
 bool EventDispatcher::isEventFiltered(EventType type) const {
-    auto it = m_eventFilters.find(type);
-    return (it != m_eventFilters.end()) && it->second;
+    auto index = static_cast<size_t>(type);
+    return index < kEventTypeCount && m_eventFilters[index].load(std::memory_order_relaxed);
+}
+
+void EventDispatcher::setEventPolicy(EventType type, const EventPolicy& policy) {
+    auto index = static_cast<size_t>(type);
+    if (index >= kEventTypeCount) {
+        return;
+    }
+    
+    PolicyState& state = m_policies[index];
+    state.coalesce.store(policy.coalesce);
+    state.priority.store(policy.priority);
+    state.minIntervalUs.store(policy.maxRateHz > 0.0
+        ? static_cast<int64_t>(1000000.0 / policy.maxRateHz)
+        : 0);
+}
+
+EventPolicy EventDispatcher::getEventPolicy(EventType type) const {
+    EventPolicy policy;
+    auto index = static_cast<size_t>(type);
+    if (index >= kEventTypeCount) {
+        return policy;
+    }
+    
+    const PolicyState& state = m_policies[index];
+    policy.coalesce = state.coalesce.load();
+    policy.priority = state.priority.load();
+    int64_t minIntervalUs = state.minIntervalUs.load();
+    policy.maxRateHz = minIntervalUs > 0 ? 1000000.0 / static_cast<double>(minIntervalUs) : 0.0;
+    return policy;
+}
+
+void EventDispatcher::setMessageThreadExecutor(MessageThreadExecutor executor) {
+    m_messageThreadQueue->setExecutor(std::move(executor));
+    
+    // Anything batched before the executor was set can now be posted
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_flushRequested = true;
+    }
+    m_queueCondition.notify_one();
+}
+
+void EventDispatcher::setMessageThreadFrameRate(double framesPerSecond) {
+    m_messageThreadQueue->setFrameInterval(std::chrono::microseconds(
+        framesPerSecond > 0.0 ? static_cast<int64_t>(1000000.0 / framesPerSecond) : 0));
+}
+
+size_t EventDispatcher::drainMessageThreadQueue() {
+    return m_messageThreadQueue->drain();
+}
+
+bool EventDispatcher::isListenerSlow(ListenerHandle handle) const {
+    std::lock_guard<std::mutex> lock(m_listenersMutex);
+    auto it = m_listeners.find(handle);
+    return it != m_listeners.end() && it->second->slow.load();
 }
 
 EventDispatcher::Stats EventDispatcher::getStats() const {
-    std::lock_guard<std::mutex> lock(m_statsMutex);
-    return m_stats;
+    Stats stats;
+    stats.eventsPublished = m_eventsPublished.load(std::memory_order_relaxed);
+    stats.eventsDelivered = m_eventsDelivered.load(std::memory_order_relaxed);
+    stats.eventsDropped = m_eventsDropped.load(std::memory_order_relaxed);
+    stats.eventsCoalesced = m_eventsCoalesced.load(std::memory_order_relaxed);
+    stats.activeListeners = m_activeListeners.load(std::memory_order_relaxed);
+    stats.averageDeliveryTime = m_averageDeliveryTime.load(std::memory_order_relaxed);
+    stats.queueSize = m_queueSize.load(std::memory_order_relaxed) + m_realtimeQueue->size();
+    stats.deliveryTimeouts = m_deliveryTimeouts.load(std::memory_order_relaxed);
+    stats.slowListeners = m_slowListeners.load(std::memory_order_relaxed);
+    stats.messageThreadPosts = m_messageThreadQueue->posts();
+    return stats;
 }
 
 void EventDispatcher::resetStats() {
-    std::lock_guard<std::mutex> lock(m_statsMutex);
-    m_stats = Stats{};
-    m_stats.activeListeners = m_listeners.size();
-    m_lastStatsUpdate = std::chrono::steady_clock::now();
+    // Listener counts describe current state, not history, so they are kept
+    m_eventsPublished.store(0);
+    m_eventsDelivered.store(0);
+    m_eventsDropped.store(0);
+    m_eventsCoalesced.store(0);
+    m_deliveryTimeouts.store(0);
+    m_averageDeliveryTime.store(0.0);
+    m_messageThreadQueue->resetPosts();
 }
 
 void EventDispatcher::setMaxQueueSize(size_t maxSize) {
@@ -226,45 +776,91 @@ void EventDispatcher::setMaxQueueSize(size_t maxSize) {
 }
 
 void EventDispatcher::setDeliveryTimeout(std::chrono::milliseconds timeout) {
-    m_deliveryTimeout = timeout;
+    m_deliveryTimeoutMs.store(timeout.count());
+    if (m_deliveryPool) {
+        m_deliveryPool->wakeWatchdog();
+    }
+}
+
+void EventDispatcher::setDeliveryThreadCount(size_t threadCount) {
+    m_deliveryThreadCount = std::max<size_t>(threadCount, 1);
+}
+
+void EventDispatcher::setRealtimeQueueCapacity(size_t capacity) {
+    if (m_running.load()) {
+        return;  // Publishers may be writing into the current ring
+    }
+    m_realtimeQueue = std::make_unique<utils::MpscRingBuffer<RealtimeRecord>>(capacity);
+}
+
+void EventDispatcher::setRealtimePollInterval(std::chrono::milliseconds interval) {
+    m_realtimePollIntervalMs.store(std::max<int64_t>(interval.count(), 1));
 }
 
 // Private methods
 
 void EventDispatcher::processEvents() {
+    std::optional<Event> event;
+    
     while (!m_shouldStop.load()) {
+        // Hand rate-limited listeners their held event once their slot opens
+        auto nextHeldDue = flushHeldEvents();
+        
+        // Post the message thread batch if a frame has elapsed since the last one
+        auto nextPostDue = flushMessageThreadQueue();
+        
+        // Real-time publishers never signal the condition variable, so poll the
+        // ring at a short interval while they are active (within the last second)
+        auto now = std::chrono::steady_clock::now();
+        auto waitTime = std::chrono::milliseconds(100);
+        if (now - m_lastRealtimeActivity < std::chrono::seconds(1)) {
+            waitTime = std::chrono::milliseconds(m_realtimePollIntervalMs.load());
+        }
+        auto nextDue = std::min(m_heldListeners.empty() ? std::chrono::steady_clock::time_point::max() : nextHeldDue,
+                                nextPostDue);
+        if (nextDue != std::chrono::steady_clock::time_point::max()) {
+            auto untilDue = std::chrono::duration_cast<std::chrono::milliseconds>(nextDue - now) +
+                            std::chrono::milliseconds(1);
+            waitTime = std::max(std::min(waitTime, untilDue), std::chrono::milliseconds(1));
+        }
+        
         std::unique_lock<std::mutex> lock(m_queueMutex);
         
-        // Wait for events or stop signal
-        m_queueCondition.wait_for(lock, std::chrono::milliseconds(100), [this] {
-            return !m_eventQueue.empty() || m_shouldStop.load();
+        // Wait for events, a message thread flush request or stop signal
+        m_queueCondition.wait_for(lock, waitTime, [this] {
+            return hasQueuedEventsLocked() || m_flushRequested || m_shouldStop.load();
         });
+        m_flushRequested = false;
         
         if (m_shouldStop.load()) {
             break;
         }
         
+        lock.unlock();
+        if (drainRealtimeEvents()) {
+            m_lastRealtimeActivity = std::chrono::steady_clock::now();
+        }
+        lock.lock();
+        
         // Process all available events
-        while (!m_eventQueue.empty() && !m_shouldStop.load()) {
-            Event event = m_eventQueue.front();
-            m_eventQueue.pop();
-            
-            {
-                std::lock_guard<std::mutex> statsLock(m_statsMutex);
-                m_stats.queueSize = m_eventQueue.size();
-            }
+        while (!m_shouldStop.load() && popNextEventLocked(event)) {
+            m_queueSize.store(queuedEventCountLocked(), std::memory_order_relaxed);
             
             lock.unlock();
             
             // Deliver event
-            deliverEvent(event);
+            deliverEvent(*event);
+            if (event->type == EventType::AudioDeviceError) {
+                dumpTraceOnError();
+            }
+            event.reset();
             
             lock.lock();
         }
         
         // Periodically clean up inactive listeners
         static auto lastCleanup = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
+        now = std::chrono::steady_clock::now();
         if (now - lastCleanup > std::chrono::minutes(5)) {
             lock.unlock();
             cleanupInactiveListeners();
@@ -274,102 +870,373 @@ void EventDispatcher::processEvents() {
     }
 }
 
-void EventDispatcher::deliverEvent(const Event& event) {
-    auto deliveryStart = std::chrono::high_resolution_clock::now();
+bool EventDispatcher::drainRealtimeEvents() {
+    bool drained = false;
+    RealtimeRecord record;
     
-    std::vector<EventListener> listenersToNotify;
+    // This thread is the ring's only consumer, so popping needs no lock.
+    // Direct listeners run here rather than on the audio thread; the records
+    // then join the regular queues so the same policies apply to them.
+    while (!m_shouldStop.load() && m_realtimeQueue->tryPop(record)) {
+        Event event(record.type, record.payload);
+        event.timestamp = record.timestamp;
+        deliverDirect(event);
+        
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        queueEventLocked(std::move(event));
+        drained = true;
+    }
     
-    // Collect listeners to notify
-    {
-        std::lock_guard<std::mutex> lock(m_listenersMutex);
+    return drained;
+}
+
+bool EventDispatcher::admitRateLimited(const ListenerPtr& listener, const Event& event,
+                                       std::chrono::microseconds minInterval) {
+    auto now = std::chrono::steady_clock::now();
+    if (!listener->held && now - listener->lastDelivery >= minInterval) {
+        listener->lastDelivery = now;
+        return true;
+    }
+    
+    // Too soon: keep only the newest event until the listener's next slot
+    if (listener->held) {
+        m_eventsCoalesced.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_heldListeners.push_back(listener);
+    }
+    listener->held = event;
+    return false;
+}
+
+std::chrono::steady_clock::time_point EventDispatcher::flushHeldEvents() {
+    auto now = std::chrono::steady_clock::now();
+    auto nextDue = std::chrono::steady_clock::time_point::max();
+    uint64_t dropped = 0;
+    
+    for (size_t i = 0; i < m_heldListeners.size();) {
+        ListenerPtr& listener = m_heldListeners[i];
         
-        // Add global listeners
-        for (ListenerHandle handle : m_globalListeners) {
-            auto it = m_listeners.find(handle);
-            if (it != m_listeners.end()) {
-                listenersToNotify.push_back(it->second.listener);
-            }
+        auto index = static_cast<size_t>(listener->held->type);
+        auto minInterval = std::chrono::microseconds(m_policies[index].minIntervalUs.load(std::memory_order_relaxed));
+        auto due = listener->lastDelivery + minInterval;
+        
+        if (due > now) {
+            nextDue = std::min(nextDue, due);
+            ++i;
+            continue;
         }
         
-        // Add type-specific listeners
-        auto typeIt = m_typeListeners.find(event.type);
-        if (typeIt != m_typeListeners.end()) {
-            for (ListenerHandle handle : typeIt->second) {
-                auto it = m_listeners.find(handle);
-                if (it != m_listeners.end()) {
-                    listenersToNotify.push_back(it->second.listener);
-                    
-                    // Update activity timestamp
-                    it->second.lastActivity = std::chrono::steady_clock::now();
-                    it->second.eventsReceived++;
-                }
+        if (m_deliveryPool && !dispatchToListener(listener, *listener->held, false)) {
+            dropped++;
+        }
+        listener->lastDelivery = now;
+        listener->held.reset();
+        
+        std::swap(listener, m_heldListeners.back());
+        m_heldListeners.pop_back();
+    }
+    
+    if (dropped > 0) {
+        m_eventsDropped.fetch_add(dropped, std::memory_order_relaxed);
+    }
+    
+    return nextDue;
+}
+
+void EventDispatcher::deliverEvent(const Event& event, bool deliverInline) {
+    auto index = static_cast<size_t>(event.type);
+    
+    // Lock-free: take the current snapshots; concurrent subscribe/unsubscribe
+    // swap in new lists and leave these untouched
+    ListenerListPtr globalListeners = std::atomic_load(&m_globalListeners);
+    ListenerListPtr typeListeners;
+    bool priority = false;
+    auto minInterval = std::chrono::microseconds(0);
+    if (index < kEventTypeCount) {
+        typeListeners = std::atomic_load(&m_typeListeners[index]);
+        priority = m_policies[index].priority.load(std::memory_order_relaxed);
+        minInterval = std::chrono::microseconds(m_policies[index].minIntervalUs.load(std::memory_order_relaxed));
+    }
+    
+    // Hand off to the delivery threads (or run on the caller for publishImmediate)
+    uint64_t dropped = 0;
+    bool flushNeeded = false;
+    auto dispatch = [&](const ListenerPtr& listener) {
+        if (listener->mode == DeliveryMode::MessageThread && deliverInline) {
+            // Off the processing thread: wake it so the batch gets posted
+            bool wasEmpty = false;
+            if (!m_messageThreadQueue->add(listener, event, wasEmpty)) {
+                dropped++;
             }
+            flushNeeded = flushNeeded || wasEmpty;
+            return;
+        }
+        
+        if (deliverInline || !m_deliveryPool) {
+            invokeListener(*listener, event);
+            return;
+        }
+        
+        // Rate limits apply per type-specific subscriber; this path only runs
+        // on the processing thread, which owns the held-event state
+        if (minInterval.count() > 0 && listener->type == event.type &&
+            !admitRateLimited(listener, event, minInterval)) {
+            return;
+        }
+        
+        if (!dispatchToListener(listener, event, priority)) {
+            dropped++;
+        }
+    };
+    
+    if (globalListeners) {
+        for (const auto& listener : *globalListeners) {
+            dispatch(listener);
         }
     }
     
-    // Deliver to listeners (outside of lock to avoid blocking)
-    for (const auto& listener : listenersToNotify) {
-        try {
-            deliverToListener(listener, event);
-        } catch (const std::exception& e) {
-            // Log error but continue with other listeners
-            // In a real implementation, you'd use a proper logging system
+    if (typeListeners) {
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        for (const auto& listener : *typeListeners) {
+            listener->lastActivity.store(now, std::memory_order_relaxed);
+            listener->eventsReceived.fetch_add(1, std::memory_order_relaxed);
+            dispatch(listener);
         }
     }
     
-    auto deliveryEnd = std::chrono::high_resolution_clock::now();
-    auto deliveryTime = std::chrono::duration_cast<std::chrono::microseconds>(
-        deliveryEnd - deliveryStart).count() / 1000.0;  // Convert to milliseconds
+    m_eventsDelivered.fetch_add(1, std::memory_order_relaxed);
+    if (dropped > 0) {
+        m_eventsDropped.fetch_add(dropped, std::memory_order_relaxed);
+    }
     
-    updateStats(event, deliveryTime);
+    if (flushNeeded) {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_flushRequested = true;
+        }
+        m_queueCondition.notify_one();
+    }
 }
 
-void EventDispatcher::deliverToListener(const EventListener& listener, const Event& event) {
-    // Set up timeout for delivery
-    std::atomic<bool> completed{false};
-    std::exception_ptr exceptionPtr;
+bool EventDispatcher::dispatchToListener(const ListenerPtr& listener, const Event& event, bool priority) {
+    if (listener->mode == DeliveryMode::MessageThread) {
+        bool wasEmpty = false;
+        return m_messageThreadQueue->add(listener, event, wasEmpty);
+    }
+    return m_deliveryPool->enqueue(listener, event, priority);
+}
+
+void EventDispatcher::deliverDirect(const Event& event) {
+    // Common case: no Direct subscribers, so publishers pay one atomic load
+    if (m_directListenerCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
     
-    std::thread deliveryThread([&]() {
-        try {
-            listener(event);
-            completed.store(true);
-        } catch (...) {
-            exceptionPtr = std::current_exception();
-            completed.store(true);
-        }
-    });
+    auto index = static_cast<size_t>(event.type);
+    ListenerListPtr globalListeners = std::atomic_load(&m_directGlobalListeners);
+    ListenerListPtr typeListeners;
+    if (index < kEventTypeCount) {
+        typeListeners = std::atomic_load(&m_directTypeListeners[index]);
+    }
     
-    // Wait for completion or timeout
-    auto start = std::chrono::steady_clock::now();
-    while (!completed.load()) {
-        auto elapsed = std::chrono::steady_clock::now() - start;
-        if (elapsed > m_deliveryTimeout) {
-            // Timeout occurred - detach thread and give up
-            deliveryThread.detach();
-            return;
+    if (globalListeners) {
+        for (const auto& listener : *globalListeners) {
+            if (!listener->removed.load(std::memory_order_relaxed)) {
+                invokeListener(*listener, event);
+            }
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
     
-    if (deliveryThread.joinable()) {
-        deliveryThread.join();
+    if (typeListeners) {
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        for (const auto& listener : *typeListeners) {
+            if (listener->removed.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            listener->lastActivity.store(now, std::memory_order_relaxed);
+            listener->eventsReceived.fetch_add(1, std::memory_order_relaxed);
+            invokeListener(*listener, event);
+        }
     }
+}
+
+std::chrono::steady_clock::time_point EventDispatcher::flushMessageThreadQueue() {
+    return m_messageThreadQueue->flush(std::chrono::steady_clock::now());
+}
+
+void EventDispatcher::invokeListener(ListenerInfo& info, const Event& event) {
+    auto invokeStart = std::chrono::steady_clock::now();
+    try {
+        info.listener(event);
+    } catch (...) {
+        // Log error but continue with other listeners
+    }
+    auto elapsed = std::chrono::steady_clock::now() - invokeStart;
     
-    // Re-throw any exception that occurred
-    if (exceptionPtr) {
-        std::rethrow_exception(exceptionPtr);
+    // Inline invocations are not watched, so check the budget after the fact
+    bool timedOut = elapsed > std::chrono::milliseconds(m_deliveryTimeoutMs.load());
+    if (timedOut) {
+        flagSlowListener(info);
     }
+    
+    recordInvocation(info, event, invokeStart, elapsed, timedOut);
 }
 
-void EventDispatcher::updateStats(const Event& event, double deliveryTime) {
-    std::lock_guard<std::mutex> lock(m_statsMutex);
+void EventDispatcher::recordInvocation(ListenerInfo& info, const Event& event,
+                                       std::chrono::steady_clock::time_point started,
+                                       std::chrono::nanoseconds elapsed, bool timedOut) {
+    // A listener stays flagged until it completes an invocation within the timeout
+    if (!timedOut && info.slow.exchange(false)) {
+        m_slowListeners.fetch_sub(1, std::memory_order_relaxed);
+    }
     
-    m_stats.eventsDelivered++;
+    if (EventTraceBuffer* trace = m_activeTrace.load(std::memory_order_acquire)) {
+        EventTraceRecord record;
+        record.kind = EventTraceRecord::Kind::Deliver;
+        record.type = static_cast<uint16_t>(event.type);
+        record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            event.timestamp.time_since_epoch()).count());
+        record.startNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            started.time_since_epoch()).count());
+        record.durationNs = static_cast<uint64_t>(elapsed.count());
+        record.threadId = EventTraceBuffer::currentThreadId();
+        record.listenerId = static_cast<uint32_t>(info.handle);
+        trace->record(record);
+    }
+    
+    double deliveryTime = static_cast<double>(elapsed.count()) / 1e6;  // Convert to milliseconds
     
     // Update average delivery time (exponential moving average)
     const double alpha = 0.1;
-    m_stats.averageDeliveryTime = alpha * deliveryTime + 
-                                  (1.0 - alpha) * m_stats.averageDeliveryTime;
+    double average = m_averageDeliveryTime.load(std::memory_order_relaxed);
+    while (!m_averageDeliveryTime.compare_exchange_weak(
+               average, alpha * deliveryTime + (1.0 - alpha) * average, std::memory_order_relaxed)) {
+    }
+}
+
+void EventDispatcher::flagSlowListener(ListenerInfo& info) {
+    m_deliveryTimeouts.fetch_add(1, std::memory_order_relaxed);
+    if (!info.slow.exchange(true)) {
+        m_slowListeners.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Tracing
+
+void EventDispatcher::tracePublish(EventType type, std::chrono::steady_clock::time_point timestamp,
+                                   size_t queueDepth) noexcept {
+    // One relaxed load when tracing is off; safe from publishRT()
+    EventTraceBuffer* trace = m_activeTrace.load(std::memory_order_acquire);
+    if (!trace) {
+        return;
+    }
+    
+    EventTraceRecord record;
+    record.kind = EventTraceRecord::Kind::Publish;
+    record.type = static_cast<uint16_t>(type);
+    record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        timestamp.time_since_epoch()).count());
+    record.queueDepth = static_cast<uint32_t>(std::min<size_t>(queueDepth, std::numeric_limits<uint32_t>::max()));
+    record.threadId = EventTraceBuffer::currentThreadId();
+    trace->record(record);
+}
+
+void EventDispatcher::enableTracing(size_t capacity) {
+    std::lock_guard<std::mutex> lock(m_traceMutex);
+    if (!m_traceBuffer) {
+        m_traceBuffer = std::make_unique<EventTraceBuffer>(capacity);
+    }
+    m_activeTrace.store(m_traceBuffer.get(), std::memory_order_release);
+}
+
+void EventDispatcher::disableTracing() {
+    m_activeTrace.store(nullptr, std::memory_order_release);
+}
+
+bool EventDispatcher::isTracing() const {
+    return m_activeTrace.load() != nullptr;
+}
+
+std::vector<EventTraceRecord> EventDispatcher::getTrace() const {
+    std::lock_guard<std::mutex> lock(m_traceMutex);
+    return m_traceBuffer ? m_traceBuffer->snapshot() : std::vector<EventTraceRecord>();
+}
+
+bool EventDispatcher::dumpTrace(const std::string& path) const {
+    return EventTraceBuffer::writeFile(path, getTrace());
+}
+
+void EventDispatcher::setTraceDumpPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_traceMutex);
+    m_traceDumpPath = path;
+}
+
+void EventDispatcher::dumpTraceOnError() {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_traceMutex);
+        auto now = std::chrono::steady_clock::now();
+        
+        // An error storm rewrites the file at most once a second
+        if (!m_activeTrace.load() || m_traceDumpPath.empty() ||
+            now - m_lastTraceDump < std::chrono::seconds(1)) {
+            return;
+        }
+        m_lastTraceDump = now;
+        path = m_traceDumpPath;
+    }
+    
+    dumpTrace(path);
+}
+
+// Copy-on-write: build a new snapshot rather than touching the one that
+// delivery may be walking. Called with m_listenersMutex held.
+void EventDispatcher::appendListener(ListenerListPtr& list, const ListenerPtr& info) {
+    auto current = std::atomic_load(&list);
+    auto updated = current ? std::make_shared<ListenerList>(*current) : std::make_shared<ListenerList>();
+    updated->push_back(info);
+    std::atomic_store(&list, ListenerListPtr(std::move(updated)));
+}
+
+void EventDispatcher::removeListener(ListenerListPtr& list, const ListenerPtr& info) {
+    auto current = std::atomic_load(&list);
+    if (!current) {
+        return;
+    }
+    
+    auto updated = std::make_shared<ListenerList>();
+    updated->reserve(current->size());
+    std::copy_if(current->begin(), current->end(), std::back_inserter(*updated),
+                 [&info](const ListenerPtr& entry) { return entry != info; });
+    std::atomic_store(&list, updated->empty() ? ListenerListPtr() : ListenerListPtr(std::move(updated)));
+}
+
+void EventDispatcher::detachListener(const ListenerPtr& info) {
+    bool direct = info->mode == DeliveryMode::Direct;
+    auto index = static_cast<size_t>(info->type);
+    if (index < kEventTypeCount) {
+        removeListener(direct ? m_directTypeListeners[index] : m_typeListeners[index], info);
+        m_subscriberCounts[index].fetch_sub(1, std::memory_order_relaxed);
+    } else {
+        removeListener(direct ? m_directGlobalListeners : m_globalListeners, info);
+        m_globalSubscriberCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (direct) {
+        m_directListenerCount.fetch_sub(1);
+    }
+}
+
+void EventDispatcher::retireListener(const ListenerPtr& info) {
+    // Queued deliveries (pool backlog, message thread batch) check this flag
+    info->removed.store(true);
+    
+    if (m_deliveryPool) {
+        m_deliveryPool->retire(info);
+    }
+    
+    if (info->slow.exchange(false)) {
+        m_slowListeners.fetch_sub(1, std::memory_order_relaxed);
+    }
 }
 
 void EventDispatcher::cleanupInactiveListeners() {
@@ -378,79 +1245,73 @@ void EventDispatcher::cleanupInactiveListeners() {
     auto now = std::chrono::steady_clock::now();
     const auto inactiveThreshold = std::chrono::hours(1);  // Remove listeners inactive for 1 hour
     
-    std::vector<ListenerHandle> toRemove;
-    
-    for (const auto& [handle, info] : m_listeners) {
-        if (now - info.lastActivity > inactiveThreshold) {
-            toRemove.push_back(handle);
-        }
-    }
-    
-    for (ListenerHandle handle : toRemove) {
-        // Remove without lock (we already have it)
-        auto it = m_listeners.find(handle);
-        if (it != m_listeners.end()) {
-            EventType type = it->second.type;
-            
-            if (type != static_cast<EventType>(-1)) {
-                auto& typeListeners = m_typeListeners[type];
-                typeListeners.erase(
-                    std::remove(typeListeners.begin(), typeListeners.end(), handle),
-                    typeListeners.end()
-                );
-                
-                if (typeListeners.empty()) {
-                    m_typeListeners.erase(type);
-                }
-            } else {
-                m_globalListeners.erase(
-                    std::remove(m_globalListeners.begin(), m_globalListeners.end(), handle),
-                    m_globalListeners.end()
-                );
-            }
-            
-            m_listeners.erase(it);
+    for (auto it = m_listeners.begin(); it != m_listeners.end();) {
+        std::chrono::steady_clock::time_point lastActivity(
+            std::chrono::steady_clock::duration(it->second->lastActivity.load(std::memory_order_relaxed)));
+        
+        if (now - lastActivity > inactiveThreshold) {
+            detachListener(it->second);
+            retireListener(it->second);
+            it = m_listeners.erase(it);
+        } else {
+            ++it;
         }
     }
     
-    {
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.activeListeners = m_listeners.size();
+    m_activeListeners.store(m_listeners.size(), std::memory_order_relaxed);
+}
+
+// Payload field lookup for the string-keyed adapters
+
+std::any getPayloadField(const EventPayload& payload, const std::string& key) {
+    if (auto* p = std::get_if<AudioLevelPayload>(&payload)) {
+        if (key == "level") return p->level;
+        if (key == "isInput") return p->isInput;
+    } else if (auto* p = std::get_if<ProcessingStatsPayload>(&payload)) {
+        if (key == "cpu_usage") return p->cpuUsage;
+        if (key == "latency") return p->latency;
+        if (key == "reduction_level") return p->reductionLevel;
+    } else if (auto* p = std::get_if<NoiseReductionPayload>(&payload)) {
+        if (key == "enabled") return p->enabled;
+        if (key == "level") return p->level;
+        if (key == "threshold") return p->threshold;
+        if (key == "adaptive") return p->adaptive;
+    } else if (auto* p = std::get_if<AudioProcessingPayload>(&payload)) {
+        if (key == "sample_rate") return p->sampleRate;
+    } else if (auto* p = std::get_if<DeviceChangedPayload>(&payload)) {
+        if (key == "device_id") return p->deviceId.str();
+        if (key == "device_name") return p->deviceName.str();
+    } else if (auto* p = std::get_if<ErrorPayload>(&payload)) {
+        if (key == "message") return p->message.str();
+        if (key == "error_code") return p->errorCode;
+    } else if (auto* p = std::get_if<SettingsChangedPayload>(&payload)) {
+        if (key == "key") return p->key.str();
+        if (key == "change_count") return static_cast<int>(p->changeCount);
+        if (key == "version") return p->version;
     }
+    return {};
 }
 
 // EventDataFactory implementation
 
 namespace EventDataFactory {
 
-std::shared_ptr<EventData> createAudioLevelData(float level) {
-    auto data = std::make_shared<EventData>();
-    data->setValue("level", level);
-    return data;
+AudioLevelPayload createAudioLevelData(float level, bool isInput) {
+    return AudioLevelPayload{level, isInput};
 }
 
-std::shared_ptr<EventData> createDeviceChangedData(const std::string& deviceId, 
-                                                   const std::string& deviceName) {
-    auto data = std::make_shared<EventData>();
-    data->setValue("device_id", deviceId);
-    data->setValue("device_name", deviceName);
-    return data;
+DeviceChangedPayload createDeviceChangedData(const std::string& deviceId, 
+                                             const std::string& deviceName) {
+    return DeviceChangedPayload{deviceId, deviceName};
 }
 
-std::shared_ptr<EventData> createErrorData(const std::string& message, int errorCode) {
-    auto data = std::make_shared<EventData>();
-    data->setValue("message", message);
-    data->setValue("error_code", errorCode);
-    return data;
+ErrorPayload createErrorData(const std::string& message, int errorCode) {
+    return ErrorPayload{message, errorCode};
 }
 
-std::shared_ptr<EventData> createProcessingStatsData(float cpuUsage, float latency, 
-                                                     float reductionLevel) {
-    auto data = std::make_shared<EventData>();
-    data->setValue("cpu_usage", cpuUsage);
-    data->setValue("latency", latency);
-    data->setValue("reduction_level", reductionLevel);
-    return data;
+ProcessingStatsPayload createProcessingStatsData(float cpuUsage, float latency, 
+                                                 float reductionLevel) {
+    return ProcessingStatsPayload{cpuUsage, latency, reductionLevel};
 }
 
 } // namespace EventDataFactory
@@ -0,0 +1,202 @@
+#include "quiet/core/EventTrace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace quiet {
+namespace core {
+
+namespace {
+
+constexpr char kFileMagic[8] = {'Q', 'E', 'V', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kFileVersion = 1;
+constexpr size_t kRecordBytes = 40;
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void pack(const EventTraceRecord& record, uint64_t (&words)[5]) {
+    words[0] = record.timestampNs;
+    words[1] = record.startNs;
+    words[2] = record.durationNs;
+    words[3] = static_cast<uint64_t>(record.queueDepth) |
+               (static_cast<uint64_t>(record.type) << 32) |
+               (static_cast<uint64_t>(record.kind) << 48);
+    words[4] = static_cast<uint64_t>(record.threadId) |
+               (static_cast<uint64_t>(record.listenerId) << 32);
+}
+
+EventTraceRecord unpack(const uint64_t (&words)[5]) {
+    EventTraceRecord record;
+    record.timestampNs = words[0];
+    record.startNs = words[1];
+    record.durationNs = words[2];
+    record.queueDepth = static_cast<uint32_t>(words[3]);
+    record.type = static_cast<uint16_t>(words[3] >> 32);
+    record.kind = static_cast<EventTraceRecord::Kind>((words[3] >> 48) & 0xff);
+    record.threadId = static_cast<uint32_t>(words[4]);
+    record.listenerId = static_cast<uint32_t>(words[4] >> 32);
+    return record;
+}
+
+void putLittleEndian(char* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+uint64_t getLittleEndian(const char* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+EventTraceBuffer::EventTraceBuffer(size_t capacity)
+    : m_capacity(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2)))
+    , m_mask(m_capacity - 1)
+    , m_slots(new Slot[m_capacity]) {
+}
+
+void EventTraceBuffer::record(const EventTraceRecord& record) noexcept {
+    uint64_t words[kWords];
+    pack(record, words);
+
+    // Odd sequence while writing, even (and unique per lap) once complete.
+    // If a writer from another lap still holds the slot, or a newer lap has
+    // already taken it, this record is dropped rather than waited on.
+    uint64_t index = m_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[index & m_mask];
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    do {
+        if ((sequence & 1) != 0 || sequence > index * 2) {
+            return;
+        }
+    } while (!slot.sequence.compare_exchange_weak(sequence, index * 2 + 1, std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed));
+
+    for (size_t i = 0; i < kWords; ++i) {
+        slot.words[i].store(words[i], std::memory_order_release);
+    }
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+}
+
+std::vector<EventTraceRecord> EventTraceBuffer::snapshot() const {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t first = head > m_capacity ? head - m_capacity : 0;
+
+    std::vector<EventTraceRecord> records;
+    records.reserve(static_cast<size_t>(head - first));
+
+    for (uint64_t index = first; index < head; ++index) {
+        const Slot& slot = m_slots[index & m_mask];
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != index * 2 + 2) {
+            continue;  // Still being written, or already overwritten by a newer lap
+        }
+
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_acquire);
+        }
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+
+        records.push_back(unpack(words));
+    }
+
+    return records;
+}
+
+void EventTraceBuffer::clear() noexcept {
+    // Leaves the slots alone; their sequence numbers no longer match once the
+    // head moves past them, so snapshot() ignores stale entries. One atomic
+    // skip of a full lap, so concurrent record() calls either land before it
+    // (and fall out of the window) or after it, never lost in between.
+    m_head.fetch_add(m_capacity, std::memory_order_acq_rel);
+}
+
+bool EventTraceBuffer::writeFile(const std::string& path, const std::vector<EventTraceRecord>& records) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    char header[16];
+    std::memcpy(header, kFileMagic, sizeof(kFileMagic));
+    putLittleEndian(header + 8, kFileVersion, 4);
+    putLittleEndian(header + 12, static_cast<uint32_t>(records.size()), 4);
+    file.write(header, sizeof(header));
+
+    std::vector<char> buffer(records.size() * kRecordBytes);
+    for (size_t i = 0; i < records.size(); ++i) {
+        uint64_t words[kWords];
+        pack(records[i], words);
+        for (size_t w = 0; w < kWords; ++w) {
+            putLittleEndian(buffer.data() + i * kRecordBytes + w * 8, words[w], 8);
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    return static_cast<bool>(file);
+}
+
+bool EventTraceBuffer::readFile(const std::string& path, std::vector<EventTraceRecord>& records) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    char header[16];
+    if (!file.read(header, sizeof(header)) ||
+        std::memcmp(header, kFileMagic, sizeof(kFileMagic)) != 0 ||
+        getLittleEndian(header + 8, 4) != kFileVersion) {
+        return false;
+    }
+
+    auto count = static_cast<size_t>(getLittleEndian(header + 12, 4));
+    std::vector<char> buffer(count * kRecordBytes);
+    if (!file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+        return false;
+    }
+
+    records.clear();
+    records.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t words[kWords];
+        for (size_t w = 0; w < kWords; ++w) {
+            words[w] = getLittleEndian(buffer.data() + i * kRecordBytes + w * 8, 8);
+        }
+        records.push_back(unpack(words));
+    }
+
+    return true;
+}
+
+uint32_t EventTraceBuffer::currentThreadId() noexcept {
+    thread_local uint32_t id = 0;
+    if (id == 0) {
+        id = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+    }
+    return id;
+}
+
+uint64_t EventTraceBuffer::nowNs() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace core
+} // namespace quiet
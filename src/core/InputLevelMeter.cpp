@@ -0,0 +1,46 @@
+#include "quiet/core/InputLevelMeter.h"
+#include "quiet/core/AudioBuffer.h"
+#include "quiet/core/EventDispatcher.h"
+#include <algorithm>
+#include <cmath>
+
+namespace quiet {
+namespace core {
+
+InputLevelMeter::InputLevelMeter(EventDispatcher& eventDispatcher)
+    : m_eventDispatcher(eventDispatcher) {
+}
+
+void InputLevelMeter::process(const AudioBuffer& buffer, int numChannels, int numSamples) noexcept {
+    if (numChannels <= 0 || numSamples <= 0 ||
+        !m_eventDispatcher.hasSubscribers(EventType::AudioLevelChanged)) {
+        return;
+    }
+
+    // RMS across all channels
+    float rmsLevel = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float channelRms = buffer.getRMSLevel(ch, 0, numSamples);
+        rmsLevel += channelRms * channelRms;
+    }
+    rmsLevel = std::sqrt(rmsLevel / numChannels);
+
+    // Convert to dB and normalize to 0-1
+    float levelDb = 20.0f * std::log10(std::max(rmsLevel, 1e-6f));
+    levelDb = std::clamp(levelDb, kMinLevelDb, kMaxLevelDb);
+    float normalizedLevel = (levelDb - kMinLevelDb) / (kMaxLevelDb - kMinLevelDb);
+
+    float smoothedLevel = getLevel() * kSmoothingFactor + normalizedLevel * (1.0f - kSmoothingFactor);
+    m_level.store(smoothedLevel, std::memory_order_relaxed);
+
+    // Throttled to avoid flooding the dispatcher
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastPublish > kPublishInterval) {
+        m_eventDispatcher.publishRT(EventType::AudioLevelChanged,
+                                    EventDataFactory::createAudioLevelData(smoothedLevel));
+        m_lastPublish = now;
+    }
+}
+
+} // namespace core
+} // namespace quiet
@@ -0,0 +1,66 @@
+#include "quiet/core/LogFrequencyBands.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace quiet {
+namespace core {
+
+void LogFrequencyBands::configure(int numBands, int fftSize, double sampleRate, float minHz, float maxHz) {
+    m_fftSize = fftSize;
+    m_sampleRate = sampleRate;
+    m_bands.clear();
+    if (numBands <= 0 || fftSize < 4 || sampleRate <= 0.0) {
+        return;
+    }
+
+    const int numBins = fftSize / 2;
+    const double binHz = sampleRate / fftSize;
+    const float nyquist = static_cast<float>(sampleRate * 0.5);
+
+    // Keep clear of DC and of the last bin
+    m_minHz = std::clamp(minHz, static_cast<float>(binHz), nyquist * 0.5f);
+    m_maxHz = std::clamp(maxHz, m_minHz * 2.0f, nyquist);
+    m_logMin = std::log(m_minHz);
+    m_logRange = std::log(m_maxHz) - m_logMin;
+
+    m_bands.resize(static_cast<size_t>(numBands));
+    for (int i = 0; i < numBands; ++i) {
+        Band& band = m_bands[i];
+        band.lowHz = std::exp(m_logMin + m_logRange * i / numBands);
+        band.highHz = std::exp(m_logMin + m_logRange * (i + 1) / numBands);
+
+        // Bins whose centre lies in [lowHz, highHz)
+        int first = static_cast<int>(std::ceil(band.lowHz / binHz));
+        int last = static_cast<int>(std::ceil(band.highHz / binHz)) - 1;
+        if (last < first) {
+            int centre = static_cast<int>(std::lround(std::sqrt(band.lowHz * band.highHz) / binHz));
+            first = last = centre;
+        }
+        band.firstBin = std::clamp(first, 1, numBins - 1);
+        band.lastBin = std::clamp(last, band.firstBin, numBins - 1);
+    }
+}
+
+void LogFrequencyBands::aggregate(const float* magnitudesDb, size_t numBins, float* bandDb) const {
+    for (size_t i = 0; i < m_bands.size(); ++i) {
+        const Band& band = m_bands[i];
+        const size_t first = static_cast<size_t>(band.firstBin);
+        const size_t end = std::min(static_cast<size_t>(band.lastBin) + 1, numBins);
+        float peak = first < end ? magnitudesDb[first] : std::numeric_limits<float>::lowest();
+        for (size_t bin = first + 1; bin < end; ++bin) {
+            peak = std::max(peak, magnitudesDb[bin]);
+        }
+        bandDb[i] = peak;
+    }
+}
+
+float LogFrequencyBands::proportionOfFrequency(float hz) const {
+    if (hz <= 0.0f) {
+        return 0.0f;
+    }
+    return (std::log(hz) - m_logMin) / m_logRange;
+}
+
+} // namespace core
+} // namespace quiet
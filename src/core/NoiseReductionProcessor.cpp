@@ -1,5 +1,6 @@
 #include "quiet/core/NoiseReductionProcessor.h"
 #include "quiet/core/EventDispatcher.h"
+#include "quiet/utils/Logger.h"
 #include <algorithm>
 #include <cstring>
 #include <chrono>
@@ -15,8 +16,19 @@ extern "C" {
 namespace quiet {
 namespace core {
 
+namespace {
+
+NoiseReductionPayload makeConfigPayload(const NoiseReductionConfig& config) {
+    return NoiseReductionPayload{config.enabled, static_cast<int>(config.level),
+                                 config.threshold, config.adaptiveMode};
+}
+
+} // namespace
+
 NoiseReductionProcessor::NoiseReductionProcessor(EventDispatcher& eventDispatcher)
-    : m_eventDispatcher(eventDispatcher) {
+    : m_eventDispatcher(eventDispatcher)
+    , m_bufferSpanId(utils::PerfSpanCollector::registerName("denoise.buffer"))
+    , m_frameSpanId(utils::PerfSpanCollector::registerName("denoise.frame")) {
     
     // Initialize default configuration
     m_config.level = NoiseReductionConfig::Level::Medium;
@@ -52,6 +64,7 @@ bool NoiseReductionProcessor::initialize(double sampleRate) {
     
     // Initialize RNNoise
     if (!initializeRNNoise()) {
+        LOGF_ERROR("RNNoise initialization failed at {} Hz", sampleRate);
         return false;
     }
     
@@ -65,11 +78,10 @@ bool NoiseReductionProcessor::initialize(double sampleRate) {
     resetStats();
     
     m_isInitialized = true;
+    LOGF_INFO("Noise reduction initialized at {} Hz (resampling: {})", sampleRate, m_needsResampling);
     
-    // Notify event dispatcher
-    auto eventData = std::make_shared<EventData>();
-    eventData->setValue("sample_rate", sampleRate);
-    m_eventDispatcher.publish(EventType::AudioProcessingStarted, eventData);
+    // Notify event dispatcher (may be called from the audio device callback)
+    m_eventDispatcher.publishRT(EventType::AudioProcessingStarted, AudioProcessingPayload{sampleRate});
     
     return true;
 }
@@ -103,18 +115,15 @@ bool NoiseReductionProcessor::isInitialized() const {
 }
 
 void NoiseReductionProcessor::setConfig(const NoiseReductionConfig& config) {
-    std::lock_guard<std::mutex> lock(m_statsMutex);
-    m_config = config;
-    m_enabled.store(config.enabled);
-    
-    // Notify about configuration change
-    auto eventData = std::make_shared<EventData>();
-    eventData->setValue("enabled", config.enabled);
-    eventData->setValue("level", static_cast<int>(config.level));
-    eventData->setValue("threshold", config.threshold);
-    eventData->setValue("adaptive", config.adaptiveMode);
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_config = config;
+        m_enabled.store(config.enabled);
+    }
     
-    m_eventDispatcher.publish(EventType::NoiseReductionLevelChanged, eventData);
+    // Notify about configuration change. Published outside m_statsMutex, which
+    // the audio thread also takes, and without allocating.
+    m_eventDispatcher.publishRT(EventType::NoiseReductionLevelChanged, makeConfigPayload(config));
 }
 
 NoiseReductionConfig NoiseReductionProcessor::getConfig() const {
@@ -126,13 +135,15 @@ void NoiseReductionProcessor::setEnabled(bool enabled) {
     bool wasEnabled = m_enabled.exchange(enabled);
     
     if (wasEnabled != enabled) {
-        std::lock_guard<std::mutex> lock(m_statsMutex);
-        m_config.enabled = enabled;
+        NoiseReductionConfig config;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_config.enabled = enabled;
+            config = m_config;
+        }
         
         // Notify about toggle
-        auto eventData = std::make_shared<EventData>();
-        eventData->setValue("enabled", enabled);
-        m_eventDispatcher.publish(EventType::NoiseReductionToggled, eventData);
+        m_eventDispatcher.publishRT(EventType::NoiseReductionToggled, makeConfigPayload(config));
     }
 }
 
@@ -141,15 +152,15 @@ bool NoiseReductionProcessor::isEnabled() const {
 }
 
 void NoiseReductionProcessor::setLevel(NoiseReductionConfig::Level level) {
+    NoiseReductionConfig config;
     {
         std::lock_guard<std::mutex> lock(m_statsMutex);
         m_config.level = level;
+        config = m_config;
     }
     
     // Notify about level change
-    auto eventData = std::make_shared<EventData>();
-    eventData->setValue("level", static_cast<int>(level));
-    m_eventDispatcher.publish(EventType::NoiseReductionLevelChanged, eventData);
+    m_eventDispatcher.publishRT(EventType::NoiseReductionLevelChanged, makeConfigPayload(config));
 }
 
 NoiseReductionConfig::Level NoiseReductionProcessor::getLevel() const {
@@ -167,6 +178,7 @@ bool NoiseReductionProcessor::process(AudioBuffer& buffer) {
         return true;
     }
     
+    QUIET_PERF_SPAN_ID(m_bufferSpanId);
     auto startTime = std::chrono::high_resolution_clock::now();
     
     // Convert to mono if necessary (RNNoise processes mono)
@@ -308,6 +320,8 @@ bool NoiseReductionProcessor::processFrame(float* frame, int frameSize) {
         return false;
     }
     
+    QUIET_PERF_SPAN_ID(m_frameSpanId);
+    
     // Store pre-processed RMS for statistics
     float preRMS = calculateRMS(frame, frameSize);
     
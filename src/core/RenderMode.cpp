@@ -0,0 +1,82 @@
+#include "quiet/core/RenderMode.h"
+#include <algorithm>
+#include <cctype>
+
+namespace quiet {
+namespace core {
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+bool containsIgnoreCase(std::string_view text, std::string_view needle) {
+    auto it = std::search(text.begin(), text.end(), needle.begin(), needle.end(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+    return it != text.end();
+}
+
+} // namespace
+
+RenderMode parseRenderMode(std::string_view text) {
+    if (equalsIgnoreCase(text, "software")) {
+        return RenderMode::Software;
+    }
+    if (equalsIgnoreCase(text, "opengl")) {
+        return RenderMode::OpenGL;
+    }
+    return RenderMode::Auto;
+}
+
+const char* renderModeName(RenderMode mode) {
+    switch (mode) {
+        case RenderMode::Software: return "software";
+        case RenderMode::OpenGL: return "opengl";
+        case RenderMode::Auto: return "auto";
+    }
+    return "auto";
+}
+
+bool isSoftwareRasterizer(std::string_view rendererName) {
+    static constexpr std::string_view kSoftwareRenderers[] = {
+        "llvmpipe", "softpipe", "swrast", "SwiftShader", "Software Rasterizer", "GDI Generic"
+    };
+
+    for (std::string_view name : kSoftwareRenderers) {
+        if (containsIgnoreCase(rendererName, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RenderCpuMeter::sample(double cpuSeconds, double wallSeconds, uint64_t frameCount) {
+    if (!m_started) {
+        m_started = true;
+        m_startCpu = cpuSeconds;
+        m_startWall = wallSeconds;
+        m_startFrames = frameCount;
+        return false;
+    }
+
+    double elapsed = wallSeconds - m_startWall;
+    if (elapsed < m_windowSeconds) {
+        return false;
+    }
+
+    m_cpuPercent = 100.0 * (cpuSeconds - m_startCpu) / elapsed;
+    m_framesPerSecond = static_cast<double>(frameCount - m_startFrames) / elapsed;
+
+    m_startCpu = cpuSeconds;
+    m_startWall = wallSeconds;
+    m_startFrames = frameCount;
+    return true;
+}
+
+} // namespace core
+} // namespace quiet
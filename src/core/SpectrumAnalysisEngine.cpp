@@ -0,0 +1,212 @@
+#include "quiet/core/SpectrumAnalysisEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace quiet {
+namespace core {
+
+namespace {
+
+constexpr int kMinFftOrder = 8;    // 256
+constexpr int kMaxFftOrder = 14;   // 16384
+
+// Input ring: at least this many samples, and at least four FFT windows
+constexpr size_t kMinInputCapacity = 16384;
+
+int fftOrderFor(int fftSize) {
+    int order = kMinFftOrder;
+    while (order < kMaxFftOrder && (1 << order) < fftSize) {
+        ++order;
+    }
+    return order;
+}
+
+} // namespace
+
+SpectrumAnalysisEngine::SpectrumAnalysisEngine()
+    : SpectrumAnalysisEngine(Settings()) {
+}
+
+SpectrumAnalysisEngine::SpectrumAnalysisEngine(const Settings& settings) {
+    configure(settings);
+}
+
+SpectrumAnalysisEngine::~SpectrumAnalysisEngine() {
+    stop();
+}
+
+void SpectrumAnalysisEngine::configure(const Settings& settings) {
+    const int order = fftOrderFor(settings.fftSize);
+    const int fftSize = 1 << order;
+    m_settings.fftSize = fftSize;
+    m_settings.hopSize = std::clamp(settings.hopSize, 1, fftSize);
+    m_settings.queuedFrames = std::max(settings.queuedFrames, 0);
+
+    m_fft = std::make_unique<juce::dsp::FFT>(order);
+
+    // Hann window; the scale makes a full-scale sine read 0 dB
+    m_window.resize(static_cast<size_t>(fftSize));
+    float windowSum = 0.0f;
+    for (int i = 0; i < fftSize; ++i) {
+        m_window[i] = 0.5f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * i / (fftSize - 1));
+        windowSum += m_window[i];
+    }
+    m_magnitudeScale = 2.0f / windowSum;
+
+    m_history.assign(static_cast<size_t>(fftSize), 0.0f);
+    m_hopBuffer.assign(static_cast<size_t>(m_settings.hopSize), 0.0f);
+    m_fftData.assign(static_cast<size_t>(fftSize) * 2, 0.0f);
+    m_hopFill = 0;
+    m_input = std::make_unique<utils::SpscRingBuffer<float>>(
+        std::max(kMinInputCapacity, static_cast<size_t>(fftSize) * 4));
+
+    m_frames.forEachSlot([fftSize](SpectrumFrame& frame) {
+        frame.magnitudesDb.assign(static_cast<size_t>(fftSize / 2), kFloorDb);
+        frame.fftSize = fftSize;
+        frame.sampleRate = 0.0;
+        frame.sequence = 0;
+    });
+    m_framesAnalyzed.store(0, std::memory_order_relaxed);
+
+    m_queue.reset();
+    if (m_settings.queuedFrames > 0) {
+        m_queue = std::make_unique<utils::SpscRingBuffer<float>>(
+            static_cast<size_t>(m_settings.queuedFrames) * static_cast<size_t>(fftSize / 2));
+    }
+    m_droppedFrames.store(0, std::memory_order_relaxed);
+}
+
+void SpectrumAnalysisEngine::start() {
+    if (isRunning()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = false;
+        m_wakeRequested = true;   // Pick up anything pushed while stopped
+    }
+    m_running.store(true, std::memory_order_relaxed);
+    m_thread = std::thread(&SpectrumAnalysisEngine::analysisThread, this);
+}
+
+void SpectrumAnalysisEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running.store(false, std::memory_order_relaxed);
+}
+
+void SpectrumAnalysisEngine::setSettings(const Settings& settings) {
+    const bool wasRunning = isRunning();
+    stop();
+    configure(settings);
+    if (wasRunning) {
+        start();
+    }
+}
+
+void SpectrumAnalysisEngine::pushSamples(const float* samples, size_t count, double sampleRate) {
+    if (samples == nullptr || count == 0) {
+        return;
+    }
+
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+    size_t pushed = m_input->tryPushBulk(samples, count);
+    if (pushed < count) {
+        m_droppedSamples.fetch_add(count - pushed, std::memory_order_relaxed);
+    }
+
+    if (isRunning()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wakeRequested = true;
+        }
+        m_condition.notify_one();
+    }
+}
+
+bool SpectrumAnalysisEngine::popQueuedFrame(float* magnitudesDb) noexcept {
+    const size_t numBins = static_cast<size_t>(m_settings.fftSize / 2);
+    if (!m_queue || m_queue->size() < numBins) {
+        return false;
+    }
+
+    // Frames are pushed whole, so a frame's worth queued is one complete frame
+    m_queue->tryPopBulk(magnitudesDb, numBins);
+    return true;
+}
+
+void SpectrumAnalysisEngine::analysisThread() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopRequested) {
+        m_condition.wait(lock, [this] { return m_wakeRequested || m_stopRequested; });
+        m_wakeRequested = false;
+
+        lock.unlock();
+        processPending();
+        lock.lock();
+    }
+}
+
+void SpectrumAnalysisEngine::processPending() {
+    const int hopSize = m_settings.hopSize;
+    const int fftSize = m_settings.fftSize;
+
+    size_t popped;
+    while ((popped = m_input->tryPopBulk(m_hopBuffer.data() + m_hopFill,
+                                         static_cast<size_t>(hopSize - m_hopFill))) > 0) {
+        m_hopFill += static_cast<int>(popped);
+        if (m_hopFill < hopSize) {
+            continue;
+        }
+
+        // Slide the window along by one hop
+        std::memmove(m_history.data(), m_history.data() + hopSize,
+                     static_cast<size_t>(fftSize - hopSize) * sizeof(float));
+        std::memcpy(m_history.data() + (fftSize - hopSize), m_hopBuffer.data(),
+                    static_cast<size_t>(hopSize) * sizeof(float));
+        m_hopFill = 0;
+
+        analyseFrame();
+    }
+}
+
+void SpectrumAnalysisEngine::analyseFrame() {
+    const int fftSize = m_settings.fftSize;
+
+    for (int i = 0; i < fftSize; ++i) {
+        m_fftData[i] = m_history[i] * m_window[i];
+    }
+    std::fill(m_fftData.begin() + fftSize, m_fftData.end(), 0.0f);
+    m_fft->performFrequencyOnlyForwardTransform(m_fftData.data());
+
+    SpectrumFrame& frame = m_frames.writeBuffer();
+    for (int i = 0; i < fftSize / 2; ++i) {
+        frame.magnitudesDb[i] = juce::Decibels::gainToDecibels(m_fftData[i] * m_magnitudeScale, kFloorDb);
+    }
+    frame.sampleRate = m_sampleRate.load(std::memory_order_relaxed);
+    frame.fftSize = fftSize;
+    frame.sequence = m_framesAnalyzed.load(std::memory_order_relaxed) + 1;
+
+    if (m_queue) {
+        const size_t numBins = frame.magnitudesDb.size();
+        if (m_queue->capacity() - m_queue->size() >= numBins) {
+            m_queue->tryPushBulk(frame.magnitudesDb.data(), numBins);
+        } else {
+            m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    m_framesAnalyzed.store(frame.sequence, std::memory_order_relaxed);
+    m_frames.publish();
+}
+
+} // namespace core
+} // namespace quiet
@@ -0,0 +1,56 @@
+#include "quiet/core/VisualizationTap.h"
+#include "quiet/core/AudioBuffer.h"
+
+namespace quiet {
+namespace core {
+
+VisualizationTap::VisualizationTap(size_t capacity)
+    : m_streams{Stream(capacity), Stream(capacity)} {
+}
+
+void VisualizationTap::write(Source source, const AudioBuffer& buffer) noexcept {
+    if (!isEnabled() || buffer.isEmpty()) {
+        return;
+    }
+
+    double sampleRate = buffer.getSampleRate();
+    if (m_sampleRate.load(std::memory_order_relaxed) != sampleRate) {
+        m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+    }
+    write(source, buffer.getReadPointer(0), static_cast<size_t>(buffer.getNumSamples()));
+}
+
+void VisualizationTap::write(Source source, const float* samples, size_t count) noexcept {
+    if (!isEnabled() || samples == nullptr || count == 0) {
+        return;
+    }
+
+    Stream& target = stream(source);
+    size_t pushed = target.samples.tryPushBulk(samples, count);
+
+    // Only this thread writes the counters; relaxed stores are enough
+    target.written.store(target.written.load(std::memory_order_relaxed) + pushed, std::memory_order_relaxed);
+    if (pushed < count) {
+        target.dropped.store(target.dropped.load(std::memory_order_relaxed) + (count - pushed),
+                             std::memory_order_relaxed);
+    }
+}
+
+size_t VisualizationTap::read(Source source, float* destination, size_t maxSamples) noexcept {
+    return stream(source).samples.tryPopBulk(destination, maxSamples);
+}
+
+size_t VisualizationTap::available(Source source) const noexcept {
+    return stream(source).samples.size();
+}
+
+uint64_t VisualizationTap::getWrittenSamples(Source source) const noexcept {
+    return stream(source).written.load(std::memory_order_relaxed);
+}
+
+uint64_t VisualizationTap::getDroppedSamples(Source source) const noexcept {
+    return stream(source).dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace core
+} // namespace quiet
@@ -0,0 +1,126 @@
+#include "quiet/core/WaveformPeakCache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace quiet {
+namespace core {
+
+namespace {
+
+inline void merge(WaveformPeakCache::Peak& into, const WaveformPeakCache::Peak& peak) {
+    into.min = std::min(into.min, peak.min);
+    into.max = std::max(into.max, peak.max);
+}
+
+} // namespace
+
+WaveformPeakCache::WaveformPeakCache(size_t historySamples)
+    : m_historySamples(std::max<size_t>(historySamples, 1)) {
+    // Levels up to the first whose pairs each cover the whole history
+    uint64_t samplesPerPeak = 1;
+    while (true) {
+        Level level;
+        level.samplesPerPeak = samplesPerPeak;
+        size_t needed = static_cast<size_t>((m_historySamples + samplesPerPeak - 1) / samplesPerPeak) + 1;
+        size_t capacity = 1;
+        while (capacity < std::min(needed, kMaxPeaksPerLevel)) {
+            capacity <<= 1;
+        }
+        level.peaks.resize(capacity);
+        level.mask = capacity - 1;
+        m_levels.push_back(std::move(level));
+
+        if (samplesPerPeak >= m_historySamples) {
+            break;
+        }
+        samplesPerPeak *= kFanOut;
+    }
+}
+
+void WaveformPeakCache::addSamples(const float* samples, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        pushPeak(0, Peak{samples[i], samples[i]});
+    }
+    m_totalSamples += count;
+}
+
+void WaveformPeakCache::pushPeak(size_t level, const Peak& peak) {
+    // Iterative carry up the levels
+    Peak carry = peak;
+    for (size_t l = level; l < m_levels.size(); ++l) {
+        Level& current = m_levels[l];
+        current.peaks[current.completed & current.mask] = carry;
+        ++current.completed;
+
+        if (l + 1 == m_levels.size()) {
+            return;
+        }
+
+        Level& next = m_levels[l + 1];
+        if (next.partialCount == 0) {
+            next.partial = carry;
+        } else {
+            merge(next.partial, carry);
+        }
+        if (++next.partialCount < kFanOut) {
+            return;
+        }
+        carry = next.partial;
+        next.partialCount = 0;
+    }
+}
+
+void WaveformPeakCache::getPeaks(size_t spanSamples, Peak* peaks, size_t columns) const {
+    if (columns == 0) {
+        return;
+    }
+
+    const double samplesPerColumn = std::max(1.0, static_cast<double>(spanSamples) / static_cast<double>(columns));
+
+    // Coarsest level still at least as fine as a column
+    size_t level = 0;
+    while (level + 1 < m_levels.size() && m_levels[level + 1].samplesPerPeak <= samplesPerColumn) {
+        ++level;
+    }
+    const Level& source = m_levels[level];
+    const auto samplesPerPeak = static_cast<int64_t>(source.samplesPerPeak);
+    const auto completed = static_cast<int64_t>(source.completed);
+    const int64_t oldest = std::max<int64_t>(0, completed - static_cast<int64_t>(source.peaks.size()));
+
+    // End on the last completed pair, so columns stay on the same pair
+    // boundaries from one call to the next instead of shimmering
+    const int64_t end = completed * samplesPerPeak;
+    const int64_t start = end - static_cast<int64_t>(std::llround(samplesPerColumn * static_cast<double>(columns)));
+
+    for (size_t c = 0; c < columns; ++c) {
+        const int64_t columnStart = start + static_cast<int64_t>(samplesPerColumn * static_cast<double>(c));
+        int64_t columnEnd = start + static_cast<int64_t>(samplesPerColumn * static_cast<double>(c + 1));
+        columnEnd = std::max(columnEnd, columnStart + 1);
+
+        // Pairs overlapping [columnStart, columnEnd) that are still held
+        const int64_t first = std::max(oldest, columnStart >= 0 ? columnStart / samplesPerPeak : 0);
+        const int64_t last = std::min(completed - 1, columnEnd > 0 ? (columnEnd - 1) / samplesPerPeak : -1);
+        if (first > last) {
+            peaks[c] = Peak{};
+            continue;
+        }
+
+        Peak result = source.peaks[static_cast<uint64_t>(first) & source.mask];
+        for (int64_t index = first + 1; index <= last; ++index) {
+            merge(result, source.peaks[static_cast<uint64_t>(index) & source.mask]);
+        }
+        peaks[c] = result;
+    }
+}
+
+void WaveformPeakCache::clear() {
+    for (auto& level : m_levels) {
+        level.completed = 0;
+        level.partialCount = 0;
+        std::fill(level.peaks.begin(), level.peaks.end(), Peak{});
+    }
+    m_totalSamples = 0;
+}
+
+} // namespace core
+} // namespace quiet
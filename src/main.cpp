@@ -1,4 +1,5 @@
 #include <JuceHeader.h>
+#include <chrono>
 #include <memory>
 #include <iostream>
 #include "quiet/core/EventDispatcher.h"
@@ -6,13 +7,19 @@
 #include "quiet/core/NoiseReductionProcessor.h"
 #include "quiet/core/ConfigurationManager.h"
 #include "quiet/core/VirtualDeviceRouter.h"
+#include "quiet/core/VisualizationTap.h"
 #include "quiet/ui/MainWindow.h"
 #include "quiet/utils/Logger.h"
+#include "quiet/utils/MetricsServer.h"
 
 /**
  * @brief Main QUIET application class
  * 
  * Coordinates all subsystems and manages the application lifecycle.
+ *
+ * With --headless only the audio pipeline runs: no window, no visualization
+ * tap, and no level events unless something subscribes to them. Either mode
+ * can serve metrics on a loopback port (--metrics-port).
  */
 class QuietApplication : public juce::JUCEApplication {
 public:
@@ -49,7 +56,13 @@ public:
         }
 
         // Create and show main window
-        createMainWindow();
+        if (m_headless) {
+            LOG_INFO("Running headless: no window or visualizations");
+        } else {
+            createMainWindow();
+        }
+        
+        startMetricsServer();
         
         quiet::utils::Logger::getInstance().log(quiet::utils::Logger::Level::INFO, "QUIET",
             "QUIET application initialized successfully");
@@ -58,6 +71,10 @@ public:
     void shutdown() override {
         quiet::utils::Logger::getInstance().log(quiet::utils::Logger::Level::INFO, "QUIET",
             "Shutting down QUIET application");
+        logProcessUsage();
+        
+        // The metrics thread reads the subsystems, so it goes first
+        m_metricsServer.reset();
         
         // Save configuration
         if (m_configManager) {
@@ -77,8 +94,12 @@ public:
         m_mainWindow.reset();
         m_virtualRouter.reset();
         m_noiseProcessor.reset();
+        m_visualizationTap.reset();
         m_audioManager.reset();
         m_configManager.reset();
+        if (m_eventDispatcher && m_eventDispatcher->isTracing()) {
+            m_eventDispatcher->dumpTrace(kEventTracePath);
+        }
         m_eventDispatcher.reset();
         
         quiet::utils::Logger::getInstance().log(quiet::utils::Logger::Level::INFO, "QUIET",
@@ -103,11 +124,18 @@ private:
         juce::StringArray args;
         args.addTokens(commandLine, true);
         
-        for (const auto& arg : args) {
+        for (int i = 0; i < args.size(); ++i) {
+            const juce::String& arg = args[i];
             if (arg == "--minimized" || arg == "-m") {
                 m_startMinimized = true;
             } else if (arg == "--debug" || arg == "-d") {
                 quiet::utils::Logger::getInstance().setLevel(quiet::utils::Logger::Level::DEBUG);
+            } else if (arg == "--trace-events" || arg == "-t") {
+                m_traceEvents = true;
+            } else if (arg == "--headless") {
+                m_headless = true;
+            } else if (arg == "--metrics-port" && i + 1 < args.size()) {
+                m_metricsPort = args[++i].getIntValue();
             } else if (arg == "--help" || arg == "-h") {
                 showUsage();
                 quit();
@@ -122,6 +150,10 @@ private:
                   << "\nOptions:\n"
                   << "  -m, --minimized    Start minimized to system tray\n"
                   << "  -d, --debug        Enable debug logging\n"
+                  << "  -t, --trace-events Record event traces (written to " << kEventTracePath
+                  << " on device errors and at exit)\n"
+                  << "  --headless         Run the audio pipeline only, without window or visualizations\n"
+                  << "  --metrics-port N   Serve Prometheus metrics on 127.0.0.1:N/metrics\n"
                   << "  -h, --help         Show this help message\n"
                   << std::endl;
     }
@@ -130,6 +162,13 @@ private:
         try {
             // Event dispatcher
             m_eventDispatcher = std::make_unique<quiet::core::EventDispatcher>();
+            m_eventDispatcher->setMessageThreadExecutor([](std::function<void()> task) {
+                juce::MessageManager::callAsync(std::move(task));
+            });
+            if (m_traceEvents) {
+                m_eventDispatcher->enableTracing();
+                m_eventDispatcher->setTraceDumpPath(kEventTracePath);
+            }
             m_eventDispatcher->start();
 
             // Configuration manager
@@ -159,6 +198,12 @@ private:
                     "Virtual device router initialization failed - routing disabled");
             }
             
+            // Audio-to-UI sample FIFOs for the visualizations; headless runs
+            // have no UI to feed, so the audio callback skips them entirely
+            if (!m_headless) {
+                m_visualizationTap = std::make_unique<quiet::core::VisualizationTap>();
+            }
+            
             // Check virtual device installation
             checkVirtualDeviceSetup();
 
@@ -190,7 +235,7 @@ private:
 
     void createMainWindow() {
         m_mainWindow = quiet::ui::MainWindow::create(
-            *m_audioManager, *m_configManager, *m_eventDispatcher);
+            *m_audioManager, *m_configManager, *m_eventDispatcher, *m_visualizationTap);
 
         if (!m_mainWindow) {
             quiet::utils::Logger::getInstance().log(quiet::utils::Logger::Level::ERROR, "QUIET",
@@ -229,21 +274,40 @@ private:
             // Passthrough if processing is disabled
             output.copyFrom(input);
         }
+        
+        // Wait-free: drops samples if the UI has fallen behind
+        if (m_visualizationTap) {
+            m_visualizationTap->write(quiet::core::VisualizationTap::Source::Input, input);
+            m_visualizationTap->write(quiet::core::VisualizationTap::Source::Output, output);
+        }
     }
     
     void publishAudioLevels(const quiet::core::AudioBuffer& input,
                            const quiet::core::AudioBuffer& output) {
+        // Nobody listening (e.g. headless): skip the RMS and the events
+        if (!m_eventDispatcher->hasSubscribers(quiet::core::EventType::AudioLevelChanged)) {
+            return;
+        }
+        
         float inputLevel = input.getRMSLevel(0, 0, input.getNumSamples());
         float outputLevel = output.getRMSLevel(0, 0, output.getNumSamples());
         
-        auto eventData = quiet::core::EventDataFactory::createAudioLevelData(inputLevel, true);
-        m_eventDispatcher->publish(quiet::core::EventType::AudioLevelChanged, eventData);
-        
-        eventData = quiet::core::EventDataFactory::createAudioLevelData(outputLevel, false);
-        m_eventDispatcher->publish(quiet::core::EventType::AudioLevelChanged, eventData);
+        // Called from the audio callback, so use the allocation-free path
+        m_eventDispatcher->publishRT(quiet::core::EventType::AudioLevelChanged,
+                                     quiet::core::EventDataFactory::createAudioLevelData(inputLevel, true));
+        m_eventDispatcher->publishRT(quiet::core::EventType::AudioLevelChanged,
+                                     quiet::core::EventDataFactory::createAudioLevelData(outputLevel, false));
     }
     
     void checkVirtualDeviceSetup() {
+        if (m_headless) {
+            // No one to ask; carry on without routing
+            if (!quiet::core::VirtualDeviceRouter::isVirtualDeviceInstalled()) {
+                LOG_WARNING("No virtual audio device installed - routing disabled");
+            }
+            return;
+        }
+        
         if (!quiet::core::VirtualDeviceRouter::isVirtualDeviceInstalled()) {
             auto result = juce::AlertWindow::showYesNoCancelBox(
                 juce::AlertWindow::InfoIcon,
@@ -269,17 +333,92 @@ private:
         }
     }
 
+    void startMetricsServer() {
+        if (m_metricsPort <= 0) {
+            return;
+        }
+        
+        m_metricsServer = std::make_unique<quiet::utils::MetricsServer>([this] { return formatMetrics(); });
+        if (m_metricsServer->start(m_metricsPort)) {
+            LOGF_INFO("Serving metrics on http://127.0.0.1:{}/metrics", m_metricsServer->getPort());
+        } else {
+            LOGF_WARNING("Could not listen on metrics port {}", m_metricsPort);
+            m_metricsServer.reset();
+        }
+    }
+    
+    // Runs on the metrics server thread
+    std::string formatMetrics() const {
+        using quiet::utils::MetricsServer;
+        
+        std::string out;
+        const auto usage = quiet::utils::readProcessUsage();
+        MetricsServer::appendMetric(out, "quiet_process_cpu_seconds_total", "counter",
+                                    "User and system CPU time", usage.cpuSeconds);
+        MetricsServer::appendMetric(out, "quiet_process_resident_memory_bytes", "gauge",
+                                    "Resident set size", static_cast<double>(usage.residentBytes));
+        MetricsServer::appendMetric(out, "quiet_uptime_seconds", "gauge", "Time since startup",
+                                    secondsSinceStart());
+        MetricsServer::appendMetric(out, "quiet_headless", "gauge", "1 when running without UI",
+                                    m_headless ? 1.0 : 0.0);
+        
+        if (m_noiseProcessor) {
+            const auto stats = m_noiseProcessor->getStats();
+            MetricsServer::appendMetric(out, "quiet_frames_processed_total", "counter",
+                                        "Noise reduction frames processed",
+                                        static_cast<double>(stats.framesProcessed));
+            MetricsServer::appendMetric(out, "quiet_reduction_db", "gauge", "Average noise reduction",
+                                        stats.averageReduction);
+            MetricsServer::appendMetric(out, "quiet_processing_cpu_ratio", "gauge",
+                                        "Audio processing CPU load", m_noiseProcessor->getCpuUsage());
+            MetricsServer::appendMetric(out, "quiet_processing_latency_ms", "gauge",
+                                        "Processing latency", m_noiseProcessor->getLatency());
+        }
+        
+        if (m_eventDispatcher) {
+            const auto stats = m_eventDispatcher->getStats();
+            MetricsServer::appendMetric(out, "quiet_events_published_total", "counter",
+                                        "Events published", static_cast<double>(stats.eventsPublished));
+            MetricsServer::appendMetric(out, "quiet_events_dropped_total", "counter",
+                                        "Events dropped", static_cast<double>(stats.eventsDropped));
+        }
+        return out;
+    }
+    
+    double secondsSinceStart() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    }
+    
+    // Average CPU and current RSS over the run, for comparing headless and
+    // windowed deployments on the same host
+    void logProcessUsage() const {
+        const auto usage = quiet::utils::readProcessUsage();
+        const double uptime = secondsSinceStart();
+        LOGF_INFO("{} run: {:.1f} s CPU over {:.1f} s ({:.2f}% of one core), RSS {:.1f} MB",
+                  m_headless ? "Headless" : "Windowed", usage.cpuSeconds, uptime,
+                  uptime > 0.0 ? 100.0 * usage.cpuSeconds / uptime : 0.0,
+                  static_cast<double>(usage.residentBytes) / (1024.0 * 1024.0));
+    }
+
     // Subsystem instances
     std::unique_ptr<quiet::core::EventDispatcher> m_eventDispatcher;
     std::unique_ptr<quiet::core::ConfigurationManager> m_configManager;
     std::unique_ptr<quiet::core::AudioDeviceManager> m_audioManager;
     std::unique_ptr<quiet::core::NoiseReductionProcessor> m_noiseProcessor;
     std::unique_ptr<quiet::core::VirtualDeviceRouter> m_virtualRouter;
+    std::unique_ptr<quiet::core::VisualizationTap> m_visualizationTap;
     
     std::unique_ptr<quiet::ui::MainWindow> m_mainWindow;
+    std::unique_ptr<quiet::utils::MetricsServer> m_metricsServer;
+    std::chrono::steady_clock::time_point m_startTime{std::chrono::steady_clock::now()};
 
     // Command line options
     bool m_startMinimized{false};
+    bool m_traceEvents{false};
+    bool m_headless{false};
+    int m_metricsPort{0};
+    
+    static constexpr const char* kEventTracePath = "quiet-events.qtrace";
 };
 
 // Application entry point
@@ -0,0 +1,113 @@
+#include "quiet/ui/FrameScheduler.h"
+#include <algorithm>
+
+namespace quiet {
+namespace ui {
+
+namespace {
+
+// A vblank this close to the due time takes the frame, so a 60 Hz display
+// serving 30 fps does not slip to every third vblank on timing jitter
+constexpr double kVBlankSlackMs = 2.0;
+
+// Longest step handed to animations, e.g. after the window was hidden
+constexpr double kMaxFrameSeconds = 0.25;
+
+} // namespace
+
+FrameScheduler::FrameScheduler() = default;
+
+FrameScheduler::~FrameScheduler()
+{
+    stop();
+}
+
+void FrameScheduler::addClient(Client& client, juce::Component* component)
+{
+    removeClient(client);
+    
+    Entry entry;
+    entry.client = &client;
+    entry.component = component;
+    m_clients.push_back(entry);
+}
+
+void FrameScheduler::removeClient(Client& client)
+{
+    m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+                                   [&client](const Entry& entry) { return entry.client == &client; }),
+                    m_clients.end());
+}
+
+void FrameScheduler::setFrameRate(int framesPerSecond)
+{
+    m_frameRate = juce::jlimit(1, 240, framesPerSecond);
+    m_nextFrameMs = 0.0;
+}
+
+void FrameScheduler::start(juce::Component& host)
+{
+    if (isRunning())
+        return;
+    
+    m_nextFrameMs = 0.0;
+    m_lastFrameMs = 0.0;
+    m_vblank = std::make_unique<juce::VBlankAttachment>(&host, [this]() { onVBlank(); });
+}
+
+void FrameScheduler::stop()
+{
+    m_vblank.reset();
+}
+
+void FrameScheduler::onVBlank()
+{
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+    if (nowMs + kVBlankSlackMs < m_nextFrameMs)
+        return;
+    
+    // Schedule from the due time, not from now, so the rate holds on
+    // average; after a stall, start again from now rather than catching up
+    const double intervalMs = 1000.0 / m_frameRate;
+    m_nextFrameMs = juce::jmax(m_nextFrameMs + intervalMs, nowMs + intervalMs - kVBlankSlackMs);
+    
+    const double frameSeconds = m_lastFrameMs > 0.0 ? (nowMs - m_lastFrameMs) / 1000.0 : intervalMs / 1000.0;
+    m_lastFrameMs = nowMs;
+    
+    tick(juce::jmin(frameSeconds, kMaxFrameSeconds));
+}
+
+void FrameScheduler::tick(double frameSeconds)
+{
+    ++m_frameCount;
+    
+    // All data first, so views fed by another client see this frame's samples
+    for (auto& entry : m_clients)
+        entry.client->prepareFrame(frameSeconds);
+    
+    for (auto& entry : m_clients)
+    {
+        juce::Component* component = entry.component.getComponent();
+        if (component == nullptr)
+            continue;
+        
+        const uint64_t generation = entry.client->getFrameGeneration();
+        if (entry.painted && generation == entry.paintedGeneration)
+        {
+            ++m_skippedRepaints;
+            continue;
+        }
+        
+        // Views on hidden tabs catch up when they are shown, as JUCE repaints
+        // them then anyway
+        if (!component->isShowing())
+            continue;
+        
+        entry.paintedGeneration = generation;
+        entry.painted = true;
+        component->repaint();
+    }
+}
+
+} // namespace ui
+} // namespace quiet
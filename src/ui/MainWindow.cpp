@@ -3,12 +3,17 @@
 #include "quiet/core/ConfigurationManager.h"
 #include "quiet/core/EventDispatcher.h"
 #include "quiet/core/NoiseReductionProcessor.h"
+#include "quiet/core/SpectrumAnalysisEngine.h"
 #include "quiet/core/VirtualDeviceRouter.h"
+#include "quiet/core/VisualizationTap.h"
 #include "quiet/ui/WaveformDisplay.h"
+#include "quiet/ui/SpectrogramDisplay.h"
 #include "quiet/ui/SpectrumAnalyzer.h"
+#include "quiet/ui/VisualizationRenderer.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_dsp/juce_dsp.h>
+#include <cmath>
 
 namespace quiet {
 namespace ui {
@@ -119,7 +124,7 @@ private:
 // Main Content Component Implementation
 //==============================================================================
 class MainWindow::MainContentComponent : public juce::Component,
-                                       public juce::Timer,
+                                       public FrameScheduler::Client,
                                        public juce::Button::Listener,
                                        public juce::ComboBox::Listener,
                                        public juce::Slider::Listener
@@ -130,6 +135,9 @@ public:
         , audioDeviceManager(window.getAudioDeviceManager())
         , configManager(window.getConfigurationManager())
         , eventDispatcher(window.getEventDispatcher())
+        , visualizationTap(window.getVisualizationTap())
+        , inputSpectrumEngine(spectrumSettings(configManager))
+        , outputSpectrumEngine(spectrumSettings(configManager))
     {
         // Device selection
         addAndMakeVisible(deviceLabel);
@@ -200,78 +208,88 @@ public:
         visualizationTabs.addTab("Waveform", ThemeColors::panel, waveformContainer, true);
         
         // Spectrum analyzer tab  
-        spectrumAnalyzer = std::make_unique<SpectrumAnalyzer>(ThemeColors::accent);
+        spectrumAnalyzer = std::make_unique<SpectrumAnalyzer>(inputSpectrumEngine, ThemeColors::accent);
         visualizationTabs.addTab("Spectrum", ThemeColors::panel, spectrumAnalyzer.get(), false);
         
+        // Spectrogram tab: input against output, from the same analysis frames
+        spectrogramDisplay = std::make_unique<SpectrogramDisplay>(inputSpectrumEngine, outputSpectrumEngine);
+        visualizationTabs.addTab("Spectrogram", ThemeColors::panel, spectrogramDisplay.get(), false);
+        inputSpectrumEngine.start();
+        outputSpectrumEngine.start();
+        
         // Settings tab (created dynamically)
         settingsPanel = std::make_unique<SettingsPanel>(configManager);
         visualizationTabs.addTab("Settings", ThemeColors::panel, settingsPanel.get(), false);
         
-        // Subscribe to events
-        eventDispatcher.subscribe(EventType::AudioLevelChanged,
+        // The meters and visualizations draw through OpenGL when the machine
+        // has a GPU, otherwise through the software renderer. The context
+        // covers this whole component, as the meters sit outside the tabs.
+        renderer.attachTo(*this, core::parseRenderMode(
+            configManager.getValue<std::string>("ui.render_mode", "auto")));
+        
+        // Subscribe to events. MessageThread listeners already run on the
+        // message thread, batched once per frame by the dispatcher.
+        subscriptions.push_back(eventDispatcher.subscribe(EventType::AudioLevelChanged,
             [this](const Event& e) {
-                if (e.data) {
-                    float level = e.data->getValue<float>("level", 0.0f);
-                    bool isInput = e.data->getValue<bool>("isInput", true);
-                    
-                    juce::MessageManager::callAsync([this, level, isInput]() {
-                        if (isInput)
-                            inputLevelMeter.updateLevel(level);
-                        else
-                            outputLevelMeter.updateLevel(level);
-                    });
+                if (auto* payload = e.get<AudioLevelPayload>()) {
+                    if (payload->isInput)
+                        inputLevelMeter.updateLevel(payload->level);
+                    else
+                        outputLevelMeter.updateLevel(payload->level);
                 }
-            });
+            }, DeliveryMode::MessageThread));
             
-        eventDispatcher.subscribe(EventType::AudioDeviceChanged,
+        subscriptions.push_back(eventDispatcher.subscribe(EventType::AudioDeviceChanged,
             [this](const Event&) {
-                juce::MessageManager::callAsync([this]() {
-                    updateDeviceList();
-                });
-            });
+                updateDeviceList();
+            }, DeliveryMode::MessageThread));
             
-        eventDispatcher.subscribe(EventType::ProcessingStatsUpdated,
+        subscriptions.push_back(eventDispatcher.subscribe(EventType::ProcessingStatsUpdated,
             [this](const Event& e) {
-                if (e.data) {
-                    float cpuUsage = e.data->getValue<float>("cpu_usage", 0.0f);
-                    float latency = e.data->getValue<float>("latency", 0.0f);
-                    float reduction = e.data->getValue<float>("reduction_level", 0.0f);
-                    
-                    juce::MessageManager::callAsync([this, cpuUsage, latency, reduction]() {
-                        updateStats(cpuUsage, latency, reduction);
-                    });
+                if (auto* payload = e.get<ProcessingStatsPayload>()) {
+                    updateStats(payload->cpuUsage, payload->latency, payload->reductionLevel);
                 }
-            });
+            }, DeliveryMode::MessageThread));
+        
+        // One clock for every view. This component drains the tap into the
+        // views, so it goes first; the views repaint only when their data moved.
+        frameScheduler.setFrameRate(configManager.getValue<int>("ui.visualization_fps",
+                                                                FrameScheduler::kDefaultFrameRate));
+        frameScheduler.addClient(*this, nullptr);
+        frameScheduler.addClient(inputLevelMeter, &inputLevelMeter);
+        frameScheduler.addClient(outputLevelMeter, &outputLevelMeter);
+        frameScheduler.addClient(*inputWaveform, inputWaveform.get());
+        frameScheduler.addClient(*outputWaveform, outputWaveform.get());
+        frameScheduler.addClient(*spectrumAnalyzer, spectrumAnalyzer.get());
+        frameScheduler.addClient(*spectrogramDisplay, spectrogramDisplay.get());
+        frameScheduler.start(*this);
+        
+        // Nothing ticks while the window is hidden or minimised, and the audio
+        // thread stops copying into the tap. What it wrote before is stale by
+        // the time the window is back, so it is thrown away, not drawn.
+        subscriptions.push_back(eventDispatcher.subscribe(EventType::WindowHidden,
+            [this](const Event&) {
+                frameScheduler.stop();
+                visualizationTap.setEnabled(false);
+            }, DeliveryMode::MessageThread));
             
-        eventDispatcher.subscribe(EventType::AudioBufferProcessed,
-            [this](const Event& e) {
-                if (e.data) {
-                    bool isInput = e.data->getValue<bool>("isInput", true);
-                    
-                    // Get audio buffer data
-                    if (e.data->hasValue("audioData")) {
-                        auto audioData = e.data->getValue<std::shared_ptr<AudioBuffer>>("audioData");
-                        if (audioData) {
-                            juce::MessageManager::callAsync([this, audioData, isInput]() {
-                                if (isInput) {
-                                    inputWaveform->updateBuffer(*audioData);
-                                    spectrumAnalyzer->updateSpectrum(*audioData);
-                                } else {
-                                    outputWaveform->updateBuffer(*audioData);
-                                }
-                            });
-                        }
-                    }
-                }
-            });
-        
-        // Start update timer
-        startTimerHz(10);
+        subscriptions.push_back(eventDispatcher.subscribe(EventType::WindowShown,
+            [this](const Event&) {
+                visualizationTap.setEnabled(true);
+                discardVisualizationTap();
+                frameScheduler.start(*this);
+            }, DeliveryMode::MessageThread));
     }
     
     ~MainContentComponent()
     {
-        stopTimer();
+        // Batched deliveries for removed listeners are discarded, so none can
+        // reach this component after it is gone
+        for (auto handle : subscriptions)
+            eventDispatcher.unsubscribe(handle);
+        
+        frameScheduler.stop();
+        renderer.detach();
         visualizationTabs.clearTabs();
     }
     
@@ -370,14 +388,15 @@ public:
                                 enabled ? ThemeColors::accent : ThemeColors::panel);
             
             // Notify processor
-            eventDispatcher.publish(EventType::NoiseReductionToggled,
-                EventDataFactory::createProcessingStatsData(0, 0, enabled ? 1.0f : 0.0f));
+            NoiseReductionPayload toggle;
+            toggle.enabled = enabled;
+            eventDispatcher.publish(EventType::NoiseReductionToggled, toggle);
             
             updateStatus(enabled ? "Processing..." : "Ready");
         }
         else if (button == &settingsButton)
         {
-            visualizationTabs.setCurrentTabIndex(2); // Switch to settings tab
+            visualizationTabs.setCurrentTabIndex(3); // Switch to settings tab
         }
     }
     
@@ -420,10 +439,10 @@ public:
         }
     }
     
-    void timerCallback() override
+    void prepareFrame(double) override
     {
-        // Update any real-time displays if needed
-        repaint();
+        drainVisualizationTap();
+        renderer.reportCpuUsage(frameScheduler.getFrameCount());
     }
     
     void toggleNoiseReduction()
@@ -433,7 +452,7 @@ public:
     
     void showSettings()
     {
-        visualizationTabs.setCurrentTabIndex(2); // Switch to settings tab
+        visualizationTabs.setCurrentTabIndex(3); // Switch to settings tab
     }
     
 private:
@@ -441,6 +460,14 @@ private:
     core::AudioDeviceManager& audioDeviceManager;
     core::ConfigurationManager& configManager;
     core::EventDispatcher& eventDispatcher;
+    core::VisualizationTap& visualizationTap;
+    std::vector<core::EventDispatcher::ListenerHandle> subscriptions;
+    std::array<float, 2048> tapScratch{};
+    FrameScheduler frameScheduler;
+    
+    // Declared before the views that read their frames, so they outlive them
+    core::SpectrumAnalysisEngine inputSpectrumEngine;
+    core::SpectrumAnalysisEngine outputSpectrumEngine;
     
     // UI Components
     juce::Label deviceLabel;
@@ -458,8 +485,13 @@ private:
     juce::Component* waveformContainer = nullptr;
     std::unique_ptr<WaveformDisplay> inputWaveform, outputWaveform;
     std::unique_ptr<SpectrumAnalyzer> spectrumAnalyzer;
+    std::unique_ptr<SpectrogramDisplay> spectrogramDisplay;
     std::unique_ptr<SettingsPanel> settingsPanel;
     
+    // Attached to this component; declared after the meters and tabs so the
+    // GL context detaches before they go
+    VisualizationRenderer renderer;
+    
     // Stats display
     float currentCpuUsage = 0.0f;
     float currentLatency = 0.0f;
@@ -484,6 +516,47 @@ private:
             deviceCombo.setSelectedId(selectedId);
     }
     
+    void drainVisualizationTap()
+    {
+        using Source = core::VisualizationTap::Source;
+        
+        // Everything that arrived since the last frame. The tap is bounded, so
+        // after a stall this is at most one ring's worth; whatever the audio
+        // thread could not fit in the meantime was dropped there.
+        size_t count;
+        while ((count = visualizationTap.read(Source::Input, tapScratch.data(), tapScratch.size())) > 0)
+        {
+            inputWaveform->pushSamples(tapScratch.data(), static_cast<int>(count));
+            inputSpectrumEngine.pushSamples(tapScratch.data(), count, visualizationTap.getSampleRate());
+        }
+        
+        while ((count = visualizationTap.read(Source::Output, tapScratch.data(), tapScratch.size())) > 0)
+        {
+            outputWaveform->pushSamples(tapScratch.data(), static_cast<int>(count));
+            outputSpectrumEngine.pushSamples(tapScratch.data(), count, visualizationTap.getSampleRate());
+        }
+    }
+    
+    void discardVisualizationTap()
+    {
+        using Source = core::VisualizationTap::Source;
+        
+        while (visualizationTap.read(Source::Input, tapScratch.data(), tapScratch.size()) > 0) {}
+        while (visualizationTap.read(Source::Output, tapScratch.data(), tapScratch.size()) > 0) {}
+    }
+    
+    static core::SpectrumAnalysisEngine::Settings spectrumSettings(const core::ConfigurationManager& config)
+    {
+        core::SpectrumAnalysisEngine::Settings settings;
+        settings.fftSize = config.getValue<int>("ui.spectrum_fft_size", 2048);
+        settings.hopSize = config.getValue<int>("ui.spectrum_hop_size", 512);
+        
+        // Every frame is queued for the spectrogram; 64 frames ride out about
+        // two thirds of a second of UI stall at 48 kHz and the default hop
+        settings.queuedFrames = 64;
+        return settings;
+    }
+    
     void updateStatus(const juce::String& message)
     {
         statusPanel.setText(message, juce::dontSendNotification);
@@ -510,12 +583,10 @@ private:
 //==============================================================================
 AnimatedLevelMeter::AnimatedLevelMeter()
 {
-    startTimerHz(30);
 }
 
 AnimatedLevelMeter::~AnimatedLevelMeter()
 {
-    stopTimer();
 }
 
 void AnimatedLevelMeter::paint(juce::Graphics& g)
@@ -570,22 +641,30 @@ void AnimatedLevelMeter::paint(juce::Graphics& g)
     g.drawRoundedRectangle(bounds, 4.0f, 1.0f);
 }
 
-void AnimatedLevelMeter::timerCallback()
+void AnimatedLevelMeter::prepareFrame(double frameSeconds)
 {
+    // The smoothing constants were tuned per 30 Hz step; scale them so the
+    // motion looks the same at any frame rate
+    const float steps = static_cast<float>(frameSeconds * 30.0);
+    const float previousLevel = currentLevel;
+    const float previousPeak = peakLevel;
+    
     // Smooth animation
-    currentLevel = currentLevel * 0.8f + targetLevel * 0.2f;
+    currentLevel = targetLevel + (currentLevel - targetLevel) * std::pow(0.8f, steps);
     
     // Peak hold and decay
     if (peakHoldTime > 0)
     {
-        peakHoldTime -= 1.0f / 30.0f; // Decay based on timer frequency
+        peakHoldTime -= static_cast<float>(frameSeconds);
     }
     else
     {
-        peakLevel *= 0.95f; // Slow decay
+        peakLevel *= std::pow(0.95f, steps); // Slow decay
     }
     
-    repaint();
+    // Settled meters are not repainted
+    if (std::abs(currentLevel - previousLevel) > 1.0e-4f || std::abs(peakLevel - previousPeak) > 1.0e-4f)
+        ++generation;
 }
 
 void AnimatedLevelMeter::setLevel(float newLevel)
@@ -596,6 +675,7 @@ void AnimatedLevelMeter::setLevel(float newLevel)
     {
         peakLevel = newLevel;
         peakHoldTime = 2.0f; // Hold for 2 seconds
+        ++generation;
     }
 }
 
@@ -603,6 +683,7 @@ void AnimatedLevelMeter::setPeakLevel(float peak)
 {
     peakLevel = juce::jlimit(0.0f, 1.0f, peak);
     peakHoldTime = 2.0f;
+    ++generation;
 }
 
 //==============================================================================
@@ -611,12 +692,14 @@ void AnimatedLevelMeter::setPeakLevel(float peak)
 MainWindow::MainWindow(const juce::String& name,
                       core::AudioDeviceManager& audioManager,
                       core::ConfigurationManager& configManager,
-                      core::EventDispatcher& eventDispatcher)
+                      core::EventDispatcher& eventDispatcher,
+                      core::VisualizationTap& visualizationTap)
     : juce::DocumentWindow(name, ThemeColors::background, 
                           juce::DocumentWindow::allButtons)
     , audioDeviceManager(audioManager)
     , configManager(configManager)
     , eventDispatcher(eventDispatcher)
+    , visualizationTap(visualizationTap)
 {
     // Set custom look and feel
     lookAndFeel = std::make_unique<juce::LookAndFeel_V4>();
@@ -658,6 +741,28 @@ void MainWindow::closeButtonPressed()
     }
 }
 
+void MainWindow::visibilityChanged()
+{
+    DocumentWindow::visibilityChanged();
+    publishWindowVisibility();
+}
+
+void MainWindow::minimisationStateChanged(bool isNowMinimised)
+{
+    DocumentWindow::minimisationStateChanged(isNowMinimised);
+    publishWindowVisibility();
+}
+
+void MainWindow::publishWindowVisibility()
+{
+    const bool shown = isVisible() && !isMinimised();
+    if (shown == windowShown)
+        return;
+    
+    windowShown = shown;
+    eventDispatcher.publish(shown ? core::EventType::WindowShown : core::EventType::WindowHidden);
+}
+
 void MainWindow::initializeSystemTray()
 {
 #if JUCE_MAC || JUCE_WINDOWS
@@ -685,10 +790,11 @@ void MainWindow::initializeSystemTray()
 std::unique_ptr<MainWindow> MainWindow::create(
     core::AudioDeviceManager& audioManager,
     core::ConfigurationManager& configManager,
-    core::EventDispatcher& eventDispatcher)
+    core::EventDispatcher& eventDispatcher,
+    core::VisualizationTap& visualizationTap)
 {
     return std::make_unique<MainWindow>("QUIET", audioManager, 
-                                       configManager, eventDispatcher);
+                                       configManager, eventDispatcher, visualizationTap);
 }
 
 } // namespace ui
@@ -0,0 +1,173 @@
+#include "quiet/ui/SpectrogramDisplay.h"
+#include <algorithm>
+
+namespace quiet {
+namespace ui {
+
+SpectrogramDisplay::SpectrogramDisplay(core::SpectrumAnalysisEngine& inputEngine,
+                                       core::SpectrumAnalysisEngine& outputEngine)
+    : m_lanes{{ Lane{inputEngine, "Input"}, Lane{outputEngine, "Output"} }}
+{
+    // Black through blue, magenta and orange to pale yellow: brightness
+    // rises steadily with level
+    juce::ColourGradient gradient(juce::Colour(0xff000004), 0.0f, 0.0f,
+                                  juce::Colour(0xfffcffa4), 1.0f, 0.0f, false);
+    gradient.addColour(0.25, juce::Colour(0xff3b0f70));
+    gradient.addColour(0.5, juce::Colour(0xff8c2981));
+    gradient.addColour(0.75, juce::Colour(0xfff1605d));
+    
+    for (int i = 0; i < m_lutSize; ++i)
+        m_lut[static_cast<size_t>(i)] = gradient.getColourAtPosition(i / static_cast<double>(m_lutSize - 1));
+}
+
+SpectrogramDisplay::~SpectrogramDisplay()
+{
+}
+
+void SpectrogramDisplay::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colour(0xff1a1a1a));
+    
+    for (const auto& lane : m_lanes)
+        paintLane(g, lane);
+}
+
+void SpectrogramDisplay::paintLane(juce::Graphics& g, const Lane& lane) const
+{
+    if (!lane.image.isValid())
+        return;
+    
+    // Oldest columns, from the write position to the end, go on the left;
+    // the newest, from the start up to it, on the right
+    const int width = lane.image.getWidth();
+    const int height = lane.image.getHeight();
+    const int olderWidth = width - lane.writeColumn;
+    const int x = lane.area.getX();
+    const int y = lane.area.getY();
+    
+    g.drawImage(lane.image, x, y, olderWidth, height, lane.writeColumn, 0, olderWidth, height);
+    if (lane.writeColumn > 0)
+        g.drawImage(lane.image, x + olderWidth, y, lane.writeColumn, height, 0, 0, lane.writeColumn, height);
+    
+    g.setColour(juce::Colour(0xff3d3d3d));
+    g.drawRect(lane.area.expanded(1), 1);
+    
+    g.setColour(juce::Colour(0xffc0c0c0));
+    g.setFont(12.0f);
+    g.drawText(lane.title, lane.area.reduced(6, 4), juce::Justification::topLeft);
+}
+
+void SpectrogramDisplay::resized()
+{
+    auto bounds = getLocalBounds().reduced(5);
+    const int halfHeight = bounds.getHeight() / 2;
+    
+    m_lanes[0].area = bounds.removeFromTop(halfHeight).reduced(1, 3);
+    m_lanes[1].area = bounds.reduced(1, 3);
+    
+    for (auto& lane : m_lanes)
+        resetLane(lane);
+}
+
+void SpectrogramDisplay::resetLane(Lane& lane)
+{
+    const int width = lane.area.getWidth();
+    const int height = lane.area.getHeight();
+    lane.writeColumn = 0;
+    
+    if (width <= 0 || height <= 0)
+    {
+        lane.image = {};
+        return;
+    }
+    
+    lane.image = juce::Image(juce::Image::RGB, width, height, false);
+    lane.image.clear(lane.image.getBounds(), m_lut[0]);
+    
+    // One band per pixel row; rebuilt when a frame arrives at another rate
+    lane.rows.configure(height, lane.engine.getSettings().fftSize, 48000.0);
+    lane.rowDb.assign(lane.rows.size(), m_minDb);
+}
+
+void SpectrogramDisplay::clear()
+{
+    for (auto& lane : m_lanes)
+    {
+        lane.frameDb.resize(static_cast<size_t>(lane.engine.getSettings().fftSize / 2));
+        while (lane.engine.popQueuedFrame(lane.frameDb.data()))
+        {
+        }
+        resetLane(lane);
+    }
+    repaint();
+}
+
+bool SpectrogramDisplay::drainFrames(Lane& lane)
+{
+    const int fftSize = lane.engine.getSettings().fftSize;
+    lane.frameDb.resize(static_cast<size_t>(fftSize / 2));
+    
+    if (!lane.image.isValid())
+    {
+        // Nothing to draw into; keep the queue from filling up
+        while (lane.engine.popQueuedFrame(lane.frameDb.data()))
+        {
+        }
+        return false;
+    }
+    
+    // Only touch the image when there is a frame, so an idle lane is not
+    // marked as changed
+    if (!lane.engine.popQueuedFrame(lane.frameDb.data()))
+        return false;
+    
+    const int width = lane.image.getWidth();
+    const int height = lane.image.getHeight();
+    juce::Image::BitmapData pixels(lane.image, juce::Image::BitmapData::writeOnly);
+    
+    do
+    {
+        double sampleRate = lane.engine.getSampleRate();
+        if (sampleRate <= 0.0)
+            sampleRate = 48000.0;
+        
+        if (lane.rows.fftSize() != fftSize || lane.rows.sampleRate() != sampleRate)
+        {
+            lane.rows.configure(height, fftSize, sampleRate);
+            lane.rowDb.assign(lane.rows.size(), m_minDb);
+        }
+        
+        lane.rows.aggregate(lane.frameDb.data(), lane.frameDb.size(), lane.rowDb.data());
+        
+        // Row 0 of the bands is the lowest frequency, drawn at the bottom
+        const int rows = juce::jmin(height, static_cast<int>(lane.rowDb.size()));
+        for (int row = 0; row < rows; ++row)
+        {
+            // Clamped before scaling: empty bands read as the lowest float
+            const float normalized = juce::jlimit(0.0f, 1.0f,
+                (lane.rowDb[static_cast<size_t>(row)] - m_minDb) / (m_maxDb - m_minDb));
+            const int index = static_cast<int>(normalized * (m_lutSize - 1));
+            pixels.setPixelColour(lane.writeColumn, height - 1 - row, m_lut[static_cast<size_t>(index)]);
+        }
+        
+        lane.writeColumn = (lane.writeColumn + 1) % width;
+    }
+    while (lane.engine.popQueuedFrame(lane.frameDb.data()));
+    
+    return true;
+}
+
+void SpectrogramDisplay::prepareFrame(double frameSeconds)
+{
+    juce::ignoreUnused(frameSeconds);
+    
+    bool changed = false;
+    for (auto& lane : m_lanes)
+        changed = drainFrames(lane) || changed;
+    
+    if (changed)
+        ++m_generation;
+}
+
+} // namespace ui
+} // namespace quiet
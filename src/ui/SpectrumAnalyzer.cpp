@@ -5,118 +5,156 @@
 namespace quiet {
 namespace ui {
 
-SpectrumAnalyzer::SpectrumAnalyzer(const juce::Colour& barColor)
-    : m_barColor(barColor), m_forwardFFT(m_fftOrder)
+SpectrumAnalyzer::SpectrumAnalyzer(core::SpectrumAnalysisEngine& engine, const juce::Colour& barColor)
+    : m_engine(engine), m_barColor(barColor)
 {
-    std::fill(m_fftData.begin(), m_fftData.end(), 0.0f);
-    std::fill(m_smoothedMagnitudes.begin(), m_smoothedMagnitudes.end(), 0.0f);
-    
-    // Create Hann window
-    createWindow();
-    
-    startTimerHz(30); // 30 FPS update rate
 }
 
 SpectrumAnalyzer::~SpectrumAnalyzer()
 {
-    stopTimer();
 }
 
 void SpectrumAnalyzer::paint(juce::Graphics& g)
 {
-    auto bounds = getLocalBounds();
+    if (m_background.isValid())
+        g.drawImageAt(m_background, 0, 0);
+    else
+        g.fillAll(juce::Colour(0xff1a1a1a));
+    
+    // Draw spectrum bars
+    const float height = static_cast<float>(getHeight() - 1);
+    const float barWidth = static_cast<float>(m_barPitch - 1);
+    
+    for (size_t i = 0; i < m_smoothedDb.size(); ++i)
+    {
+        const float normalizedDb = juce::jlimit(0.0f, 1.0f, juce::jmap(m_smoothedDb[i], m_minDb, m_maxDb, 0.0f, 1.0f));
+        const float barHeight = normalizedDb * (height - 1.0f);
+        if (barHeight < 0.5f)
+            continue;
+        
+        g.setColour(m_barColours[i]);
+        g.fillRect(1.0f + static_cast<float>(i * m_barPitch), height - barHeight, barWidth, barHeight);
+    }
+}
+
+void SpectrumAnalyzer::resized()
+{
+    rebuildLayout();
+}
+
+void SpectrumAnalyzer::rebuildLayout()
+{
+    // Until the first frame arrives, lay out for the engine's settings at 48 kHz
+    const int fftSize = m_fftSize > 0 ? m_fftSize : m_engine.getSettings().fftSize;
+    const double sampleRate = m_sampleRate > 0.0 ? m_sampleRate : 48000.0;
+    const int numBars = juce::jmax(1, (getWidth() - 2) / m_barPitch);
+    
+    m_bands.configure(numBars, fftSize, sampleRate);
+    m_frameBandDb.assign(m_bands.size(), core::SpectrumAnalysisEngine::kFloorDb);
+    m_smoothedDb.assign(m_bands.size(), core::SpectrumAnalysisEngine::kFloorDb);
+    
+    // Color gradient based on frequency, green to yellow
+    m_barColours.resize(m_bands.size());
+    for (size_t i = 0; i < m_barColours.size(); ++i)
+    {
+        const float hue = static_cast<float>(i) / static_cast<float>(m_barColours.size()) * 0.3f;
+        m_barColours[i] = juce::Colour::fromHSV(hue, 0.8f, 0.9f, 0.8f);
+    }
+    
+    renderBackground();
+    repaint();
+}
+
+void SpectrumAnalyzer::renderBackground()
+{
+    const int width = getWidth();
+    const int height = getHeight();
+    if (width <= 0 || height <= 0)
+    {
+        m_background = juce::Image();
+        return;
+    }
+    
+    m_background = juce::Image(juce::Image::RGB, width, height, false);
+    juce::Graphics g(m_background);
     
     // Background
     g.fillAll(juce::Colour(0xff1a1a1a));
     
     // Border
     g.setColour(juce::Colour(0xff3d3d3d));
-    g.drawRect(bounds, 1);
-    
-    const float width = static_cast<float>(bounds.getWidth());
-    const float height = static_cast<float>(bounds.getHeight());
+    g.drawRect(getLocalBounds(), 1);
     
-    // Draw spectrum bars
-    const int numBins = m_fftSize / 2;
-    const float binWidth = width / numBins;
-    
-    for (int i = 1; i < numBins; ++i)
+    // Frequency grid: 1-2-5 steps up to Nyquist, labelled at each decade
+    const float axisWidth = static_cast<float>(m_bands.size() * m_barPitch);
+    static constexpr float gridFrequencies[] = {50.0f, 100.0f, 200.0f, 500.0f, 1000.0f, 2000.0f,
+                                                5000.0f, 10000.0f, 20000.0f};
+    g.setFont(10.0f);
+    for (float freq : gridFrequencies)
     {
-        const float magnitude = m_smoothedMagnitudes[i];
-        const float db = 20.0f * std::log10(magnitude + 1e-6f);
-        const float normalizedDb = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
-        const float barHeight = normalizedDb * height;
+        if (freq < m_bands.minHz() || freq > m_bands.maxHz())
+            continue;
         
-        // Color gradient based on frequency
-        const float hue = i / static_cast<float>(numBins) * 0.3f; // Green to yellow
-        g.setColour(juce::Colour::fromHSV(hue, 0.8f, 0.9f, 0.8f));
+        const float x = 1.0f + m_bands.proportionOfFrequency(freq) * axisWidth;
+        g.setColour(juce::Colour(0xff3d3d3d).withAlpha(0.5f));
+        g.drawVerticalLine(static_cast<int>(x), 0.0f, static_cast<float>(height));
         
-        const float x = i * binWidth;
-        g.fillRect(x, height - barHeight, binWidth - 1.0f, barHeight);
+        if (freq == 100.0f || freq == 1000.0f || freq == 10000.0f)
+        {
+            g.setColour(juce::Colour(0xff808080));
+            g.drawText(freq >= 1000.0f ? juce::String(static_cast<int>(freq / 1000.0f)) + "k"
+                                       : juce::String(static_cast<int>(freq)),
+                       static_cast<int>(x - 15), height - 20, 30, 20,
+                       juce::Justification::centred);
+        }
     }
     
-    // Draw frequency grid
+    // Level grid every 20 dB
     g.setColour(juce::Colour(0xff3d3d3d).withAlpha(0.5f));
-    for (int freq = 1000; freq < 20000; freq += 1000)
+    for (float db = m_maxDb - 20.0f; db > m_minDb; db -= 20.0f)
     {
-        const float x = (freq / 24000.0f) * width;
-        g.drawVerticalLine(static_cast<int>(x), 0, height);
-        
-        if (freq % 5000 == 0)
-        {
-            g.setColour(juce::Colour(0xff808080));
-            g.setFont(10.0f);
-            g.drawText(juce::String(freq / 1000) + "k", 
-                      static_cast<int>(x - 15), height - 20, 30, 20,
-                      juce::Justification::centred);
-            g.setColour(juce::Colour(0xff3d3d3d).withAlpha(0.5f));
-        }
+        const float y = juce::jmap(db, m_minDb, m_maxDb, static_cast<float>(height - 1), 1.0f);
+        g.drawHorizontalLine(static_cast<int>(y), 1.0f, static_cast<float>(width - 1));
     }
 }
 
-void SpectrumAnalyzer::resized()
+void SpectrumAnalyzer::updateSpectrum(const AudioBuffer& buffer)
 {
-    // Nothing special needed
+    if (buffer.isEmpty())
+        return;
+    
+    m_engine.pushSamples(buffer.getReadPointer(0), static_cast<size_t>(buffer.getNumSamples()),
+                         buffer.getSampleRate());
 }
 
-void SpectrumAnalyzer::updateSpectrum(const AudioBuffer& buffer)
+void SpectrumAnalyzer::prepareFrame(double frameSeconds)
 {
-    if (buffer.getNumSamples() < m_fftSize)
-        return;
+    juce::ignoreUnused(frameSeconds);
     
-    const juce::ScopedLock sl(m_fftLock);
+    // Nothing to redraw until the engine has finished another frame
+    if (!m_engine.updateFrame())
+        return;
     
-    // Copy and window the audio data
-    const float* samples = buffer.getReadPointer(0);
-    for (int i = 0; i < m_fftSize; ++i)
+    const auto& frame = m_engine.getFrame();
+    if (frame.fftSize != m_fftSize || (frame.sampleRate > 0.0 && frame.sampleRate != m_sampleRate))
     {
-        m_fftData[i] = samples[i] * m_window[i];
+        m_fftSize = frame.fftSize;
+        m_sampleRate = frame.sampleRate > 0.0 ? frame.sampleRate : m_sampleRate;
+        rebuildLayout();
     }
     
-    // Perform FFT
-    m_forwardFFT.performRealOnlyForwardTransform(m_fftData.data());
+    m_bands.aggregate(frame.magnitudesDb.data(), frame.magnitudesDb.size(), m_frameBandDb.data());
     
-    // Calculate magnitudes with smoothing
-    for (int i = 0; i < m_fftSize / 2; ++i)
-    {
-        const float real = m_fftData[i * 2];
-        const float imag = m_fftData[i * 2 + 1];
-        const float magnitude = std::sqrt(real * real + imag * imag);
-        
-        // Smooth the spectrum
-        m_smoothedMagnitudes[i] = m_smoothedMagnitudes[i] * 0.8f + magnitude * 0.2f;
-    }
-}
-
-void SpectrumAnalyzer::timerCallback()
-{
-    repaint();
+    // Smooth the spectrum
+    for (size_t i = 0; i < m_smoothedDb.size(); ++i)
+        m_smoothedDb[i] = m_smoothedDb[i] * 0.8f + m_frameBandDb[i] * 0.2f;
+    
+    ++m_generation;
 }
 
 void SpectrumAnalyzer::clear()
 {
-    const juce::ScopedLock sl(m_fftLock);
-    std::fill(m_smoothedMagnitudes.begin(), m_smoothedMagnitudes.end(), 0.0f);
+    std::fill(m_smoothedDb.begin(), m_smoothedDb.end(), core::SpectrumAnalysisEngine::kFloorDb);
     repaint();
 }
 
@@ -126,14 +164,5 @@ void SpectrumAnalyzer::setBarColor(const juce::Colour& color)
     repaint();
 }
 
-void SpectrumAnalyzer::createWindow()
-{
-    // Hann window
-    for (int i = 0; i < m_fftSize; ++i)
-    {
-        m_window[i] = 0.5f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * i / (m_fftSize - 1));
-    }
-}
-
 } // namespace ui
 } // namespace quiet
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "quiet/ui/VisualizationRenderer.h"
+#include "quiet/utils/Logger.h"
+#include "quiet/utils/MetricsServer.h"
+
+namespace quiet {
+namespace ui {
+
+VisualizationRenderer::VisualizationRenderer()
+{
+    m_context.setRenderer(this);
+    m_context.setComponentPaintingEnabled(true);
+    
+    // Redraw only when a component asks to, not every vblank
+    m_context.setContinuousRepainting(false);
+}
+
+VisualizationRenderer::~VisualizationRenderer()
+{
+    detach();
+}
+
+void VisualizationRenderer::attachTo(juce::Component& target, Mode mode)
+{
+    detach();
+    m_mode = mode;
+    
+    if (mode == Mode::Software)
+    {
+        LOG_INFO("Visualizations: software rendering");
+        return;
+    }
+    
+    m_contextCreated.store(false);
+    m_context.attachTo(target);
+    m_usingOpenGL = true;
+    
+    if (mode == Mode::Auto)
+    {
+        juce::WeakReference<VisualizationRenderer> self(this);
+        juce::Timer::callAfterDelay(m_contextTimeoutMs, [self]() {
+            if (self != nullptr && self->m_usingOpenGL && !self->m_contextCreated.load())
+                self->fallBackToSoftware("no OpenGL context was created");
+        });
+    }
+}
+
+void VisualizationRenderer::detach()
+{
+    if (m_context.isAttached())
+        m_context.detach();
+    m_usingOpenGL = false;
+}
+
+juce::String VisualizationRenderer::getRendererName() const
+{
+    const juce::ScopedLock sl(m_nameLock);
+    return m_rendererName;
+}
+
+void VisualizationRenderer::reportCpuUsage(uint64_t frameCount)
+{
+    if (utils::Logger::getInstance().getLogLevel() > utils::LogLevel::DEBUG)
+        return;
+    
+    const double now = juce::Time::getMillisecondCounterHiRes() / 1000.0;
+    if (!m_cpuMeter.isDue(now) || !m_cpuMeter.sample(utils::readProcessUsage().cpuSeconds, now, frameCount))
+        return;
+    
+    // Whole-process CPU, so compare modes under the same audio load
+    const juce::String renderer = m_usingOpenGL ? "opengl on " + getRendererName() : juce::String("software");
+    LOGF_DEBUG("Visualizations ({}, mode {}): {:.1f}% CPU at {:.1f} fps",
+               renderer.toRawUTF8(), core::renderModeName(m_mode),
+               m_cpuMeter.cpuPercent(), m_cpuMeter.framesPerSecond());
+}
+
+void VisualizationRenderer::newOpenGLContextCreated()
+{
+    // GL render thread
+    const auto* renderer = reinterpret_cast<const char*>(juce::gl::glGetString(juce::gl::GL_RENDERER));
+    const juce::String name = renderer != nullptr ? juce::String(renderer) : juce::String("unknown");
+    {
+        const juce::ScopedLock sl(m_nameLock);
+        m_rendererName = name;
+    }
+    m_contextCreated.store(true);
+    
+    if (m_mode == Mode::Auto && core::isSoftwareRasterizer(name.toStdString()))
+    {
+        juce::WeakReference<VisualizationRenderer> self(this);
+        juce::MessageManager::callAsync([self, name]() {
+            if (self != nullptr)
+                self->fallBackToSoftware("OpenGL driver is a software rasterizer (" + name + ")");
+        });
+        return;
+    }
+    
+    LOG_INFO("Visualizations: OpenGL rendering on " + name.toStdString());
+}
+
+void VisualizationRenderer::renderOpenGL()
+{
+    // The attached components are painted over this by JUCE
+    juce::OpenGLHelpers::clear(juce::Colour(0xff1a1a1a));
+}
+
+void VisualizationRenderer::openGLContextClosing()
+{
+}
+
+void VisualizationRenderer::fallBackToSoftware(const juce::String& reason)
+{
+    detach();
+    LOG_WARNING("Visualizations: software rendering, " + reason.toStdString());
+}
+
+} // namespace ui
+} // namespace quiet
@@ -8,14 +8,10 @@ namespace ui {
 WaveformDisplay::WaveformDisplay(const juce::String& title, const juce::Colour& waveColor)
     : m_title(title), m_waveformColor(waveColor)
 {
-    m_audioBuffer.setSize(2, m_bufferSize);
-    m_audioBuffer.clear();
-    startTimerHz(30); // 30 FPS update rate
 }
 
 WaveformDisplay::~WaveformDisplay()
 {
-    stopTimer();
 }
 
 void WaveformDisplay::paint(juce::Graphics& g)
@@ -36,7 +32,6 @@ void WaveformDisplay::paint(juce::Graphics& g)
     g.drawText(m_title, titleBounds, juce::Justification::centred);
     
     // Waveform area
-    const float width = static_cast<float>(bounds.getWidth());
     const float height = static_cast<float>(bounds.getHeight());
     const float midY = height * 0.5f;
     
@@ -45,56 +40,26 @@ void WaveformDisplay::paint(juce::Graphics& g)
     g.drawHorizontalLine(static_cast<int>(bounds.getY() + midY), 
                         bounds.getX(), bounds.getRight());
     
-    // Draw waveform
+    // Draw waveform: one vertical min-to-max line per pixel column
     g.setColour(m_waveformColor.withAlpha(0.8f));
     
-    juce::Path waveform;
     const juce::ScopedLock sl(m_bufferLock);
     
-    if (m_audioBuffer.getNumSamples() > 0)
+    const int columns = bounds.getWidth();
+    if (columns > 0)
     {
-        const float* samples = m_audioBuffer.getReadPointer(0);
-        const int numSamples = m_audioBuffer.getNumSamples();
-        const float samplesPerPixel = numSamples / width;
+        m_columnPeaks.resize(static_cast<size_t>(columns));
+        m_peakCache.getPeaks(static_cast<size_t>(m_visibleSamples), m_columnPeaks.data(), m_columnPeaks.size());
         
-        waveform.startNewSubPath(bounds.getX(), bounds.getY() + midY);
-        
-        for (int x = 0; x < width; ++x)
+        const float top = bounds.getY() + midY;
+        for (int x = 0; x < columns; ++x)
         {
-            // Find min/max values for this pixel column
-            int startSample = static_cast<int>(x * samplesPerPixel);
-            int endSample = std::min(static_cast<int>((x + 1) * samplesPerPixel), numSamples);
-            
-            float minVal = 0.0f;
-            float maxVal = 0.0f;
-            
-            for (int i = startSample; i < endSample; ++i)
-            {
-                float sample = samples[i];
-                minVal = std::min(minVal, sample);
-                maxVal = std::max(maxVal, sample);
-            }
-            
             // Scale and draw
-            float yMin = bounds.getY() + midY - (maxVal * midY * 0.8f);
-            float yMax = bounds.getY() + midY - (minVal * midY * 0.8f);
-            
-            if (x == 0)
-            {
-                waveform.startNewSubPath(bounds.getX() + x, yMin);
-            }
-            else
-            {
-                waveform.lineTo(bounds.getX() + x, yMin);
-            }
-            
-            if (yMax != yMin)
-            {
-                waveform.lineTo(bounds.getX() + x, yMax);
-            }
+            const auto& peak = m_columnPeaks[static_cast<size_t>(x)];
+            const float yMin = top - (peak.max * midY * 0.8f);
+            const float yMax = top - (peak.min * midY * 0.8f);
+            g.drawVerticalLine(bounds.getX() + x, yMin, juce::jmax(yMax, yMin + 1.0f));
         }
-        
-        g.strokePath(waveform, juce::PathStrokeType(1.5f));
     }
     
     // Draw level meter at bottom
@@ -129,53 +94,40 @@ void WaveformDisplay::resized()
 
 void WaveformDisplay::updateBuffer(const AudioBuffer& buffer)
 {
+    if (buffer.isEmpty())
+        return;
+    
+    pushSamples(buffer.getReadPointer(0), buffer.getNumSamples());
+}
+
+void WaveformDisplay::pushSamples(const float* samples, int numSamples)
+{
+    if (samples == nullptr || numSamples <= 0)
+        return;
+    
     const juce::ScopedLock sl(m_bufferLock);
     
     // Calculate RMS level
-    m_currentLevel = buffer.getRMSLevel(0, 0, buffer.getNumSamples());
-    
-    // Copy buffer data for display
-    int samplesToUse = std::min(buffer.getNumSamples(), m_bufferSize);
+    float sumSquares = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+        sumSquares += samples[i] * samples[i];
+    m_currentLevel = std::sqrt(sumSquares / numSamples);
     
-    // Simple downsampling if needed
-    if (buffer.getNumSamples() > m_bufferSize)
-    {
-        float downsampleRatio = static_cast<float>(buffer.getNumSamples()) / m_bufferSize;
-        
-        for (int i = 0; i < m_bufferSize; ++i)
-        {
-            int sourceIndex = static_cast<int>(i * downsampleRatio);
-            m_audioBuffer.setSample(0, i, buffer.getSample(0, sourceIndex));
-        }
-    }
-    else
-    {
-        // Shift existing samples and add new ones
-        int samplesToShift = m_bufferSize - samplesToUse;
-        
-        // Shift existing samples to the left
-        for (int i = 0; i < samplesToShift; ++i)
-        {
-            m_audioBuffer.setSample(0, i, m_audioBuffer.getSample(0, i + samplesToUse));
-        }
-        
-        // Add new samples
-        for (int i = 0; i < samplesToUse; ++i)
-        {
-            m_audioBuffer.setSample(0, samplesToShift + i, buffer.getSample(0, i));
-        }
-    }
+    // Every sample goes into the peak cache, so nothing is aliased away
+    m_peakCache.addSamples(samples, static_cast<size_t>(numSamples));
+    m_generation.fetch_add(1, std::memory_order_relaxed);
 }
 
-void WaveformDisplay::timerCallback()
+void WaveformDisplay::setVisibleSamples(int numSamples)
 {
+    m_visibleSamples = juce::jlimit(16, m_historySamples, numSamples);
     repaint();
 }
 
 void WaveformDisplay::clear()
 {
     const juce::ScopedLock sl(m_bufferLock);
-    m_audioBuffer.clear();
+    m_peakCache.clear();
     m_currentLevel = 0.0f;
     repaint();
 }
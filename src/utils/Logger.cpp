@@ -1,110 +1,175 @@
 #include "quiet/utils/Logger.h"
+#include "quiet/utils/StructuredLog.h"
 #include <iostream>
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
+#include <ctime>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 namespace quiet {
 namespace utils {
 
-// LockFreeQueue implementation
-template<typename T>
-LockFreeQueue<T>::LockFreeQueue(size_t capacity) 
-    : capacity(capacity), count(0) {
-    Node* dummy = new Node;
-    head.store(dummy);
-    tail.store(dummy);
-}
+namespace {
+
+// Records drained per batch before the sinks are written
+constexpr size_t kMaxBatchRecords = 512;
 
-template<typename T>
-LockFreeQueue<T>::~LockFreeQueue() {
-    T item;
-    while (pop(item)) {
-        // Drain the queue
+// write() until done; gives up on errors other than EINTR
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
     }
-    
-    Node* current = head.load();
-    while (current) {
-        Node* next = current->next.load();
-        delete current;
-        current = next;
+    return true;
+}
+
+// Strips directories at the call site so records only carry the file name
+const char* fileBaseName(const char* path) {
+    const char* name = path;
+    for (const char* p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') {
+            name = p + 1;
+        }
     }
+    return name;
 }
 
-template<typename T>
-bool LockFreeQueue<T>::push(T&& item) {
-    if (count.load() >= capacity) {
-        return false;
+// Turns a "{:spec}" such as ".2f" or "08x" into a printf conversion. Specs
+// that do not end in one of the allowed conversions for the argument type,
+// or contain anything but flags, width and precision, get the default.
+std::string printfConversion(const std::string& spec, const char* allowed, char fallback,
+                             const char* lengthModifier) {
+    std::string conversion = "%";
+    char type = fallback;
+    if (!spec.empty() && std::strchr(allowed, spec.back()) &&
+        spec.find_first_not_of("0123456789.-+# ") == spec.size() - 1) {
+        conversion.append(spec, 0, spec.size() - 1);
+        type = spec.back();
     }
+    conversion += lengthModifier;
+    conversion += type;
+    return conversion;
+}
+
+} // namespace
+
+namespace detail {
+
+std::string formatLogArgs(const char* format, const char* data, size_t size) {
+    std::string out;
+    out.reserve(std::strlen(format) + size);
     
-    Node* newNode = new Node;
-    T* data = new T(std::move(item));
-    newNode->data.store(data);
+    const char* end = data + size;
+    auto take = [&](void* value, size_t bytes) {
+        if (static_cast<size_t>(end - data) < bytes) {
+            data = end;
+            return false;
+        }
+        std::memcpy(value, data, bytes);
+        data += bytes;
+        return true;
+    };
     
-    while (true) {
-        Node* last = tail.load();
-        Node* next = last->next.load();
+    for (const char* p = format; *p; ++p) {
+        if ((p[0] == '{' && p[1] == '{') || (p[0] == '}' && p[1] == '}')) {
+            out += *p++;
+            continue;
+        }
+        if (*p != '{') {
+            out += *p;
+            continue;
+        }
         
-        if (last == tail.load()) {
-            if (next == nullptr) {
-                if (last->next.compare_exchange_weak(next, newNode)) {
-                    tail.compare_exchange_weak(last, newNode);
-                    count.fetch_add(1);
-                    return true;
-                }
-            } else {
-                tail.compare_exchange_weak(last, next);
-            }
+        // "{}" or "{:spec}"; spec is passed to snprintf (e.g. {:.2f}, {:x})
+        const char* close = std::strchr(p, '}');
+        if (!close) {
+            out += p;
+            break;
         }
-    }
-}
-
-template<typename T>
-bool LockFreeQueue<T>::pop(T& item) {
-    while (true) {
-        Node* first = head.load();
-        Node* last = tail.load();
-        Node* next = first->next.load();
+        std::string spec = p[1] == ':' ? std::string(p + 2, close) : std::string();
+        p = close;
         
-        if (first == head.load()) {
-            if (first == last) {
-                if (next == nullptr) {
-                    return false;
-                }
-                tail.compare_exchange_weak(last, next);
-            } else {
-                T* data = next->data.load();
-                if (data == nullptr) {
-                    continue;
-                }
-                
-                if (head.compare_exchange_weak(first, next)) {
-                    item = std::move(*data);
-                    delete data;
-                    delete first;
-                    count.fetch_sub(1);
-                    return true;
-                }
+        auto type = LogArgType::Bool;
+        if (data >= end || !take(&type, 1)) {
+            out += '?';
+            continue;
+        }
+        
+        char text[64];
+        text[0] = '\0';
+        switch (type) {
+            case LogArgType::Bool: {
+                uint8_t value = 0;
+                take(&value, sizeof(value));
+                out += value ? "true" : "false";
+                break;
+            }
+            case LogArgType::Char: {
+                char value = 0;
+                take(&value, sizeof(value));
+                out += value;
+                break;
             }
+            case LogArgType::Int: {
+                int64_t value = 0;
+                take(&value, sizeof(value));
+                std::snprintf(text, sizeof(text), printfConversion(spec, "dixXo", 'd', "ll").c_str(),
+                              static_cast<long long>(value));
+                out += text;
+                break;
+            }
+            case LogArgType::UInt: {
+                uint64_t value = 0;
+                take(&value, sizeof(value));
+                std::snprintf(text, sizeof(text), printfConversion(spec, "uxXo", 'u', "ll").c_str(),
+                              static_cast<unsigned long long>(value));
+                out += text;
+                break;
+            }
+            case LogArgType::Double: {
+                double value = 0;
+                take(&value, sizeof(value));
+                std::snprintf(text, sizeof(text), printfConversion(spec, "fFeEgGaA", 'g', "").c_str(), value);
+                out += text;
+                break;
+            }
+            case LogArgType::String: {
+                uint16_t length = 0;
+                take(&length, sizeof(length));
+                length = static_cast<uint16_t>(std::min<size_t>(length, static_cast<size_t>(end - data)));
+                out.append(data, length);
+                data += length;
+                break;
+            }
+            case LogArgType::Pointer: {
+                uintptr_t value = 0;
+                take(&value, sizeof(value));
+                std::snprintf(text, sizeof(text), "%p", reinterpret_cast<void*>(value));
+                out += text;
+                break;
+            }
+            default:
+                out += '?';
+                data = end;
+                break;
         }
     }
+    
+    return out;
 }
 
-template<typename T>
-size_t LockFreeQueue<T>::size() const {
-    return count.load();
-}
-
-template<typename T>
-bool LockFreeQueue<T>::empty() const {
-    return count.load() == 0;
-}
-
-// Explicit template instantiation
-template class LockFreeQueue<LogEntry>;
+} // namespace detail
 
 // Logger implementation
 Logger& Logger::getInstance() {
@@ -118,16 +183,18 @@ Logger::Logger()
     , currentFileSize_(0)
     , remoteEnabled_(false) {
     
-    // Initialize with default configuration
-    configure(LoggerConfig{});
-    
     // Set default formatter
     formatter_ = [this](const LogEntry& entry) {
         return formatLogEntry(entry);
     };
     
-    // Start worker thread
-    workerThread_ = std::make_unique<std::thread>(&Logger::workerThread, this);
+    // Initialize with default configuration
+    configure(LoggerConfig{});
+    
+    // Start worker and housekeeping threads
+    startWorker();
+    housekeepingRunning_ = true;
+    housekeepingThread_ = std::make_unique<std::thread>(&Logger::housekeepingThread, this);
 }
 
 Logger::~Logger() {
@@ -135,91 +202,245 @@ Logger::~Logger() {
 }
 
 void Logger::configure(const LoggerConfig& config) {
+    std::lock_guard<std::mutex> configLock(configMutex_);
+    
+    // The worker is the queue's only consumer; park it while the queue and
+    // sinks are replaced. Anything still queued is written with the old settings.
+    bool wasRunning = stopWorker();
+    retireQueue(new MpscRingBuffer<LogRecord>(config.queueSize));
+    retireLogFile();
+    
+    // The remote thread formats with config_ too; it sends what the worker
+    // forwarded so far and is parked until the new settings are in place
+    bool remoteWasRunning = stopRemote();
+    
     config_ = config;
     minLevel_.store(config.minLevel);
+    remoteFormat_.store(config.outputFormat);
+    processedCount_.store(0);
     
-    // Initialize queues
-    queue_ = std::make_unique<LockFreeQueue<LogEntry>>(config.queueSize);
+    fileBuffer_.reserve(config.writeBufferSize);
+    {
+        std::lock_guard<std::mutex> lock(housekeepingMutex_);
+        syncInterval_ = config.fsyncInterval;
+    }
     
     // Create log directory if needed
     if (config.enableFile) {
         std::filesystem::path logPath(config.logFilePath);
-        std::filesystem::create_directories(logPath.parent_path());
-        
-        // Open log file
-        std::lock_guard<std::mutex> lock(fileMutex_);
-        fileStream_ = std::make_unique<std::ofstream>(config.logFilePath, std::ios::app);
-        if (fileStream_->is_open()) {
-            currentFileSize_ = std::filesystem::file_size(config.logFilePath);
+        if (logPath.has_parent_path()) {
+            std::filesystem::create_directories(logPath.parent_path());
+        }
+        openLogFile();
+    }
+    
+    if (remoteWasRunning) {
+        startRemote();
+    }
+    if (wasRunning) {
+        startWorker();
+    }
+}
+
+void Logger::retireQueue(MpscRingBuffer<LogRecord>* replacement) {
+    // Publish the new queue first, then move to the next generation and wait
+    // for the writers of the old one. A producer that registered late sees
+    // the new queue, so once the count drains nobody can touch the old one.
+    MpscRingBuffer<LogRecord>* old = queue_.exchange(replacement);
+    uint32_t generation = queueGeneration_.fetch_add(1);
+    while (queueWriters_[generation & 1].load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    
+    if (old) {
+        LogRecord record;
+        while (old->tryPop(record)) {
+            processRecord(record);
         }
+        reportDroppedMessages();
+        writeBatch();
     }
+    ownedQueue_.reset(replacement);
 }
 
 void Logger::configureRemote(const RemoteLogConfig& config) {
+    std::lock_guard<std::mutex> configLock(configMutex_);
+    
+    // The sink belongs to the remote thread and the queue sits between it
+    // and the worker, so both threads are parked while they are replaced
+    bool workerWasRunning = stopWorker();
+    stopRemote();
+    
     remoteConfig_ = config;
+    {
+        std::lock_guard<std::mutex> lock(remoteSinkMutex_);
+        remoteSink_ = std::make_unique<RemoteLogSink>(config);
+    }
+    remoteQueue_ = std::make_unique<MpscRingBuffer<LogRecord>>(config_.queueSize);
     remoteEnabled_.store(true);
+    startRemote();
     
-    // Initialize remote queue
-    remoteQueue_ = std::make_unique<LockFreeQueue<LogEntry>>(config_.queueSize);
+    if (workerWasRunning) {
+        startWorker();
+    }
+}
+
+void Logger::disableRemote() {
+    std::lock_guard<std::mutex> configLock(configMutex_);
     
-    // Start remote thread
-    if (!remoteThread_) {
-        remoteThread_ = std::make_unique<std::thread>([this]() {
-            while (running_.load()) {
-                LogEntry entry;
-                if (remoteQueue_->pop(entry)) {
-                    sendToRemote(entry);
-                } else {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                }
+    // Queued lines are still sent; the sink is kept so its stats stay readable
+    remoteEnabled_.store(false);
+    stopRemote();
+}
+
+RemoteLogStats Logger::getRemoteStats() const {
+    RemoteLogStats stats;
+    {
+        std::lock_guard<std::mutex> lock(remoteSinkMutex_);
+        if (remoteSink_) {
+            stats = remoteSink_->getStats();
+        }
+    }
+    stats.linesDropped = remoteDropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Logger::remoteThread() {
+    LogRecord record;
+    std::string batch;
+    std::string remoteMessage;
+    
+    while (true) {
+        // Format a batch of forwarded records and send it in one go
+        size_t lines = 0;
+        LogOutputFormat format = remoteFormat_.load();
+        while (lines < kMaxBatchRecords && remoteQueue_->tryPop(record)) {
+            if (format == LogOutputFormat::Text) {
+                batch += formatter_(toLogEntry(record));
+                batch += '\n';
+            } else {
+                // The remote protocol is line based, so binary output is sent as JSON
+                appendStructured(batch, record, LogOutputFormat::JsonLines, remoteMessage);
             }
-        });
+            ++lines;
+        }
+        
+        if (lines > 0) {
+            remoteSink_->write(batch, lines);
+            batch.clear();
+            continue;
+        }
+        
+        if (!remoteRunning_.load()) {
+            break;
+        }
+        
+        // Idle: reconnect or replay spilled lines when due, else wait for the worker
+        auto wait = remoteSink_->maintain();
+        std::unique_lock<std::mutex> lock(remoteMutex_);
+        remoteCv_.wait_for(lock, wait, [this] { return remotePending_ || !remoteRunning_.load(); });
+        remotePending_ = false;
     }
 }
 
-void Logger::log(LogLevel level, const std::string& message,
-                 const std::string& file, const std::string& function, int line) {
-    if (level < minLevel_.load()) {
-        return;
+void Logger::startRemote() {
+    remoteRunning_.store(true);
+    remoteThread_ = std::make_unique<std::thread>(&Logger::remoteThread, this);
+}
+
+bool Logger::stopRemote() {
+    if (!remoteThread_) {
+        return false;
     }
     
-    LogEntry entry;
-    entry.timestamp = std::chrono::system_clock::now();
-    entry.level = level;
-    entry.threadId = std::this_thread::get_id();
-    entry.message = message;
-    entry.file = file;
-    entry.function = function;
-    entry.line = line;
-    
-    if (!queue_->push(std::move(entry))) {
-        // Queue is full, log to stderr
-        std::cerr << "Logger queue full, dropping message: " << message << std::endl;
-    } else {
-        cv_.notify_one();
+    {
+        std::lock_guard<std::mutex> lock(remoteMutex_);
+        remoteRunning_.store(false);
     }
+    remoteCv_.notify_all();
+    
+    // The thread sends whatever is still queued before it exits
+    if (remoteThread_->joinable()) {
+        remoteThread_->join();
+    }
+    remoteThread_.reset();
+    return true;
+}
+
+void Logger::log(LogLevel level, std::string_view message,
+                 const char* file, const char* function, int line) {
+    if (level < minLevel_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    enqueue(level, message, file, function, line, nullptr, {});
 }
 
-void Logger::logWithContext(LogLevel level, const std::string& message,
+void Logger::logWithContext(LogLevel level, std::string_view message,
                            const std::unordered_map<std::string, std::string>& context,
-                           const std::string& file, const std::string& function, int line) {
-    if (level < minLevel_.load()) {
+                           const char* file, const char* function, int line) {
+    if (level < minLevel_.load(std::memory_order_relaxed)) {
         return;
     }
     
-    LogEntry entry;
-    entry.timestamp = std::chrono::system_clock::now();
-    entry.level = level;
-    entry.threadId = std::this_thread::get_id();
-    entry.message = message;
-    entry.file = file;
-    entry.function = function;
-    entry.line = line;
-    entry.context = context;
-    
-    if (!queue_->push(std::move(entry))) {
-        std::cerr << "Logger queue full, dropping message: " << message << std::endl;
-    } else {
+    enqueue(level, message, file, function, line, &context, {});
+}
+
+void Logger::logWithFields(LogLevel level, std::string_view message, std::initializer_list<LogField> fields,
+                           const char* file, const char* function, int line) {
+    if (level < minLevel_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    enqueue(level, message, file, function, line, nullptr, fields);
+}
+
+bool Logger::enqueue(LogLevel level, std::string_view message, const char* file, const char* function,
+                     int line, const std::unordered_map<std::string, std::string>* context,
+                     std::initializer_list<LogField> fields) {
+    auto timestamp = std::chrono::system_clock::now();
+    
+    return pushRecord(false, [&](LogRecord& record) noexcept {
+        record.timestamp = timestamp;
+        record.level = level;
+        record.threadId = std::this_thread::get_id();
+        record.line = line;
+        record.site = nullptr;
+        record.file = fileBaseName(file ? file : "");
+        record.function = function ? function : "";
+        record.message.assign(message.data(), message.size());
+        
+        // Encode the fields into the inline buffer; those that don't fit are dropped
+        char buffer[decltype(record.context)::capacity()];
+        detail::LogArgEncoder encoder(buffer, sizeof(buffer));
+        if (context) {
+            for (const auto& [key, value] : *context) {
+                LogField(key, value).encode(encoder);
+            }
+        }
+        for (const LogField& field : fields) {
+            field.encode(encoder);
+        }
+        record.context.assign(buffer, encoder.size());
+    });
+}
+
+void Logger::wakeWorker(bool realtime) {
+    // Pairs with the fence in workerThread(): either the worker sees the new
+    // record before sleeping, or we see it waiting and notify. Only the first
+    // producer after the worker went to sleep pays for the notification.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (workerWaiting_.load(std::memory_order_relaxed) &&
+        workerWaiting_.exchange(false, std::memory_order_relaxed)) {
+        // Taking cvMutex_ makes sure the worker is inside wait_for() before
+        // the notify. Real-time callers only try: if the worker holds the
+        // mutex it is between its empty check and the wait, and the notify
+        // can be lost until the next poll.
+        if (!realtime) {
+            std::lock_guard<std::mutex> lock(cvMutex_);
+        } else if (cvMutex_.try_lock()) {
+            cvMutex_.unlock();
+        }
         cv_.notify_one();
     }
 }
@@ -262,6 +483,20 @@ void Logger::logPerformanceMetric(const std::string& operation,
     }
 }
 
+void Logger::logPerformanceReport(LogLevel level) {
+    std::string report = PerfSpanCollector::getInstance().formatReport();
+    
+    size_t start = 0;
+    while (start < report.size()) {
+        size_t end = report.find('\n', start);
+        if (end == std::string::npos) {
+            end = report.size();
+        }
+        log(level, std::string_view(report).substr(start, end - start));
+        start = end + 1;
+    }
+}
+
 void Logger::setLogLevel(LogLevel level) {
     minLevel_.store(level);
 }
@@ -270,63 +505,127 @@ LogLevel Logger::getLogLevel() const {
     return minLevel_.load();
 }
 
+uint64_t Logger::getDroppedCount() const {
+    return droppedCount_.load(std::memory_order_relaxed);
+}
+
 void Logger::flush() {
-    // Wait for queue to empty
-    while (!queue_->empty()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    // Keeps configure() from swapping the queue while its counters are compared
+    std::lock_guard<std::mutex> configLock(configMutex_);
     
-    // Flush file stream
-    if (fileStream_ && fileStream_->is_open()) {
-        std::lock_guard<std::mutex> lock(fileMutex_);
-        fileStream_->flush();
+    // Wait until everything queued so far has been written, not merely dequeued
+    uint64_t target = queue_.load()->pushedCount();
+    while (workerRunning_.load() && processedCount_.load(std::memory_order_acquire) < target) {
+        wakeWorker();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+    
+    // Then for the data to reach the disk, along with any pending pruning
+    requestSync();
+    waitForHousekeeping();
 }
 
 void Logger::shutdown() {
-    running_.store(false);
-    cv_.notify_all();
+    std::lock_guard<std::mutex> configLock(configMutex_);
     
-    if (workerThread_ && workerThread_->joinable()) {
-        workerThread_->join();
-    }
-    
-    if (remoteThread_ && remoteThread_->joinable()) {
-        remoteThread_->join();
-    }
+    running_.store(false);
+    stopWorker();
     
-    // Process remaining entries
-    LogEntry entry;
-    while (queue_->pop(entry)) {
-        processLogEntry(entry);
+    // Process remaining entries, then let the remote thread send its share
+    LogRecord record;
+    MpscRingBuffer<LogRecord>* queue = queue_.load();
+    while (queue->tryPop(record)) {
+        processRecord(record);
     }
+    writeBatch();
+    stopRemote();
+    retireLogFile();
     
-    // Close file stream
-    if (fileStream_ && fileStream_->is_open()) {
-        fileStream_->close();
+    // Housekeeping syncs and closes every file before it exits
+    if (housekeepingThread_) {
+        {
+            std::lock_guard<std::mutex> lock(housekeepingMutex_);
+            housekeepingRunning_ = false;
+        }
+        housekeepingCv_.notify_all();
+        if (housekeepingThread_->joinable()) {
+            housekeepingThread_->join();
+        }
+        housekeepingThread_.reset();
     }
 }
 
 void Logger::setFormatter(Formatter formatter) {
+    if (!formatter) {
+        // Back to the built-in format
+        formatter = [this](const LogEntry& entry) {
+            return formatLogEntry(entry);
+        };
+    }
     formatter_ = formatter;
 }
 
+void Logger::startWorker() {
+    workerRunning_.store(true);
+    workerThread_ = std::make_unique<std::thread>(&Logger::workerThread, this);
+}
+
+bool Logger::stopWorker() {
+    if (!workerThread_) {
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(cvMutex_);
+        workerRunning_.store(false);
+    }
+    cv_.notify_all();
+    
+    if (workerThread_->joinable()) {
+        workerThread_->join();
+    }
+    workerThread_.reset();
+    return true;
+}
+
 void Logger::workerThread() {
-    while (running_.load()) {
-        LogEntry entry;
-        bool hasEntry = false;
+    // Only replaced while this thread is parked
+    MpscRingBuffer<LogRecord>* queue = queue_.load();
+    LogRecord record;
+    
+    while (workerRunning_.load()) {
+        // Drain a batch, then hand it to each sink in one write
+        size_t batch = 0;
+        while (batch < kMaxBatchRecords && queue->tryPop(record)) {
+            processRecord(record);
+            ++batch;
+        }
         
-        // Try to get an entry from the queue
-        if (queue_->pop(entry)) {
-            hasEntry = true;
+        if (batch > 0) {
+            writeBatch();
+            processedCount_.fetch_add(batch, std::memory_order_release);
+            
+            if (remoteForwarded_) {
+                remoteForwarded_ = false;
+                {
+                    std::lock_guard<std::mutex> lock(remoteMutex_);
+                    remotePending_ = true;
+                }
+                remoteCv_.notify_one();
+            }
         } else {
-            // Wait for notification or timeout
+            reportDroppedMessages();
+            writeBatch();
+            
+            // Wait for notification or timeout. Producers only notify while
+            // workerWaiting_ is set, so re-check the queue after setting it.
             std::unique_lock<std::mutex> lock(cvMutex_);
-            cv_.wait_for(lock, std::chrono::milliseconds(100));
-        }
-        
-        if (hasEntry) {
-            processLogEntry(entry);
+            workerWaiting_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (queue->empty() && workerRunning_.load()) {
+                cv_.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            workerWaiting_.store(false, std::memory_order_relaxed);
         }
         
         // Check log rotation periodically
@@ -339,137 +638,342 @@ void Logger::workerThread() {
     }
 }
 
-void Logger::processLogEntry(const LogEntry& entry) {
-    if (config_.enableConsole) {
-        writeToConsole(entry);
+void Logger::processRecord(const LogRecord& record) {
+    bool structuredFile = config_.enableFile && config_.outputFormat != LogOutputFormat::Text;
+    bool textFile = config_.enableFile && !structuredFile;
+    
+    // The console always gets text
+    if (config_.enableConsole || textFile) {
+        std::string formatted = formatter_(toLogEntry(record));
+        if (config_.enableConsole) {
+            writeToConsole(record.level, formatted);
+        }
+        if (textFile) {
+            writeToFile(record.level, formatted);
+        }
     }
     
-    if (config_.enableFile) {
-        writeToFile(entry);
+    if (structuredFile) {
+        structuredLine_.clear();
+        appendStructured(structuredLine_, record, config_.outputFormat, formattedArgs_);
+        writeToFile(record.level, structuredLine_, false);
     }
     
     if (remoteEnabled_.load() && remoteQueue_) {
-        remoteQueue_->push(LogEntry(entry));
+        if (remoteQueue_->tryPush(record)) {
+            remoteForwarded_ = true;
+        } else {
+            remoteDropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::reportDroppedMessages() {
+    uint64_t dropped = droppedCount_.load(std::memory_order_relaxed);
+    if (dropped == reportedDrops_) {
+        return;
     }
+    
+    LogRecord record;
+    record.timestamp = std::chrono::system_clock::now();
+    record.level = LogLevel::WARNING;
+    record.threadId = std::this_thread::get_id();
+    record.message = "Logger queue full, dropped " + std::to_string(dropped - reportedDrops_) + " messages";
+    reportedDrops_ = dropped;
+    processRecord(record);
 }
 
-void Logger::writeToConsole(const LogEntry& entry) {
-    std::string formatted = formatter_(entry);
+LogEntry Logger::toLogEntry(const LogRecord& record) {
+    LogEntry entry;
+    entry.timestamp = record.timestamp;
+    entry.level = record.level;
+    entry.threadId = record.threadId;
+    entry.line = record.line;
     
-    // Use different streams based on log level
-    if (entry.level >= LogLevel::ERROR) {
-        std::cerr << formatted << std::endl;
+    if (record.site) {
+        entry.message = detail::formatLogArgs(record.site->format, record.message.c_str(), record.message.size());
+        entry.file = record.site->file;
+        entry.function = record.site->function;
+        return entry;
+    }
+    
+    entry.message = record.message.str();
+    entry.file = record.file.str();
+    entry.function = record.function.str();
+    
+    // Formatters see every field value as text
+    LogFieldReader reader(std::string_view(record.context.c_str(), record.context.size()));
+    LogFieldValue field;
+    while (reader.next(field)) {
+        std::string& value = entry.context[std::string(field.key)];
+        value.clear();
+        appendLogFieldValue(value, field);
+    }
+    
+    return entry;
+}
+
+void Logger::appendStructured(std::string& out, const LogRecord& record, LogOutputFormat format,
+                              std::string& messageScratch) {
+    StructuredLogRecord view;
+    view.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        record.timestamp.time_since_epoch()).count();
+    view.level = record.level;
+    view.threadId = std::hash<std::thread::id>()(record.threadId);
+    view.line = static_cast<uint32_t>(record.line);
+    
+    if (record.site) {
+        messageScratch = detail::formatLogArgs(record.site->format, record.message.c_str(), record.message.size());
+        view.message = messageScratch;
+        view.file = record.site->file;
+        view.function = record.site->function;
     } else {
-        std::cout << formatted << std::endl;
+        view.message = std::string_view(record.message.c_str(), record.message.size());
+        view.file = std::string_view(record.file.c_str(), record.file.size());
+        view.function = std::string_view(record.function.c_str(), record.function.size());
+        view.fields = std::string_view(record.context.c_str(), record.context.size());
     }
+    
+    if (format == LogOutputFormat::Binary) {
+        appendBinaryLogRecord(out, view);
+    } else {
+        appendJsonLogLine(out, view);
+    }
+}
+
+void Logger::writeToConsole(LogLevel level, const std::string& formatted) {
+    // Use different streams based on log level
+    std::string& buffer = level >= LogLevel::ERROR ? consoleErr_ : consoleOut_;
+    buffer += formatted;
+    buffer += '\n';
 }
 
-void Logger::writeToFile(const LogEntry& entry) {
-    if (!fileStream_ || !fileStream_->is_open()) {
+void Logger::writeToFile(LogLevel level, std::string_view data, bool appendNewline) {
+    if (fileFd_ < 0) {
         return;
     }
     
-    std::string formatted = formatter_(entry);
-    
-    std::lock_guard<std::mutex> lock(fileMutex_);
-    *fileStream_ << formatted << std::endl;
+    // Rotate before the file would grow past its limit
+    size_t pending = currentFileSize_ + fileBuffer_.size() + data.size() + (appendNewline ? 1 : 0);
+    if (pending > config_.maxFileSize && currentFileSize_ + fileBuffer_.size() > 0) {
+        writeBatch();
+        rotateLogFile();
+    }
     
-    currentFileSize_ += formatted.size() + 1; // +1 for newline
+    fileBuffer_ += data;
+    if (appendNewline) {
+        fileBuffer_ += '\n';
+    }
+    errorSinceSync_ = errorSinceSync_ || level >= LogLevel::ERROR;
     
-    // Check if rotation is needed
-    if (currentFileSize_ >= config_.maxFileSize) {
-        rotateLogFile();
+    if (fileBuffer_.size() >= config_.writeBufferSize) {
+        writeBatch();
     }
 }
 
-void Logger::sendToRemote(const LogEntry& entry) {
-    // Simple TCP implementation
-    if (remoteConfig_.protocol != "tcp") {
-        return; // Only TCP supported for now
+void Logger::writeBatch() {
+    if (!consoleOut_.empty()) {
+        std::fwrite(consoleOut_.data(), 1, consoleOut_.size(), stdout);
+        std::fflush(stdout);
+        consoleOut_.clear();
+    }
+    
+    if (!consoleErr_.empty()) {
+        std::fwrite(consoleErr_.data(), 1, consoleErr_.size(), stderr);
+        std::fflush(stderr);
+        consoleErr_.clear();
     }
     
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock < 0) {
+    if (fileBuffer_.empty() || fileFd_ < 0) {
+        fileBuffer_.clear();
         return;
     }
     
-    struct sockaddr_in serverAddr;
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(remoteConfig_.port);
+    bool written = writeAll(fileFd_, fileBuffer_.data(), fileBuffer_.size());
+    currentFileSize_ += fileBuffer_.size();
+    fileBuffer_.clear();
     
-    if (inet_pton(AF_INET, remoteConfig_.host.c_str(), &serverAddr.sin_addr) <= 0) {
-        close(sock);
-        return;
+    // Errors, and failed writes, are synced straight away; everything else
+    // on the housekeeping timer
+    if (errorSinceSync_ || !written) {
+        errorSinceSync_ = false;
+        requestSync();
+    } else {
+        std::lock_guard<std::mutex> lock(housekeepingMutex_);
+        if (!unsynced_) {
+            unsynced_ = true;
+            housekeepingCv_.notify_one();
+        }
+    }
+}
+
+bool Logger::openLogFile() {
+    fileFd_ = ::open(config_.logFilePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fileFd_ < 0) {
+        return false;
     }
     
-    // Set timeout
-    struct timeval tv;
-    tv.tv_sec = remoteConfig_.timeout.count() / 1000;
-    tv.tv_usec = (remoteConfig_.timeout.count() % 1000) * 1000;
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    struct stat info;
+    currentFileSize_ = ::fstat(fileFd_, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    
+    // Binary logs open with a magic number so the decoder can recognise them
+    if (config_.outputFormat == LogOutputFormat::Binary && currentFileSize_ == 0 &&
+        writeAll(fileFd_, kBinaryLogMagic, sizeof(kBinaryLogMagic))) {
+        currentFileSize_ = sizeof(kBinaryLogMagic);
+    }
     
-    if (connect(sock, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
-        close(sock);
+    std::lock_guard<std::mutex> lock(housekeepingMutex_);
+    syncFd_ = ::dup(fileFd_);
+    return true;
+}
+
+void Logger::retireLogFile() {
+    if (fileFd_ < 0) {
         return;
     }
     
-    std::string formatted = formatter_(entry);
-    send(sock, formatted.c_str(), formatted.length(), 0);
+    // Housekeeping syncs and closes both descriptors
+    std::lock_guard<std::mutex> lock(housekeepingMutex_);
+    retiredFds_.push_back(fileFd_);
+    if (syncFd_ >= 0) {
+        retiredFds_.push_back(syncFd_);
+    }
+    fileFd_ = -1;
+    syncFd_ = -1;
+    housekeepingRequested_++;
+    housekeepingCv_.notify_one();
+}
+
+void Logger::requestSync() {
+    std::lock_guard<std::mutex> lock(housekeepingMutex_);
+    syncRequested_ = true;
+    housekeepingRequested_++;
+    housekeepingCv_.notify_one();
+}
+
+void Logger::waitForHousekeeping() {
+    std::unique_lock<std::mutex> lock(housekeepingMutex_);
+    uint64_t target = housekeepingRequested_;
+    housekeepingDoneCv_.wait(lock, [this, target] {
+        return housekeepingCompleted_ >= target || !housekeepingRunning_;
+    });
+}
+
+void Logger::housekeepingThread() {
+    std::unique_lock<std::mutex> lock(housekeepingMutex_);
+    auto lastSync = std::chrono::steady_clock::now();
     
-    close(sock);
+    while (true) {
+        auto hasWork = [this] {
+            return syncRequested_ || !retiredFds_.empty() || !prunePath_.empty() || !housekeepingRunning_;
+        };
+        
+        // Sleep until asked, or until unsynced data is due for its timed fsync
+        if (!hasWork()) {
+            if (unsynced_ && syncInterval_.count() > 0) {
+                housekeepingCv_.wait_until(lock, lastSync + syncInterval_, hasWork);
+            } else {
+                housekeepingCv_.wait(lock, [this, &hasWork] {
+                    return hasWork() || (unsynced_ && syncInterval_.count() > 0);
+                });
+                // The interval starts with the first unsynced write
+                lastSync = std::chrono::steady_clock::now();
+                continue;
+            }
+        }
+        
+        bool stopping = !housekeepingRunning_;
+        bool sync = syncRequested_ || unsynced_ || stopping;
+        int syncFd = syncFd_;
+        std::vector<int> retired;
+        retired.swap(retiredFds_);
+        std::string prunePath;
+        prunePath.swap(prunePath_);
+        size_t maxFiles = pruneMaxFiles_;
+        uint64_t generation = housekeepingRequested_;
+        syncRequested_ = false;
+        unsynced_ = false;
+        lock.unlock();
+        
+        if (sync && syncFd >= 0) {
+            ::fsync(syncFd);
+        }
+        for (int fd : retired) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+        if (!prunePath.empty()) {
+            // Keep the newest maxFiles rotated copies
+            std::error_code error;
+            std::filesystem::path logPath(prunePath);
+            std::string baseName = logPath.stem().string();
+            std::filesystem::path directory = logPath.parent_path().empty() ? "." : logPath.parent_path();
+            
+            std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> logFiles;
+            for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+                if (entry.path().stem().string().find(baseName) == 0) {
+                    logFiles.emplace_back(std::filesystem::last_write_time(entry.path(), error), entry.path());
+                }
+            }
+            
+            std::sort(logFiles.begin(), logFiles.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+            for (size_t i = maxFiles; i < logFiles.size(); ++i) {
+                std::filesystem::remove(logFiles[i].second, error);
+            }
+        }
+        
+        lock.lock();
+        lastSync = std::chrono::steady_clock::now();
+        housekeepingCompleted_ = std::max(housekeepingCompleted_, generation);
+        housekeepingDoneCv_.notify_all();
+        
+        if (stopping) {
+            if (syncFd_ >= 0) {
+                ::close(syncFd_);
+                syncFd_ = -1;
+            }
+            break;
+        }
+    }
 }
 
 void Logger::rotateLogFile() {
-    if (!fileStream_ || !fileStream_->is_open()) {
+    if (fileFd_ < 0) {
         return;
     }
     
-    fileStream_->close();
+    writeBatch();
     
     // Generate timestamp for rotated file
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S");
+    auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm localTime{};
+    localtime_r(&time_t, &localTime);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &localTime);
     
-    // Rotate files
+    // Rotated filename; several rotations within a second get a counter
     std::filesystem::path logPath(config_.logFilePath);
     std::string baseName = logPath.stem().string();
     std::string extension = logPath.extension().string();
-    std::filesystem::path directory = logPath.parent_path();
-    
-    // Create rotated filename
-    std::string rotatedName = baseName + "_" + ss.str() + extension;
-    std::filesystem::path rotatedPath = directory / rotatedName;
-    
-    // Rename current log file
-    std::filesystem::rename(config_.logFilePath, rotatedPath);
-    
-    // Clean up old files
-    std::vector<std::filesystem::path> logFiles;
-    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
-        if (entry.path().stem().string().find(baseName) == 0) {
-            logFiles.push_back(entry.path());
-        }
+    std::filesystem::path rotatedPath = logPath.parent_path() / (baseName + "_" + stamp + extension);
+    for (int suffix = 1; std::filesystem::exists(rotatedPath); ++suffix) {
+        rotatedPath = logPath.parent_path() /
+                      (baseName + "_" + stamp + "_" + std::to_string(suffix) + extension);
     }
     
-    // Sort by modification time
-    std::sort(logFiles.begin(), logFiles.end(),
-              [](const auto& a, const auto& b) {
-                  return std::filesystem::last_write_time(a) > 
-                         std::filesystem::last_write_time(b);
-              });
+    // Rename and reopen here; syncing the old file and pruning old copies
+    // happen on the housekeeping thread
+    std::error_code error;
+    std::filesystem::rename(config_.logFilePath, rotatedPath, error);
+    retireLogFile();
+    openLogFile();
     
-    // Remove old files
-    if (logFiles.size() > config_.maxFiles) {
-        for (size_t i = config_.maxFiles; i < logFiles.size(); ++i) {
-            std::filesystem::remove(logFiles[i]);
-        }
-    }
-    
-    // Open new file
-    fileStream_ = std::make_unique<std::ofstream>(config_.logFilePath, std::ios::app);
-    currentFileSize_ = 0;
+    std::lock_guard<std::mutex> lock(housekeepingMutex_);
+    prunePath_ = config_.logFilePath;
+    pruneMaxFiles_ = config_.maxFiles;
+    housekeepingRequested_++;
+    housekeepingCv_.notify_one();
 }
 
 void Logger::checkLogRotation() {
@@ -477,68 +981,107 @@ void Logger::checkLogRotation() {
     static auto lastDate = std::chrono::system_clock::now();
     auto now = std::chrono::system_clock::now();
     
-    auto lastDay = std::chrono::time_point_cast<std::chrono::days>(lastDate);
-    auto currentDay = std::chrono::time_point_cast<std::chrono::days>(now);
+    using Days = std::chrono::duration<int64_t, std::ratio<86400>>;
+    auto lastDay = std::chrono::time_point_cast<Days>(lastDate);
+    auto currentDay = std::chrono::time_point_cast<Days>(now);
     
     if (currentDay > lastDay) {
-        std::lock_guard<std::mutex> lock(fileMutex_);
         rotateLogFile();
         lastDate = now;
     }
 }
 
 std::string Logger::formatLogEntry(const LogEntry& entry) {
-    std::stringstream ss;
+    // Formatting runs on the worker (and the remote sender), so the caches are
+    // per thread. The date part only changes once a second.
+    struct TimestampCache {
+        std::time_t second = -1;
+        std::string dateFormat;
+        std::string text;
+    };
+    thread_local TimestampCache timestampCache;
+    thread_local std::unordered_map<std::thread::id, std::string> threadIdText;
     
-    // Timestamp
     auto time_t = std::chrono::system_clock::to_time_t(entry.timestamp);
+    if (time_t != timestampCache.second || timestampCache.dateFormat != config_.dateFormat) {
+        std::tm localTime{};
+#ifdef _WIN32
+        localtime_s(&localTime, &time_t);
+#else
+        localtime_r(&time_t, &localTime);
+#endif
+        char buffer[64];
+        size_t length = std::strftime(buffer, sizeof(buffer), config_.dateFormat.c_str(), &localTime);
+        timestampCache.second = time_t;
+        timestampCache.dateFormat = config_.dateFormat;
+        timestampCache.text.assign(buffer, length);
+    }
+    
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        entry.timestamp.time_since_epoch()) % 1000;
-    ss << std::put_time(std::localtime(&time_t), config_.dateFormat.c_str());
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count();
+        entry.timestamp.time_since_epoch()).count() % 1000;
+    
+    std::string line;
+    line.reserve(64 + entry.message.size());
+    
+    // Timestamp
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(ms < 0 ? ms + 1000 : ms));
+    line += timestampCache.text;
+    line += millis;
     
     // Log level
-    ss << " [" << getLogLevelString(entry.level) << "]";
+    line += " [";
+    line += getLogLevelString(entry.level);
+    line += "]";
     
     // Thread ID
     if (config_.includeThreadId) {
-        ss << " [" << entry.threadId << "]";
+        auto it = threadIdText.find(entry.threadId);
+        if (it == threadIdText.end()) {
+            std::ostringstream id;
+            id << entry.threadId;
+            it = threadIdText.emplace(entry.threadId, id.str()).first;
+        }
+        line += " [";
+        line += it->second;
+        line += "]";
     }
     
-    // Source location
+    // Source location (records already carry the bare file name)
     if (config_.includeSourceLocation && !entry.file.empty()) {
-        std::filesystem::path filePath(entry.file);
-        ss << " [" << filePath.filename().string() << ":" << entry.line 
-           << " " << entry.function << "]";
+        size_t slash = entry.file.find_last_of("/\\");
+        line += " [";
+        line.append(entry.file, slash == std::string::npos ? 0 : slash + 1, std::string::npos);
+        line += ":";
+        line += std::to_string(entry.line);
+        line += " ";
+        line += entry.function;
+        line += "]";
     }
     
     // Message
-    ss << " " << entry.message;
+    line += " ";
+    line += entry.message;
     
     // Context
     if (!entry.context.empty()) {
-        ss << " {";
+        line += " {";
         bool first = true;
         for (const auto& [key, value] : entry.context) {
-            if (!first) ss << ", ";
-            ss << key << "=" << value;
+            if (!first) line += ", ";
+            line += key;
+            line += "=";
+            line += value;
             first = false;
         }
-        ss << "}";
+        line += "}";
     }
     
-    return ss.str();
+    return line;
 }
 
 std::string Logger::getLogLevelString(LogLevel level) const {
-    switch (level) {
-        case LogLevel::DEBUG:    return "DEBUG";
-        case LogLevel::INFO:     return "INFO";
-        case LogLevel::WARNING:  return "WARN";
-        case LogLevel::ERROR:    return "ERROR";
-        case LogLevel::CRITICAL: return "CRIT";
-        default:                 return "UNKNOWN";
-    }
+    return logLevelName(level);
 }
 
 std::string Logger::getCurrentTimestamp() const {
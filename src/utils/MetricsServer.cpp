@@ -0,0 +1,220 @@
+#include "quiet/utils/MetricsServer.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace quiet {
+namespace utils {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+// Close-on-exec, and no SIGPIPE from a scraper that disconnects early where
+// send() has no MSG_NOSIGNAL (macOS). SOCK_CLOEXEC is Linux-only.
+void configureSocket(int fd) {
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+}
+
+// A scrape that has not sent its request line by then is dropped
+constexpr int kRequestTimeoutMs = 2000;
+
+// Requests are only inspected up to the end of their first line
+constexpr size_t kMaxRequestBytes = 8192;
+
+bool sendAll(int fd, const std::string& data) {
+    const char* next = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t sent = ::send(fd, next, remaining, kSendFlags);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        next += sent;
+        remaining -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+} // namespace
+
+ProcessUsage readProcessUsage() {
+    ProcessUsage usage;
+
+    rusage self{};
+    if (::getrusage(RUSAGE_SELF, &self) == 0) {
+        usage.cpuSeconds = static_cast<double>(self.ru_utime.tv_sec + self.ru_stime.tv_sec) +
+                           static_cast<double>(self.ru_utime.tv_usec + self.ru_stime.tv_usec) / 1e6;
+#ifdef __APPLE__
+        usage.residentBytes = static_cast<uint64_t>(self.ru_maxrss);           // Bytes on macOS
+#else
+        usage.residentBytes = static_cast<uint64_t>(self.ru_maxrss) * 1024;    // Kilobytes on Linux
+#endif
+    }
+
+#ifdef __linux__
+    // Current rather than peak RSS: resident pages are the second field
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    if (statm >> sizePages >> residentPages) {
+        usage.residentBytes = residentPages * static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    }
+#endif
+
+    return usage;
+}
+
+MetricsServer::MetricsServer(Provider provider)
+    : m_provider(std::move(provider)) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(int port) {
+    if (isRunning()) {
+        return true;
+    }
+
+    m_listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        return false;
+    }
+    configureSocket(m_listenFd);
+
+    int reuse = 1;
+    ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+
+    socklen_t length = sizeof(address);
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(m_listenFd, 8) != 0 ||
+        ::getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length) != 0 ||
+        ::pipe(m_wakeFds) != 0) {
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    m_port = ntohs(address.sin_port);
+    m_thread = std::thread(&MetricsServer::serverThread, this);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!isRunning()) {
+        return;
+    }
+
+    char wake = 1;
+    while (::write(m_wakeFds[1], &wake, 1) < 0 && errno == EINTR) {
+    }
+    m_thread.join();
+
+    ::close(m_listenFd);
+    ::close(m_wakeFds[0]);
+    ::close(m_wakeFds[1]);
+    m_listenFd = -1;
+    m_wakeFds[0] = m_wakeFds[1] = -1;
+}
+
+void MetricsServer::serverThread() {
+    pollfd fds[2] = {{m_listenFd, POLLIN, 0}, {m_wakeFds[0], POLLIN, 0}};
+
+    while (true) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;  // stop()
+        }
+        if ((fds[0].revents & POLLIN) == 0) {
+            continue;
+        }
+
+        int client = ::accept(m_listenFd, nullptr, nullptr);
+        if (client >= 0) {
+            configureSocket(client);
+            handleConnection(client);
+            ::close(client);
+        }
+    }
+}
+
+void MetricsServer::handleConnection(int fd) {
+    std::string request;
+    char chunk[1024];
+    pollfd client{fd, POLLIN, 0};
+
+    while (request.find("\r\n") == std::string::npos && request.size() < kMaxRequestBytes) {
+        if (::poll(&client, 1, kRequestTimeoutMs) <= 0) {
+            return;
+        }
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return;
+        }
+        request.append(chunk, static_cast<size_t>(received));
+    }
+
+    m_requests.fetch_add(1, std::memory_order_relaxed);
+
+    std::string line = request.substr(0, request.find("\r\n"));
+    bool found = line.rfind("GET /metrics ", 0) == 0 || line.rfind("GET / ", 0) == 0;
+
+    std::string body = found ? m_provider() : std::string("not found\n");
+    std::string response = found ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 404 Not Found\r\n";
+    response += found ? "Content-Type: text/plain; version=0.0.4\r\n" : "Content-Type: text/plain\r\n";
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    response += body;
+    sendAll(fd, response);
+}
+
+void MetricsServer::appendMetric(std::string& out, const char* name, const char* type,
+                                 const char* help, double value) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "%.17g", value);
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+    out += name;
+    out += ' ';
+    out += text;
+    out += '\n';
+}
+
+} // namespace utils
+} // namespace quiet
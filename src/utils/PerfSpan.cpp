@@ -0,0 +1,366 @@
+#include "quiet/utils/PerfSpan.h"
+#include "quiet/utils/StructuredLog.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+
+namespace quiet {
+namespace utils {
+
+namespace {
+
+// Spans a thread can record between two collections before dropping
+constexpr size_t kThreadRingCapacity = 4096;
+
+// Rings preallocated for prepareThread(): the audio thread across a few
+// device restarts, plus any other real-time threads
+constexpr size_t kReservedThreadBuffers = 8;
+
+// Most recent spans kept for trace export
+constexpr size_t kTraceCapacity = 65536;
+
+// Histogram range and precision: 1 ns to one minute, two significant digits
+constexpr uint64_t kHighestTrackableNs = 60ull * 1000 * 1000 * 1000;
+constexpr int kSignificantDigits = 2;
+
+// Tick rate is only trusted once this much time has passed since startup
+constexpr std::chrono::milliseconds kMinCalibrationTime{1};
+
+// Calling thread's ring, once it has one. Trivially destructible, so a
+// thread that only claims a reserved ring registers no exit handler.
+thread_local PerfSpanCollector::ThreadBuffer* t_threadBuffer = nullptr;
+
+uint32_t currentThreadId() {
+    return static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+}
+
+std::string formatNs(double ns) {
+    char text[32];
+    if (ns < 1e3) {
+        std::snprintf(text, sizeof(text), "%.0fns", ns);
+    } else if (ns < 1e6) {
+        std::snprintf(text, sizeof(text), "%.1fus", ns / 1e3);
+    } else if (ns < 1e9) {
+        std::snprintf(text, sizeof(text), "%.2fms", ns / 1e6);
+    } else {
+        std::snprintf(text, sizeof(text), "%.2fs", ns / 1e9);
+    }
+    return text;
+}
+
+void appendMicroseconds(std::string& out, uint64_t ns) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(ns / 1000),
+                  static_cast<unsigned long long>(ns % 1000));
+    out += text;
+}
+
+} // namespace
+
+PerfSpanCollector& PerfSpanCollector::getInstance() {
+    static PerfSpanCollector instance;
+    return instance;
+}
+
+PerfSpanCollector::PerfSpanCollector()
+    : m_epochTicks(readTicks())
+    , m_epochTime(std::chrono::steady_clock::now()) {
+    for (size_t i = 0; i < kReservedThreadBuffers; ++i) {
+        m_reserved.push_back(std::make_shared<ThreadBuffer>(kThreadRingCapacity));
+    }
+    m_threads = m_reserved;
+    m_thread = std::thread(&PerfSpanCollector::collectorThread, this);
+}
+
+PerfSpanCollector::~PerfSpanCollector() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+uint32_t PerfSpanCollector::registerName(const char* name) {
+    PerfSpanCollector& collector = getInstance();
+    std::lock_guard<std::mutex> lock(collector.m_mutex);
+
+    // Call sites sharing a name share a histogram
+    auto it = std::find(collector.m_names.begin(), collector.m_names.end(), name);
+    if (it != collector.m_names.end()) {
+        return static_cast<uint32_t>(it - collector.m_names.begin());
+    }
+
+    collector.m_names.emplace_back(name);
+    collector.m_histograms.push_back(std::make_unique<HdrHistogram>(kHighestTrackableNs, kSignificantDigits));
+    return static_cast<uint32_t>(collector.m_names.size() - 1);
+}
+
+PerfSpanCollector::ThreadBuffer* PerfSpanCollector::threadBuffer() {
+    // Marks the buffer retired when the thread exits; the collector drops it
+    // once its last spans are collected
+    struct Handle {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~Handle() {
+            if (buffer) {
+                buffer->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    if (t_threadBuffer) {
+        return t_threadBuffer;
+    }
+
+    thread_local Handle handle;
+    handle.buffer = getInstance().registerThread();
+    t_threadBuffer = handle.buffer.get();
+    return t_threadBuffer;
+}
+
+std::shared_ptr<PerfSpanCollector::ThreadBuffer> PerfSpanCollector::registerThread() {
+    auto buffer = std::make_shared<ThreadBuffer>(kThreadRingCapacity);
+    buffer->threadId = currentThreadId();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threads.push_back(buffer);
+    return buffer;
+}
+
+void PerfSpanCollector::prepareThread(const char* threadName) {
+    if (!t_threadBuffer) {
+        size_t index = m_nextReserved.fetch_add(1, std::memory_order_relaxed);
+        if (index < m_reserved.size()) {
+            // Already listed in m_threads; the ring's pushes publish the id
+            t_threadBuffer = m_reserved[index].get();
+            t_threadBuffer->threadId = currentThreadId();
+        } else {
+            threadBuffer();
+        }
+    }
+    if (threadName) {
+        t_threadBuffer->pendingName.store(threadName, std::memory_order_release);
+    }
+}
+
+void PerfSpanCollector::setCollectInterval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_collectInterval = std::max(interval, std::chrono::milliseconds(1));
+    }
+    m_cv.notify_all();
+}
+
+void PerfSpanCollector::collectorThread() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        m_cv.wait_for(lock, m_collectInterval, [this] { return !m_running; });
+        collectLocked();
+    }
+}
+
+void PerfSpanCollector::collect() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectLocked();
+}
+
+double PerfSpanCollector::ticksPerNs() {
+#ifdef QUIET_PERF_HAS_TSC
+    // The counter's rate is measured against steady_clock over the whole
+    // lifetime of the collector, so it gets more precise the longer we run
+    auto elapsed = std::chrono::steady_clock::now() - m_epochTime;
+    if (elapsed < kMinCalibrationTime) {
+        std::this_thread::sleep_for(kMinCalibrationTime - elapsed);
+    }
+    uint64_t ticks = readTicks() - m_epochTicks;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_epochTime).count();
+    return ns > 0 ? static_cast<double>(ticks) / static_cast<double>(ns) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+void PerfSpanCollector::collectLocked() {
+    if (m_threads.empty()) {
+        return;
+    }
+
+    const double nsPerTick = 1.0 / ticksPerNs();
+    if (m_trace.size() < kTraceCapacity) {
+        m_trace.reserve(kTraceCapacity);
+    }
+
+    for (auto it = m_threads.begin(); it != m_threads.end();) {
+        ThreadBuffer& buffer = **it;
+
+        // Read before draining so nothing recorded before retirement is missed
+        bool retired = buffer.retired.load(std::memory_order_acquire);
+
+        if (const char* name = buffer.pendingName.exchange(nullptr, std::memory_order_acquire)) {
+            m_threadNames[buffer.threadId] = name;
+        }
+
+        PerfSpanSample sample;
+        while (buffer.samples.tryPop(sample)) {
+            if (sample.nameId >= m_histograms.size()) {
+                continue;
+            }
+            uint64_t ticks = sample.endTicks >= sample.startTicks ? sample.endTicks - sample.startTicks : 0;
+            auto durationNs = static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick);
+            m_histograms[sample.nameId]->record(durationNs);
+
+            uint64_t sinceEpoch = sample.startTicks >= m_epochTicks ? sample.startTicks - m_epochTicks : 0;
+            TraceSpan span{static_cast<uint64_t>(static_cast<double>(sinceEpoch) * nsPerTick), durationNs,
+                           buffer.threadId, sample.nameId};
+            if (m_trace.size() < kTraceCapacity) {
+                m_trace.push_back(span);
+            } else {
+                m_trace[m_traceNext] = span;
+                m_traceNext = (m_traceNext + 1) % kTraceCapacity;
+            }
+        }
+
+        if (retired) {
+            m_retiredDrops += buffer.dropped.load(std::memory_order_relaxed);
+            it = m_threads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::vector<PerfSpanStats> PerfSpanCollector::getStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectLocked();
+
+    std::vector<PerfSpanStats> stats;
+    for (size_t id = 0; id < m_names.size(); ++id) {
+        const HdrHistogram& histogram = *m_histograms[id];
+        if (histogram.count() == 0) {
+            continue;
+        }
+
+        PerfSpanStats entry;
+        entry.name = m_names[id];
+        entry.count = histogram.count();
+        entry.minNs = histogram.min();
+        entry.p50Ns = histogram.valueAtPercentile(50.0);
+        entry.p90Ns = histogram.valueAtPercentile(90.0);
+        entry.p99Ns = histogram.valueAtPercentile(99.0);
+        entry.p999Ns = histogram.valueAtPercentile(99.9);
+        entry.maxNs = histogram.max();
+        entry.meanNs = histogram.mean();
+        stats.push_back(std::move(entry));
+    }
+
+    std::sort(stats.begin(), stats.end(),
+              [](const PerfSpanStats& a, const PerfSpanStats& b) { return a.name < b.name; });
+    return stats;
+}
+
+std::string PerfSpanCollector::formatReport() {
+    auto stats = getStats();
+
+    size_t nameWidth = 4;
+    for (const auto& entry : stats) {
+        nameWidth = std::max(nameWidth, entry.name.size());
+    }
+
+    std::string report;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-*s %10s %9s %9s %9s %9s %9s %9s %9s\n", static_cast<int>(nameWidth),
+                  "Span", "count", "min", "mean", "p50", "p90", "p99", "p99.9", "max");
+    report += line;
+
+    for (const auto& entry : stats) {
+        std::snprintf(line, sizeof(line), "%-*s %10llu %9s %9s %9s %9s %9s %9s %9s\n",
+                      static_cast<int>(nameWidth), entry.name.c_str(),
+                      static_cast<unsigned long long>(entry.count),
+                      formatNs(static_cast<double>(entry.minNs)).c_str(), formatNs(entry.meanNs).c_str(),
+                      formatNs(static_cast<double>(entry.p50Ns)).c_str(),
+                      formatNs(static_cast<double>(entry.p90Ns)).c_str(),
+                      formatNs(static_cast<double>(entry.p99Ns)).c_str(),
+                      formatNs(static_cast<double>(entry.p999Ns)).c_str(),
+                      formatNs(static_cast<double>(entry.maxNs)).c_str());
+        report += line;
+    }
+
+    uint64_t dropped = getDroppedCount();
+    if (dropped > 0) {
+        report += "(" + std::to_string(dropped) + " spans dropped: rings full between collections)\n";
+    }
+    return report;
+}
+
+std::string PerfSpanCollector::exportChromeTrace() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectLocked();
+
+    std::string json;
+    json.reserve(128 + m_trace.size() * 96);
+    json += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+
+    // Thread names first, as metadata events
+    for (const auto& [threadId, name] : m_threadNames) {
+        json += first ? "\n" : ",\n";
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        json += std::to_string(threadId);
+        json += ",\"args\":{\"name\":";
+        appendJsonString(json, name);
+        json += "}}";
+        first = false;
+    }
+
+    // Oldest span first
+    for (size_t i = 0; i < m_trace.size(); ++i) {
+        const TraceSpan& span = m_trace[(m_traceNext + i) % m_trace.size()];
+        json += first ? "\n" : ",\n";
+        json += "{\"name\":";
+        appendJsonString(json, m_names[span.nameId]);
+        json += ",\"cat\":\"quiet\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        json += std::to_string(span.threadId);
+        json += ",\"ts\":";
+        appendMicroseconds(json, span.startNs);
+        json += ",\"dur\":";
+        appendMicroseconds(json, span.durationNs);
+        json += "}";
+        first = false;
+    }
+
+    json += "\n]}\n";
+    return json;
+}
+
+bool PerfSpanCollector::writeChromeTrace(const std::string& path) {
+    std::string json = exportChromeTrace();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(file);
+}
+
+void PerfSpanCollector::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectLocked();
+
+    for (auto& histogram : m_histograms) {
+        histogram->reset();
+    }
+    m_trace.clear();
+    m_traceNext = 0;
+}
+
+uint64_t PerfSpanCollector::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t dropped = m_retiredDrops;
+    for (const auto& buffer : m_threads) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+} // namespace utils
+} // namespace quiet
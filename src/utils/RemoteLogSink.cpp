@@ -0,0 +1,350 @@
+#include "quiet/utils/RemoteLogSink.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace quiet {
+namespace utils {
+
+namespace {
+
+// Spilled data is replayed in chunks of this size
+constexpr size_t kReplayChunkBytes = 64 * 1024;
+
+// Idle wait when there is nothing to reconnect for; writes wake the caller
+constexpr std::chrono::milliseconds kIdleWait{60000};
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+// Close-on-exec, and no SIGPIPE from a dropped connection where send() has
+// no MSG_NOSIGNAL (macOS). SOCK_CLOEXEC is Linux-only.
+int openSocket(int family, int type, int protocol) {
+    int fd = ::socket(family, type, protocol);
+    if (fd < 0) {
+        return -1;
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+    return fd;
+}
+
+// Blocking TCP connect bounded by timeout
+bool connectWithTimeout(int fd, const sockaddr* address, socklen_t length, std::chrono::milliseconds timeout) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    int result = ::connect(fd, address, length);
+    if (result < 0 && errno == EINPROGRESS) {
+        pollfd request{fd, POLLOUT, 0};
+        if (::poll(&request, 1, static_cast<int>(timeout.count())) == 1) {
+            int error = 0;
+            socklen_t errorLength = sizeof(error);
+            ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLength);
+            result = error == 0 ? 0 : -1;
+        }
+    }
+
+    ::fcntl(fd, F_SETFL, flags);
+    return result == 0;
+}
+
+} // namespace
+
+RemoteLogSink::RemoteLogSink(const RemoteLogConfig& config)
+    : config_(config)
+    , udp_(config.protocol == "udp")
+    , nextConnect_(std::chrono::steady_clock::now())
+    , backoff_(config.initialBackoff) {
+
+    // Lines spilled by an earlier run are replayed once connected
+    if (!udp_ && !config_.spillPath.empty()) {
+        spillFd_ = ::open(config_.spillPath.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+        struct stat info;
+        if (spillFd_ >= 0 && ::fstat(spillFd_, &info) == 0) {
+            spillSize_ = static_cast<uint64_t>(info.st_size);
+        }
+    }
+}
+
+RemoteLogSink::~RemoteLogSink() {
+    disconnect();
+    if (spillFd_ >= 0) {
+        ::close(spillFd_);
+    }
+}
+
+void RemoteLogSink::write(const std::string& lines, size_t lineCount) {
+    if (lines.empty()) {
+        return;
+    }
+
+    if (fd_ < 0 && std::chrono::steady_clock::now() >= nextConnect_) {
+        connect();
+    }
+
+    if (udp_) {
+        if (fd_ < 0) {
+            bytesDropped_.fetch_add(lines.size(), std::memory_order_relaxed);
+            return;
+        }
+        writeDatagrams(lines);
+        return;
+    }
+
+    // A collector that closed the connection while we were idle shows up as
+    // a readable socket with nothing to read; catching it here avoids
+    // writing a batch into a connection that is already gone
+    if (fd_ >= 0) {
+        char probe;
+        if (::recv(fd_, &probe, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+            disconnect();
+            connect();
+        }
+    }
+
+    // Spilled lines go first so the collector sees them in order
+    if (fd_ >= 0 && spillOffset_ < spillSize_) {
+        replaySpill();
+    }
+
+    if (fd_ < 0 || spillOffset_ < spillSize_) {
+        spill(lines);
+        return;
+    }
+
+    if (!sendAll(lines.data(), lines.size())) {
+        disconnect();
+        spill(lines);
+        return;
+    }
+
+    linesSent_.fetch_add(lineCount, std::memory_order_relaxed);
+}
+
+std::chrono::milliseconds RemoteLogSink::maintain() {
+    auto now = std::chrono::steady_clock::now();
+    bool spillPending = spillOffset_ < spillSize_;
+
+    if (fd_ < 0 && spillPending && now >= nextConnect_) {
+        connect();
+    }
+
+    if (fd_ >= 0 && spillPending) {
+        replaySpill();
+    }
+
+    // Only keep retrying in the background while spilled lines are waiting;
+    // otherwise the next write reconnects
+    if (fd_ < 0 && spillOffset_ < spillSize_) {
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextConnect_ - now);
+        return std::max(wait, std::chrono::milliseconds(1));
+    }
+
+    return kIdleWait;
+}
+
+RemoteLogStats RemoteLogSink::getStats() const {
+    RemoteLogStats stats;
+    stats.linesSent = linesSent_.load(std::memory_order_relaxed);
+    stats.sendCalls = sendCalls_.load(std::memory_order_relaxed);
+    stats.connects = connects_.load(std::memory_order_relaxed);
+    stats.bytesSpilled = bytesSpilled_.load(std::memory_order_relaxed);
+    stats.bytesReplayed = bytesReplayed_.load(std::memory_order_relaxed);
+    stats.bytesDropped = bytesDropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool RemoteLogSink::connect() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = udp_ ? SOCK_DGRAM : SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    std::string port = std::to_string(config_.port);
+    if (::getaddrinfo(config_.host.c_str(), port.c_str(), &hints, &addresses) == 0) {
+        for (addrinfo* address = addresses; address && fd_ < 0; address = address->ai_next) {
+            int fd = openSocket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (fd < 0) {
+                continue;
+            }
+
+            bool connected = udp_ ? ::connect(fd, address->ai_addr, address->ai_addrlen) == 0
+                                  : connectWithTimeout(fd, address->ai_addr, address->ai_addrlen, config_.timeout);
+            if (!connected) {
+                ::close(fd);
+                continue;
+            }
+
+            if (!udp_) {
+                // Batching happens above the socket, so don't let Nagle hold batches back
+                int noDelay = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+                timeval tv;
+                tv.tv_sec = static_cast<time_t>(config_.timeout.count() / 1000);
+                tv.tv_usec = static_cast<suseconds_t>((config_.timeout.count() % 1000) * 1000);
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+            }
+            fd_ = fd;
+        }
+        ::freeaddrinfo(addresses);
+    }
+
+    if (fd_ < 0) {
+        // Try again later, backing off while the collector stays away
+        nextConnect_ = std::chrono::steady_clock::now() + backoff_;
+        backoff_ = std::min(backoff_ * 2, config_.maxBackoff);
+        return false;
+    }
+
+    connects_.fetch_add(1, std::memory_order_relaxed);
+    backoff_ = config_.initialBackoff;
+    return true;
+}
+
+void RemoteLogSink::disconnect() {
+    if (fd_ < 0) {
+        return;
+    }
+
+    ::close(fd_);
+    fd_ = -1;
+    nextConnect_ = std::chrono::steady_clock::now() + backoff_;
+    backoff_ = std::min(backoff_ * 2, config_.maxBackoff);
+}
+
+bool RemoteLogSink::sendAll(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = ::send(fd_, data, size, kSendFlags);
+        sendCalls_.fetch_add(1, std::memory_order_relaxed);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool RemoteLogSink::replaySpill() {
+    std::vector<char> chunk(kReplayChunkBytes);
+
+    while (spillOffset_ < spillSize_) {
+        size_t wanted = static_cast<size_t>(std::min<uint64_t>(chunk.size(), spillSize_ - spillOffset_));
+        ssize_t read = ::pread(spillFd_, chunk.data(), wanted, static_cast<off_t>(spillOffset_));
+        if (read <= 0) {
+            break;  // Unreadable; give up on the rest rather than resend forever
+        }
+        if (!sendAll(chunk.data(), static_cast<size_t>(read))) {
+            disconnect();
+            return false;
+        }
+        spillOffset_ += static_cast<uint64_t>(read);
+        bytesReplayed_.fetch_add(static_cast<uint64_t>(read), std::memory_order_relaxed);
+    }
+
+    // Everything replayed: start the file over
+    if (::ftruncate(spillFd_, 0) == 0) {
+        spillSize_ = 0;
+        spillOffset_ = 0;
+    }
+    return true;
+}
+
+void RemoteLogSink::spill(const std::string& lines) {
+    if (config_.spillPath.empty() || spillSize_ + lines.size() > config_.maxSpillBytes) {
+        bytesDropped_.fetch_add(lines.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    if (spillFd_ < 0) {
+        std::filesystem::path spillPath(config_.spillPath);
+        std::error_code error;
+        if (spillPath.has_parent_path()) {
+            std::filesystem::create_directories(spillPath.parent_path(), error);
+        }
+        spillFd_ = ::open(config_.spillPath.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (spillFd_ < 0) {
+            bytesDropped_.fetch_add(lines.size(), std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    const char* data = lines.data();
+    size_t remaining = lines.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(spillFd_, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    size_t spilled = lines.size() - remaining;
+    spillSize_ += spilled;
+    bytesSpilled_.fetch_add(spilled, std::memory_order_relaxed);
+    bytesDropped_.fetch_add(remaining, std::memory_order_relaxed);
+}
+
+void RemoteLogSink::writeDatagrams(const std::string& lines) {
+    const size_t maxDatagram = std::max<size_t>(config_.maxDatagramSize, 64);
+    size_t start = 0;
+    size_t linesInDatagram = 0;
+
+    // Pack whole lines into each datagram; a single oversized line is cut
+    auto sendDatagram = [&](size_t end) {
+        size_t length = std::min(end - start, maxDatagram);
+        ssize_t sent = ::send(fd_, lines.data() + start, length, kSendFlags);
+        sendCalls_.fetch_add(1, std::memory_order_relaxed);
+        if (sent < 0) {
+            bytesDropped_.fetch_add(end - start, std::memory_order_relaxed);
+        } else {
+            linesSent_.fetch_add(linesInDatagram, std::memory_order_relaxed);
+        }
+        start = end;
+        linesInDatagram = 0;
+    };
+
+    size_t position = 0;
+    while (position < lines.size()) {
+        size_t newline = lines.find('\n', position);
+        size_t lineEnd = newline == std::string::npos ? lines.size() : newline + 1;
+
+        if (linesInDatagram > 0 && lineEnd - start > maxDatagram) {
+            sendDatagram(position);
+        }
+        linesInDatagram++;
+        position = lineEnd;
+    }
+
+    if (position > start) {
+        sendDatagram(position);
+    }
+}
+
+} // namespace utils
+} // namespace quiet
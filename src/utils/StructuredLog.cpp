@@ -0,0 +1,354 @@
+#include "quiet/utils/StructuredLog.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace quiet {
+namespace utils {
+
+namespace {
+
+template<typename V>
+void putRaw(std::string& out, V value) {
+    char bytes[sizeof(V)];
+    std::memcpy(bytes, &value, sizeof(V));
+    out.append(bytes, sizeof(V));
+}
+
+template<typename Length>
+void putText(std::string& out, std::string_view text) {
+    auto length = static_cast<Length>(std::min<size_t>(text.size(), static_cast<Length>(-1)));
+    putRaw(out, length);
+    out.append(text.data(), length);
+}
+
+// Bounds-checked reads for the binary reader and the field walker
+class ByteReader {
+public:
+    ByteReader(const char* data, const char* end) : m_data(data), m_end(end) {}
+
+    template<typename V>
+    bool read(V& value) {
+        if (static_cast<size_t>(m_end - m_data) < sizeof(V)) {
+            return false;
+        }
+        std::memcpy(&value, m_data, sizeof(V));
+        m_data += sizeof(V);
+        return true;
+    }
+
+    template<typename Length>
+    bool readText(std::string_view& text) {
+        Length length = 0;
+        if (!read(length) || static_cast<size_t>(m_end - m_data) < length) {
+            return false;
+        }
+        text = std::string_view(m_data, length);
+        m_data += length;
+        return true;
+    }
+
+    const char* position() const { return m_data; }
+
+private:
+    const char* m_data;
+    const char* m_end;
+};
+
+void appendNumber(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+template<typename Integer>
+void appendNumber(std::string& out, Integer value) {
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+// "2026-01-31T12:00:00.123456Z"; the date part is rebuilt once per second
+void appendIsoTimestamp(std::string& out, int64_t timestampNs) {
+    struct SecondCache {
+        int64_t second = INT64_MIN;
+        char text[24] = {};
+        size_t length = 0;
+    };
+    thread_local SecondCache cache;
+
+    int64_t second = timestampNs / 1000000000;
+    int64_t micros = (timestampNs % 1000000000) / 1000;
+    if (micros < 0) {
+        second -= 1;
+        micros += 1000000;
+    }
+
+    if (second != cache.second) {
+        auto time = static_cast<std::time_t>(second);
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &time);
+#else
+        gmtime_r(&time, &utc);
+#endif
+        cache.length = std::strftime(cache.text, sizeof(cache.text), "%Y-%m-%dT%H:%M:%S", &utc);
+        cache.second = second;
+    }
+
+    char fraction[16];
+    std::snprintf(fraction, sizeof(fraction), ".%06dZ", static_cast<int>(micros));
+    out.append(cache.text, cache.length);
+    out += fraction;
+}
+
+void appendJsonFieldValue(std::string& out, const LogFieldValue& field) {
+    switch (field.type) {
+        case detail::LogArgType::Bool:
+            out += field.uintValue ? "true" : "false";
+            break;
+        case detail::LogArgType::Int:
+            appendNumber(out, field.intValue);
+            break;
+        case detail::LogArgType::UInt:
+        case detail::LogArgType::Pointer:
+            appendNumber(out, field.uintValue);
+            break;
+        case detail::LogArgType::Double:
+            appendNumber(out, field.doubleValue);
+            break;
+        case detail::LogArgType::Char: {
+            char value = static_cast<char>(field.intValue);
+            appendJsonString(out, std::string_view(&value, 1));
+            break;
+        }
+        default:
+            appendJsonString(out, field.text);
+            break;
+    }
+}
+
+} // namespace
+
+bool LogFieldReader::next(LogFieldValue& field) noexcept {
+    ByteReader reader(m_data, m_end);
+
+    uint8_t keyLength = 0;
+    if (!reader.read(keyLength) || static_cast<size_t>(m_end - reader.position()) < keyLength) {
+        return false;
+    }
+    field = LogFieldValue{};
+    field.key = std::string_view(reader.position(), keyLength);
+    reader = ByteReader(reader.position() + keyLength, m_end);
+
+    bool complete = reader.read(field.type);
+    if (complete) {
+        switch (field.type) {
+            case detail::LogArgType::Bool: {
+                uint8_t value = 0;
+                complete = reader.read(value);
+                field.uintValue = value;
+                break;
+            }
+            case detail::LogArgType::Char: {
+                char value = 0;
+                complete = reader.read(value);
+                field.intValue = value;
+                break;
+            }
+            case detail::LogArgType::Int:
+                complete = reader.read(field.intValue);
+                break;
+            case detail::LogArgType::UInt:
+                complete = reader.read(field.uintValue);
+                break;
+            case detail::LogArgType::Double:
+                complete = reader.read(field.doubleValue);
+                break;
+            case detail::LogArgType::String:
+                complete = reader.readText<uint16_t>(field.text);
+                break;
+            case detail::LogArgType::Pointer: {
+                uintptr_t value = 0;
+                complete = reader.read(value);
+                field.uintValue = value;
+                break;
+            }
+            default:
+                complete = false;
+                break;
+        }
+    }
+
+    if (!complete) {
+        m_data = m_end;
+        return false;
+    }
+    m_data = reader.position();
+    return true;
+}
+
+const char* logLevelName(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::DEBUG:    return "DEBUG";
+        case LogLevel::INFO:     return "INFO";
+        case LogLevel::WARNING:  return "WARN";
+        case LogLevel::ERROR:    return "ERROR";
+        case LogLevel::CRITICAL: return "CRIT";
+        default:                 return "UNKNOWN";
+    }
+}
+
+void appendLogFieldValue(std::string& out, const LogFieldValue& field) {
+    switch (field.type) {
+        case detail::LogArgType::Bool:
+            out += field.uintValue ? "true" : "false";
+            break;
+        case detail::LogArgType::Char:
+            out += static_cast<char>(field.intValue);
+            break;
+        case detail::LogArgType::Int:
+            appendNumber(out, field.intValue);
+            break;
+        case detail::LogArgType::UInt:
+            appendNumber(out, field.uintValue);
+            break;
+        case detail::LogArgType::Double: {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%g", field.doubleValue);
+            out += text;
+            break;
+        }
+        case detail::LogArgType::Pointer: {
+            char text[24];
+            std::snprintf(text, sizeof(text), "%p", reinterpret_cast<void*>(static_cast<uintptr_t>(field.uintValue)));
+            out += text;
+            break;
+        }
+        default:
+            out += field.text;
+            break;
+    }
+}
+
+void appendJsonString(std::string& out, std::string_view text) {
+    static const char kHex[] = "0123456789abcdef";
+
+    out += '"';
+    size_t plainStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        // Copy the run of characters that need no escaping in one go
+        out.append(text.data() + plainStart, i - plainStart);
+        plainStart = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                char escaped[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+                out.append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+    }
+    out.append(text.data() + plainStart, text.size() - plainStart);
+    out += '"';
+}
+
+void appendJsonLogLine(std::string& out, const StructuredLogRecord& record) {
+    out += "{\"ts\":\"";
+    appendIsoTimestamp(out, record.timestampNs);
+    out += "\",\"level\":\"";
+    out += logLevelName(record.level);
+    out += "\",\"thread\":";
+    appendNumber(out, record.threadId);
+
+    if (!record.file.empty()) {
+        out += ",\"file\":";
+        appendJsonString(out, record.file);
+        out += ",\"line\":";
+        appendNumber(out, record.line);
+        out += ",\"function\":";
+        appendJsonString(out, record.function);
+    }
+
+    out += ",\"msg\":";
+    appendJsonString(out, record.message);
+
+    if (!record.fields.empty()) {
+        out += ",\"ctx\":{";
+        LogFieldReader reader(record.fields);
+        LogFieldValue field;
+        bool first = true;
+        while (reader.next(field)) {
+            if (!first) {
+                out += ',';
+            }
+            appendJsonString(out, field.key);
+            out += ':';
+            appendJsonFieldValue(out, field);
+            first = false;
+        }
+        out += '}';
+    }
+
+    out += "}\n";
+}
+
+void appendBinaryLogRecord(std::string& out, const StructuredLogRecord& record) {
+    size_t start = out.size();
+    putRaw(out, uint32_t(0));  // Size, filled in below
+
+    putRaw(out, static_cast<uint8_t>(record.level));
+    putRaw(out, record.timestampNs);
+    putRaw(out, record.threadId);
+    putRaw(out, record.line);
+    putText<uint16_t>(out, record.file);
+    putText<uint16_t>(out, record.function);
+    putText<uint32_t>(out, record.message);
+    putText<uint16_t>(out, record.fields);
+
+    auto size = static_cast<uint32_t>(out.size() - start - sizeof(uint32_t));
+    std::memcpy(&out[start], &size, sizeof(size));
+}
+
+size_t readBinaryLogRecord(const char* data, size_t size, StructuredLogRecord& record) noexcept {
+    uint32_t recordSize = 0;
+    if (size < sizeof(recordSize)) {
+        return 0;
+    }
+    std::memcpy(&recordSize, data, sizeof(recordSize));
+    if (size - sizeof(recordSize) < recordSize) {
+        return 0;
+    }
+
+    const char* body = data + sizeof(recordSize);
+    ByteReader reader(body, body + recordSize);
+    uint8_t level = 0;
+    if (!reader.read(level) || level > static_cast<uint8_t>(LogLevel::CRITICAL) ||
+        !reader.read(record.timestampNs) || !reader.read(record.threadId) || !reader.read(record.line) ||
+        !reader.readText<uint16_t>(record.file) || !reader.readText<uint16_t>(record.function) ||
+        !reader.readText<uint32_t>(record.message) || !reader.readText<uint16_t>(record.fields)) {
+        return 0;
+    }
+    record.level = static_cast<LogLevel>(level);
+
+    return sizeof(recordSize) + recordSize;
+}
+
+} // namespace utils
+} // namespace quiet
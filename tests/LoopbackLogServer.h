@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace quiet {
+namespace test {
+
+/**
+ * @brief Minimal log collector on 127.0.0.1 for remote logging tests
+ *
+ * Accepts TCP connections (or receives UDP datagrams) and counts the
+ * newline-terminated lines that arrive, so tests and benchmarks can measure
+ * throughput and loss without an external collector. Passing the port of an
+ * earlier server restarts a collector on the same address.
+ */
+class LoopbackLogServer {
+public:
+    enum class Protocol {
+        Tcp,
+        Udp
+    };
+
+    explicit LoopbackLogServer(Protocol protocol, int port = 0, bool keepLines = true)
+        : m_protocol(protocol), m_keepLines(keepLines) {
+        m_listenFd = ::socket(AF_INET, protocol == Protocol::Tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+        int reuse = 1;
+        ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (protocol == Protocol::Udp) {
+            int receiveBuffer = 4 * 1024 * 1024;
+            ::setsockopt(m_listenFd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        ::bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        if (protocol == Protocol::Tcp) {
+            ::listen(m_listenFd, 8);
+        }
+
+        socklen_t length = sizeof(address);
+        ::getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+        m_port = ntohs(address.sin_port);
+
+        m_thread = std::thread([this] { run(); });
+    }
+
+    ~LoopbackLogServer() { stop(); }
+
+    LoopbackLogServer(const LoopbackLogServer&) = delete;
+    LoopbackLogServer& operator=(const LoopbackLogServer&) = delete;
+
+    int port() const { return m_port; }
+    uint64_t linesReceived() const { return m_lines.load(); }
+    uint64_t bytesReceived() const { return m_bytes.load(); }
+
+    std::vector<std::string> lines() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_received;
+    }
+
+    bool waitForLines(uint64_t count, std::chrono::milliseconds timeout) const {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (m_lines.load() < count) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Closes the listener and every connection, like a collector going down
+    void stop() {
+        if (!m_thread.joinable()) {
+            return;
+        }
+        m_running = false;
+        m_thread.join();
+        for (int fd : m_clients) {
+            ::close(fd);
+        }
+        m_clients.clear();
+        ::close(m_listenFd);
+    }
+
+    // A free port nobody listens on, for testing an unreachable collector
+    static int unusedPort() {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        socklen_t length = sizeof(address);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+        ::close(fd);
+        return ntohs(address.sin_port);
+    }
+
+private:
+    void run() {
+        std::vector<char> buffer(64 * 1024);
+        std::vector<std::string> partial;
+
+        while (m_running) {
+            std::vector<pollfd> fds{{m_listenFd, POLLIN, 0}};
+            for (int fd : m_clients) {
+                fds.push_back({fd, POLLIN, 0});
+            }
+            if (::poll(fds.data(), fds.size(), 10) <= 0) {
+                continue;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                if (m_protocol == Protocol::Tcp) {
+                    int client = ::accept(m_listenFd, nullptr, nullptr);
+                    if (client >= 0) {
+                        m_clients.push_back(client);
+                        partial.emplace_back();
+                    }
+                } else {
+                    ssize_t received = ::recv(m_listenFd, buffer.data(), buffer.size(), 0);
+                    std::string datagram;
+                    if (received > 0) {
+                        consume(buffer.data(), static_cast<size_t>(received), datagram);
+                    }
+                }
+            }
+
+            // Walk backwards so closed clients can be erased in place
+            for (size_t i = fds.size() - 1; i >= 1; --i) {
+                if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                    continue;
+                }
+                ssize_t received = ::recv(fds[i].fd, buffer.data(), buffer.size(), 0);
+                if (received > 0) {
+                    consume(buffer.data(), static_cast<size_t>(received), partial[i - 1]);
+                } else {
+                    ::close(fds[i].fd);
+                    m_clients.erase(m_clients.begin() + static_cast<long>(i - 1));
+                    partial.erase(partial.begin() + static_cast<long>(i - 1));
+                }
+            }
+        }
+    }
+
+    void consume(const char* data, size_t size, std::string& partial) {
+        m_bytes += size;
+        for (size_t i = 0; i < size; ++i) {
+            if (data[i] != '\n') {
+                partial += data[i];
+                continue;
+            }
+            if (m_keepLines) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_received.push_back(partial);
+            }
+            partial.clear();
+            m_lines++;
+        }
+    }
+
+    Protocol m_protocol;
+    bool m_keepLines;
+    int m_listenFd = -1;
+    int m_port = 0;
+    std::vector<int> m_clients;
+    std::thread m_thread;
+    std::atomic<bool> m_running{true};
+    std::atomic<uint64_t> m_lines{0};
+    std::atomic<uint64_t> m_bytes{0};
+    mutable std::mutex m_mutex;
+    std::vector<std::string> m_received;
+};
+
+} // namespace test
+} // namespace quiet
@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+#include "quiet/core/ConfigJson.h"
+#include <sstream>
+#include <string>
+
+using namespace quiet::core;
+
+namespace {
+
+// The loader ConfigurationManager used before ConfigJson: split on ',' and
+// ':' and guess each value's type. Kept here as the baseline to beat; it
+// only copes with flat files whose strings contain no commas.
+std::unordered_map<std::string, ConfigValue> legacyParse(std::string content) {
+    auto trim = [](const std::string& str) {
+        size_t start = str.find_first_not_of(" \t\n\r");
+        if (start == std::string::npos) return std::string();
+        size_t end = str.find_last_not_of(" \t\n\r");
+        return str.substr(start, end - start + 1);
+    };
+
+    std::unordered_map<std::string, ConfigValue> loadedValues;
+    content = trim(content);
+    if (content.front() == '{' && content.back() == '}') {
+        content = content.substr(1, content.length() - 2);
+    }
+
+    std::istringstream iss(content);
+    std::string line;
+    while (std::getline(iss, line, ',')) {
+        size_t colonPos = line.find(':');
+        if (colonPos == std::string::npos) continue;
+
+        std::string key = trim(line.substr(0, colonPos));
+        std::string value = trim(line.substr(colonPos + 1));
+        if (key.front() == '"' && key.back() == '"') {
+            key = key.substr(1, key.length() - 2);
+        }
+
+        ConfigValue configValue;
+        if (value == "true") {
+            configValue.set(true);
+        } else if (value == "false") {
+            configValue.set(false);
+        } else if (value.front() == '"' && value.back() == '"') {
+            configValue.set(value.substr(1, value.length() - 2));
+        } else {
+            try {
+                if (value.find('.') != std::string::npos) {
+                    configValue.set(std::stod(value));
+                } else {
+                    configValue.set(std::stoi(value));
+                }
+            } catch (...) {
+                configValue.set(value);
+            }
+        }
+        loadedValues[key] = configValue;
+    }
+    return loadedValues;
+}
+
+// A flat file both loaders can read: state.range(0) device profiles of
+// eight settings each, as dotted keys
+std::string makeFlatProfileFile(int64_t profiles) {
+    std::string json = "{\n";
+    for (int64_t p = 0; p < profiles; ++p) {
+        std::string prefix = "  \"profiles.device_" + std::to_string(p) + ".";
+        json += prefix + "name\": \"Microphone " + std::to_string(p) + "\",\n";
+        json += prefix + "sample_rate\": 48000,\n";
+        json += prefix + "buffer_size\": 256,\n";
+        json += prefix + "gain\": 0.75,\n";
+        json += prefix + "vad_threshold\": 0.5,\n";
+        json += prefix + "noise_reduction\": true,\n";
+        json += prefix + "reduction_level\": \"medium\",\n";
+        json += prefix + "channels\": 1" + (p + 1 < profiles ? ",\n" : "\n");
+    }
+    json += "}\n";
+    return json;
+}
+
+} // namespace
+
+static void BM_ConfigLoad_Legacy(benchmark::State& state) {
+    const std::string json = makeFlatProfileFile(state.range(0));
+    for (auto _ : state) {
+        auto values = legacyParse(json);
+        benchmark::DoNotOptimize(values.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+
+BENCHMARK(BM_ConfigLoad_Legacy)->Arg(16)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+static void BM_ConfigLoad_Json(benchmark::State& state) {
+    const std::string json = makeFlatProfileFile(state.range(0));
+    for (auto _ : state) {
+        std::unordered_map<std::string, ConfigValue> values;
+        parseConfigJson(json, values);
+        benchmark::DoNotOptimize(values.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+
+BENCHMARK(BM_ConfigLoad_Json)->Arg(16)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+// The same profiles as an array of objects, which only the new loader reads
+static void BM_ConfigLoad_JsonProfileArray(benchmark::State& state) {
+    std::unordered_map<std::string, ConfigValue> source;
+    ConfigArray profiles;
+    for (int64_t p = 0; p < state.range(0); ++p) {
+        ConfigObject profile;
+        profile["name"] = ConfigValue(std::string("Microphone, input ") + std::to_string(p));
+        profile["sample_rate"] = ConfigValue(48000);
+        profile["gain"] = ConfigValue(0.75);
+        profile["channels"] = ConfigValue(ConfigArray{ConfigValue(0), ConfigValue(1)});
+        profiles.push_back(ConfigValue(profile));
+    }
+    source["audio.device_profiles"] = ConfigValue(profiles);
+    const std::string json = writeConfigJson(source);
+
+    for (auto _ : state) {
+        std::unordered_map<std::string, ConfigValue> values;
+        parseConfigJson(json, values);
+        benchmark::DoNotOptimize(values.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+
+BENCHMARK(BM_ConfigLoad_JsonProfileArray)->Arg(16)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+static void BM_ConfigSave_Json(benchmark::State& state) {
+    std::unordered_map<std::string, ConfigValue> values;
+    parseConfigJson(makeFlatProfileFile(state.range(0)), values);
+
+    for (auto _ : state) {
+        std::string json = writeConfigJson(values);
+        benchmark::DoNotOptimize(json.data());
+    }
+}
+
+BENCHMARK(BM_ConfigSave_Json)->Arg(16)->Arg(1024)->Unit(benchmark::kMicrosecond);
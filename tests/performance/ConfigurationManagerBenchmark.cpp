@@ -0,0 +1,181 @@
+#include <benchmark/benchmark.h>
+#include "quiet/core/ConfigurationManager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+using namespace quiet::core;
+
+namespace {
+
+// Shared by every benchmark thread; set up and torn down by thread 0
+EventDispatcher* g_dispatcher = nullptr;
+ConfigurationManager* g_config = nullptr;
+std::atomic<bool> g_writing{false};
+std::thread g_writer;
+
+void setUp(benchmark::State& state) {
+    if (state.thread_index() != 0) {
+        return;
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "quiet_config_benchmark" / "config.json";
+    g_dispatcher = new EventDispatcher();
+    g_config = new ConfigurationManager(*g_dispatcher);
+    g_config->setAutoSave(false);
+    g_config->initialize(path.string());
+
+    // Arg(1): a settings change every millisecond alongside the readers
+    if (state.range(0) != 0) {
+        g_writing = true;
+        g_writer = std::thread([] {
+            int value = 0;
+            while (g_writing.load()) {
+                g_config->setValue("ui.visualization_fps", 30 + (value++ % 30));
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+}
+
+void tearDown(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_writing = false;
+        if (g_writer.joinable()) {
+            g_writer.join();
+        }
+        delete g_config;
+        delete g_dispatcher;
+        g_config = nullptr;
+        g_dispatcher = nullptr;
+        std::filesystem::remove_all(std::filesystem::temp_directory_path() / "quiet_config_benchmark");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+// What getValue() used to do: lock the manager's mutex and look up the key
+static void BM_ConfigRead_MutexBaseline(benchmark::State& state) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, ConfigValue> values{{"audio.buffer_size", ConfigValue(256)}};
+    const std::string key = "audio.buffer_size";
+
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = values.find(key);
+        benchmark::DoNotOptimize(it != values.end() ? it->second.get<int>(0) : 0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ConfigRead_MutexBaseline)->ThreadRange(1, 8)->UseRealTime();
+
+// getValue(): the thread's cached snapshot, then a hash lookup
+static void BM_ConfigRead_GetValue(benchmark::State& state) {
+    setUp(state);
+    const std::string key = "audio.buffer_size";
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(g_config->getValue<int>(key, 0));
+    }
+    tearDown(state);
+}
+
+BENCHMARK(BM_ConfigRead_GetValue)->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
+
+// getSnapshot(): an atomic shared_ptr copy per read
+static void BM_ConfigRead_Snapshot(benchmark::State& state) {
+    setUp(state);
+    const std::string key = "audio.buffer_size";
+
+    for (auto _ : state) {
+        auto snapshot = g_config->getSnapshot();
+        benchmark::DoNotOptimize(snapshot->get<int>(key, 0));
+    }
+    tearDown(state);
+}
+
+BENCHMARK(BM_ConfigRead_Snapshot)->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
+
+// ConfigHandle::get(): one atomic load
+static void BM_ConfigRead_Handle(benchmark::State& state) {
+    setUp(state);
+    static ConfigHandle<int> handle;
+    if (state.thread_index() == 0) {
+        handle = g_config->bind<int>("audio.buffer_size", 0);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(handle.get());
+    }
+
+    if (state.thread_index() == 0) {
+        handle = ConfigHandle<int>();
+    }
+    tearDown(state);
+}
+
+BENCHMARK(BM_ConfigRead_Handle)->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
+
+// Cost of one change with state.range(0) callbacks registered on other keys
+// and sections: the index makes it depend on the callbacks that match, not
+// on how many exist
+static void BM_ConfigNotify_SetValue(benchmark::State& state) {
+    EventDispatcher dispatcher;
+    ConfigurationManager config(dispatcher);
+    config.setAutoSave(false);
+
+    std::atomic<uint64_t> calls{0};
+    auto count = [&calls](const std::string&, const ConfigValue&, const ConfigValue&) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+    };
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        config.addChangeCallback("profiles.device_" + std::to_string(i) + ".gain", count);
+        config.addChangeCallback("profiles.device_" + std::to_string(i) + ".*", count);
+    }
+    config.addChangeCallback("audio.buffer_size", count);
+    config.addChangeCallback("audio.*", count);
+
+    int value = 0;
+    for (auto _ : state) {
+        config.setValue("audio.buffer_size", ++value);
+    }
+    state.counters["callbacks_per_change"] =
+        static_cast<double>(calls.load()) / static_cast<double>(std::max<int64_t>(state.iterations(), 1));
+}
+
+BENCHMARK(BM_ConfigNotify_SetValue)->Arg(0)->Arg(16)->Arg(1024);
+
+// restoreDefaults() with one batch subscriber per section
+static void BM_ConfigNotify_RestoreDefaults(benchmark::State& state) {
+    EventDispatcher dispatcher;
+    ConfigurationManager config(dispatcher);
+    config.setAutoSave(false);
+
+    std::atomic<uint64_t> batches{0};
+    for (const char* section : {"audio.*", "processing.*", "ui.*", "system.*", "virtual_device.*", "performance.*"}) {
+        config.addBatchChangeCallback(section, [&batches](const std::vector<ConfigChange>&) {
+            batches.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        config.addChangeCallback("profiles.device_" + std::to_string(i) + ".*",
+                                 [](const std::string&, const ConfigValue&, const ConfigValue&) {});
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        config.clear();
+        state.ResumeTiming();
+        config.restoreDefaults();
+    }
+    // clear() and restoreDefaults() each deliver one batch per section: 12
+    state.counters["batches_per_iteration"] =
+        static_cast<double>(batches.load()) / static_cast<double>(std::max<int64_t>(state.iterations(), 1));
+}
+
+BENCHMARK(BM_ConfigNotify_RestoreDefaults)->Arg(0)->Arg(1024)->Unit(benchmark::kMicrosecond);
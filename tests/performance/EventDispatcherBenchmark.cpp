@@ -0,0 +1,174 @@
+#include <benchmark/benchmark.h>
+#include "quiet/core/EventDispatcher.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+using namespace quiet::core;
+
+// Count heap allocations so each benchmark can report allocations per event
+static std::atomic<uint64_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+// Publishes state.range(0) events per iteration and waits until the listener
+// has seen all of them, so the timing covers publish -> queue -> deliver.
+template<typename PublishFn>
+void runPublishDeliver(benchmark::State& state, PublishFn publishOne) {
+    EventDispatcher dispatcher;
+    dispatcher.setEventPolicy(EventType::AudioLevelChanged, EventPolicy{});  // Measure every event, not just the latest
+    dispatcher.start();
+
+    std::atomic<uint64_t> delivered{0};
+    dispatcher.subscribe(EventType::AudioLevelChanged, [&](const Event&) {
+        delivered.fetch_add(1, std::memory_order_release);
+    });
+
+    const int64_t batch = state.range(0);
+    uint64_t expected = 0;
+
+    // Warm up so queue and listener storage reach their working size
+    for (int i = 0; i < 1000; ++i) {
+        publishOne(dispatcher, i);
+    }
+    expected += 1000;
+    while (delivered.load(std::memory_order_acquire) < expected) {
+        std::this_thread::yield();
+    }
+
+    uint64_t allocationsBefore = g_allocations.load();
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < batch; ++i) {
+            publishOne(dispatcher, static_cast<int>(i));
+        }
+        expected += batch;
+        while (delivered.load(std::memory_order_acquire) < expected) {
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t allocations = g_allocations.load() - allocationsBefore;
+    dispatcher.stop();
+
+    state.SetItemsProcessed(state.iterations() * batch);
+    state.counters["allocs_per_event"] = benchmark::Counter(
+        static_cast<double>(allocations) / static_cast<double>(state.iterations() * batch));
+}
+
+} // namespace
+
+static void BM_PublishDeliver_TypedPayload(benchmark::State& state) {
+    runPublishDeliver(state, [](EventDispatcher& dispatcher, int i) {
+        dispatcher.publish(EventType::AudioLevelChanged,
+                           EventDataFactory::createAudioLevelData(static_cast<float>(i) * 0.001f));
+    });
+}
+
+static void BM_PublishDeliver_EventDataMap(benchmark::State& state) {
+    runPublishDeliver(state, [](EventDispatcher& dispatcher, int i) {
+        auto data = std::make_shared<EventData>();
+        data->setValue("level", static_cast<float>(i) * 0.001f);
+        data->setValue("isInput", true);
+        dispatcher.publish(EventType::AudioLevelChanged, data);
+    });
+}
+
+static void BM_PublishDeliver_Realtime(benchmark::State& state) {
+    runPublishDeliver(state, [](EventDispatcher& dispatcher, int i) {
+        while (!dispatcher.publishRT(EventType::AudioLevelChanged,
+                                     EventDataFactory::createAudioLevelData(static_cast<float>(i) * 0.001f))) {
+            std::this_thread::yield();
+        }
+    });
+}
+
+BENCHMARK(BM_PublishDeliver_TypedPayload)->Arg(1)->Arg(256)->UseRealTime();
+BENCHMARK(BM_PublishDeliver_EventDataMap)->Arg(1)->Arg(256)->UseRealTime();
+BENCHMARK(BM_PublishDeliver_Realtime)->Arg(1)->Arg(256)->UseRealTime();
+
+// Many threads publishing with inline delivery: the path that used to
+// serialize on the listener registry and stats mutexes
+static EventDispatcher* g_contendedDispatcher = nullptr;
+static std::atomic<uint64_t> g_contendedDeliveries{0};
+
+static void BM_PublishImmediate_Contended(benchmark::State& state) {
+    std::atomic<bool> churning{true};
+    std::thread churn;
+
+    if (state.thread_index() == 0) {
+        g_contendedDispatcher = new EventDispatcher();
+        g_contendedDispatcher->start();
+        for (int l = 0; l < 4; ++l) {
+            g_contendedDispatcher->subscribe(EventType::AudioLevelChanged, [](const Event&) {
+                g_contendedDeliveries.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+
+        // Optional registry churn alongside the publishers
+        if (state.range(0) != 0) {
+            churn = std::thread([&churning] {
+                while (churning.load()) {
+                    auto handle = g_contendedDispatcher->subscribe(EventType::AudioLevelChanged, [](const Event&) {});
+                    g_contendedDispatcher->unsubscribe(handle);
+                }
+            });
+        }
+    }
+
+    for (auto _ : state) {
+        g_contendedDispatcher->publishImmediate(EventType::AudioLevelChanged,
+                                                EventDataFactory::createAudioLevelData(0.5f));
+    }
+
+    if (state.thread_index() == 0) {
+        churning = false;
+        if (churn.joinable()) {
+            churn.join();
+        }
+        g_contendedDispatcher->stop();
+        delete g_contendedDispatcher;
+        g_contendedDispatcher = nullptr;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PublishImmediate_Contended)->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
+
+// Cost of the trace ring on the inline path: Arg(0) tracing off, Arg(1) on
+static void BM_PublishImmediate_Tracing(benchmark::State& state) {
+    EventDispatcher dispatcher;
+    if (state.range(0) != 0) {
+        dispatcher.enableTracing(65536);
+    }
+    dispatcher.start();
+    dispatcher.subscribe(EventType::AudioLevelChanged, [](const Event&) {});
+
+    for (auto _ : state) {
+        dispatcher.publishImmediate(EventType::AudioLevelChanged,
+                                    EventDataFactory::createAudioLevelData(0.5f));
+    }
+
+    dispatcher.stop();
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PublishImmediate_Tracing)->Arg(0)->Arg(1);
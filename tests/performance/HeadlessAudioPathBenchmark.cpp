@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include "quiet/core/AudioBuffer.h"
+#include "quiet/core/EventDispatcher.h"
+#include "quiet/core/InputLevelMeter.h"
+#include "quiet/core/VisualizationTap.h"
+#include <array>
+#include <cmath>
+
+using namespace quiet::core;
+
+// Per-block work the audio callback does only to feed the UI: RMS levels
+// published as AudioLevelChanged, and input/output copies into the
+// visualization tap (drained here as the UI would). Headless runs replace
+// all of it with one subscriber check; compare the two per 480-sample block.
+// The device callback's own smoothed input meter is measured the same way.
+
+namespace {
+
+constexpr int kBlockSize = 480;   // 10 ms at 48 kHz
+
+void fillBlock(AudioBuffer& buffer) {
+    float* samples = buffer.getWritePointer(0);
+    for (int i = 0; i < buffer.getNumSamples(); ++i) {
+        samples[i] = 0.25f * std::sin(0.05f * static_cast<float>(i));
+    }
+}
+
+void publishLevels(EventDispatcher& dispatcher, const AudioBuffer& input, const AudioBuffer& output) {
+    if (!dispatcher.hasSubscribers(EventType::AudioLevelChanged)) {
+        return;
+    }
+    float inputLevel = input.getRMSLevel(0, 0, input.getNumSamples());
+    float outputLevel = output.getRMSLevel(0, 0, output.getNumSamples());
+    dispatcher.publishRT(EventType::AudioLevelChanged, EventDataFactory::createAudioLevelData(inputLevel, true));
+    dispatcher.publishRT(EventType::AudioLevelChanged, EventDataFactory::createAudioLevelData(outputLevel, false));
+}
+
+} // namespace
+
+static void BM_AudioBlockUiFeeds(benchmark::State& state) {
+    EventDispatcher dispatcher;
+    dispatcher.start();
+    dispatcher.subscribe(EventType::AudioLevelChanged, [](const Event&) {});
+
+    VisualizationTap tap;
+    AudioBuffer input(1, kBlockSize, 48000.0);
+    AudioBuffer output(1, kBlockSize, 48000.0);
+    fillBlock(input);
+    fillBlock(output);
+    std::array<float, kBlockSize> scratch{};
+
+    for (auto _ : state) {
+        publishLevels(dispatcher, input, output);
+        tap.write(VisualizationTap::Source::Input, input);
+        tap.write(VisualizationTap::Source::Output, output);
+
+        tap.read(VisualizationTap::Source::Input, scratch.data(), scratch.size());
+        tap.read(VisualizationTap::Source::Output, scratch.data(), scratch.size());
+        benchmark::DoNotOptimize(scratch.data());
+    }
+    dispatcher.stop();
+}
+BENCHMARK(BM_AudioBlockUiFeeds);
+
+static void BM_AudioBlockHeadless(benchmark::State& state) {
+    EventDispatcher dispatcher;
+    dispatcher.start();
+
+    AudioBuffer input(1, kBlockSize, 48000.0);
+    AudioBuffer output(1, kBlockSize, 48000.0);
+    fillBlock(input);
+    fillBlock(output);
+
+    for (auto _ : state) {
+        publishLevels(dispatcher, input, output);
+        benchmark::DoNotOptimize(input.getReadPointer(0));
+    }
+    dispatcher.stop();
+}
+BENCHMARK(BM_AudioBlockHeadless);
+
+static void BM_DeviceLevelMeter(benchmark::State& state) {
+    const bool listening = state.range(0) != 0;
+    EventDispatcher dispatcher;
+    dispatcher.start();
+    if (listening) {
+        dispatcher.subscribe(EventType::AudioLevelChanged, [](const Event&) {});
+    }
+
+    InputLevelMeter meter(dispatcher);
+    AudioBuffer input(2, kBlockSize, 48000.0);
+    fillBlock(input);
+
+    for (auto _ : state) {
+        meter.process(input, input.getNumChannels(), kBlockSize);
+        benchmark::DoNotOptimize(meter.getLevel());
+    }
+    dispatcher.stop();
+}
+BENCHMARK(BM_DeviceLevelMeter)->ArgName("listening")->Arg(1)->Arg(0);
@@ -0,0 +1,262 @@
+#include <benchmark/benchmark.h>
+#include "quiet/utils/Logger.h"
+#include "LoopbackLogServer.h"
+#include <filesystem>
+#include <unordered_map>
+
+using namespace quiet::utils;
+
+namespace {
+
+// Sinks are disabled so the numbers cover the producer side only: the
+// record is formatted in place in the ring and the worker drains it.
+void configureForBenchmark() {
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = false;
+    config.minLevel = LogLevel::DEBUG;
+    Logger::getInstance().configure(config);
+}
+
+// Lets the worker catch up outside the timed region every few thousand
+// calls, so the numbers measure accepted messages rather than the drop path
+// when there are fewer cores than producers
+constexpr int kFlushInterval = 128;
+
+void flushUntimed(benchmark::State& state, int& sinceFlush) {
+    if (++sinceFlush == kFlushInterval) {
+        state.PauseTiming();
+        Logger::getInstance().flush();
+        state.ResumeTiming();
+        sinceFlush = 0;
+    }
+}
+
+void reportDrops(benchmark::State& state, uint64_t droppedBefore) {
+    Logger& logger = Logger::getInstance();
+    logger.flush();
+    state.counters["dropped"] = static_cast<double>(logger.getDroppedCount() - droppedBefore);
+}
+
+} // namespace
+
+// ns per LOG_INFO call with 1-16 producer threads
+static void BM_LogInfo(benchmark::State& state) {
+    uint64_t droppedBefore = 0;
+    if (state.thread_index() == 0) {
+        configureForBenchmark();
+        droppedBefore = Logger::getInstance().getDroppedCount();
+    }
+
+    int sinceFlush = 0;
+    for (auto _ : state) {
+        LOG_INFO("Audio buffer processed");
+        flushUntimed(state, sinceFlush);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        reportDrops(state, droppedBefore);
+    }
+}
+BENCHMARK(BM_LogInfo)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_LogWithContext(benchmark::State& state) {
+    uint64_t droppedBefore = 0;
+    if (state.thread_index() == 0) {
+        configureForBenchmark();
+        droppedBefore = Logger::getInstance().getDroppedCount();
+    }
+
+    const std::unordered_map<std::string, std::string> context{
+        {"device", "Built-in Microphone"},
+        {"sampleRate", "48000"}
+    };
+
+    int sinceFlush = 0;
+    for (auto _ : state) {
+        LOG_WITH_CONTEXT(LogLevel::INFO, "Device opened", context);
+        flushUntimed(state, sinceFlush);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        reportDrops(state, droppedBefore);
+    }
+}
+BENCHMARK(BM_LogWithContext)->ThreadRange(1, 16)->UseRealTime();
+
+// Same context as above passed as inline fields: no map, no string copies
+static void BM_LogWithFields(benchmark::State& state) {
+    uint64_t droppedBefore = 0;
+    if (state.thread_index() == 0) {
+        configureForBenchmark();
+        droppedBefore = Logger::getInstance().getDroppedCount();
+    }
+
+    int sinceFlush = 0;
+    for (auto _ : state) {
+        LOG_WITH_FIELDS(LogLevel::INFO, "Device opened", {"device", "Built-in Microphone"}, {"sampleRate", 48000});
+        flushUntimed(state, sinceFlush);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        reportDrops(state, droppedBefore);
+    }
+}
+BENCHMARK(BM_LogWithFields)->ThreadRange(1, 16)->UseRealTime();
+
+// Deferred formatting: only the call site and raw arguments are queued
+static void BM_LogFormat(benchmark::State& state) {
+    uint64_t droppedBefore = 0;
+    if (state.thread_index() == 0) {
+        configureForBenchmark();
+        droppedBefore = Logger::getInstance().getDroppedCount();
+    }
+
+    int frames = 0;
+    int sinceFlush = 0;
+    for (auto _ : state) {
+        LOGF_INFO("Processed {} frames at {:.1f} dB, device {}", ++frames, -23.5, "Built-in Microphone");
+        flushUntimed(state, sinceFlush);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        reportDrops(state, droppedBefore);
+    }
+}
+BENCHMARK(BM_LogFormat)->ThreadRange(1, 16)->UseRealTime();
+
+// Cost of one QUIET_PERF_SPAN on the recording thread; the collector
+// drains the per-thread rings in the background
+static void BM_PerfSpan(benchmark::State& state) {
+    PerfSpanCollector& collector = PerfSpanCollector::getInstance();
+    collector.prepareThread();
+    uint64_t droppedBefore = collector.getDroppedCount();
+
+    int sinceCollect = 0;
+    for (auto _ : state) {
+        QUIET_PERF_SPAN("benchmark.span");
+        if (++sinceCollect == 1024) {
+            state.PauseTiming();
+            collector.collect();
+            state.ResumeTiming();
+            sinceCollect = 0;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        state.counters["dropped"] = static_cast<double>(collector.getDroppedCount() - droppedBefore);
+    }
+}
+BENCHMARK(BM_PerfSpan)->ThreadRange(1, 8)->UseRealTime();
+
+// File sink throughput: each iteration logs a burst of lines and waits for
+// them to be written and synced, so items/s is end-to-end lines per second.
+// The second argument selects text, JSON lines or binary output.
+static void BM_FileSinkLinesPerSecond(benchmark::State& state) {
+    static const char* const kFormatNames[] = {"text", "json", "binary"};
+    const auto linesPerBurst = static_cast<int>(state.range(0));
+    const auto format = static_cast<LogOutputFormat>(state.range(1));
+    const std::string path = "bench_logs/logger_benchmark.log";
+
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = path;
+    config.minLevel = LogLevel::DEBUG;
+    config.maxFileSize = 64 * 1024 * 1024;
+    config.queueSize = static_cast<size_t>(linesPerBurst) * 2;
+    config.outputFormat = format;
+    Logger& logger = Logger::getInstance();
+    logger.configure(config);
+    uint64_t droppedBefore = logger.getDroppedCount();
+
+    int line = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < linesPerBurst; ++i) {
+            LOG_WITH_FIELDS(LogLevel::INFO, "Processed frame", {"frame", ++line}, {"reductionDb", 18.25});
+        }
+        logger.flush();
+    }
+
+    state.SetLabel(kFormatNames[static_cast<int>(format)]);
+
+    state.SetItemsProcessed(state.iterations() * linesPerBurst);
+    state.counters["dropped"] = static_cast<double>(logger.getDroppedCount() - droppedBefore);
+
+    configureForBenchmark();
+    std::error_code error;
+    std::filesystem::remove_all("bench_logs", error);
+}
+BENCHMARK(BM_FileSinkLinesPerSecond)
+    ->ArgsProduct({{1024, 8192}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Remote transport against a loopback collector: lines/s end to end and the
+// share of lines that never arrived (UDP may lose some under load)
+static void runRemoteBenchmark(benchmark::State& state, quiet::test::LoopbackLogServer::Protocol protocol) {
+    const auto linesPerBurst = static_cast<int>(state.range(0));
+    quiet::test::LoopbackLogServer server(protocol, 0, false);
+
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = false;
+    config.queueSize = static_cast<size_t>(linesPerBurst) * 2;
+    Logger& logger = Logger::getInstance();
+    logger.configure(config);
+
+    RemoteLogConfig remote;
+    remote.host = "127.0.0.1";
+    remote.port = server.port();
+    remote.protocol = protocol == quiet::test::LoopbackLogServer::Protocol::Udp ? "udp" : "tcp";
+    remote.spillPath.clear();
+    logger.configureRemote(remote);
+
+    uint64_t sent = 0;
+    int line = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < linesPerBurst; ++i) {
+            LOGF_INFO("Remote frame {} level {:.1f} dB", ++line, -12.5);
+        }
+        sent += static_cast<uint64_t>(linesPerBurst);
+        logger.flush();
+        server.waitForLines(sent, std::chrono::milliseconds(500));
+    }
+
+    logger.disableRemote();
+    uint64_t received = server.linesReceived();
+    state.SetItemsProcessed(static_cast<int64_t>(received));
+    state.counters["loss_pct"] = sent > 0 ? 100.0 * static_cast<double>(sent - std::min(sent, received)) /
+                                                static_cast<double>(sent)
+                                          : 0.0;
+    state.counters["send_calls"] = static_cast<double>(logger.getRemoteStats().sendCalls);
+    configureForBenchmark();
+}
+
+static void BM_RemoteTcpLinesPerSecond(benchmark::State& state) {
+    runRemoteBenchmark(state, quiet::test::LoopbackLogServer::Protocol::Tcp);
+}
+BENCHMARK(BM_RemoteTcpLinesPerSecond)->Arg(1024)->Arg(8192)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_RemoteUdpLinesPerSecond(benchmark::State& state) {
+    runRemoteBenchmark(state, quiet::test::LoopbackLogServer::Protocol::Udp);
+}
+BENCHMARK(BM_RemoteUdpLinesPerSecond)->Arg(1024)->Arg(8192)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Filtered calls should cost one relaxed load
+static void BM_LogBelowLevel(benchmark::State& state) {
+    configureForBenchmark();
+    Logger::getInstance().setLogLevel(LogLevel::WARNING);
+
+    for (auto _ : state) {
+        LOG_DEBUG("Not written");
+    }
+
+    Logger::getInstance().setLogLevel(LogLevel::DEBUG);
+}
+BENCHMARK(BM_LogBelowLevel);
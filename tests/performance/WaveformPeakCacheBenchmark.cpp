@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "quiet/core/WaveformPeakCache.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace quiet::core;
+
+namespace {
+
+constexpr size_t kColumns = 800;
+constexpr size_t kHistory = 30 * 48000;
+
+std::vector<float> makeSignal(size_t length) {
+    std::vector<float> samples(length);
+    for (size_t i = 0; i < length; ++i) {
+        samples[i] = static_cast<float>(std::sin(i * 0.013) * std::cos(i * 0.0007));
+    }
+    return samples;
+}
+
+} // namespace
+
+// What WaveformDisplay::paint did before the cache: scan every visible
+// sample for each column's min and max
+static void BM_WaveformFullScan(benchmark::State& state) {
+    const auto span = static_cast<size_t>(state.range(0));
+    auto samples = makeSignal(span);
+    std::vector<WaveformPeakCache::Peak> peaks(kColumns);
+
+    for (auto _ : state) {
+        const double perColumn = static_cast<double>(span) / kColumns;
+        for (size_t c = 0; c < kColumns; ++c) {
+            size_t from = static_cast<size_t>(perColumn * c);
+            size_t to = std::max(static_cast<size_t>(perColumn * (c + 1)), from + 1);
+            float minValue = 0.0f;
+            float maxValue = 0.0f;
+            for (size_t i = from; i < to; ++i) {
+                minValue = std::min(minValue, samples[i]);
+                maxValue = std::max(maxValue, samples[i]);
+            }
+            peaks[c] = {minValue, maxValue};
+        }
+        benchmark::DoNotOptimize(peaks.data());
+    }
+}
+BENCHMARK(BM_WaveformFullScan)->Arg(4096)->Arg(48000)->Arg(kHistory);
+
+static void BM_WaveformPeakCache(benchmark::State& state) {
+    const auto span = static_cast<size_t>(state.range(0));
+    auto samples = makeSignal(kHistory);
+    WaveformPeakCache cache(kHistory);
+    cache.addSamples(samples.data(), samples.size());
+    std::vector<WaveformPeakCache::Peak> peaks(kColumns);
+
+    for (auto _ : state) {
+        cache.getPeaks(span, peaks.data(), peaks.size());
+        benchmark::DoNotOptimize(peaks.data());
+    }
+}
+BENCHMARK(BM_WaveformPeakCache)->Arg(4096)->Arg(48000)->Arg(kHistory);
+
+// Cost of keeping the cache up to date, per 256-sample block
+static void BM_WaveformPeakCacheAdd(benchmark::State& state) {
+    auto samples = makeSignal(256);
+    WaveformPeakCache cache(kHistory);
+
+    for (auto _ : state) {
+        cache.addSamples(samples.data(), samples.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples.size()));
+}
+BENCHMARK(BM_WaveformPeakCacheAdd);
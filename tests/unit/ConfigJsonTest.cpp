@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "quiet/core/ConfigJson.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using namespace quiet::core;
+
+namespace {
+
+std::unordered_map<std::string, ConfigValue> parseOrFail(const std::string& text) {
+    std::unordered_map<std::string, ConfigValue> values;
+    ConfigJsonResult result = parseConfigJson(text, values);
+    EXPECT_TRUE(result.ok) << result.error << " at offset " << result.offset;
+    return values;
+}
+
+} // namespace
+
+TEST(ConfigJsonTest, NestedSectionsBecomeDottedKeys) {
+    auto nested = parseOrFail(R"({
+        "audio": {"buffer_size": 256, "device": {"name": "USB, Mic \"2\""}},
+        "processing": {"vad_threshold": 0.5, "enabled": true},
+        "ui.theme": "dark"
+    })");
+
+    EXPECT_EQ(nested.size(), 5u);
+    EXPECT_EQ(nested["audio.buffer_size"].get<int>(), 256);
+    EXPECT_EQ(nested["audio.device.name"].get<std::string>(), "USB, Mic \"2\"");
+    EXPECT_DOUBLE_EQ(nested["processing.vad_threshold"].get<double>(), 0.5);
+    EXPECT_TRUE(nested["processing.enabled"].get<bool>());
+    EXPECT_EQ(nested["ui.theme"].get<std::string>(), "dark");
+
+    // Files written before sections existed use flat keys and load the same
+    auto flat = parseOrFail(R"({"audio.buffer_size": 256, "processing.enabled": true})");
+    EXPECT_EQ(flat["audio.buffer_size"].get<int>(), 256);
+    EXPECT_TRUE(flat["processing.enabled"].get<bool>());
+}
+
+TEST(ConfigJsonTest, ArraysOfProfiles) {
+    auto values = parseOrFail(R"({"audio": {"device_profiles": [
+        {"device_id": "hw:0,0", "gain": 1.25, "channels": [0, 1]},
+        {"device_id": "\u00e9\ud83c\udfa4", "gain": -3e-2, "channels": []}
+    ]}})");
+
+    auto profiles = values["audio.device_profiles"].get<ConfigArray>();
+    ASSERT_EQ(profiles.size(), 2u);
+
+    auto first = profiles[0].get<ConfigObject>();
+    EXPECT_EQ(first["device_id"].get<std::string>(), "hw:0,0");
+    EXPECT_DOUBLE_EQ(first["gain"].get<double>(), 1.25);
+    EXPECT_EQ(first["channels"].get<ConfigArray>().size(), 2u);
+
+    auto second = profiles[1].get<ConfigObject>();
+    EXPECT_EQ(second["device_id"].get<std::string>(), "\xC3\xA9\xF0\x9F\x8E\xA4");
+    EXPECT_DOUBLE_EQ(second["gain"].get<double>(), -0.03);
+    EXPECT_TRUE(second["channels"].get<ConfigArray>().empty());
+}
+
+TEST(ConfigJsonTest, RoundTripsValuesExactly) {
+    ConfigObject profile;
+    profile["device_id"] = ConfigValue(std::string("hw:1,0"));
+    profile["gain"] = ConfigValue(0.1);
+
+    std::unordered_map<std::string, ConfigValue> values;
+    values["audio.buffer_size"] = ConfigValue(256);
+    values["audio.device_profiles"] = ConfigValue(ConfigArray{ConfigValue(profile), ConfigValue()});
+    values["performance.cpu_limit"] = ConfigValue(15.0);
+    values["performance.tiny"] = ConfigValue(5e-324);
+    values["performance.third"] = ConfigValue(1.0 / 3.0);
+    values["stats.bytes"] = ConfigValue(int64_t(1) << 40);
+    values["stats.minimum"] = ConfigValue(std::numeric_limits<int>::min());
+    values["ui.theme"] = ConfigValue(std::string("line\nbreak\t\"quoted\" \\ \x01"));
+    values["ui.start_minimized"] = ConfigValue(false);
+    values["ui"] = ConfigValue(std::string("a value and a section"));
+
+    std::string json = writeConfigJson(values);
+    auto loaded = parseOrFail(json);
+    ASSERT_EQ(loaded.size(), values.size()) << json;
+
+    EXPECT_EQ(loaded["audio.buffer_size"].get<int>(), 256);
+    EXPECT_EQ(loaded["performance.cpu_limit"].get<double>(), 15.0);
+    EXPECT_EQ(loaded["performance.tiny"].get<double>(), 5e-324);
+    EXPECT_EQ(loaded["performance.third"].get<double>(), 1.0 / 3.0);
+    EXPECT_EQ(loaded["stats.bytes"].get<int64_t>(), int64_t(1) << 40);
+    EXPECT_EQ(loaded["stats.minimum"].get<int>(), std::numeric_limits<int>::min());
+    EXPECT_EQ(loaded["ui.theme"].get<std::string>(), values["ui.theme"].get<std::string>());
+    EXPECT_FALSE(loaded["ui.start_minimized"].get<bool>(true));
+    EXPECT_EQ(loaded["ui"].get<std::string>(), "a value and a section");
+
+    auto profiles = loaded["audio.device_profiles"].get<ConfigArray>();
+    ASSERT_EQ(profiles.size(), 2u);
+    EXPECT_EQ(profiles[0].get<ConfigObject>()["gain"].get<double>(), 0.1);
+    EXPECT_TRUE(profiles[1].empty());
+
+    // Writing what was read gives the same bytes
+    EXPECT_EQ(writeConfigJson(loaded), json);
+}
+
+TEST(ConfigJsonTest, WritesSortedSections) {
+    std::unordered_map<std::string, ConfigValue> values;
+    values["ui.window_size.width"] = ConfigValue(800);
+    values["audio.sample_rate"] = ConfigValue(48000);
+    values["ui.theme"] = ConfigValue(std::string("dark"));
+
+    EXPECT_EQ(writeConfigJson(values),
+              "{\n"
+              "  \"audio\": {\n"
+              "    \"sample_rate\": 48000\n"
+              "  },\n"
+              "  \"ui\": {\n"
+              "    \"theme\": \"dark\",\n"
+              "    \"window_size\": {\n"
+              "      \"width\": 800\n"
+              "    }\n"
+              "  }\n"
+              "}\n");
+}
+
+TEST(ConfigJsonTest, RejectsMalformedDocuments) {
+    const char* documents[] = {
+        "",
+        "[1, 2]",
+        "{\"a\": 1,}",
+        "{\"a\" 1}",
+        "{\"a\": \"unterminated}",
+        "{\"a\": tru}",
+        "{\"a\": 1} trailing",
+        "{\"a\": \"\\ud800\"}",
+        "{\"a\": 1e999}",
+        "{\"a\": -}",
+    };
+
+    for (const char* document : documents) {
+        std::unordered_map<std::string, ConfigValue> values;
+        ConfigJsonResult result = parseConfigJson(document, values);
+        EXPECT_FALSE(result.ok) << document;
+        EXPECT_FALSE(result.error.empty()) << document;
+    }
+
+    std::string deep(100, '[');
+    std::unordered_map<std::string, ConfigValue> values;
+    EXPECT_FALSE(parseConfigJson("{\"a\": " + deep, values).ok);
+}
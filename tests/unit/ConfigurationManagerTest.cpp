@@ -0,0 +1,360 @@
+#include <gtest/gtest.h>
+#include "quiet/core/ConfigurationManager.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quiet::core;
+
+class ConfigurationManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_configDir = std::filesystem::temp_directory_path() /
+                      ("quiet_config_test_" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())));
+        std::filesystem::remove_all(m_configDir);
+
+        m_config = std::make_unique<ConfigurationManager>(m_dispatcher);
+        m_config->setAutoSave(false);
+        ASSERT_TRUE(m_config->initialize((m_configDir / "config.json").string()));
+    }
+
+    void TearDown() override {
+        m_config.reset();
+        std::filesystem::remove_all(m_configDir);
+    }
+
+    // Poll until the predicate holds or the timeout expires
+    template<typename Predicate>
+    bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (predicate()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return predicate();
+    }
+
+    std::string readConfigFile() const {
+        std::ifstream file(m_configDir / "config.json", std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    EventDispatcher m_dispatcher;
+    std::filesystem::path m_configDir;
+    std::unique_ptr<ConfigurationManager> m_config;
+};
+
+TEST_F(ConfigurationManagerTest, SnapshotsAreImmutable) {
+    auto before = m_config->getSnapshot();
+    EXPECT_EQ(before->get<int>("audio.buffer_size"), 256);
+
+    m_config->setValue("audio.buffer_size", 512);
+    auto after = m_config->getSnapshot();
+
+    EXPECT_EQ(before->get<int>("audio.buffer_size"), 256);
+    EXPECT_EQ(after->get<int>("audio.buffer_size"), 512);
+    EXPECT_GT(after->version(), before->version());
+    EXPECT_EQ(m_config->getValue<int>("audio.buffer_size"), 512);
+
+    m_config->removeValue("audio.buffer_size");
+    EXPECT_FALSE(m_config->hasValue("audio.buffer_size"));
+    EXPECT_EQ(m_config->getValue<int>("audio.buffer_size", 128), 128);
+    EXPECT_TRUE(after->has("audio.buffer_size"));
+}
+
+TEST_F(ConfigurationManagerTest, HandlesFollowChanges) {
+    ConfigHandle<int> bufferSize = m_config->bind<int>("audio.buffer_size", 64);
+    ConfigHandle<double> missing = m_config->bind<double>("test.missing", 1.5);
+    ConfigHandle<int> unbound;
+
+    EXPECT_TRUE(bufferSize.isBound());
+    EXPECT_FALSE(unbound.isBound());
+    EXPECT_EQ(unbound.get(), 0);
+    EXPECT_EQ(bufferSize.get(), 256);
+    EXPECT_DOUBLE_EQ(missing.get(), 1.5);
+
+    m_config->setValue("audio.buffer_size", 1024);
+    m_config->setValue("test.missing", 2.5);
+    EXPECT_EQ(bufferSize.get(), 1024);
+    EXPECT_DOUBLE_EQ(missing.get(), 2.5);
+
+    // Another type or no value at all reads as the handle's default
+    m_config->setValue("audio.buffer_size", std::string("large"));
+    EXPECT_EQ(bufferSize.get(), 64);
+    m_config->removeValue("test.missing");
+    EXPECT_DOUBLE_EQ(missing.get(), 1.5);
+
+    m_config->restoreDefault("audio.buffer_size");
+    EXPECT_EQ(bufferSize.get(), 256);
+
+    // Copies share the binding
+    ConfigHandle<int> copy = bufferSize;
+    m_config->setValue("audio.buffer_size", 480);
+    EXPECT_EQ(copy.get(), 480);
+}
+
+TEST_F(ConfigurationManagerTest, ManagersDoNotShareCachedSnapshots) {
+    ConfigurationManager other(m_dispatcher);
+    other.setAutoSave(false);
+    ASSERT_TRUE(other.initialize((m_configDir / "other.json").string()));
+
+    m_config->setValue("audio.sample_rate", 44100);
+    other.setValue("audio.sample_rate", 96000);
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(m_config->getValue<int>("audio.sample_rate"), 44100);
+        EXPECT_EQ(other.getValue<int>("audio.sample_rate"), 96000);
+    }
+}
+
+TEST_F(ConfigurationManagerTest, ConcurrentReadersSeeWholeSnapshots) {
+    constexpr int kWrites = 2000;
+    constexpr int kReaders = 4;
+
+    // The writer keeps both keys equal; a snapshot must never show them apart
+    m_config->setValue("ui.window_size.width", 0);
+    m_config->setValue("ui.window_size.height", 0);
+    ConfigHandle<int> width = m_config->bind<int>("ui.window_size.width");
+
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::atomic<int> backwards{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&] {
+            int lastSeen = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                auto snapshot = m_config->getSnapshot();
+                if (snapshot->get<int>("ui.window_size.width") != snapshot->get<int>("ui.window_size.height")) {
+                    torn.fetch_add(1);
+                }
+
+                int value = width.get();
+                if (value < lastSeen) {
+                    backwards.fetch_add(1);
+                }
+                lastSeen = value;
+                m_config->getValue<int>("ui.window_size.height");
+            }
+        });
+    }
+
+    for (int i = 1; i <= kWrites; ++i) {
+        m_config->setDefaults({{"ui.window_size.width", ConfigValue(i)}, {"ui.window_size.height", ConfigValue(i)}});
+        m_config->restoreDefaults();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(backwards.load(), 0);
+    EXPECT_EQ(width.get(), kWrites);
+    EXPECT_EQ(m_config->getValue<int>("ui.window_size.height"), kWrites);
+}
+
+TEST_F(ConfigurationManagerTest, PersistenceCoalescesBursts) {
+    m_config->setSaveDelay(std::chrono::milliseconds(50));
+    m_config->setAutoSave(true);
+    uint64_t savesBefore = m_config->getStats().saveCount;
+
+    // A slider being dragged
+    for (int i = 0; i < 100; ++i) {
+        m_config->setValue("ui.visualization_fps", i);
+    }
+    m_config->setValue("test.persisted", std::string("yes"));
+
+    ASSERT_TRUE(waitFor([&] { return m_config->getStats().saveCount > savesBefore; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    auto stats = m_config->getStats();
+    EXPECT_EQ(stats.saveCount, savesBefore + 1);
+    EXPECT_GE(stats.coalescedChanges, 101u);
+    EXPECT_GE(stats.coalescingRatio, 1.0);
+    EXPECT_GE(stats.maxSaveMs, stats.lastSaveMs);
+    EXPECT_NE(readConfigFile().find("\"persisted\": \"yes\""), std::string::npos);
+    EXPECT_FALSE(std::filesystem::exists(m_configDir / "config.json.tmp"));
+}
+
+TEST_F(ConfigurationManagerTest, SavesOnlyWhenSomethingChanged) {
+    auto before = m_config->getStats();
+
+    // Nothing changed since initialize() wrote the defaults
+    EXPECT_TRUE(m_config->saveConfiguration());
+    EXPECT_EQ(m_config->getStats().saveCount, before.saveCount);
+    EXPECT_EQ(m_config->getStats().skippedSaves, before.skippedSaves + 1);
+
+    // Changed and changed back: same content, no write
+    m_config->setValue("audio.buffer_size", 512);
+    m_config->setValue("audio.buffer_size", 256);
+    EXPECT_TRUE(m_config->saveConfiguration());
+    EXPECT_EQ(m_config->getStats().saveCount, before.saveCount);
+
+    m_config->setValue("test.flag", std::string("on"));
+    EXPECT_TRUE(m_config->saveConfiguration());
+    EXPECT_EQ(m_config->getStats().saveCount, before.saveCount + 1);
+}
+
+TEST_F(ConfigurationManagerTest, SaveImmediatelyDoesNotWaitForTheDelay) {
+    m_config->setSaveDelay(std::chrono::seconds(10));
+    m_config->setAutoSave(true);
+    uint64_t savesBefore = m_config->getStats().saveCount;
+
+    m_config->setValue("test.urgent", std::string("now"), true);
+    EXPECT_TRUE(waitFor([&] { return m_config->getStats().saveCount > savesBefore; }));
+    EXPECT_NE(readConfigFile().find("\"urgent\": \"now\""), std::string::npos);
+}
+
+TEST_F(ConfigurationManagerTest, FailedSavesBackOff) {
+    // A directory where the file should be: every write fails
+    std::filesystem::remove(m_configDir / "config.json");
+    std::filesystem::create_directories(m_configDir / "config.json" / "blocked");
+
+    m_config->setSaveDelay(std::chrono::milliseconds(10));
+    m_config->setAutoSave(true, 60);
+    m_config->setValue("test.pending", std::string("yes"));
+
+    ASSERT_TRUE(waitFor([&] { return m_config->getStats().failedSaves > 0; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    // 100, 200, 400 ms apart rather than every 10 ms
+    uint64_t failures = m_config->getStats().failedSaves;
+    EXPECT_LE(failures, 4u);
+    EXPECT_FALSE(m_config->getStats().lastError.empty());
+
+    // An explicit request retries without waiting out the backoff
+    m_config->requestSave();
+    EXPECT_TRUE(waitFor([&] { return m_config->getStats().failedSaves > failures; },
+                        std::chrono::milliseconds(300)));
+}
+
+TEST_F(ConfigurationManagerTest, SavedFileLoadsBack) {
+    ConfigObject profile;
+    profile["device_id"] = ConfigValue(std::string("USB Audio, Rear"));
+    profile["gain"] = ConfigValue(0.75);
+    m_config->setValue("audio.device_profiles", ConfigArray{ConfigValue(profile)});
+    m_config->setValue("ui.theme", std::string("dark, \"high contrast\""));
+    ASSERT_TRUE(m_config->saveConfiguration());
+    EXPECT_NE(readConfigFile().find("\"audio\": {"), std::string::npos);
+
+    ConfigurationManager reloaded(m_dispatcher);
+    reloaded.setAutoSave(false);
+    ASSERT_TRUE(reloaded.initialize((m_configDir / "config.json").string()));
+
+    EXPECT_EQ(reloaded.getValue<int>("audio.buffer_size"), 256);
+    EXPECT_EQ(reloaded.getValue<double>("performance.cpu_limit"), 15.0);
+    EXPECT_TRUE(reloaded.getValue<bool>("audio.auto_select_device"));
+    EXPECT_EQ(reloaded.getValue<std::string>("ui.theme"), "dark, \"high contrast\"");
+
+    auto profiles = reloaded.getValue<ConfigArray>("audio.device_profiles");
+    ASSERT_EQ(profiles.size(), 1u);
+    EXPECT_EQ(profiles[0].get<ConfigObject>()["device_id"].get<std::string>(), "USB Audio, Rear");
+    EXPECT_EQ(profiles[0].get<ConfigObject>()["gain"].get<double>(), 0.75);
+
+    // Loading what it wrote leaves nothing to save
+    EXPECT_EQ(reloaded.getStats().saveCount, 0u);
+    EXPECT_TRUE(reloaded.saveConfiguration());
+    EXPECT_EQ(reloaded.getStats().saveCount, 0u);
+}
+
+TEST_F(ConfigurationManagerTest, RejectsCorruptFile) {
+    {
+        std::ofstream file(m_configDir / "corrupt.json", std::ios::binary);
+        file << "{\"audio\": {\"buffer_size\": 256,";
+    }
+
+    ConfigurationManager corrupt(m_dispatcher);
+    corrupt.setAutoSave(false);
+    ASSERT_TRUE(corrupt.initialize((m_configDir / "corrupt.json").string()));
+
+    // Falls back to defaults and keeps the broken file aside
+    EXPECT_EQ(corrupt.getValue<int>("audio.buffer_size"), 256);
+    EXPECT_NE(corrupt.getStats().lastError.find("created backup"), std::string::npos);
+    EXPECT_TRUE(std::filesystem::exists(m_configDir / "corrupt.json.backup"));
+}
+
+TEST_F(ConfigurationManagerTest, CallbacksMatchKeysSectionsAndGlobs) {
+    std::vector<std::string> calls;
+    auto record = [&calls](const std::string& name) {
+        return [&calls, name](const std::string& key, const ConfigValue&, const ConfigValue&) {
+            calls.push_back(name + ":" + key);
+        };
+    };
+
+    m_config->addChangeCallback("audio.buffer_size", record("exact"));
+    m_config->addChangeCallback("audio.*", record("section"));
+    m_config->addGlobalChangeCallback(record("global"));
+    m_config->addChangeCallback("*.enabled", record("glob"));
+    auto ui = m_config->addChangeCallback("ui.*", record("ui"));
+
+    m_config->setValue("audio.buffer_size", 512);
+    EXPECT_EQ(calls, (std::vector<std::string>{"global:audio.buffer_size", "section:audio.buffer_size",
+                                               "exact:audio.buffer_size"}));
+
+    calls.clear();
+    m_config->setValue("processing.denoise.enabled", false);
+    EXPECT_EQ(calls, (std::vector<std::string>{"global:processing.denoise.enabled", "glob:processing.denoise.enabled"}));
+
+    // "audio.*" is about keys below audio, not audio itself or audio_x
+    calls.clear();
+    m_config->setValue("audio", 1);
+    m_config->setValue("audio_gain", 1);
+    EXPECT_EQ(calls, (std::vector<std::string>{"global:audio", "global:audio_gain"}));
+
+    calls.clear();
+    m_config->setValue("ui.theme", std::string("light"));
+    EXPECT_TRUE(m_config->removeChangeCallback(ui));
+    EXPECT_FALSE(m_config->removeChangeCallback(ui));
+    m_config->setValue("ui.theme", std::string("dark"));
+    EXPECT_EQ(calls, (std::vector<std::string>{"global:ui.theme", "ui:ui.theme", "global:ui.theme"}));
+}
+
+TEST_F(ConfigurationManagerTest, BulkChangesArriveAsOneBatch) {
+    std::atomic<int> events{0};
+    std::atomic<int> eventChanges{0};
+    m_dispatcher.start();
+    m_dispatcher.subscribe(EventType::SettingsChanged, [&](const Event& e) {
+        if (auto* payload = e.get<SettingsChangedPayload>()) {
+            eventChanges += static_cast<int>(payload->changeCount);
+            ++events;
+        }
+    });
+
+    m_config->setValue("ui.theme", std::string("light"));
+    m_config->setValue("ui.window_size.width", 1024);
+    m_config->setValue("test.extra", 1);
+    ASSERT_TRUE(waitFor([&] { return events.load() == 3; }));
+
+    std::vector<std::vector<ConfigChange>> batches;
+    m_config->addBatchChangeCallback("ui.*", [&batches](const std::vector<ConfigChange>& changes) {
+        batches.push_back(changes);
+    });
+    int perKeyCalls = 0;
+    m_config->addGlobalChangeCallback([&perKeyCalls](const std::string&, const ConfigValue&, const ConfigValue&) {
+        ++perKeyCalls;
+    });
+
+    // Only the keys that differ from their defaults count as changes
+    m_config->restoreDefaults();
+    ASSERT_EQ(batches.size(), 1u);
+    ASSERT_EQ(batches[0].size(), 2u);
+    EXPECT_EQ(batches[0][0].key, "ui.theme");
+    EXPECT_EQ(batches[0][0].oldValue.get<std::string>(), "light");
+    EXPECT_EQ(batches[0][0].newValue.get<std::string>(), "dark");
+    EXPECT_EQ(batches[0][1].key, "ui.window_size.width");
+    EXPECT_EQ(perKeyCalls, 3);  // ui.theme, ui.window_size.width and the removed test.extra
+
+    // One event for the whole operation
+    ASSERT_TRUE(waitFor([&] { return events.load() == 4; }));
+    EXPECT_EQ(eventChanges.load(), 6);
+    m_dispatcher.stop();
+}
@@ -0,0 +1,640 @@
+#include <gtest/gtest.h>
+#include "quiet/core/EventDispatcher.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace quiet::core;
+
+class EventDispatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dispatcher = std::make_unique<EventDispatcher>();
+        m_dispatcher->start();
+    }
+
+    void TearDown() override {
+        m_dispatcher->stop();
+    }
+
+    // Poll until the predicate holds or the timeout expires
+    template<typename Predicate>
+    bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (predicate()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return predicate();
+    }
+
+    std::unique_ptr<EventDispatcher> m_dispatcher;
+};
+
+TEST_F(EventDispatcherTest, DeliversToTypeAndGlobalListeners) {
+    std::atomic<int> typeCount{0};
+    std::atomic<int> globalCount{0};
+
+    m_dispatcher->subscribe(EventType::AudioLevelChanged, [&](const Event&) { typeCount++; });
+    m_dispatcher->subscribeAll([&](const Event&) { globalCount++; });
+
+    m_dispatcher->publish(EventType::AudioLevelChanged, EventDataFactory::createAudioLevelData(0.5f));
+    m_dispatcher->publish(EventType::WindowShown);
+
+    EXPECT_TRUE(waitFor([&] { return typeCount == 1 && globalCount == 2; }));
+}
+
+TEST_F(EventDispatcherTest, PreservesOrderPerListener) {
+    const int numEvents = 500;
+    std::mutex mutex;
+    std::vector<int> received;
+
+    m_dispatcher->setEventPolicy(EventType::AudioLevelChanged, EventPolicy{});  // Deliver every event
+
+    m_dispatcher->subscribe(EventType::AudioLevelChanged, [&](const Event& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(static_cast<int>(e.get<AudioLevelPayload>()->level));
+    });
+
+    for (int i = 0; i < numEvents; ++i) {
+        m_dispatcher->publish(EventType::AudioLevelChanged,
+                              EventDataFactory::createAudioLevelData(static_cast<float>(i)));
+    }
+
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received.size() == numEvents;
+    }));
+
+    for (int i = 0; i < numEvents; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+}
+
+TEST_F(EventDispatcherTest, DoesNotCreateThreadPerDelivery) {
+    std::mutex mutex;
+    std::vector<std::thread::id> threadIds;
+
+    m_dispatcher->setEventPolicy(EventType::AudioLevelChanged, EventPolicy{});
+
+    for (int l = 0; l < 4; ++l) {
+        m_dispatcher->subscribe(EventType::AudioLevelChanged, [&](const Event&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto id = std::this_thread::get_id();
+            if (std::find(threadIds.begin(), threadIds.end(), id) == threadIds.end()) {
+                threadIds.push_back(id);
+            }
+        });
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        m_dispatcher->publish(EventType::AudioLevelChanged);
+    }
+
+    ASSERT_TRUE(waitFor([&] { return m_dispatcher->getStats().eventsDelivered == 200; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // 800 invocations, but only ever on the fixed delivery threads
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_LE(threadIds.size(), 2u);
+}
+
+TEST_F(EventDispatcherTest, WatchdogFlagsSlowListenerWithoutAbandoningIt) {
+    m_dispatcher->setDeliveryTimeout(std::chrono::milliseconds(20));
+
+    std::atomic<bool> slowFinished{false};
+    std::atomic<int> fastCount{0};
+
+    auto slowHandle = m_dispatcher->subscribe(EventType::ProcessingStatsUpdated, [&](const Event&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        slowFinished = true;
+    });
+    auto fastHandle = m_dispatcher->subscribe(EventType::ProcessingStatsUpdated, [&](const Event&) {
+        fastCount++;
+    });
+
+    m_dispatcher->publish(EventType::ProcessingStatsUpdated);
+
+    // The fast listener is not held up behind the slow one
+    EXPECT_TRUE(waitFor([&] { return fastCount == 1; }, std::chrono::milliseconds(100)));
+
+    EXPECT_TRUE(waitFor([&] { return m_dispatcher->isListenerSlow(slowHandle); }));
+    EXPECT_FALSE(m_dispatcher->isListenerSlow(fastHandle));
+
+    auto stats = m_dispatcher->getStats();
+    EXPECT_GE(stats.deliveryTimeouts, 1u);
+    EXPECT_EQ(stats.slowListeners, 1u);
+
+    // The slow invocation runs to completion rather than being detached
+    EXPECT_TRUE(waitFor([&] { return slowFinished.load(); }));
+}
+
+TEST_F(EventDispatcherTest, ListenerExceptionDoesNotStopDelivery) {
+    std::atomic<int> count{0};
+
+    m_dispatcher->subscribe(EventType::ErrorOccurred, [](const Event&) {
+        throw std::runtime_error("listener failure");
+    });
+    m_dispatcher->subscribe(EventType::ErrorOccurred, [&](const Event&) { count++; });
+
+    m_dispatcher->publish(EventType::ErrorOccurred);
+    m_dispatcher->publish(EventType::ErrorOccurred);
+
+    EXPECT_TRUE(waitFor([&] { return count == 2; }));
+}
+
+TEST_F(EventDispatcherTest, UnsubscribeStopsDelivery) {
+    std::atomic<int> count{0};
+
+    auto handle = m_dispatcher->subscribe(EventType::WindowHidden, [&](const Event&) { count++; });
+    m_dispatcher->publish(EventType::WindowHidden);
+    ASSERT_TRUE(waitFor([&] { return count == 1; }));
+
+    EXPECT_TRUE(m_dispatcher->unsubscribe(handle));
+    EXPECT_FALSE(m_dispatcher->unsubscribe(handle));
+
+    m_dispatcher->publish(EventType::WindowHidden);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(count, 1);
+}
+
+TEST_F(EventDispatcherTest, HasSubscribersTracksTypedAndGlobalListeners) {
+    EXPECT_FALSE(m_dispatcher->hasSubscribers(EventType::AudioLevelChanged));
+
+    auto typed = m_dispatcher->subscribe(EventType::AudioLevelChanged, [](const Event&) {},
+                                         DeliveryMode::MessageThread);
+    EXPECT_TRUE(m_dispatcher->hasSubscribers(EventType::AudioLevelChanged));
+    EXPECT_FALSE(m_dispatcher->hasSubscribers(EventType::WindowShown));
+
+    // Filtered types have no audience either
+    m_dispatcher->setEventFilter(EventType::AudioLevelChanged, false);
+    EXPECT_FALSE(m_dispatcher->hasSubscribers(EventType::AudioLevelChanged));
+    m_dispatcher->setEventFilter(EventType::AudioLevelChanged, true);
+
+    m_dispatcher->unsubscribe(typed);
+    EXPECT_FALSE(m_dispatcher->hasSubscribers(EventType::AudioLevelChanged));
+
+    m_dispatcher->subscribeAll([](const Event&) {});
+    EXPECT_TRUE(m_dispatcher->hasSubscribers(EventType::AudioLevelChanged));
+    EXPECT_TRUE(m_dispatcher->hasSubscribers(EventType::WindowShown));
+
+    m_dispatcher->unsubscribeAll();
+    EXPECT_FALSE(m_dispatcher->hasSubscribers(EventType::WindowShown));
+}
+
+TEST_F(EventDispatcherTest, PublishImmediateRunsOnCallerThread) {
+    std::thread::id listenerThread;
+
+    m_dispatcher->subscribe(EventType::ApplicationShutdown, [&](const Event&) {
+        listenerThread = std::this_thread::get_id();
+    });
+
+    m_dispatcher->publishImmediate(EventType::ApplicationShutdown);
+
+    EXPECT_EQ(listenerThread, std::this_thread::get_id());
+}
+
+TEST_F(EventDispatcherTest, PublishRTDeliversPayload) {
+    std::atomic<bool> received{false};
+    float level = 0.0f;
+    bool isInput = true;
+    std::atomic<int> reductionLevel{0};
+
+    m_dispatcher->subscribe(EventType::AudioLevelChanged, [&](const Event& e) {
+        level = e.get<AudioLevelPayload>()->level;
+        isInput = e.get<AudioLevelPayload>()->isInput;
+        received = true;
+    });
+    m_dispatcher->subscribe(EventType::NoiseReductionLevelChanged, [&](const Event& e) {
+        reductionLevel = e.get<NoiseReductionPayload>()->level;
+    });
+
+    NoiseReductionPayload config;
+    config.level = 2;
+    EXPECT_TRUE(m_dispatcher->publishRT(EventType::AudioLevelChanged,
+                                        EventDataFactory::createAudioLevelData(0.25f, false)));
+    EXPECT_TRUE(m_dispatcher->publishRT(EventType::NoiseReductionLevelChanged, config));
+
+    ASSERT_TRUE(waitFor([&] { return received && reductionLevel != 0; }));
+    EXPECT_FLOAT_EQ(level, 0.25f);
+    EXPECT_FALSE(isInput);
+    EXPECT_EQ(reductionLevel, 2);
+}
+
+TEST_F(EventDispatcherTest, PublishRTDropsWhenRingIsFull) {
+    m_dispatcher->stop();
+    m_dispatcher->setRealtimeQueueCapacity(4);
+
+    // Not running: nothing is accepted
+    EXPECT_FALSE(m_dispatcher->publishRT(EventType::WindowShown));
+
+    m_dispatcher->start();
+
+    // The dispatcher thread only polls the ring periodically while idle, so a
+    // quick burst overflows the four slots
+    int accepted = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (m_dispatcher->publishRT(EventType::WindowHidden)) {
+            accepted++;
+        }
+    }
+
+    EXPECT_GE(accepted, 4);
+    EXPECT_LT(accepted, 10);
+    auto stats = m_dispatcher->getStats();
+    EXPECT_EQ(stats.eventsDropped, static_cast<uint64_t>(10 - accepted));
+}
+
+TEST_F(EventDispatcherTest, PublishRTFromManyProducers) {
+    const int numProducers = 4;
+    const int eventsPerProducer = 200;
+    std::atomic<int> count{0};
+    std::mutex mutex;
+    std::vector<std::vector<int>> perProducer(numProducers);
+
+    m_dispatcher->setRealtimePollInterval(std::chrono::milliseconds(1));
+    m_dispatcher->subscribe(EventType::ErrorOccurred, [&](const Event& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto* payload = e.get<ErrorPayload>();
+        perProducer[payload->errorCode].push_back(std::atoi(payload->message.c_str()));
+        count++;
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < eventsPerProducer; ++i) {
+                auto payload = EventDataFactory::createErrorData(std::to_string(i), p);
+                while (!m_dispatcher->publishRT(EventType::ErrorOccurred, payload)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    ASSERT_TRUE(waitFor([&] { return count == numProducers * eventsPerProducer; }));
+
+    // Each producer's events arrive in the order they were published
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& sequences : perProducer) {
+        ASSERT_EQ(sequences.size(), static_cast<size_t>(eventsPerProducer));
+        EXPECT_TRUE(std::is_sorted(sequences.begin(), sequences.end()));
+    }
+}
+
+TEST_F(EventDispatcherTest, TypedPayloadIsStoredInline) {
+    Event event(EventType::ProcessingStatsUpdated, EventDataFactory::createProcessingStatsData(12.5f, 3.0f, 0.8f));
+
+    ASSERT_NE(event.get<ProcessingStatsPayload>(), nullptr);
+    EXPECT_EQ(event.get<AudioLevelPayload>(), nullptr);
+    EXPECT_EQ(event.data, nullptr);
+    EXPECT_FLOAT_EQ(event.get<ProcessingStatsPayload>()->cpuUsage, 12.5f);
+}
+
+TEST_F(EventDispatcherTest, GetValueAdapterReadsPayloadAndData) {
+    Event error(EventType::ErrorOccurred, EventDataFactory::createErrorData("disk full", 28));
+    EXPECT_EQ(error.getValue<std::string>("message"), "disk full");
+    EXPECT_EQ(error.getValue<int>("error_code"), 28);
+    EXPECT_EQ(error.getValue<int>("missing", -1), -1);
+    EXPECT_EQ(error.getValue<float>("error_code", 1.5f), 1.5f);  // Wrong type falls back
+
+    auto data = std::make_shared<EventData>();
+    data->setValue("custom", 7);
+    Event custom(EventType::SettingsChanged, data);
+    EXPECT_EQ(custom.getValue<int>("custom"), 7);
+}
+
+TEST_F(EventDispatcherTest, LongErrorMessagesAreTruncated) {
+    std::string message(1000, 'x');
+    auto payload = EventDataFactory::createErrorData(message);
+
+    EXPECT_EQ(payload.message.size(), payload.message.capacity());
+    EXPECT_EQ(payload.message.str(), message.substr(0, payload.message.capacity()));
+}
+
+TEST_F(EventDispatcherTest, CoalescedTypeDeliversLatestValue) {
+    const int numEvents = 1000;
+    std::atomic<int> received{0};
+    std::atomic<int> lastLevel{-1};
+
+    m_dispatcher->subscribe(EventType::AudioLevelChanged, [&](const Event& e) {
+        lastLevel = static_cast<int>(e.get<AudioLevelPayload>()->level);
+        received++;
+    });
+
+    ASSERT_TRUE(m_dispatcher->getEventPolicy(EventType::AudioLevelChanged).coalesce);
+
+    for (int i = 0; i < numEvents; ++i) {
+        m_dispatcher->publish(EventType::AudioLevelChanged,
+                              EventDataFactory::createAudioLevelData(static_cast<float>(i)));
+    }
+
+    ASSERT_TRUE(waitFor([&] { return lastLevel == numEvents - 1; }));
+
+    // Every event was either delivered or superseded by a newer one
+    auto stats = m_dispatcher->getStats();
+    EXPECT_EQ(stats.eventsDelivered + stats.eventsCoalesced, static_cast<uint64_t>(numEvents));
+    EXPECT_EQ(stats.eventsDropped, 0u);
+    EXPECT_LE(received, numEvents);
+}
+
+TEST_F(EventDispatcherTest, RateLimitHoldsNewestEventForNextSlot) {
+    EventPolicy policy;
+    policy.maxRateHz = 10.0;  // One delivery per 100 ms
+    m_dispatcher->setEventPolicy(EventType::SettingsChanged, policy);
+
+    std::mutex mutex;
+    std::vector<int> received;
+    m_dispatcher->subscribe(EventType::SettingsChanged, [&](const Event& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(e.get<ErrorPayload>()->errorCode);
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        m_dispatcher->publish(EventType::SettingsChanged, EventDataFactory::createErrorData("", i));
+    }
+
+    // First event passes straight through, the rest collapse into the newest
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received.size() == 2;
+    }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0], 0);
+    EXPECT_EQ(received[1], 9);
+}
+
+TEST_F(EventDispatcherTest, PriorityEventsOvertakeBacklog) {
+    std::mutex mutex;
+    std::vector<EventType> received;
+
+    m_dispatcher->subscribeAll([&](const Event& e) {
+        bool first;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            first = received.empty();
+            received.push_back(e.type);
+        }
+        if (first) {
+            // Let a backlog build up behind the first event
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+
+    for (int i = 0; i < 50; ++i) {
+        m_dispatcher->publish(EventType::WindowShown);
+    }
+    m_dispatcher->publish(EventType::AudioDeviceError);
+    m_dispatcher->publish(EventType::ApplicationShutdown);
+
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received.size() == 52;
+    }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto error = std::find(received.begin(), received.end(), EventType::AudioDeviceError);
+    auto shutdown = std::find(received.begin(), received.end(), EventType::ApplicationShutdown);
+    ASSERT_NE(shutdown, received.end());
+    EXPECT_LT(std::distance(received.begin(), shutdown), 5);
+
+    // Priority events overtake the backlog but keep their own order
+    EXPECT_LT(std::distance(received.begin(), error), std::distance(received.begin(), shutdown));
+}
+
+TEST_F(EventDispatcherTest, CoalescedEventsAreNotStarvedByRegularTraffic) {
+    std::mutex mutex;
+    std::vector<EventType> received;
+    std::atomic<bool> gateOpen{false};
+
+    // Holds the processing thread, so a backlog of regular events builds up
+    // in the dispatcher queue behind it
+    m_dispatcher->subscribe(EventType::SettingsChanged, [&](const Event&) {
+        while (!gateOpen.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }, DeliveryMode::Direct);
+
+    m_dispatcher->subscribeAll([&](const Event& e) {
+        if (e.type != EventType::SettingsChanged) {
+            std::lock_guard<std::mutex> lock(mutex);
+            received.push_back(e.type);
+        }
+    });
+
+    ASSERT_TRUE(m_dispatcher->publishRT(EventType::SettingsChanged));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    for (int i = 0; i < 200; ++i) {
+        m_dispatcher->publish(EventType::WindowShown);
+    }
+    m_dispatcher->publish(EventType::AudioLevelChanged, EventDataFactory::createAudioLevelData(0.5f));
+    for (int i = 0; i < 200; ++i) {
+        m_dispatcher->publish(EventType::WindowShown);
+    }
+    gateOpen = true;
+
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received.size() == 401;
+    }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto level = std::find(received.begin(), received.end(), EventType::AudioLevelChanged);
+    ASSERT_NE(level, received.end());
+    EXPECT_LE(std::distance(received.begin(), level), 16);
+}
+
+TEST_F(EventDispatcherTest, SubscribeAndUnsubscribeWhilePublishing) {
+    std::atomic<bool> running{true};
+    std::atomic<int> stableCount{0};
+
+    m_dispatcher->subscribe(EventType::WindowShown, [&](const Event&) { stableCount++; });
+
+    // Registry churn from another thread while events are being delivered
+    std::thread churn([&] {
+        while (running) {
+            auto handle = m_dispatcher->subscribe(EventType::WindowShown, [](const Event&) {});
+            auto global = m_dispatcher->subscribeAll([](const Event&) {});
+            m_dispatcher->unsubscribe(handle);
+            m_dispatcher->unsubscribe(global);
+        }
+    });
+
+    const int numEvents = 2000;
+    for (int i = 0; i < numEvents; ++i) {
+        if (i % 2 == 0) {
+            m_dispatcher->publish(EventType::WindowShown);
+        } else {
+            m_dispatcher->publishImmediate(EventType::WindowShown);
+        }
+    }
+
+    EXPECT_TRUE(waitFor([&] { return stableCount == numEvents; }));
+    running = false;
+    churn.join();
+
+    EXPECT_EQ(m_dispatcher->getStats().activeListeners, 1u);
+}
+
+TEST_F(EventDispatcherTest, DirectListenerRunsBeforePublishReturns) {
+    std::thread::id listenerThread;
+    int received = 0;
+
+    m_dispatcher->subscribe(EventType::WindowShown, [&](const Event&) {
+        listenerThread = std::this_thread::get_id();
+        received++;
+    }, DeliveryMode::Direct);
+
+    m_dispatcher->publish(EventType::WindowShown);
+    EXPECT_EQ(received, 1);
+    EXPECT_EQ(listenerThread, std::this_thread::get_id());
+
+    m_dispatcher->publishImmediate(EventType::WindowShown);
+    EXPECT_EQ(received, 2);
+}
+
+TEST_F(EventDispatcherTest, DirectListenerSeesRealtimeEventsOffPublisherThread) {
+    std::atomic<bool> received{false};
+    std::thread::id listenerThread;
+
+    m_dispatcher->subscribe(EventType::AudioLevelChanged, [&](const Event& e) {
+        EXPECT_FLOAT_EQ(e.get<AudioLevelPayload>()->level, 0.5f);
+        listenerThread = std::this_thread::get_id();
+        received = true;
+    }, DeliveryMode::Direct);
+
+    ASSERT_TRUE(m_dispatcher->publishRT(EventType::AudioLevelChanged,
+                                        EventDataFactory::createAudioLevelData(0.5f)));
+
+    ASSERT_TRUE(waitFor([&] { return received.load(); }));
+    EXPECT_NE(listenerThread, std::this_thread::get_id());
+}
+
+TEST_F(EventDispatcherTest, MessageThreadListenersAreBatchedPerFrame) {
+    std::mutex tasksMutex;
+    std::vector<std::function<void()>> tasks;
+    m_dispatcher->setMessageThreadExecutor([&](std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        tasks.push_back(std::move(task));
+    });
+    m_dispatcher->setMessageThreadFrameRate(20.0);
+
+    std::vector<std::thread::id> threads;
+    m_dispatcher->subscribe(EventType::WindowShown, [&](const Event&) {
+        threads.push_back(std::this_thread::get_id());
+    }, DeliveryMode::MessageThread);
+
+    const int numEvents = 100;
+    for (int i = 0; i < numEvents; ++i) {
+        m_dispatcher->publish(EventType::WindowShown);
+    }
+
+    // Act as the message loop: run posted tasks until every event has arrived
+    ASSERT_TRUE(waitFor([&] {
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(tasksMutex);
+            pending.swap(tasks);
+        }
+        for (auto& task : pending) {
+            task();
+        }
+        return threads.size() == static_cast<size_t>(numEvents);
+    }));
+
+    // One post per frame, not one per event
+    EXPECT_LT(m_dispatcher->getStats().messageThreadPosts, 10u);
+    for (const auto& id : threads) {
+        EXPECT_EQ(id, std::this_thread::get_id());
+    }
+}
+
+TEST_F(EventDispatcherTest, MessageThreadQueueCanBeDrainedManually) {
+    int received = 0;
+    auto handle = m_dispatcher->subscribeAll([&](const Event&) { received++; },
+                                             DeliveryMode::MessageThread);
+
+    m_dispatcher->publishImmediate(EventType::WindowShown);
+    m_dispatcher->publishImmediate(EventType::WindowHidden);
+    EXPECT_EQ(received, 0);
+
+    EXPECT_EQ(m_dispatcher->drainMessageThreadQueue(), 2u);
+    EXPECT_EQ(received, 2);
+
+    // Batched events for a removed listener are discarded
+    m_dispatcher->publishImmediate(EventType::WindowShown);
+    m_dispatcher->unsubscribe(handle);
+    EXPECT_EQ(m_dispatcher->drainMessageThreadQueue(), 0u);
+    EXPECT_EQ(received, 2);
+}
+
+TEST_F(EventDispatcherTest, TracingRecordsPublishesAndInvocations) {
+    std::atomic<int> received{0};
+    auto handle = m_dispatcher->subscribe(EventType::WindowShown, [&](const Event&) { received++; });
+
+    m_dispatcher->publish(EventType::WindowHidden);  // Not traced yet
+    m_dispatcher->enableTracing(256);
+    m_dispatcher->publish(EventType::WindowShown);
+    m_dispatcher->publishImmediate(EventType::WindowShown);
+    ASSERT_TRUE(waitFor([&] { return received == 2; }));
+
+    // The delivery thread records after the listener returns
+    std::vector<EventTraceRecord> trace;
+    ASSERT_TRUE(waitFor([&] {
+        trace = m_dispatcher->getTrace();
+        return trace.size() == 4;
+    }));
+
+    int publishes = 0;
+    int deliveries = 0;
+    for (const auto& record : trace) {
+        EXPECT_EQ(record.type, static_cast<uint16_t>(EventType::WindowShown));
+        EXPECT_NE(record.threadId, 0u);
+        if (record.kind == EventTraceRecord::Kind::Publish) {
+            publishes++;
+        } else {
+            deliveries++;
+            EXPECT_EQ(record.listenerId, handle);
+            EXPECT_GE(record.startNs, record.timestampNs);
+        }
+    }
+    EXPECT_EQ(publishes, 2);
+    EXPECT_EQ(deliveries, 2);
+
+    m_dispatcher->disableTracing();
+    m_dispatcher->publishImmediate(EventType::WindowShown);
+    EXPECT_EQ(m_dispatcher->getTrace().size(), 4u);
+}
+
+TEST_F(EventDispatcherTest, DumpsTraceOnAudioDeviceError) {
+    auto path = (std::filesystem::temp_directory_path() / "quiet_dispatcher_error.qtrace").string();
+    std::filesystem::remove(path);
+
+    m_dispatcher->enableTracing();
+    m_dispatcher->setTraceDumpPath(path);
+    m_dispatcher->publish(EventType::AudioLevelChanged, EventDataFactory::createAudioLevelData(0.1f));
+    m_dispatcher->publish(EventType::AudioDeviceError, EventDataFactory::createErrorData("device lost"));
+
+    ASSERT_TRUE(waitFor([&] { return std::filesystem::exists(path); }));
+
+    std::vector<EventTraceRecord> records;
+    ASSERT_TRUE(waitFor([&] { return EventTraceBuffer::readFile(path, records); }));
+    EXPECT_GE(records.size(), 2u);
+
+    std::filesystem::remove(path);
+}
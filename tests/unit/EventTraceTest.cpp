@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "quiet/core/EventTrace.h"
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace quiet::core;
+
+namespace {
+
+EventTraceRecord makeDeliverRecord(uint64_t timestamp) {
+    EventTraceRecord record;
+    record.kind = EventTraceRecord::Kind::Deliver;
+    record.type = 7;
+    record.timestampNs = timestamp;
+    record.startNs = timestamp + 500;
+    record.durationNs = 1200;
+    record.threadId = 42;
+    record.listenerId = 3;
+    return record;
+}
+
+} // namespace
+
+TEST(EventTraceTest, KeepsMostRecentRecordsInOrder) {
+    EventTraceBuffer buffer(8);
+
+    for (uint64_t i = 0; i < 20; ++i) {
+        buffer.record(makeDeliverRecord(i));
+    }
+
+    auto records = buffer.snapshot();
+    ASSERT_EQ(records.size(), 8u);
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].timestampNs, 12 + i);
+    }
+    EXPECT_EQ(records.back().queueLatencyNs(), 500u);
+
+    buffer.clear();
+    EXPECT_TRUE(buffer.snapshot().empty());
+}
+
+TEST(EventTraceTest, ConcurrentWritersDoNotTearRecords) {
+    EventTraceBuffer buffer(1024);
+    std::vector<std::thread> writers;
+
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&buffer, t] {
+            for (uint64_t i = 0; i < 5000; ++i) {
+                EventTraceRecord record = makeDeliverRecord(i);
+                record.listenerId = static_cast<uint32_t>(t);
+                record.durationNs = i * 10 + static_cast<uint64_t>(t);
+                buffer.record(record);
+            }
+        });
+    }
+
+    // Snapshots taken mid-write only ever contain complete records
+    for (int i = 0; i < 50; ++i) {
+        for (const auto& record : buffer.snapshot()) {
+            EXPECT_EQ(record.durationNs, record.timestampNs * 10 + record.listenerId);
+        }
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    // A record may be dropped when its slot is still held by a writer a lap behind
+    EXPECT_EQ(buffer.recorded(), 20000u);
+    EXPECT_LE(buffer.snapshot().size(), 1024u);
+    EXPECT_GT(buffer.snapshot().size(), 1000u);
+}
+
+TEST(EventTraceTest, ClearDuringConcurrentWritesLosesNoSlots) {
+    EventTraceBuffer buffer(256);
+    std::vector<std::thread> writers;
+
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&buffer] {
+            for (uint64_t i = 0; i < 5000; ++i) {
+                buffer.record(makeDeliverRecord(i));
+            }
+        });
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        buffer.clear();
+        std::this_thread::yield();
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    // Every claimed index and every skipped lap is accounted for, so no two
+    // writers were handed the same index
+    EXPECT_EQ(buffer.recorded(), 20000u + 100u * buffer.capacity());
+
+    buffer.clear();
+    buffer.record(makeDeliverRecord(1));
+    buffer.record(makeDeliverRecord(2));
+    auto records = buffer.snapshot();
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].timestampNs, 1u);
+    EXPECT_EQ(records[1].timestampNs, 2u);
+}
+
+TEST(EventTraceTest, FileRoundTrip) {
+    std::vector<EventTraceRecord> records;
+    EventTraceRecord publish;
+    publish.type = 2;
+    publish.timestampNs = 123456789;
+    publish.queueDepth = 17;
+    publish.threadId = 9;
+    records.push_back(publish);
+    records.push_back(makeDeliverRecord(123456789));
+
+    auto path = (std::filesystem::temp_directory_path() / "quiet_event_trace_test.qtrace").string();
+    ASSERT_TRUE(EventTraceBuffer::writeFile(path, records));
+    EXPECT_EQ(std::filesystem::file_size(path), 16u + 40u * records.size());
+
+    std::vector<EventTraceRecord> loaded;
+    ASSERT_TRUE(EventTraceBuffer::readFile(path, loaded));
+    ASSERT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(loaded[0].kind, EventTraceRecord::Kind::Publish);
+    EXPECT_EQ(loaded[0].queueDepth, 17u);
+    EXPECT_EQ(loaded[0].type, 2u);
+    EXPECT_EQ(loaded[1].kind, EventTraceRecord::Kind::Deliver);
+    EXPECT_EQ(loaded[1].durationNs, 1200u);
+    EXPECT_EQ(loaded[1].listenerId, 3u);
+    EXPECT_EQ(loaded[1].threadId, 42u);
+
+    std::filesystem::remove(path);
+    EXPECT_FALSE(EventTraceBuffer::readFile(path, loaded));
+}
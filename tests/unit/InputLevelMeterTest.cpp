@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "quiet/core/AudioBuffer.h"
+#include "quiet/core/EventDispatcher.h"
+#include "quiet/core/InputLevelMeter.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace quiet::core;
+
+namespace {
+
+void fillBlock(AudioBuffer& buffer, float amplitude) {
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        float* samples = buffer.getWritePointer(ch);
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            samples[i] = (i % 2 == 0) ? amplitude : -amplitude;
+        }
+    }
+}
+
+} // namespace
+
+TEST(InputLevelMeterTest, SkipsMeteringWithoutSubscribers) {
+    EventDispatcher dispatcher;
+    InputLevelMeter meter(dispatcher);
+    AudioBuffer block(2, 480, 48000.0);
+    fillBlock(block, 0.5f);
+
+    for (int i = 0; i < 10; ++i) {
+        meter.process(block, 2, 480);
+    }
+    EXPECT_EQ(meter.getLevel(), 0.0f);
+}
+
+TEST(InputLevelMeterTest, SmoothsTowardsBlockLevelAndPublishes) {
+    EventDispatcher dispatcher;
+    dispatcher.start();
+    std::atomic<int> published{0};
+    dispatcher.subscribe(EventType::AudioLevelChanged, [&](const Event&) { ++published; });
+
+    InputLevelMeter meter(dispatcher);
+    AudioBuffer block(2, 480, 48000.0);
+    fillBlock(block, 0.1f);  // -20 dB: 2/3 of the way up the -60..0 dB range
+
+    meter.process(block, 2, 480);
+    float first = meter.getLevel();
+    EXPECT_GT(first, 0.0f);
+
+    for (int i = 0; i < 200; ++i) {
+        meter.process(block, 2, 480);
+    }
+    EXPECT_NEAR(meter.getLevel(), 2.0f / 3.0f, 1e-3f);
+    EXPECT_GT(meter.getLevel(), first);
+
+    // The first block publishes; the rest fall inside the throttle interval
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (published.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_GE(published.load(), 1);
+
+    meter.reset();
+    EXPECT_EQ(meter.getLevel(), 0.0f);
+    dispatcher.stop();
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "quiet/core/LogFrequencyBands.h"
+#include <vector>
+
+using namespace quiet::core;
+
+TEST(LogFrequencyBandsTest, BandsCoverAxisInOrder) {
+    LogFrequencyBands bands;
+    bands.configure(64, 2048, 48000.0);
+
+    ASSERT_EQ(bands.size(), 64u);
+    EXPECT_FLOAT_EQ(bands.minHz(), 23.4375f);  // Clamped up to the first bin
+    EXPECT_FLOAT_EQ(bands.maxHz(), 20000.0f);
+
+    const auto& list = bands.bands();
+    EXPECT_NEAR(list.front().lowHz, bands.minHz(), 0.01f);
+    EXPECT_NEAR(list.back().highHz, 20000.0f, 0.1f);
+    for (size_t i = 0; i < list.size(); ++i) {
+        EXPECT_GE(list[i].firstBin, 1);
+        EXPECT_LE(list[i].firstBin, list[i].lastBin);
+        EXPECT_LT(list[i].lastBin, 1024);
+        if (i > 0) {
+            EXPECT_NEAR(list[i].lowHz, list[i - 1].highHz, 0.01f);
+            EXPECT_GE(list[i].firstBin, list[i - 1].firstBin);
+        }
+    }
+
+    // High bands aggregate many bins; bins are never skipped between them
+    EXPECT_GT(list.back().lastBin - list.back().firstBin, 10);
+    for (size_t i = 1; i < list.size(); ++i) {
+        if (list[i].firstBin != list[i - 1].firstBin) {
+            EXPECT_EQ(list[i].firstBin, list[i - 1].lastBin + 1);
+        }
+    }
+
+    EXPECT_FLOAT_EQ(bands.proportionOfFrequency(bands.minHz()), 0.0f);
+    EXPECT_NEAR(bands.proportionOfFrequency(20000.0f), 1.0f, 1e-5f);
+}
+
+TEST(LogFrequencyBandsTest, MaxFrequencyFollowsSampleRate) {
+    LogFrequencyBands bands;
+    bands.configure(32, 1024, 16000.0);
+    EXPECT_FLOAT_EQ(bands.maxHz(), 8000.0f);
+    EXPECT_EQ(bands.bands().back().lastBin, 511);
+
+    bands.configure(32, 1024, 0.0);
+    EXPECT_EQ(bands.size(), 0u);
+}
+
+TEST(LogFrequencyBandsTest, AggregateTakesPeakOfEachBand) {
+    LogFrequencyBands bands;
+    bands.configure(16, 512, 48000.0);
+
+    std::vector<float> magnitudes(256, -100.0f);
+    magnitudes[200] = -3.0f;
+
+    std::vector<float> bandDb(bands.size());
+    bands.aggregate(magnitudes.data(), magnitudes.size(), bandDb.data());
+
+    int loudBands = 0;
+    for (size_t i = 0; i < bandDb.size(); ++i) {
+        const auto& band = bands.bands()[i];
+        bool containsPeak = band.firstBin <= 200 && band.lastBin >= 200;
+        EXPECT_EQ(bandDb[i], containsPeak ? -3.0f : -100.0f);
+        loudBands += containsPeak ? 1 : 0;
+    }
+    EXPECT_EQ(loudBands, 1);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "quiet/utils/Logger.h"
+#include "quiet/utils/StructuredLog.h"
+#include "LoopbackLogServer.h"
 #include <fstream>
 #include <filesystem>
 #include <thread>
@@ -122,6 +124,51 @@ TEST_F(LoggerTest, MultiThreadedLogging) {
     EXPECT_EQ(lineCount, numThreads * logsPerThread);
 }
 
+TEST_F(LoggerTest, ReconfigureWhileLogging) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_reconfigure.log";
+    config.minLevel = LogLevel::INFO;
+    config.queueSize = 8192;
+    logger.configure(config);
+    uint64_t droppedBefore = logger.getDroppedCount();
+    
+    const int numThreads = 4;
+    const int logsPerThread = 500;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([i, logsPerThread]() {
+            for (int j = 0; j < logsPerThread; ++j) {
+                LOGF_INFO("Thread {} log {}", i, j);
+            }
+        });
+    }
+    
+    // Each configure() swaps the queue out from under the producers; records
+    // already queued in the old one are written before it is freed
+    for (int i = 0; i < 20; ++i) {
+        logger.configure(config);
+    }
+    
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger.flush();
+    
+    std::ifstream logFile(config.logFilePath);
+    int lineCount = 0;
+    std::string line;
+    while (std::getline(logFile, line)) {
+        lineCount++;
+    }
+    
+    EXPECT_EQ(logger.getDroppedCount(), droppedBefore);
+    EXPECT_EQ(lineCount, numThreads * logsPerThread);
+}
+
 TEST_F(LoggerTest, PerformanceLogging) {
     Logger& logger = Logger::getInstance();
     
@@ -288,4 +335,300 @@ TEST_F(LoggerTest, QueueOverflow) {
     // Should have some messages, but not all 100
     EXPECT_GT(lineCount, 0);
     EXPECT_LT(lineCount, 100);
-}
\ No newline at end of file
+}
+
+TEST_F(LoggerTest, LongMessagesAreTruncated) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_truncate.log";
+    logger.configure(config);
+    
+    // Records are fixed-size, so oversized text is cut rather than allocated
+    std::string longMessage(1000, 'x');
+    LOG_INFO(longMessage);
+    logger.flush();
+    
+    std::ifstream logFile(config.logFilePath);
+    std::string line;
+    ASSERT_TRUE(std::getline(logFile, line));
+    
+    EXPECT_NE(line.find(std::string(LogRecord{}.message.capacity(), 'x')), std::string::npos);
+    EXPECT_EQ(line.find(std::string(LogRecord{}.message.capacity() + 1, 'x')), std::string::npos);
+}
+
+TEST_F(LoggerTest, DeferredFormatArguments) {
+    char buffer[256];
+    detail::LogArgEncoder encoder(buffer, sizeof(buffer));
+    encoder.add(42);
+    encoder.add(std::string("mic"));
+    encoder.add(0.5);
+    encoder.add(true);
+    encoder.add(255u);
+    
+    std::string text = detail::formatLogArgs("{} {} {:.2f} {} {:x} {{}}", buffer, encoder.size());
+    EXPECT_EQ(text, "42 mic 0.50 true ff {}");
+    
+    // Missing arguments are shown rather than read past the end
+    EXPECT_EQ(detail::formatLogArgs("{} and {}", buffer, 9), "42 and ?");
+    
+    static_assert(detail::countLogPlaceholders("{} {:.1f} {{}}") == 2, "placeholder count");
+}
+
+TEST_F(LoggerTest, DeferredFormatLogging) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_deferred.log";
+    config.minLevel = LogLevel::INFO;
+    logger.configure(config);
+    logger.setFormatter(nullptr);
+    
+    const char* device = "Built-in Microphone";
+    LOGF_INFO("Opened {} at {} Hz", device, 48000);
+    LOGF_DEBUG("Filtered {}", 1);
+    logger.flush();
+    
+    std::ifstream logFile(config.logFilePath);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(logFile, line)) {
+        lines.push_back(line);
+    }
+    
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("Opened Built-in Microphone at 48000 Hz"), std::string::npos);
+    EXPECT_NE(lines[0].find("LoggerTest.cpp"), std::string::npos);
+}
+
+TEST_F(LoggerTest, RotationKeepsEveryLine) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_rotate_all.log";
+    config.maxFileSize = 1024;
+    config.maxFiles = 100;
+    logger.configure(config);
+    logger.setFormatter(nullptr);
+    
+    for (int i = 0; i < 50; ++i) {
+        LOGF_INFO("Line {} {}", i, std::string(60, 'Y'));
+    }
+    logger.flush();
+    
+    // Lines are batched, but files still rotate before passing the limit
+    size_t lines = 0;
+    size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator("logs")) {
+        if (entry.path().stem().string().find("test_rotate_all") != 0) {
+            continue;
+        }
+        files++;
+        EXPECT_LE(std::filesystem::file_size(entry.path()), config.maxFileSize);
+        
+        std::ifstream logFile(entry.path());
+        std::string line;
+        while (std::getline(logFile, line)) {
+            lines++;
+        }
+    }
+    
+    EXPECT_GT(files, 1u);
+    EXPECT_EQ(lines, 50u);
+}
+
+TEST_F(LoggerTest, RemoteLoggingOverTcp) {
+    quiet::test::LoopbackLogServer server(quiet::test::LoopbackLogServer::Protocol::Tcp);
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = false;
+    logger.configure(config);
+    logger.setFormatter(nullptr);
+    
+    RemoteLogConfig remote;
+    remote.host = "127.0.0.1";
+    remote.port = server.port();
+    remote.spillPath.clear();
+    logger.configureRemote(remote);
+    
+    for (int i = 0; i < 100; ++i) {
+        LOGF_INFO("Remote line {}", i);
+    }
+    logger.flush();
+    
+    EXPECT_TRUE(server.waitForLines(100, std::chrono::seconds(5)));
+    logger.disableRemote();
+    
+    auto lines = server.lines();
+    ASSERT_FALSE(lines.empty());
+    EXPECT_NE(lines.back().find("Remote line 99"), std::string::npos);
+    EXPECT_EQ(logger.getRemoteStats().connects, 1u);
+}
+
+TEST_F(LoggerTest, ReconfigureWhileRemoteLogging) {
+    quiet::test::LoopbackLogServer server(quiet::test::LoopbackLogServer::Protocol::Tcp);
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = false;
+    logger.configure(config);
+    logger.setFormatter(nullptr);
+    
+    RemoteLogConfig remote;
+    remote.host = "127.0.0.1";
+    remote.port = server.port();
+    remote.spillPath.clear();
+    logger.configureRemote(remote);
+    
+    std::thread producer([] {
+        for (int i = 0; i < 500; ++i) {
+            LOGF_INFO("Remote line {}", i);
+        }
+    });
+    
+    // The remote thread formats with the settings configure() replaces
+    for (int i = 0; i < 20; ++i) {
+        config.dateFormat = (i % 2 == 0) ? "%H:%M:%S" : "%Y-%m-%d %H:%M:%S";
+        config.includeThreadId = (i % 2 == 0);
+        logger.configure(config);
+    }
+    
+    producer.join();
+    logger.flush();
+    
+    EXPECT_TRUE(server.waitForLines(500, std::chrono::seconds(5)));
+    logger.disableRemote();
+    EXPECT_EQ(server.lines().size(), 500u);
+    EXPECT_EQ(logger.getRemoteStats().connects, 1u);
+}
+
+TEST_F(LoggerTest, FieldsInTextOutput) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_fields.log";
+    logger.configure(config);
+    logger.setFormatter(nullptr);
+    
+    std::string device = "USB Mic";
+    LOG_WITH_FIELDS(LogLevel::INFO, "Device opened", {"device", device}, {"rate", 48000});
+    logger.flush();
+    
+    std::ifstream logFile(config.logFilePath);
+    std::string line;
+    ASSERT_TRUE(std::getline(logFile, line));
+    EXPECT_NE(line.find("Device opened {"), std::string::npos);
+    EXPECT_NE(line.find("device=USB Mic"), std::string::npos);
+    EXPECT_NE(line.find("rate=48000"), std::string::npos);
+}
+
+TEST_F(LoggerTest, JsonLinesOutput) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_json.log";
+    config.outputFormat = LogOutputFormat::JsonLines;
+    logger.configure(config);
+    
+    LOG_WITH_FIELDS(LogLevel::WARNING, "Buffer \"underrun\"", {"frames", 256}, {"muted", false},
+                    {"device", "Mic\n1"});
+    LOGF_INFO("Opened {} at {} Hz", "mic", 48000);
+    logger.flush();
+    
+    std::ifstream logFile(config.logFilePath);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(logFile, line)) {
+        lines.push_back(line);
+    }
+    
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].front(), '{');
+    EXPECT_EQ(lines[0].back(), '}');
+    EXPECT_NE(lines[0].find("\"level\":\"WARN\""), std::string::npos);
+    EXPECT_NE(lines[0].find("\"msg\":\"Buffer \\\"underrun\\\"\""), std::string::npos);
+    EXPECT_NE(lines[0].find("\"ctx\":{\"frames\":256,\"muted\":false,\"device\":\"Mic\\n1\"}"),
+              std::string::npos);
+    EXPECT_NE(lines[1].find("\"msg\":\"Opened mic at 48000 Hz\""), std::string::npos);
+    EXPECT_NE(lines[1].find("\"file\":\"LoggerTest.cpp\""), std::string::npos);
+}
+
+TEST_F(LoggerTest, BinaryOutputRoundTrip) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_binary.log";
+    config.outputFormat = LogOutputFormat::Binary;
+    logger.configure(config);
+    
+    for (int i = 0; i < 10; ++i) {
+        LOG_WITH_FIELDS(LogLevel::INFO, "Block processed", {"index", i}, {"gain", 0.5});
+    }
+    logger.flush();
+    
+    std::ifstream logFile(config.logFilePath, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(logFile)), std::istreambuf_iterator<char>());
+    ASSERT_GE(data.size(), sizeof(kBinaryLogMagic));
+    EXPECT_EQ(data.compare(0, sizeof(kBinaryLogMagic), kBinaryLogMagic, sizeof(kBinaryLogMagic)), 0);
+    
+    size_t offset = sizeof(kBinaryLogMagic);
+    int records = 0;
+    StructuredLogRecord record;
+    while (size_t consumed = readBinaryLogRecord(data.data() + offset, data.size() - offset, record)) {
+        EXPECT_EQ(record.level, LogLevel::INFO);
+        EXPECT_EQ(record.message, "Block processed");
+        EXPECT_EQ(record.file, "LoggerTest.cpp");
+        
+        LogFieldReader reader(record.fields);
+        LogFieldValue field;
+        ASSERT_TRUE(reader.next(field));
+        EXPECT_EQ(field.key, "index");
+        EXPECT_EQ(field.intValue, records);
+        ASSERT_TRUE(reader.next(field));
+        EXPECT_EQ(field.key, "gain");
+        EXPECT_DOUBLE_EQ(field.doubleValue, 0.5);
+        EXPECT_FALSE(reader.next(field));
+        
+        offset += consumed;
+        records++;
+    }
+    
+    EXPECT_EQ(offset, data.size());
+    EXPECT_EQ(records, 10);
+}
+
+TEST_F(LoggerTest, PerformanceReport) {
+    Logger& logger = Logger::getInstance();
+    
+    LoggerConfig config;
+    config.enableConsole = false;
+    config.enableFile = true;
+    config.logFilePath = "logs/test_perf_report.log";
+    logger.configure(config);
+    
+    for (int i = 0; i < 5; ++i) {
+        QUIET_PERF_SPAN("logger.test.span");
+    }
+    logger.logPerformanceReport();
+    logger.flush();
+    
+    std::ifstream logFile(config.logFilePath);
+    std::string contents((std::istreambuf_iterator<char>(logFile)), std::istreambuf_iterator<char>());
+    EXPECT_NE(contents.find("p99"), std::string::npos);
+    EXPECT_NE(contents.find("logger.test.span"), std::string::npos);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "quiet/utils/MetricsServer.h"
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+
+using namespace quiet::utils;
+
+namespace {
+
+// Sends one request and returns everything the server answers
+std::string fetch(int port, const std::string& request) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return {};
+    }
+
+    ::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char chunk[512];
+    ssize_t received;
+    while ((received = ::recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        response.append(chunk, static_cast<size_t>(received));
+    }
+    ::close(fd);
+    return response;
+}
+
+} // namespace
+
+TEST(MetricsServerTest, ServesProviderOutputOnMetricsPath) {
+    int scrapes = 0;
+    MetricsServer server([&scrapes] {
+        std::string out;
+        MetricsServer::appendMetric(out, "quiet_test_value", "gauge", "A test value", ++scrapes);
+        return out;
+    });
+    ASSERT_TRUE(server.start(0));
+    ASSERT_GT(server.getPort(), 0);
+
+    std::string response = fetch(server.getPort(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.0 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("\r\n\r\n# HELP quiet_test_value A test value\n"
+                            "# TYPE quiet_test_value gauge\nquiet_test_value 1\n"), std::string::npos);
+
+    response = fetch(server.getPort(), "GET /other HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.0 404", 0), 0u);
+    EXPECT_EQ(scrapes, 1);
+    EXPECT_EQ(server.getRequestCount(), 2u);
+
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+    EXPECT_TRUE(fetch(server.getPort(), "GET /metrics HTTP/1.1\r\n\r\n").empty());
+}
+
+TEST(MetricsServerTest, ReadsProcessUsage) {
+    ProcessUsage usage = readProcessUsage();
+    EXPECT_GE(usage.cpuSeconds, 0.0);
+    EXPECT_GT(usage.residentBytes, 0u);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "quiet/utils/Logger.h"
+#include "quiet/utils/PerfSpan.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quiet::utils;
+
+namespace {
+
+void spinFor(std::chrono::microseconds duration) {
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+const PerfSpanStats* findSpan(const std::vector<PerfSpanStats>& stats, const std::string& name) {
+    auto it = std::find_if(stats.begin(), stats.end(),
+                           [&name](const PerfSpanStats& entry) { return entry.name == name; });
+    return it == stats.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+class PerfSpanTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PerfSpanCollector::getInstance().setEnabled(true);
+        PerfSpanCollector::getInstance().reset();
+    }
+};
+
+TEST(HdrHistogramTest, PercentilesWithinPrecision) {
+    HdrHistogram histogram(60ull * 1000 * 1000 * 1000, 2);
+    for (uint64_t value = 1; value <= 10000; ++value) {
+        histogram.record(value * 1000);
+    }
+
+    EXPECT_EQ(histogram.count(), 10000u);
+    EXPECT_EQ(histogram.min(), 1000u);
+    EXPECT_EQ(histogram.max(), 10000000u);
+    EXPECT_NEAR(histogram.mean(), 5000500.0, 1.0);
+
+    // Two significant digits: within 1% of the exact answer
+    EXPECT_NEAR(static_cast<double>(histogram.valueAtPercentile(50.0)), 5000000.0, 50000.0);
+    EXPECT_NEAR(static_cast<double>(histogram.valueAtPercentile(99.0)), 9900000.0, 99000.0);
+    EXPECT_EQ(histogram.valueAtPercentile(100.0), 10000000u);
+
+    // Small values are exact
+    HdrHistogram small(1000000, 2);
+    small.record(7);
+    small.record(7);
+    small.record(100);
+    EXPECT_EQ(small.valueAtPercentile(50.0), 7u);
+    EXPECT_EQ(small.valueAtPercentile(100.0), 100u);
+}
+
+TEST(HdrHistogramTest, MergeAndClamp) {
+    HdrHistogram a(1000000, 2);
+    HdrHistogram b(1000000, 2);
+    a.record(10);
+    b.record(20, 3);
+    b.record(5000000);  // Above the range: clamped
+
+    a.merge(b);
+    EXPECT_EQ(a.count(), 5u);
+    EXPECT_EQ(a.min(), 10u);
+    EXPECT_EQ(a.max(), 1000000u);
+    EXPECT_LT(a.memoryFootprint(), 16u * 1024);
+}
+
+TEST_F(PerfSpanTest, NestedSpans) {
+    for (int i = 0; i < 20; ++i) {
+        QUIET_PERF_SPAN("test.outer");
+        spinFor(std::chrono::microseconds(50));
+        {
+            QUIET_PERF_SPAN("test.inner");
+            spinFor(std::chrono::microseconds(100));
+        }
+    }
+
+    auto stats = PerfSpanCollector::getInstance().getStats();
+    const PerfSpanStats* outer = findSpan(stats, "test.outer");
+    const PerfSpanStats* inner = findSpan(stats, "test.inner");
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+
+    EXPECT_EQ(outer->count, 20u);
+    EXPECT_EQ(inner->count, 20u);
+    EXPECT_GE(inner->minNs, 90000u);
+    EXPECT_GT(outer->minNs, inner->minNs);
+    EXPECT_LE(outer->p50Ns, outer->maxNs);
+}
+
+TEST_F(PerfSpanTest, PreregisteredNameOnPreparedThread) {
+    const uint32_t nameId = PerfSpanCollector::registerName("test.preregistered");
+
+    std::thread worker([nameId] {
+        PerfSpanCollector::getInstance().prepareThread("test-audio");
+        for (int i = 0; i < 10; ++i) {
+            QUIET_PERF_SPAN_ID(nameId);
+            spinFor(std::chrono::microseconds(20));
+        }
+    });
+    worker.join();
+
+    auto stats = PerfSpanCollector::getInstance().getStats();
+    const PerfSpanStats* span = findSpan(stats, "test.preregistered");
+    ASSERT_NE(span, nullptr);
+    EXPECT_EQ(span->count, 10u);
+    EXPECT_NE(PerfSpanCollector::getInstance().exportChromeTrace().find("test-audio"), std::string::npos);
+}
+
+TEST_F(PerfSpanTest, PreparedThreadsOutlastReservedBuffers) {
+    // More than the collector preallocates; later threads allocate their own
+    constexpr int kThreads = 12;
+    const uint32_t nameId = PerfSpanCollector::registerName("test.prepared");
+
+    for (int t = 0; t < kThreads; ++t) {
+        std::thread worker([nameId] {
+            PerfSpanCollector::getInstance().prepareThread("test-prepared");
+            QUIET_PERF_SPAN_ID(nameId);
+        });
+        worker.join();
+    }
+
+    auto stats = PerfSpanCollector::getInstance().getStats();
+    const PerfSpanStats* span = findSpan(stats, "test.prepared");
+    ASSERT_NE(span, nullptr);
+    EXPECT_EQ(span->count, static_cast<uint64_t>(kThreads));
+}
+
+TEST_F(PerfSpanTest, ConcurrentThreads) {
+    constexpr int kThreads = 4;
+    constexpr int kSpans = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < kSpans; ++i) {
+                QUIET_PERF_SPAN("test.concurrent");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The threads have exited; their last spans are still collected
+    auto stats = PerfSpanCollector::getInstance().getStats();
+    const PerfSpanStats* span = findSpan(stats, "test.concurrent");
+    ASSERT_NE(span, nullptr);
+    EXPECT_EQ(span->count + PerfSpanCollector::getInstance().getDroppedCount(),
+              static_cast<uint64_t>(kThreads * kSpans));
+}
+
+TEST_F(PerfSpanTest, DisabledSpansAreNotRecorded) {
+    PerfSpanCollector::getInstance().setEnabled(false);
+    {
+        QUIET_PERF_SPAN("test.disabled");
+    }
+    PerfSpanCollector::getInstance().setEnabled(true);
+
+    auto stats = PerfSpanCollector::getInstance().getStats();
+    EXPECT_EQ(findSpan(stats, "test.disabled"), nullptr);
+}
+
+TEST_F(PerfSpanTest, TextAndChromeTraceExport) {
+    PerfSpanCollector& collector = PerfSpanCollector::getInstance();
+    collector.prepareThread("test-main");
+    for (int i = 0; i < 3; ++i) {
+        QUIET_PERF_SPAN("test.export \"quoted\"");
+    }
+
+    std::string report = collector.formatReport();
+    EXPECT_NE(report.find("test.export \"quoted\""), std::string::npos);
+    EXPECT_NE(report.find("p99.9"), std::string::npos);
+
+    std::string trace = collector.exportChromeTrace();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("\"name\":\"test.export \\\"quoted\\\"\",\"cat\":\"quiet\",\"ph\":\"X\""),
+              std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"test-main\"}"), std::string::npos);
+    EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+}
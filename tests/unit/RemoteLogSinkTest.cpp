@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "quiet/utils/RemoteLogSink.h"
+#include "LoopbackLogServer.h"
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace quiet::utils;
+using quiet::test::LoopbackLogServer;
+
+class RemoteLogSinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::filesystem::remove(spillPath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(spillPath);
+    }
+
+    RemoteLogConfig makeConfig(int port, const std::string& protocol = "tcp") {
+        RemoteLogConfig config;
+        config.host = "127.0.0.1";
+        config.port = port;
+        config.protocol = protocol;
+        config.timeout = std::chrono::milliseconds(500);
+        config.initialBackoff = std::chrono::milliseconds(10);
+        config.maxBackoff = std::chrono::milliseconds(50);
+        config.spillPath = spillPath;
+        return config;
+    }
+
+    static std::string makeLines(int first, int count) {
+        std::string lines;
+        for (int i = first; i < first + count; ++i) {
+            lines += "line " + std::to_string(i) + "\n";
+        }
+        return lines;
+    }
+
+    const std::string spillPath = "remote_sink_test.spill";
+};
+
+TEST_F(RemoteLogSinkTest, TcpSendsBatchesOverOneConnection) {
+    LoopbackLogServer server(LoopbackLogServer::Protocol::Tcp);
+    RemoteLogSink sink(makeConfig(server.port()));
+
+    for (int batch = 0; batch < 10; ++batch) {
+        sink.write(makeLines(batch * 100, 100), 100);
+    }
+
+    ASSERT_TRUE(server.waitForLines(1000, std::chrono::seconds(5)));
+    auto lines = server.lines();
+    EXPECT_EQ(lines.front(), "line 0");
+    EXPECT_EQ(lines.back(), "line 999");
+
+    auto stats = sink.getStats();
+    EXPECT_EQ(stats.connects, 1u);
+    EXPECT_EQ(stats.linesSent, 1000u);
+    EXPECT_LE(stats.sendCalls, 20u);
+}
+
+TEST_F(RemoteLogSinkTest, SpillsWhileCollectorIsDownAndReplaysInOrder) {
+    int port = LoopbackLogServer::unusedPort();
+    RemoteLogSink sink(makeConfig(port));
+
+    // Nobody is listening: both batches go to the spill file
+    sink.write(makeLines(0, 50), 50);
+    sink.write(makeLines(50, 50), 50);
+    EXPECT_FALSE(sink.isConnected());
+    EXPECT_GT(sink.getStats().bytesSpilled, 0u);
+
+    LoopbackLogServer server(LoopbackLogServer::Protocol::Tcp, port);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        auto wait = sink.maintain();
+        if (sink.isConnected()) {
+            break;
+        }
+        std::this_thread::sleep_for(wait);
+    }
+    sink.write(makeLines(100, 50), 50);
+
+    ASSERT_TRUE(server.waitForLines(150, std::chrono::seconds(5)));
+    auto lines = server.lines();
+    for (int i = 0; i < 150; ++i) {
+        EXPECT_EQ(lines[static_cast<size_t>(i)], "line " + std::to_string(i));
+    }
+    EXPECT_EQ(sink.getStats().bytesReplayed, sink.getStats().bytesSpilled);
+}
+
+TEST_F(RemoteLogSinkTest, SpillFileIsBounded) {
+    auto config = makeConfig(LoopbackLogServer::unusedPort());
+    config.maxSpillBytes = 1024;
+    RemoteLogSink sink(config);
+
+    std::string lines = makeLines(0, 200);
+    sink.write(lines, 200);
+
+    auto stats = sink.getStats();
+    EXPECT_EQ(stats.bytesSpilled, 0u);
+    EXPECT_EQ(stats.bytesDropped, lines.size());
+}
+
+TEST_F(RemoteLogSinkTest, UdpPacksLinesIntoDatagrams) {
+    LoopbackLogServer server(LoopbackLogServer::Protocol::Udp);
+    auto config = makeConfig(server.port(), "udp");
+    config.maxDatagramSize = 512;
+    RemoteLogSink sink(config);
+
+    sink.write(makeLines(0, 200), 200);
+
+    ASSERT_TRUE(server.waitForLines(200, std::chrono::seconds(5)));
+    auto stats = sink.getStats();
+    EXPECT_EQ(stats.linesSent, 200u);
+    EXPECT_LT(stats.sendCalls, 20u);
+}
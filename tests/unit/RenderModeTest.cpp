@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "quiet/core/RenderMode.h"
+
+using namespace quiet::core;
+
+TEST(RenderModeTest, ParsesConfigValuesInAnyCase) {
+    EXPECT_EQ(parseRenderMode("software"), RenderMode::Software);
+    EXPECT_EQ(parseRenderMode("OpenGL"), RenderMode::OpenGL);
+    EXPECT_EQ(parseRenderMode("AUTO"), RenderMode::Auto);
+
+    // Unknown or partial values fall back to Auto
+    EXPECT_EQ(parseRenderMode(""), RenderMode::Auto);
+    EXPECT_EQ(parseRenderMode("gl"), RenderMode::Auto);
+    EXPECT_EQ(parseRenderMode("software "), RenderMode::Auto);
+
+    EXPECT_STREQ(renderModeName(parseRenderMode("opengl")), "opengl");
+}
+
+TEST(RenderModeTest, RecognisesSoftwareRasterizers) {
+    EXPECT_TRUE(isSoftwareRasterizer("llvmpipe (LLVM 15.0.7, 256 bits)"));
+    EXPECT_TRUE(isSoftwareRasterizer("Mesa softpipe"));
+    EXPECT_TRUE(isSoftwareRasterizer("Google SwiftShader"));
+    EXPECT_TRUE(isSoftwareRasterizer("GDI Generic"));
+    EXPECT_TRUE(isSoftwareRasterizer("Apple Software Rasterizer"));
+    EXPECT_TRUE(isSoftwareRasterizer("LLVMPIPE"));
+
+    EXPECT_FALSE(isSoftwareRasterizer("NVIDIA GeForce RTX 3060/PCIe/SSE2"));
+    EXPECT_FALSE(isSoftwareRasterizer("Mesa Intel(R) UHD Graphics 620 (KBL GT2)"));
+    EXPECT_FALSE(isSoftwareRasterizer("Apple M1"));
+    EXPECT_FALSE(isSoftwareRasterizer(""));
+}
+
+TEST(RenderModeTest, CpuMeterReportsPerWindow) {
+    RenderCpuMeter meter(10.0);
+
+    EXPECT_FALSE(meter.sample(100.0, 1000.0, 0));   // Starts the window
+    EXPECT_FALSE(meter.sample(101.0, 1005.0, 150));
+
+    // 2.5 CPU seconds and 300 frames over 10 s
+    ASSERT_TRUE(meter.sample(102.5, 1010.0, 300));
+    EXPECT_DOUBLE_EQ(meter.cpuPercent(), 25.0);
+    EXPECT_DOUBLE_EQ(meter.framesPerSecond(), 30.0);
+
+    // The next window starts where that one ended
+    ASSERT_TRUE(meter.sample(103.0, 1020.0, 400));
+    EXPECT_DOUBLE_EQ(meter.cpuPercent(), 5.0);
+    EXPECT_DOUBLE_EQ(meter.framesPerSecond(), 10.0);
+}
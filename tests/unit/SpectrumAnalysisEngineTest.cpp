@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "quiet/core/SpectrumAnalysisEngine.h"
+#include "quiet/utils/TripleBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace quiet::core;
+
+namespace {
+
+// Sine centred on an FFT bin, so its energy lands in that bin
+std::vector<float> makeSine(int bin, int fftSize, size_t length, float amplitude = 1.0f) {
+    std::vector<float> samples(length);
+    for (size_t i = 0; i < length; ++i) {
+        samples[i] = amplitude * static_cast<float>(std::sin(2.0 * 3.141592653589793 * bin * i / fftSize));
+    }
+    return samples;
+}
+
+int peakBin(const SpectrumFrame& frame) {
+    auto peak = std::max_element(frame.magnitudesDb.begin(), frame.magnitudesDb.end());
+    return static_cast<int>(peak - frame.magnitudesDb.begin());
+}
+
+} // namespace
+
+TEST(TripleBufferTest, ReaderSeesLatestPublishedSlot) {
+    quiet::utils::TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.update());
+
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+
+    // Only the latest of the two is seen, once
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2);
+
+    buffer.writeBuffer() = 3;
+    buffer.publish();
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 3);
+}
+
+TEST(TripleBufferTest, ConcurrentReaderNeverSeesTornOrOlderSlots) {
+    struct Slot {
+        uint64_t a = 0;
+        uint64_t b = 0;
+    };
+    quiet::utils::TripleBuffer<Slot> buffer;
+    constexpr uint64_t kFrames = 200000;
+
+    std::thread writer([&buffer] {
+        for (uint64_t i = 1; i <= kFrames; ++i) {
+            Slot& slot = buffer.writeBuffer();
+            slot.a = i;
+            slot.b = i * 3;
+            buffer.publish();
+        }
+    });
+
+    uint64_t last = 0;
+    bool consistent = true;
+    while (last < kFrames) {
+        if (buffer.update()) {
+            const Slot& slot = buffer.readBuffer();
+            consistent = consistent && slot.b == slot.a * 3 && slot.a > last;
+            last = slot.a;
+        }
+    }
+    writer.join();
+    EXPECT_TRUE(consistent);
+}
+
+TEST(SpectrumAnalysisEngineTest, SmallBlocksProduceOverlappingFrames) {
+    SpectrumAnalysisEngine engine({512, 128});
+    EXPECT_EQ(engine.getSettings().fftSize, 512);
+    EXPECT_EQ(engine.getSettings().hopSize, 128);
+
+    // 64-sample device blocks: one frame per hop, never a whole window per block
+    auto samples = makeSine(32, 512, 2048, 0.5f);
+    for (size_t offset = 0; offset < samples.size(); offset += 64) {
+        engine.pushSamples(samples.data() + offset, 64, 48000.0);
+        engine.processPending();
+    }
+
+    EXPECT_EQ(engine.getFramesAnalyzed(), 2048u / 128u);
+    ASSERT_TRUE(engine.updateFrame());
+
+    const SpectrumFrame& frame = engine.getFrame();
+    EXPECT_EQ(frame.sequence, 16u);
+    EXPECT_EQ(frame.fftSize, 512);
+    EXPECT_EQ(frame.sampleRate, 48000.0);
+    ASSERT_EQ(frame.magnitudesDb.size(), 256u);
+    EXPECT_EQ(peakBin(frame), 32);
+    EXPECT_NEAR(frame.magnitudesDb[32], 20.0f * std::log10(0.5f), 0.5f);
+    EXPECT_LT(frame.magnitudesDb[100], -60.0f);
+}
+
+TEST(SpectrumAnalysisEngineTest, SettingsAreRoundedAndClamped) {
+    SpectrumAnalysisEngine engine({300, 1000});
+    EXPECT_EQ(engine.getSettings().fftSize, 512);
+    EXPECT_EQ(engine.getSettings().hopSize, 512);
+
+    engine.setSettings({64, 0});
+    EXPECT_EQ(engine.getSettings().fftSize, 256);
+    EXPECT_EQ(engine.getSettings().hopSize, 1);
+    EXPECT_EQ(engine.getFrame().magnitudesDb.size(), 128u);
+}
+
+TEST(SpectrumAnalysisEngineTest, BackgroundThreadPublishesFrames) {
+    SpectrumAnalysisEngine engine({256, 64});
+    engine.start();
+    ASSERT_TRUE(engine.isRunning());
+
+    auto samples = makeSine(16, 256, 1024);
+    for (size_t offset = 0; offset < samples.size(); offset += 128) {
+        engine.pushSamples(samples.data() + offset, 128, 44100.0);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (engine.getFramesAnalyzed() < 16 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+    EXPECT_FALSE(engine.isRunning());
+
+    EXPECT_EQ(engine.getFramesAnalyzed(), 16u);
+    ASSERT_TRUE(engine.updateFrame());
+    EXPECT_EQ(engine.getFrame().sequence, 16u);
+    EXPECT_EQ(peakBin(engine.getFrame()), 16);
+    EXPECT_EQ(engine.getDroppedSamples(), 0u);
+}
+
+TEST(SpectrumAnalysisEngineTest, QueuedFramesKeepEveryFrameInOrder) {
+    SpectrumAnalysisEngine engine({256, 128, 4});
+    EXPECT_FALSE(engine.popQueuedFrame(nullptr));
+
+    // Seven frames: two of silence, then a sine; the queue holds four
+    std::vector<float> samples(256, 0.0f);
+    auto sine = makeSine(8, 256, 640);
+    samples.insert(samples.end(), sine.begin(), sine.end());
+    engine.pushSamples(samples.data(), samples.size(), 48000.0);
+    engine.processPending();
+    EXPECT_EQ(engine.getFramesAnalyzed(), 7u);
+    EXPECT_EQ(engine.getDroppedFrames(), 3u);
+    EXPECT_EQ(engine.getSampleRate(), 48000.0);
+
+    std::vector<float> bins(128);
+    ASSERT_TRUE(engine.popQueuedFrame(bins.data()));
+    EXPECT_EQ(*std::max_element(bins.begin(), bins.end()), SpectrumAnalysisEngine::kFloorDb);
+    ASSERT_TRUE(engine.popQueuedFrame(bins.data()));
+    EXPECT_EQ(*std::max_element(bins.begin(), bins.end()), SpectrumAnalysisEngine::kFloorDb);
+
+    // Space freed by popping takes the next frame
+    engine.pushSamples(sine.data(), 128, 48000.0);
+    engine.processPending();
+    int remaining = 0;
+    while (engine.popQueuedFrame(bins.data())) {
+        ++remaining;
+    }
+    EXPECT_EQ(remaining, 3);
+    EXPECT_EQ(std::max_element(bins.begin(), bins.end()) - bins.begin(), 8);
+}
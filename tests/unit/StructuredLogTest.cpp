@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "quiet/utils/StructuredLog.h"
+#include <string>
+
+using namespace quiet::utils;
+
+namespace {
+
+std::string encodeFields(std::initializer_list<LogField> fields, size_t capacity = 160) {
+    std::string buffer(capacity, '\0');
+    detail::LogArgEncoder encoder(buffer.data(), buffer.size());
+    for (const LogField& field : fields) {
+        field.encode(encoder);
+    }
+    buffer.resize(encoder.size());
+    return buffer;
+}
+
+} // namespace
+
+TEST(StructuredLogTest, FieldsKeepTheirTypes) {
+    std::string name = "USB Mic";
+    std::string encoded = encodeFields({{"device", name}, {"rate", 48000u}, {"gain", -3.5}, {"muted", true}});
+
+    LogFieldReader reader(encoded);
+    LogFieldValue field;
+
+    ASSERT_TRUE(reader.next(field));
+    EXPECT_EQ(field.key, "device");
+    EXPECT_EQ(field.type, detail::LogArgType::String);
+    EXPECT_EQ(field.text, "USB Mic");
+
+    ASSERT_TRUE(reader.next(field));
+    EXPECT_EQ(field.type, detail::LogArgType::UInt);
+    EXPECT_EQ(field.uintValue, 48000u);
+
+    ASSERT_TRUE(reader.next(field));
+    EXPECT_EQ(field.type, detail::LogArgType::Double);
+    EXPECT_DOUBLE_EQ(field.doubleValue, -3.5);
+
+    ASSERT_TRUE(reader.next(field));
+    EXPECT_EQ(field.type, detail::LogArgType::Bool);
+    EXPECT_EQ(field.uintValue, 1u);
+
+    EXPECT_FALSE(reader.next(field));
+}
+
+TEST(StructuredLogTest, FieldsThatDoNotFitAreDropped) {
+    // Room for the first field only; the second must not leave a dangling key
+    std::string encoded = encodeFields({{"first", 1}, {"second", 2}}, 20);
+
+    LogFieldReader reader(encoded);
+    LogFieldValue field;
+    ASSERT_TRUE(reader.next(field));
+    EXPECT_EQ(field.key, "first");
+    EXPECT_FALSE(reader.next(field));
+}
+
+TEST(StructuredLogTest, JsonEscaping) {
+    std::string out;
+    appendJsonString(out, "say \"hi\"\\\n\t\x01");
+    EXPECT_EQ(out, "\"say \\\"hi\\\"\\\\\\n\\t\\u0001\"");
+}
+
+TEST(StructuredLogTest, JsonLine) {
+    std::string fields = encodeFields({{"frames", 256}, {"ratio", 0.25}, {"ok", false}});
+
+    StructuredLogRecord record;
+    record.timestampNs = 1700000000123456789;
+    record.level = LogLevel::ERROR;
+    record.threadId = 7;
+    record.line = 42;
+    record.file = "Audio.cpp";
+    record.function = "process";
+    record.message = "Underrun";
+    record.fields = fields;
+
+    std::string out;
+    appendJsonLogLine(out, record);
+    EXPECT_EQ(out,
+              "{\"ts\":\"2023-11-14T22:13:20.123456Z\",\"level\":\"ERROR\",\"thread\":7,"
+              "\"file\":\"Audio.cpp\",\"line\":42,\"function\":\"process\",\"msg\":\"Underrun\","
+              "\"ctx\":{\"frames\":256,\"ratio\":0.25,\"ok\":false}}\n");
+}
+
+TEST(StructuredLogTest, BinaryRoundTrip) {
+    std::string fields = encodeFields({{"device", "mic"}});
+
+    StructuredLogRecord written;
+    written.timestampNs = 1700000000000000000;
+    written.level = LogLevel::WARNING;
+    written.threadId = 99;
+    written.line = 12;
+    written.file = "Main.cpp";
+    written.function = "run";
+    written.message = "Device lost";
+    written.fields = fields;
+
+    std::string data;
+    appendBinaryLogRecord(data, written);
+    appendBinaryLogRecord(data, written);
+
+    StructuredLogRecord read;
+    size_t first = readBinaryLogRecord(data.data(), data.size(), read);
+    ASSERT_EQ(first * 2, data.size());
+    EXPECT_EQ(read.timestampNs, written.timestampNs);
+    EXPECT_EQ(read.level, LogLevel::WARNING);
+    EXPECT_EQ(read.threadId, 99u);
+    EXPECT_EQ(read.line, 12u);
+    EXPECT_EQ(read.file, "Main.cpp");
+    EXPECT_EQ(read.function, "run");
+    EXPECT_EQ(read.message, "Device lost");
+    EXPECT_EQ(read.fields, fields);
+
+    // A record cut short, as after a crash mid-write, is not returned
+    EXPECT_EQ(readBinaryLogRecord(data.data() + first, first - 1, read), 0u);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "quiet/core/AudioBuffer.h"
+#include "quiet/core/VisualizationTap.h"
+#include <thread>
+#include <vector>
+
+using namespace quiet::core;
+
+TEST(VisualizationTapTest, ReadsBackWrittenSamplesAcrossWrap) {
+    VisualizationTap tap(64);
+    ASSERT_EQ(tap.capacity(), 64u);
+
+    std::vector<float> block(48);
+    std::vector<float> out(64);
+    float next = 0.0f;
+    float expected = 0.0f;
+
+    // 48-sample writes and reads wrap the 64-slot ring on the second pass
+    for (int pass = 0; pass < 5; ++pass) {
+        for (auto& sample : block) {
+            sample = next++;
+        }
+        tap.write(VisualizationTap::Source::Input, block.data(), block.size());
+        EXPECT_EQ(tap.available(VisualizationTap::Source::Input), 48u);
+
+        size_t read = tap.read(VisualizationTap::Source::Input, out.data(), out.size());
+        ASSERT_EQ(read, 48u);
+        for (size_t i = 0; i < read; ++i) {
+            EXPECT_EQ(out[i], expected++);
+        }
+    }
+
+    // Sources are independent
+    EXPECT_EQ(tap.available(VisualizationTap::Source::Output), 0u);
+    EXPECT_EQ(tap.getWrittenSamples(VisualizationTap::Source::Input), 240u);
+    EXPECT_EQ(tap.getDroppedSamples(VisualizationTap::Source::Input), 0u);
+}
+
+TEST(VisualizationTapTest, DropsWhatDoesNotFitAndKeepsOldest) {
+    VisualizationTap tap(64);
+    std::vector<float> block(40, 1.0f);
+
+    tap.write(VisualizationTap::Source::Output, block.data(), block.size());
+    std::fill(block.begin(), block.end(), 2.0f);
+    tap.write(VisualizationTap::Source::Output, block.data(), block.size());
+    tap.write(VisualizationTap::Source::Output, block.data(), block.size());
+
+    EXPECT_EQ(tap.available(VisualizationTap::Source::Output), 64u);
+    EXPECT_EQ(tap.getWrittenSamples(VisualizationTap::Source::Output), 64u);
+    EXPECT_EQ(tap.getDroppedSamples(VisualizationTap::Source::Output), 56u);
+
+    std::vector<float> out(64);
+    ASSERT_EQ(tap.read(VisualizationTap::Source::Output, out.data(), 10), 10u);
+    EXPECT_EQ(out[0], 1.0f);
+    ASSERT_EQ(tap.read(VisualizationTap::Source::Output, out.data(), out.size()), 54u);
+    EXPECT_EQ(out[29], 1.0f);
+    EXPECT_EQ(out[30], 2.0f);
+    EXPECT_EQ(tap.read(VisualizationTap::Source::Output, out.data(), out.size()), 0u);
+}
+
+TEST(VisualizationTapTest, AudioBufferWritesChannelZeroAndSampleRate) {
+    VisualizationTap tap(256);
+    AudioBuffer buffer(2, 128, 44100.0);
+    for (int i = 0; i < 128; ++i) {
+        buffer.setSample(0, i, static_cast<float>(i));
+        buffer.setSample(1, i, -1.0f);
+    }
+
+    EXPECT_EQ(tap.getSampleRate(), 0.0);
+    tap.write(VisualizationTap::Source::Input, buffer);
+    EXPECT_EQ(tap.getSampleRate(), 44100.0);
+
+    std::vector<float> out(256);
+    ASSERT_EQ(tap.read(VisualizationTap::Source::Input, out.data(), out.size()), 128u);
+    EXPECT_EQ(out[127], 127.0f);
+
+    tap.setEnabled(false);
+    tap.write(VisualizationTap::Source::Input, buffer);
+    EXPECT_EQ(tap.available(VisualizationTap::Source::Input), 0u);
+    EXPECT_EQ(tap.getDroppedSamples(VisualizationTap::Source::Input), 0u);
+}
+
+TEST(VisualizationTapTest, ConcurrentWriterAndReaderSeeOrderedSamples) {
+    constexpr size_t kBlocks = 20000;
+    constexpr size_t kBlockSize = 128;
+    VisualizationTap tap(1024);
+
+    std::thread writer([&tap] {
+        std::vector<float> block(kBlockSize);
+        float next = 0.0f;
+        for (size_t b = 0; b < kBlocks; ++b) {
+            for (auto& sample : block) {
+                sample = next++;
+            }
+            tap.write(VisualizationTap::Source::Input, block.data(), block.size());
+        }
+    });
+
+    // Samples may be dropped, but the ones read are in order and unique
+    std::vector<float> out(300);
+    float last = -1.0f;
+    uint64_t received = 0;
+    bool ordered = true;
+    auto drain = [&] {
+        size_t read = tap.read(VisualizationTap::Source::Input, out.data(), out.size());
+        for (size_t i = 0; i < read; ++i) {
+            ordered = ordered && out[i] > last;
+            last = out[i];
+        }
+        received += read;
+        return read;
+    };
+    while (tap.getWrittenSamples(VisualizationTap::Source::Input) +
+           tap.getDroppedSamples(VisualizationTap::Source::Input) < kBlocks * kBlockSize) {
+        drain();
+    }
+    writer.join();
+    while (drain() > 0) {
+    }
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(received, tap.getWrittenSamples(VisualizationTap::Source::Input));
+    EXPECT_EQ(received + tap.getDroppedSamples(VisualizationTap::Source::Input), kBlocks * kBlockSize);
+}
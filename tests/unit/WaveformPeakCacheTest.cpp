@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "quiet/core/WaveformPeakCache.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace quiet::core;
+
+namespace {
+
+// Reference: scan every sample of each column
+std::vector<WaveformPeakCache::Peak> bruteForcePeaks(const std::vector<float>& samples, size_t span, size_t columns) {
+    std::vector<WaveformPeakCache::Peak> peaks(columns);
+    const double perColumn = std::max(1.0, static_cast<double>(span) / static_cast<double>(columns));
+    const int64_t end = static_cast<int64_t>(samples.size());
+    const int64_t start = end - static_cast<int64_t>(std::llround(perColumn * static_cast<double>(columns)));
+    for (size_t c = 0; c < columns; ++c) {
+        int64_t from = start + static_cast<int64_t>(perColumn * static_cast<double>(c));
+        int64_t to = std::max(start + static_cast<int64_t>(perColumn * static_cast<double>(c + 1)), from + 1);
+        bool found = false;
+        for (int64_t i = std::max<int64_t>(from, 0); i < to && i < end; ++i) {
+            if (!found) {
+                peaks[c] = {samples[i], samples[i]};
+                found = true;
+            } else {
+                peaks[c].min = std::min(peaks[c].min, samples[i]);
+                peaks[c].max = std::max(peaks[c].max, samples[i]);
+            }
+        }
+    }
+    return peaks;
+}
+
+} // namespace
+
+TEST(WaveformPeakCacheTest, MatchesFullScanWhenColumnsAlignWithLevels) {
+    WaveformPeakCache cache(1 << 16);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+    // 128-sample blocks, ending part-way through the coarser pairs
+    std::vector<float> samples(40000 + 37);
+    for (auto& sample : samples) {
+        sample = noise(random);
+    }
+    for (size_t offset = 0; offset < samples.size(); offset += 128) {
+        cache.addSamples(samples.data() + offset, std::min<size_t>(128, samples.size() - offset));
+    }
+    EXPECT_EQ(cache.totalSamples(), samples.size());
+
+    // Column widths of 1, 4, 16 and 256 samples: whole pairs at each level.
+    // The view ends on the last whole pair.
+    for (size_t perColumn : {1u, 4u, 16u, 256u}) {
+        const size_t columns = 100;
+        std::vector<WaveformPeakCache::Peak> peaks(columns);
+        cache.getPeaks(perColumn * columns, peaks.data(), columns);
+        std::vector<float> completed(samples.begin(), samples.end() - samples.size() % perColumn);
+        auto expected = bruteForcePeaks(completed, perColumn * columns, columns);
+        for (size_t c = 0; c < columns; ++c) {
+            EXPECT_EQ(peaks[c].min, expected[c].min) << "samples per column " << perColumn << ", column " << c;
+            EXPECT_EQ(peaks[c].max, expected[c].max) << "samples per column " << perColumn << ", column " << c;
+        }
+    }
+}
+
+TEST(WaveformPeakCacheTest, UnalignedColumnsContainTheirSamples) {
+    WaveformPeakCache cache(48000);
+    std::vector<float> samples(30000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(std::sin(i * 0.01)) * (i % 997 == 0 ? 1.0f : 0.5f);
+    }
+    cache.addSamples(samples.data(), samples.size());
+
+    // 4096 samples over 700 columns: pairs straddle column edges, so a
+    // column may show a neighbour's peak but never miss its own
+    const size_t columns = 700;
+    std::vector<WaveformPeakCache::Peak> peaks(columns);
+    cache.getPeaks(4096, peaks.data(), columns);
+    auto expected = bruteForcePeaks(samples, 4096, columns);
+    for (size_t c = 0; c < columns; ++c) {
+        EXPECT_LE(peaks[c].min, expected[c].min);
+        EXPECT_GE(peaks[c].max, expected[c].max);
+    }
+}
+
+TEST(WaveformPeakCacheTest, LongHistoryWrapsAndOldSpansReadAsSilence) {
+    const size_t history = 30 * 48000;
+    WaveformPeakCache cache(history);
+    EXPECT_GT(cache.levelCount(), 5u);
+
+    // Two minutes of audio: a spike 10 s ago, another in the past beyond history
+    std::vector<float> block(480, 0.1f);
+    for (int i = 0; i < 12000; ++i) {
+        block[0] = (i == 11000 || i == 100) ? 0.9f : 0.1f;
+        cache.addSamples(block.data(), block.size());
+    }
+
+    // Whole history on 800 columns; the spike is the only full-height column
+    std::vector<WaveformPeakCache::Peak> peaks(800);
+    cache.getPeaks(history, peaks.data(), peaks.size());
+    int spikes = 0;
+    for (const auto& peak : peaks) {
+        spikes += peak.max > 0.5f ? 1 : 0;
+        EXPECT_GE(peak.min, 0.1f - 1e-6f);
+    }
+    EXPECT_EQ(spikes, 1);
+
+    // More than the history: the oldest columns are empty
+    cache.getPeaks(history * 2, peaks.data(), peaks.size());
+    EXPECT_EQ(peaks.front().max, 0.0f);
+    EXPECT_GT(peaks.back().max, 0.0f);
+
+    cache.clear();
+    cache.getPeaks(4096, peaks.data(), peaks.size());
+    EXPECT_EQ(peaks.back().max, 0.0f);
+}
@@ -0,0 +1,268 @@
+/**
+ * @file EventTraceTool.cpp
+ * @brief Command line companion to EventDispatcher tracing
+ *
+ * Reads a trace written by EventDispatcher::dumpTrace() and either summarizes
+ * it or replays its publishes against synthetic listeners that take as long
+ * as the recorded ones, printing latency histograms.
+ *
+ *   quiet_event_trace summary <trace>
+ *   quiet_event_trace replay <trace> [--speed <factor>] [--threads <count>]
+ */
+
+#include "quiet/core/EventDispatcher.h"
+#include "quiet/core/EventTrace.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quiet::core;
+
+namespace {
+
+const char* eventTypeName(uint16_t type) {
+    static const char* const kNames[] = {
+        "AudioDeviceChanged", "AudioDeviceError", "AudioLevelChanged",
+        "AudioProcessingStarted", "AudioProcessingStopped", "NoiseReductionToggled",
+        "NoiseReductionLevelChanged", "ProcessingStatsUpdated", "WindowShown",
+        "WindowHidden", "SettingsChanged", "ApplicationStarted",
+        "ApplicationShutdown", "ErrorOccurred"
+    };
+    static_assert(sizeof(kNames) / sizeof(kNames[0]) == kEventTypeCount, "Event type names out of date");
+    return type < kEventTypeCount ? kNames[type] : "Unknown";
+}
+
+std::string formatNs(uint64_t ns) {
+    char text[32];
+    if (ns < 1000) {
+        std::snprintf(text, sizeof(text), "%lluns", static_cast<unsigned long long>(ns));
+    } else if (ns < 1000000) {
+        std::snprintf(text, sizeof(text), "%.1fus", ns / 1e3);
+    } else if (ns < 1000000000) {
+        std::snprintf(text, sizeof(text), "%.2fms", ns / 1e6);
+    } else {
+        std::snprintf(text, sizeof(text), "%.2fs", ns / 1e9);
+    }
+    return text;
+}
+
+/**
+ * Power-of-two bucketed latency histogram with exact percentiles
+ */
+class LatencyHistogram {
+public:
+    void add(uint64_t ns) {
+        size_t bucket = 0;
+        while (bucket + 1 < m_buckets.size() && (uint64_t(1) << (bucket + 1)) <= ns) {
+            ++bucket;
+        }
+        m_buckets[bucket]++;
+        m_samples.push_back(ns);
+    }
+
+    bool empty() const { return m_samples.empty(); }
+
+    void print(const std::string& title) {
+        if (m_samples.empty()) {
+            return;
+        }
+
+        std::sort(m_samples.begin(), m_samples.end());
+        auto percentile = [this](double p) {
+            size_t index = static_cast<size_t>(p * static_cast<double>(m_samples.size() - 1));
+            return m_samples[index];
+        };
+
+        std::cout << "  " << title << " (n=" << m_samples.size() << ")"
+                  << "  p50=" << formatNs(percentile(0.50))
+                  << "  p99=" << formatNs(percentile(0.99))
+                  << "  p99.9=" << formatNs(percentile(0.999))
+                  << "  max=" << formatNs(m_samples.back()) << "\n";
+
+        uint64_t peak = *std::max_element(m_buckets.begin(), m_buckets.end());
+        for (size_t bucket = 0; bucket < m_buckets.size(); ++bucket) {
+            if (m_buckets[bucket] == 0) {
+                continue;
+            }
+            auto width = static_cast<size_t>(40.0 * static_cast<double>(m_buckets[bucket]) /
+                                             static_cast<double>(peak));
+            char label[48];
+            std::snprintf(label, sizeof(label), "    %9s - %-9s %8llu ",
+                          formatNs(uint64_t(1) << bucket).c_str(),
+                          formatNs(uint64_t(1) << (bucket + 1)).c_str(),
+                          static_cast<unsigned long long>(m_buckets[bucket]));
+            std::cout << label << std::string(std::max<size_t>(width, 1), '#') << "\n";
+        }
+    }
+
+private:
+    std::array<uint64_t, 40> m_buckets{};
+    std::vector<uint64_t> m_samples;
+};
+
+struct TypeSummary {
+    uint64_t publishes = 0;
+    uint64_t maxQueueDepth = 0;
+    uint64_t totalQueueDepth = 0;
+    LatencyHistogram queueLatency;
+    LatencyHistogram delivery;
+};
+
+void printSummary(const std::vector<EventTraceRecord>& records, const char* heading) {
+    std::map<uint16_t, TypeSummary> byType;
+    std::map<uint32_t, uint64_t> threads;
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+
+    for (const auto& record : records) {
+        TypeSummary& summary = byType[record.type];
+        if (record.kind == EventTraceRecord::Kind::Publish) {
+            summary.publishes++;
+            summary.maxQueueDepth = std::max<uint64_t>(summary.maxQueueDepth, record.queueDepth);
+            summary.totalQueueDepth += record.queueDepth;
+            first = std::min(first, record.timestampNs);
+            last = std::max(last, record.timestampNs);
+        } else {
+            summary.queueLatency.add(record.queueLatencyNs());
+            summary.delivery.add(record.durationNs);
+        }
+        threads[record.threadId]++;
+    }
+
+    std::cout << heading << ": " << records.size() << " records from " << threads.size() << " threads";
+    if (last > first) {
+        std::cout << " over " << formatNs(last - first);
+    }
+    std::cout << "\n";
+
+    for (auto& [type, summary] : byType) {
+        std::cout << "\n" << eventTypeName(type) << ": " << summary.publishes << " published";
+        if (summary.publishes > 0) {
+            std::cout << ", queue depth avg " << summary.totalQueueDepth / summary.publishes
+                      << " max " << summary.maxQueueDepth;
+        }
+        std::cout << "\n";
+        summary.queueLatency.print("publish -> listener start");
+        summary.delivery.print("listener duration");
+    }
+}
+
+// Busy-waits rather than sleeping so short durations are reproduced faithfully
+void spinFor(uint64_t ns) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+int replay(const std::vector<EventTraceRecord>& records, double speed, size_t threads) {
+    // Each recorded listener is modelled by its mean duration per event type
+    std::map<std::pair<uint32_t, uint16_t>, std::pair<uint64_t, uint64_t>> costs;  // (sum, count)
+    std::vector<EventTraceRecord> publishes;
+    for (const auto& record : records) {
+        if (record.kind == EventTraceRecord::Kind::Publish) {
+            publishes.push_back(record);
+        } else {
+            auto& cost = costs[{record.listenerId, record.type}];
+            cost.first += record.durationNs;
+            cost.second++;
+        }
+    }
+
+    if (publishes.empty()) {
+        std::cerr << "Trace contains no publish records\n";
+        return 1;
+    }
+    std::sort(publishes.begin(), publishes.end(),
+              [](const EventTraceRecord& a, const EventTraceRecord& b) { return a.timestampNs < b.timestampNs; });
+
+    EventDispatcher dispatcher;
+    dispatcher.setDeliveryThreadCount(threads);
+    dispatcher.enableTracing(std::max<size_t>(records.size() * 2, 1024));
+
+    // Default policies stay in place, so coalescing and the priority lane
+    // behave as they did in the traced process
+    for (const auto& [key, cost] : costs) {
+        uint64_t meanNs = cost.first / cost.second;
+        dispatcher.subscribe(static_cast<EventType>(key.second), [meanNs](const Event&) {
+            spinFor(meanNs);
+        });
+    }
+
+    dispatcher.start();
+
+    auto replayStart = std::chrono::steady_clock::now();
+    uint64_t traceStart = publishes.front().timestampNs;
+    for (const auto& record : publishes) {
+        auto offset = std::chrono::nanoseconds(
+            static_cast<int64_t>(static_cast<double>(record.timestampNs - traceStart) / speed));
+        std::this_thread::sleep_until(replayStart + offset);
+        dispatcher.publish(static_cast<EventType>(record.type));
+    }
+
+    // Let the backlog drain before reading the trace back
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (dispatcher.getStats().queueSize > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    dispatcher.stop();
+
+    std::cout << "Replayed " << publishes.size() << " events against " << costs.size()
+              << " listeners (" << threads << " delivery threads, speed x" << speed << ")\n\n";
+    printSummary(dispatcher.getTrace(), "Replay");
+    return 0;
+}
+
+void printUsage() {
+    std::cout << "Usage:\n"
+              << "  quiet_event_trace summary <trace>\n"
+              << "  quiet_event_trace replay <trace> [--speed <factor>] [--threads <count>]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    std::string path = argv[2];
+
+    std::vector<EventTraceRecord> records;
+    if (!EventTraceBuffer::readFile(path, records)) {
+        std::cerr << "Cannot read trace file: " << path << "\n";
+        return 1;
+    }
+
+    if (command == "summary") {
+        printSummary(records, "Trace");
+        return 0;
+    }
+
+    if (command == "replay") {
+        double speed = 1.0;
+        size_t threads = 2;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--speed") == 0) {
+                speed = std::max(std::atof(argv[i + 1]), 0.001);
+            } else if (std::strcmp(argv[i], "--threads") == 0) {
+                threads = static_cast<size_t>(std::max(std::atoi(argv[i + 1]), 1));
+            }
+        }
+        return replay(records, speed, threads);
+    }
+
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file LogDecoder.cpp
+ * @brief Prints binary Logger output as text or JSON lines
+ *
+ * Reads files written with LoggerConfig::outputFormat = LogOutputFormat::Binary
+ * (rotated copies included) and prints one line per record. A record cut
+ * short at the end of a file, as left by a crash, is reported and skipped.
+ *
+ *   quiet_log_decode [--json] <log> [<log>...]
+ */
+
+#include "quiet/utils/StructuredLog.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace quiet::utils;
+
+namespace {
+
+// Same layout as the Logger's default text format
+void appendTextLine(std::string& out, const StructuredLogRecord& record) {
+    int64_t second = record.timestampNs / 1000000000;
+    int64_t millis = (record.timestampNs % 1000000000) / 1000000;
+    if (millis < 0) {
+        second -= 1;
+        millis += 1000;
+    }
+
+    auto time = static_cast<std::time_t>(second);
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+    char date[64];
+    size_t length = std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &localTime);
+    char prefix[128];
+    std::snprintf(prefix, sizeof(prefix), ".%03d [%s] [%llu]", static_cast<int>(millis),
+                  logLevelName(record.level), static_cast<unsigned long long>(record.threadId));
+    out.append(date, length);
+    out += prefix;
+
+    if (!record.file.empty()) {
+        out += " [";
+        out += record.file;
+        out += ':';
+        out += std::to_string(record.line);
+        out += ' ';
+        out += record.function;
+        out += ']';
+    }
+
+    out += ' ';
+    out += record.message;
+
+    if (!record.fields.empty()) {
+        out += " {";
+        LogFieldReader reader(record.fields);
+        LogFieldValue field;
+        bool first = true;
+        while (reader.next(field)) {
+            if (!first) {
+                out += ", ";
+            }
+            out += field.key;
+            out += '=';
+            appendLogFieldValue(out, field);
+            first = false;
+        }
+        out += '}';
+    }
+
+    out += '\n';
+}
+
+bool decodeFile(const std::string& path, bool json) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << path << ": cannot open\n";
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(kBinaryLogMagic) ||
+        std::memcmp(data.data(), kBinaryLogMagic, sizeof(kBinaryLogMagic)) != 0) {
+        std::cerr << path << ": not a binary Quiet log\n";
+        return false;
+    }
+
+    std::string out;
+    size_t offset = sizeof(kBinaryLogMagic);
+    while (offset < data.size()) {
+        StructuredLogRecord record;
+        size_t consumed = readBinaryLogRecord(data.data() + offset, data.size() - offset, record);
+        if (consumed == 0) {
+            std::cerr << path << ": incomplete or corrupt record at offset " << offset << ", "
+                      << data.size() - offset << " bytes skipped\n";
+            break;
+        }
+
+        if (json) {
+            appendJsonLogLine(out, record);
+        } else {
+            appendTextLine(out, record);
+        }
+        offset += consumed;
+
+        if (out.size() >= 64 * 1024) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    return offset == data.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            paths.emplace_back(argv[i]);
+        }
+    }
+
+    if (paths.empty()) {
+        std::cout << "Usage:\n"
+                  << "  quiet_log_decode [--json] <log> [<log>...]\n";
+        return 1;
+    }
+
+    bool ok = true;
+    for (const auto& path : paths) {
+        ok = decodeFile(path, json) && ok;
+    }
+    return ok ? 0 : 1;
+}